@@ -0,0 +1,78 @@
+/**
+ * @file bench_common.h
+ * @brief Tiny timing helpers shared by the TVLCOM microbenchmarks.
+ * @author UF4OVER
+ * @date 2026-01-12
+ *
+ * - bench_cycles(): TSC on x86 (GCC/Clang/MSVC), 0 elsewhere.
+ * - bench_now_ns(): monotonic wall clock (QueryPerformanceCounter / clock_gettime).
+ * - bench_rand(): deterministic xorshift PRNG so runs are comparable.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#if defined(_WIN32)
+#  ifndef WIN32_LEAN_AND_MEAN
+#  define WIN32_LEAN_AND_MEAN
+#  endif
+#  include <windows.h>
+#else
+#  include <time.h>
+#endif
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#  include <intrin.h>
+#  define BENCH_HAVE_TSC 1
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#  include <x86intrin.h>
+#  define BENCH_HAVE_TSC 1
+#else
+#  define BENCH_HAVE_TSC 0
+#endif
+
+static inline uint64_t bench_cycles(void)
+{
+#if BENCH_HAVE_TSC
+    return (uint64_t)__rdtsc();
+#else
+    return 0;
+#endif
+}
+
+static inline uint64_t bench_now_ns(void)
+{
+#if defined(_WIN32)
+    static LARGE_INTEGER freq;
+    LARGE_INTEGER now;
+    if (freq.QuadPart == 0) QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&now);
+    return (uint64_t)((double)now.QuadPart * 1e9 / (double)freq.QuadPart);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+static inline uint32_t bench_rand(uint32_t *state)
+{
+    uint32_t x = *state ? *state : 0x9E3779B9u;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+static inline void bench_fill_random(uint8_t *buf, size_t len, uint32_t seed)
+{
+    for (size_t i = 0; i < len; ++i) {
+        buf[i] = (uint8_t)bench_rand(&seed);
+    }
+}
+
+/** Keep the optimizer from discarding a computed value. */
+static volatile uint32_t bench_sink;
@@ -0,0 +1,72 @@
+/**
+ * @file bench_crc16.c
+ * @brief Microbenchmark: bytes/cycle of every CRC16 engine (S_CRC16).
+ * @author UF4OVER
+ * @date 2026-01-12
+ *
+ * Each engine is checked against the bitwise reference before it is timed.
+ * bytes/cycle uses the TSC where available (reported as n/a otherwise).
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include "bench_common.h"
+#include "S_CRC16.h"
+#include "S_TLV_PROTOCOL.h"
+
+#define BENCH_BUF_SIZE 4096u
+
+static uint8_t g_buf[BENCH_BUF_SIZE];
+
+static void bench_engine(tlv_crc16_engine_t engine, size_t len)
+{
+    /* Aim for ~64 MiB per measurement regardless of block length */
+    const size_t iters = (64u * 1024u * 1024u) / len;
+    uint16_t crc = 0;
+
+    uint64_t c0 = bench_cycles();
+    uint64_t t0 = bench_now_ns();
+    for (size_t i = 0; i < iters; ++i) {
+        crc ^= TLV_Crc16Compute(engine, TLV_CRC16_INIT, g_buf, len);
+    }
+    uint64_t t1 = bench_now_ns();
+    uint64_t c1 = bench_cycles();
+    bench_sink = crc;
+
+    double bytes = (double)iters * (double)len;
+    double secs = (double)(t1 - t0) / 1e9;
+    printf("  %-9s len=%5u  %9.1f MB/s", TLV_Crc16EngineName(engine), (unsigned)len, bytes / secs / 1e6);
+    if (BENCH_HAVE_TSC && c1 > c0) {
+        printf("  %6.3f bytes/cycle\n", bytes / (double)(c1 - c0));
+    } else {
+        printf("  n/a bytes/cycle\n");
+    }
+}
+
+int main(void)
+{
+    static const size_t sizes[] = { 8u, 64u, 2u + TLV_MAX_DATA_LENGTH, BENCH_BUF_SIZE };
+
+    bench_fill_random(g_buf, sizeof(g_buf), 0x12345678u);
+
+    printf("CRC16-CCITT engines (default: %s)\n", TLV_Crc16EngineName(TLV_Crc16GetEngine()));
+    for (int e = TLV_CRC16_ENGINE_BITWISE; e < TLV_CRC16_ENGINE_COUNT; ++e) {
+        tlv_crc16_engine_t engine = (tlv_crc16_engine_t)e;
+        if (!TLV_Crc16EngineAvailable(engine)) {
+            printf("  %-9s not available in this build/CPU\n", TLV_Crc16EngineName(engine));
+            continue;
+        }
+        for (size_t len = 0; len <= 300u; ++len) {
+            uint16_t ref = TLV_Crc16Compute(TLV_CRC16_ENGINE_BITWISE, TLV_CRC16_INIT, g_buf + 3, len);
+            if (TLV_Crc16Compute(engine, TLV_CRC16_INIT, g_buf + 3, len) != ref) {
+                printf("  %-9s MISMATCH at len=%u\n", TLV_Crc16EngineName(engine), (unsigned)len);
+                return 1;
+            }
+        }
+        for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s) {
+            bench_engine(engine, sizes[s]);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,131 @@
+/**
+ * @file bench_dispatch.c
+ * @brief Benchmark: receive dispatch cost vs number of registered TLV handlers.
+ * @author UF4OVER
+ * @date 2026-01-28
+ *
+ * Each frame is best-effort (no ACK is built or sent) and carries 8 one-byte
+ * TLVs whose types are the last 8 registered, i.e. the worst case for a
+ * linear registry.
+ *
+ * - linear : TLV_ParseData + the old id-array scan (reimplemented here as a baseline)
+ * - table  : FloatReceive_FrameCallback with the direct-indexed tables
+ *
+ * The table column should stay flat as the handler count grows.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "bench_common.h"
+#include "S_TLV_PROTOCOL.h"
+#include "S_RECEIVE_PROTOCOL.h"
+#include "S_TRANSPORT_PROTOCOL.h"
+
+#define ITERATIONS 200000u
+#define TLVS_PER_FRAME 8u
+
+static uint8_t g_linear_ids[256];
+static tlv_type_handler_t g_linear_fns[256];
+static uint16_t g_linear_count;
+
+static uint8_t g_data[TLV_MAX_DATA_LENGTH];
+static uint16_t g_data_len;
+
+static bool on_tlv(const tlv_entry_t *e, tlv_interface_t iface)
+{
+    (void)iface;
+    bench_sink += e->type;
+    return true;
+}
+
+static int null_send(const uint8_t *data, uint16_t len)
+{
+    (void)data;
+    return (int)len;
+}
+
+/* Registration order: 0xFF, 0xFE, ... so the frame types avoid the ACK/NACK/NO_ACK ids */
+static uint8_t nth_type(uint16_t k)
+{
+    return (uint8_t)(0xFFu - k);
+}
+
+static void setup(uint16_t handlers)
+{
+    for (uint16_t k = 0; k < 256u; ++k) {
+        FloatReceive_RegisterTLVHandler(nth_type(k), k < handlers ? on_tlv : NULL);
+    }
+    g_linear_count = 0;
+    for (uint16_t k = 0; k < handlers; ++k) {
+        g_linear_ids[g_linear_count] = nth_type(k);
+        g_linear_fns[g_linear_count] = on_tlv;
+        g_linear_count++;
+    }
+
+    tlv_entry_t e[TLVS_PER_FRAME + 1u];
+    uint8_t v = 0x5A;
+    TLV_CreateRawEntry(TLV_TYPE_NO_ACK, NULL, 0, &e[0]);
+    for (uint16_t i = 0; i < TLVS_PER_FRAME; ++i) {
+        TLV_CreateRawEntry(nth_type((uint16_t)(handlers - TLVS_PER_FRAME + i)), &v, 1, &e[i + 1u]);
+    }
+    uint8_t frame[TLV_MAX_FRAME_SIZE];
+    uint16_t size = 0;
+    TLV_BuildFrame(0x01, e, TLVS_PER_FRAME + 1u, frame, &size);
+    g_data_len = frame[3];
+    memcpy(g_data, &frame[4], g_data_len);
+}
+
+static void dispatch_linear(uint8_t frame_id)
+{
+    (void)frame_id;
+    tlv_entry_t entries[16];
+    uint8_t count = TLV_ParseData(g_data, g_data_len, entries, 16);
+    for (uint8_t i = 0; i < count; ++i) {
+        if (entries[i].type == TLV_TYPE_NO_ACK) continue;
+        for (uint16_t j = 0; j < g_linear_count; ++j) {
+            if (g_linear_ids[j] == entries[i].type) {
+                g_linear_fns[j](&entries[i], TLV_INTERFACE_UART);
+                break;
+            }
+        }
+    }
+}
+
+static void dispatch_table(uint8_t frame_id)
+{
+    FloatReceive_FrameCallback(frame_id, g_data, g_data_len, TLV_INTERFACE_UART);
+}
+
+/* Best of 5 rounds, ns per TLV */
+static double run(void (*fn)(uint8_t))
+{
+    double best = 0.0;
+    for (int round = 0; round < 5; ++round) {
+        uint64_t t0 = bench_now_ns();
+        for (uint32_t i = 0; i < ITERATIONS; ++i) {
+            fn((uint8_t)i);
+        }
+        uint64_t t1 = bench_now_ns();
+        double ns = (double)(t1 - t0) / ((double)ITERATIONS * TLVS_PER_FRAME);
+        if (round == 0 || ns < best) best = ns;
+    }
+    return best;
+}
+
+int main(void)
+{
+    static const uint16_t counts[] = { 8, 16, 32, 64, 128, 256 };
+    Transport_RegisterSender(TLV_INTERFACE_UART, null_send);
+    FloatReceive_Init(TLV_INTERFACE_UART);
+
+    printf("%-9s %16s %16s\n", "handlers", "linear ns/TLV", "table ns/TLV");
+    for (size_t i = 0; i < sizeof(counts) / sizeof(counts[0]); ++i) {
+        setup(counts[i]);
+        double a = run(dispatch_linear);
+        double b = run(dispatch_table);
+        printf("%-9u %16.1f %16.1f\n", (unsigned)counts[i], a, b);
+    }
+    return 0;
+}
@@ -0,0 +1,267 @@
+/**
+ * @file bench_event_loop.c
+ * @brief Benchmark: receive CPU per link, thread-per-link vs the epoll loop.
+ * @author UF4OVER
+ * @date 2026-02-04
+ *
+ * N pty pairs stand in for N serial ports: the slave side is opened with
+ * serial_open() and gets its own tvl_context_t, a writer thread sends
+ * best-effort frames (one 0x55 TLV of 16 bytes) to every master at
+ * FRAMES_PER_SEC for RUN_MS.
+ *
+ * - threads : one thread per link, serial_read() (select + read) -> TLV_ProcessBuffer
+ * - epoll/1 : serial_loop with one shard
+ * - epoll/4 : serial_loop with four shards
+ *
+ * The epoll columns include the loop's SERIAL_LOOP_POLL_MS timer service
+ * (Transport_PollCtx/FloatReceive_PollCtx per context), which the threads
+ * baseline does not run; with a single link that fixed cost dominates.
+ *
+ * Reported: receive-thread CPU in ms per link per second of traffic, and in
+ * us per frame, plus received/expected frames. Linux only.
+ */
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE /* posix_openpt, ptsname, clock_nanosleep */
+#endif
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__linux__)
+
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include "bench_common.h"
+#include "SERIAL.h"
+#include "SERIAL_LOOP.h"
+#include "S_CONTEXT.h"
+#include "S_TLV_PROTOCOL.h"
+#include "S_RECEIVE_PROTOCOL.h"
+
+#define MAX_LINKS 128u
+#define FRAMES_PER_SEC 200u
+#define RUN_MS 1000u
+#define BENCH_TLV_TYPE 0x55u
+
+typedef struct {
+    int master;
+    serial_t *slave;
+    tvl_context_t *ctx;
+} link_t;
+
+static link_t g_links[MAX_LINKS];
+static unsigned g_nlinks;
+static atomic_ulong g_frames;
+static atomic_bool g_stop;
+static uint8_t g_frame[TLV_MAX_FRAME_SIZE];
+static uint16_t g_frame_len;
+
+static bool on_tlv(const tlv_entry_t *e, tlv_interface_t iface)
+{
+    (void)e;
+    (void)iface;
+    atomic_fetch_add_explicit(&g_frames, 1u, memory_order_relaxed);
+    return true;
+}
+
+static uint64_t thread_cpu_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static bool open_links(unsigned n)
+{
+    for (unsigned i = 0; i < n; ++i) {
+        link_t *l = &g_links[i];
+        memset(l, 0, sizeof(*l));
+        g_nlinks = i + 1u; /* close_links() cleans up a partial set */
+        l->master = posix_openpt(O_RDWR | O_NOCTTY);
+        if (l->master < 0 || grantpt(l->master) != 0 || unlockpt(l->master) != 0) return false;
+        l->slave = serial_open(ptsname(l->master), 115200);
+        if (!l->slave) return false;
+
+        size_t size = (sizeof(tvl_context_t) + TVLCOM_CACHE_LINE - 1u) / TVLCOM_CACHE_LINE * TVLCOM_CACHE_LINE;
+        l->ctx = (tvl_context_t *)aligned_alloc(TVLCOM_CACHE_LINE, size);
+        if (!l->ctx) return false;
+        TVL_ContextInit(l->ctx);
+        FloatReceive_InitCtx(l->ctx, TLV_INTERFACE_UART);
+        FloatReceive_RegisterTLVHandlerCtx(l->ctx, BENCH_TLV_TYPE, on_tlv);
+    }
+    return true;
+}
+
+static void close_links(void)
+{
+    for (unsigned i = 0; i < g_nlinks; ++i) {
+        link_t *l = &g_links[i];
+        if (l->slave) serial_close(l->slave);
+        if (l->master >= 0) close(l->master);
+        if (l->ctx) {
+            TVL_ContextDeinit(l->ctx);
+            free(l->ctx);
+        }
+    }
+    g_nlinks = 0;
+}
+
+/* FRAMES_PER_SEC frames to every master for RUN_MS */
+static void *writer_thread(void *arg)
+{
+    (void)arg;
+    const uint64_t period_ns = 1000000000ull / FRAMES_PER_SEC;
+    const uint32_t rounds = FRAMES_PER_SEC * RUN_MS / 1000u;
+    uint64_t next = bench_now_ns();
+    for (uint32_t r = 0; r < rounds; ++r) {
+        for (unsigned i = 0; i < g_nlinks; ++i) {
+            (void)write(g_links[i].master, g_frame, g_frame_len);
+        }
+        next += period_ns;
+        struct timespec ts = { (time_t)(next / 1000000000ull), (long)(next % 1000000000ull) };
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+    }
+    return NULL;
+}
+
+/* Receive-side CPU of every worker, summed */
+static atomic_ullong g_cpu_ns;
+
+static void *per_link_thread(void *arg)
+{
+    link_t *l = (link_t *)arg;
+    uint8_t buf[SERIAL_LOOP_READ_CHUNK];
+    tlv_parser_t *p = FloatReceive_GetParserCtx(l->ctx, TLV_INTERFACE_UART);
+    uint64_t c0 = thread_cpu_ns();
+    while (!atomic_load(&g_stop)) {
+        ssize_t n = serial_read(l->slave, buf, sizeof(buf), 100);
+        if (n > 0) (void)TLV_ProcessBuffer(p, buf, (size_t)n);
+    }
+    atomic_fetch_add(&g_cpu_ns, thread_cpu_ns() - c0);
+    return NULL;
+}
+
+typedef struct {
+    serial_loop_t *loop;
+    unsigned shard;
+} shard_arg_t;
+
+static void *shard_thread(void *arg)
+{
+    shard_arg_t *a = (shard_arg_t *)arg;
+    uint64_t c0 = thread_cpu_ns();
+    while (!atomic_load(&g_stop)) {
+        if (serial_loop_run_once(a->loop, a->shard, 100) < 0) break;
+    }
+    atomic_fetch_add(&g_cpu_ns, thread_cpu_ns() - c0);
+    return NULL;
+}
+
+/* Let the receivers drain, then stop them */
+static void finish_run(pthread_t writer)
+{
+    pthread_join(writer, NULL);
+    const unsigned long expected = (unsigned long)g_nlinks * (FRAMES_PER_SEC * RUN_MS / 1000u);
+    for (int i = 0; i < 100 && atomic_load(&g_frames) < expected; ++i) {
+        struct timespec ts = { 0, 10000000L };
+        nanosleep(&ts, NULL);
+    }
+    atomic_store(&g_stop, true);
+}
+
+static void report(const char *mode, unsigned n)
+{
+    const unsigned long expected = (unsigned long)n * (FRAMES_PER_SEC * RUN_MS / 1000u);
+    unsigned long got = atomic_load(&g_frames);
+    double cpu_ms = (double)atomic_load(&g_cpu_ns) / 1e6;
+    double per_link = cpu_ms / n / (RUN_MS / 1000.0);
+    double per_frame = got ? cpu_ms * 1000.0 / (double)got : 0.0;
+    printf("%-6u %-9s %14.3f %14.2f %9lu/%lu\n", n, mode, per_link, per_frame, got, expected);
+}
+
+static void reset_counters(void)
+{
+    atomic_store(&g_frames, 0u);
+    atomic_store(&g_cpu_ns, 0u);
+    atomic_store(&g_stop, false);
+}
+
+static void run_threads(unsigned n)
+{
+    static pthread_t th[MAX_LINKS];
+    pthread_t writer;
+    reset_counters();
+    for (unsigned i = 0; i < n; ++i) pthread_create(&th[i], NULL, per_link_thread, &g_links[i]);
+    pthread_create(&writer, NULL, writer_thread, NULL);
+    finish_run(writer);
+    for (unsigned i = 0; i < n; ++i) pthread_join(th[i], NULL);
+    report("threads", n);
+}
+
+static void run_loop(unsigned n, unsigned shards)
+{
+    pthread_t th[8];
+    shard_arg_t args[8];
+    pthread_t writer;
+    char mode[16];
+
+    serial_loop_t *loop = serial_loop_create(shards);
+    if (!loop) return;
+    for (unsigned i = 0; i < n; ++i) (void)serial_loop_add(loop, g_links[i].slave, g_links[i].ctx, TLV_INTERFACE_UART);
+
+    reset_counters();
+    for (unsigned s = 0; s < shards; ++s) {
+        args[s].loop = loop;
+        args[s].shard = s;
+        pthread_create(&th[s], NULL, shard_thread, &args[s]);
+    }
+    pthread_create(&writer, NULL, writer_thread, NULL);
+    finish_run(writer);
+    for (unsigned s = 0; s < shards; ++s) pthread_join(th[s], NULL);
+    serial_loop_destroy(loop);
+
+    snprintf(mode, sizeof(mode), "epoll/%u", shards);
+    report(mode, n);
+}
+
+int main(void)
+{
+    static const unsigned counts[] = { 1, 16, 128 };
+    uint8_t value[16];
+    memset(value, 0xA5, sizeof(value));
+    tlv_entry_t e[2];
+    TLV_CreateRawEntry(TLV_TYPE_NO_ACK, NULL, 0, &e[0]);
+    TLV_CreateRawEntry(BENCH_TLV_TYPE, value, sizeof(value), &e[1]);
+    TLV_BuildFrame(0x01, e, 2, g_frame, &g_frame_len);
+
+    printf("%-6s %-9s %14s %14s %15s\n", "links", "mode", "cpu ms/link/s", "cpu us/frame", "frames");
+    for (size_t i = 0; i < sizeof(counts) / sizeof(counts[0]); ++i) {
+        if (!open_links(counts[i])) {
+            printf("%-6u could not open %u pty pairs, skipped\n", counts[i], counts[i]);
+            close_links();
+            continue;
+        }
+        run_threads(counts[i]);
+        run_loop(counts[i], 1);
+        run_loop(counts[i], 4);
+        close_links();
+    }
+    return 0;
+}
+
+#else
+
+int main(void)
+{
+    printf("bench_event_loop: epoll/pty benchmark, Linux only - skipped\n");
+    return 0;
+}
+
+#endif
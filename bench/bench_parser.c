@@ -0,0 +1,95 @@
+/**
+ * @file bench_parser.c
+ * @brief Benchmark: TLV_ProcessByte loop vs TLV_ProcessBuffer (MB/s).
+ * @author UF4OVER
+ * @date 2026-01-14
+ *
+ * Streams:
+ * - small : 1 TLV of 4..16 bytes per frame (telemetry-like)
+ * - large : max-size frames (TLV_MAX_DATA_LENGTH payload)
+ * - noisy : large frames separated by 64-byte random gaps
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench_common.h"
+#include "S_TLV_PROTOCOL.h"
+
+#define STREAM_SIZE (1u << 20)
+
+static uint8_t *g_stream;
+static size_t g_stream_len;
+static uint32_t g_frames;
+
+static void on_frame(uint8_t frame_id, const uint8_t *data, uint16_t length, tlv_interface_t iface)
+{
+    (void)frame_id; (void)data; (void)length; (void)iface;
+    g_frames++;
+}
+
+static void build_stream(int kind)
+{
+    uint32_t seed = 0xA5A5A5A5u;
+    uint8_t payload[TLV_MAX_DATA_LENGTH];
+    g_stream_len = 0;
+    while (g_stream_len + TLV_MAX_FRAME_SIZE + 64u < STREAM_SIZE) {
+        uint8_t plen = (kind == 0) ? (uint8_t)(4u + bench_rand(&seed) % 13u) : (uint8_t)(TLV_MAX_DATA_LENGTH - 2u);
+        bench_fill_random(payload, plen, bench_rand(&seed));
+        tlv_entry_t e;
+        TLV_CreateRawEntry(0x33, payload, plen, &e);
+        uint16_t flen = 0;
+        TLV_BuildFrame((uint8_t)g_stream_len, &e, 1, &g_stream[g_stream_len], &flen);
+        g_stream_len += flen;
+        if (kind == 2) {
+            bench_fill_random(&g_stream[g_stream_len], 64u, bench_rand(&seed));
+            g_stream_len += 64u;
+        }
+    }
+}
+
+static double run(size_t chunk, uint32_t *frames)
+{
+    tlv_parser_t parser;
+    const int reps = 20;
+    TLV_InitParser(&parser, TLV_INTERFACE_UART, on_frame);
+    g_frames = 0;
+
+    uint64_t t0 = bench_now_ns();
+    for (int r = 0; r < reps; ++r) {
+        for (size_t off = 0; off < g_stream_len; off += chunk) {
+            size_t len = (g_stream_len - off < chunk) ? (g_stream_len - off) : chunk;
+            if (chunk == 1) {
+                TLV_ProcessByte(&parser, g_stream[off]);
+            } else {
+                (void)TLV_ProcessBuffer(&parser, &g_stream[off], len);
+            }
+        }
+    }
+    uint64_t t1 = bench_now_ns();
+    *frames = g_frames / (uint32_t)reps;
+    return (double)g_stream_len * reps / ((double)(t1 - t0) / 1e9) / 1e6;
+}
+
+int main(void)
+{
+    static const char *names[] = { "small", "large", "noisy" };
+    g_stream = (uint8_t *)malloc(STREAM_SIZE);
+    if (!g_stream) return 1;
+
+    printf("TLV parser throughput (CRC engine: %s)\n", TLV_Crc16EngineName(TLV_Crc16GetEngine()));
+    for (int kind = 0; kind < 3; ++kind) {
+        build_stream(kind);
+        uint32_t f_byte = 0, f_256 = 0, f_4k = 0;
+        double per_byte = run(1, &f_byte);
+        double buf_256 = run(256, &f_256);
+        double buf_4k = run(4096, &f_4k);
+        printf("  %-5s  ProcessByte %8.1f MB/s | ProcessBuffer(256) %8.1f MB/s | ProcessBuffer(4096) %8.1f MB/s  frames=%u%s\n",
+               names[kind], per_byte, buf_256, buf_4k, (unsigned)f_byte,
+               (f_byte == f_256 && f_byte == f_4k) ? "" : "  FRAME COUNT MISMATCH");
+    }
+    free(g_stream);
+    return 0;
+}
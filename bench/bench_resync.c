@@ -0,0 +1,107 @@
+/**
+ * @file bench_resync.c
+ * @brief Benchmark: resync cost per MB of random noise (header hunt).
+ * @author UF4OVER
+ * @date 2026-01-16
+ *
+ * Feeds 4 MiB of random bytes (with a valid frame every 64 KiB so the parser
+ * keeps finding real headers) and reports time per MiB for:
+ * - the TLV_ProcessByte loop,
+ * - TLV_ProcessBuffer with each available sync scanner implementation.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "bench_common.h"
+#include "S_SYNC_SCAN.h"
+#include "S_TLV_PROTOCOL.h"
+
+#define NOISE_SIZE   (4u << 20)
+#define FRAME_EVERY  (64u << 10)
+#define CHUNK        4096u
+
+static uint8_t *g_noise;
+static uint32_t g_frames;
+
+static void on_frame(uint8_t frame_id, const uint8_t *data, uint16_t length, tlv_interface_t iface)
+{
+    (void)frame_id; (void)data; (void)length; (void)iface;
+    g_frames++;
+}
+
+static void report(const char *name, uint64_t ns, uint64_t cyc, const char *what)
+{
+    double mib = (double)NOISE_SIZE / (1024.0 * 1024.0);
+    printf("  %-22s %9.1f us/MiB", name, (double)ns / 1e3 / mib);
+    if (BENCH_HAVE_TSC && cyc) {
+        printf("  %8.3f cycles/byte", (double)cyc / (double)NOISE_SIZE);
+    }
+    printf("  %s=%u\n", what, (unsigned)g_frames);
+}
+
+int main(void)
+{
+    g_noise = (uint8_t *)malloc(NOISE_SIZE);
+    if (!g_noise) return 1;
+    bench_fill_random(g_noise, NOISE_SIZE, 0xDEADBEEFu);
+
+    /* Plant one valid frame every FRAME_EVERY bytes */
+    uint8_t payload[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+    tlv_entry_t e;
+    TLV_CreateRawEntry(0x33, payload, sizeof(payload), &e);
+    for (size_t off = FRAME_EVERY / 2; off + TLV_MAX_FRAME_SIZE < NOISE_SIZE; off += FRAME_EVERY) {
+        uint16_t flen = 0;
+        TLV_BuildFrame((uint8_t)(off >> 16), &e, 1, &g_noise[off], &flen);
+    }
+
+    tlv_parser_t parser;
+    printf("Resync over %u MiB of random noise (valid frame every %u KiB)\n",
+           (unsigned)(NOISE_SIZE >> 20), (unsigned)(FRAME_EVERY >> 10));
+
+    TLV_InitParser(&parser, TLV_INTERFACE_UART, on_frame);
+    g_frames = 0;
+    uint64_t t0 = bench_now_ns(), c0 = bench_cycles();
+    for (size_t i = 0; i < NOISE_SIZE; ++i) TLV_ProcessByte(&parser, g_noise[i]);
+    uint64_t c1 = bench_cycles(), t1 = bench_now_ns();
+    report("ProcessByte", t1 - t0, c1 - c0, "frames");
+
+    for (int impl = TLV_SYNC_IMPL_SCALAR; impl < TLV_SYNC_IMPL_COUNT; ++impl) {
+        if (!TLV_SyncSetImpl((tlv_sync_impl_t)impl)) continue;
+        char name[32];
+        snprintf(name, sizeof(name), "ProcessBuffer/%s", TLV_SyncImplName((tlv_sync_impl_t)impl));
+
+        TLV_InitParser(&parser, TLV_INTERFACE_UART, on_frame);
+        g_frames = 0;
+        t0 = bench_now_ns();
+        c0 = bench_cycles();
+        for (size_t off = 0; off < NOISE_SIZE; off += CHUNK) {
+            (void)TLV_ProcessBuffer(&parser, &g_noise[off], CHUNK);
+        }
+        c1 = bench_cycles();
+        t1 = bench_now_ns();
+        report(name, t1 - t0, c1 - c0, "frames");
+    }
+
+    /* Pure scanner cost (no parser): how fast can a capture decoder skip garbage */
+    for (int impl = TLV_SYNC_IMPL_SCALAR; impl < TLV_SYNC_IMPL_COUNT; ++impl) {
+        if (!TLV_SyncSetImpl((tlv_sync_impl_t)impl)) continue;
+        char name[32];
+        snprintf(name, sizeof(name), "SyncFind/%s", TLV_SyncImplName((tlv_sync_impl_t)impl));
+        g_frames = 0;
+        t0 = bench_now_ns();
+        c0 = bench_cycles();
+        for (size_t off = 0; off < NOISE_SIZE; ) {
+            size_t hit = TLV_SyncFind(&g_noise[off], NOISE_SIZE - off);
+            off += hit + 1;
+            if (off <= NOISE_SIZE) g_frames++;
+        }
+        c1 = bench_cycles();
+        t1 = bench_now_ns();
+        report(name, t1 - t0, c1 - c0, "candidates");
+    }
+
+    free(g_noise);
+    return 0;
+}
@@ -0,0 +1,210 @@
+/**
+ * @file bench_serial_latency.c
+ * @brief Benchmark: request-to-ACK round trip over a pty pair, classic read loop vs serial_reader.
+ * @author UF4OVER
+ * @date 2026-02-07
+ *
+ * The pty slave plays the device: it is opened with serial_open(), runs
+ * FloatReceive (auto-ACK) and sends its ACKs back with serial_write(). The
+ * master plays the host: it writes one reliable request frame, waits until
+ * the matching ACK has been parsed, records the round trip, idles a random
+ * 0..IDLE_MAX_US and repeats ROUNDS times.
+ *
+ * Device receive loops:
+ * - read+sleep   : serial_read(256 B, 1 ms) and a 1 ms sleep when it times
+ *                  out, the pattern of the demo rx loop (VMIN=0/VTIME=1);
+ * - reader       : serial_set_low_latency() + serial_reader_poll(), no sleep;
+ * - reader/frame : the same, returning as soon as a frame is complete.
+ *
+ * Reported: p50/p99/max round trip in microseconds. Linux only.
+ */
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE /* posix_openpt, ptsname */
+#endif
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__linux__)
+
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include "bench_common.h"
+#include "SERIAL.h"
+#include "SERIAL_READER.h"
+#include "S_TLV_PROTOCOL.h"
+#include "S_RECEIVE_PROTOCOL.h"
+#include "S_TRANSPORT_PROTOCOL.h"
+
+#define ROUNDS 2000u
+#define IDLE_MAX_US 3000u
+#define BENCH_TLV_TYPE 0x55u
+
+typedef enum { MODE_READ_SLEEP, MODE_READER, MODE_READER_FRAME } rx_mode_t;
+
+static serial_t *g_slave;
+static atomic_bool g_stop;
+static uint8_t g_acked_id;
+static bool g_acked;
+
+static bool on_request(const tlv_entry_t *e, tlv_interface_t iface)
+{
+    (void)e;
+    (void)iface;
+    return true;
+}
+
+/* Device replies go back through the slave */
+static int device_send(const uint8_t *data, uint16_t len)
+{
+    ssize_t n = serial_write(g_slave, data, len);
+    return n < 0 ? -1 : (int)n;
+}
+
+/* Host side: remember the ACKed frame id */
+static void on_host_frame(uint8_t frame_id, const uint8_t *data, uint16_t length, tlv_interface_t iface)
+{
+    (void)frame_id;
+    (void)iface;
+    tlv_entry_t e[4];
+    uint8_t n = TLV_ParseData(data, length, e, 4);
+    for (uint8_t i = 0; i < n; ++i) {
+        if (e[i].type == TLV_TYPE_ACK && e[i].length >= 1) {
+            g_acked_id = e[i].value[0];
+            g_acked = true;
+        }
+    }
+}
+
+static void *device_thread(void *arg)
+{
+    rx_mode_t mode = *(const rx_mode_t *)arg;
+    tlv_parser_t *p = FloatReceive_GetUARTParser();
+
+    if (mode == MODE_READ_SLEEP) {
+        uint8_t buf[256];
+        const struct timespec idle = { 0, 1000000L };
+        while (!atomic_load(&g_stop)) {
+            ssize_t n = serial_read(g_slave, buf, sizeof(buf), 1);
+            if (n > 0) {
+                (void)TLV_ProcessBuffer(p, buf, (size_t)n);
+            } else {
+                nanosleep(&idle, NULL);
+            }
+        }
+        return NULL;
+    }
+
+    serial_reader_t *r = serial_reader_create(g_slave, p, 0);
+    if (!r) return NULL;
+    while (!atomic_load(&g_stop)) {
+        if (serial_reader_poll(r, 50, mode == MODE_READER_FRAME) < 0) break;
+    }
+    serial_reader_destroy(r);
+    return NULL;
+}
+
+static int cmp_u64(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+static void run_mode(const char *name, rx_mode_t mode)
+{
+    static uint64_t rtt[ROUNDS];
+    int m = posix_openpt(O_RDWR | O_NOCTTY);
+    if (m < 0 || grantpt(m) != 0 || unlockpt(m) != 0 || !(g_slave = serial_open(ptsname(m), 115200))) {
+        printf("%-13s cannot open pty\n", name);
+        if (m >= 0) close(m);
+        return;
+    }
+    if (mode != MODE_READ_SLEEP) (void)serial_set_low_latency(g_slave, true); /* best-effort on a pty */
+
+    FloatReceive_Init(TLV_INTERFACE_UART);
+    Transport_RegisterSender(TLV_INTERFACE_UART, device_send);
+
+    tlv_parser_t host;
+    TLV_InitParser(&host, TLV_INTERFACE_UART, on_host_frame);
+
+    pthread_t th;
+    atomic_store(&g_stop, false);
+    pthread_create(&th, NULL, device_thread, &mode);
+
+    uint32_t seed = 0x1234u;
+    unsigned done = 0, lost = 0;
+    for (unsigned i = 0; i < ROUNDS; ++i) {
+        uint8_t id = (uint8_t)(1u + i % 250u);
+        uint8_t value[8];
+        memset(value, (int)id, sizeof(value));
+        tlv_entry_t e;
+        uint8_t frame[TLV_MAX_FRAME_SIZE];
+        uint16_t len = 0;
+        TLV_CreateRawEntry(BENCH_TLV_TYPE, value, sizeof(value), &e);
+        TLV_BuildFrame(id, &e, 1, frame, &len);
+
+        g_acked = false;
+        uint64_t t0 = bench_now_ns();
+        (void)write(m, frame, len);
+        while (!(g_acked && g_acked_id == id)) {
+            struct pollfd pfd = { m, POLLIN, 0 };
+            if (poll(&pfd, 1, 100) <= 0) break; /* lost: count it, move on */
+            uint8_t buf[256];
+            ssize_t n = read(m, buf, sizeof(buf));
+            if (n <= 0) break;
+            (void)TLV_ProcessBuffer(&host, buf, (size_t)n);
+        }
+        if (g_acked && g_acked_id == id) {
+            rtt[done++] = bench_now_ns() - t0;
+        } else {
+            lost++;
+        }
+
+        seed = seed * 1103515245u + 12345u;
+        struct timespec idle = { 0, (long)((seed >> 8) % IDLE_MAX_US) * 1000L };
+        nanosleep(&idle, NULL);
+    }
+
+    atomic_store(&g_stop, true);
+    pthread_join(th, NULL);
+    serial_close(g_slave);
+    close(m);
+
+    if (!done) {
+        printf("%-13s no ACKs received\n", name);
+        return;
+    }
+    qsort(rtt, done, sizeof(rtt[0]), cmp_u64);
+    printf("%-13s %10.1f %10.1f %10.1f %6u\n", name,
+           (double)rtt[done / 2] / 1e3, (double)rtt[(size_t)done * 99u / 100u] / 1e3,
+           (double)rtt[done - 1] / 1e3, lost);
+}
+
+int main(void)
+{
+    FloatReceive_RegisterTLVHandler(BENCH_TLV_TYPE, on_request);
+
+    printf("%-13s %10s %10s %10s %6s\n", "device rx", "p50 us", "p99 us", "max us", "lost");
+    run_mode("read+sleep", MODE_READ_SLEEP);
+    run_mode("reader", MODE_READER);
+    run_mode("reader/frame", MODE_READER_FRAME);
+    return 0;
+}
+
+#else
+
+int main(void)
+{
+    printf("bench_serial_latency: pty benchmark, Linux only - skipped\n");
+    return 0;
+}
+
+#endif
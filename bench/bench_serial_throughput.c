@@ -0,0 +1,185 @@
+/**
+ * @file bench_serial_throughput.c
+ * @brief Benchmark: serial_open() at high/custom baud rates and the byte rate achieved.
+ * @author UF4OVER
+ * @date 2026-02-06
+ *
+ * For each rate (921600, 2000000, 3000000 and the non-standard 1234567 that
+ * needs termios2/BOTHER) a port is opened with serial_open(), a writer
+ * thread streams best-effort frames (one 0x55 TLV of 200 bytes) for RUN_MS
+ * and the reader feeds serial_read() into the TLV parser.
+ *
+ * - pty      : pseudo-terminal pair; ptys ignore the line rate, so this shows
+ *              that the rate is accepted and the software ceiling of
+ *              serial_read + parser.
+ * - loopback : set TVLCOM_LOOPBACK_PORT=/dev/ttyUSB0 (TX wired to RX) to run
+ *              the same test on a real adapter; "line %" is then the share of
+ *              the configured rate actually achieved (8N1: 10 bits per byte).
+ *
+ * A rate the driver refuses is reported as "unsupported" (serial_open fails
+ * with EINVAL) instead of silently running at another speed. Linux only.
+ */
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE /* posix_openpt, ptsname */
+#endif
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__linux__)
+
+#include <stdlib.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include "bench_common.h"
+#include "SERIAL.h"
+#include "S_TLV_PROTOCOL.h"
+#include "S_RECEIVE_PROTOCOL.h"
+
+#define RUN_MS 500u
+#define VALUE_LEN 200u
+#define BENCH_TLV_TYPE 0x55u
+
+static uint8_t g_frame[TLV_MAX_FRAME_SIZE];
+static uint16_t g_frame_len;
+static atomic_bool g_writing;
+static uint64_t g_frames_rx;
+static uint64_t g_errors_rx;
+
+typedef struct {
+    int fd;             /* pty master, or -1: write through 'port' */
+    serial_t *port;
+} writer_arg_t;
+
+static bool on_tlv(const tlv_entry_t *e, tlv_interface_t iface)
+{
+    (void)iface;
+    g_frames_rx += e->length == VALUE_LEN;
+    return true;
+}
+
+static void on_error(uint8_t frame_id, tlv_interface_t iface, tlv_error_t error)
+{
+    (void)frame_id;
+    (void)iface;
+    (void)error;
+    g_errors_rx++;
+}
+
+static void *writer_thread(void *arg)
+{
+    writer_arg_t *w = (writer_arg_t *)arg;
+    while (atomic_load(&g_writing)) {
+        (void)(w->fd >= 0 ? write(w->fd, g_frame, g_frame_len) : serial_write(w->port, g_frame, g_frame_len));
+    }
+    return NULL;
+}
+
+/* Stream for RUN_MS, drain, print one row */
+static void run_rate(const char *mode, serial_t *rx, writer_arg_t *w, unsigned int baud)
+{
+    FloatReceive_Init(TLV_INTERFACE_UART); /* fresh parser per rate */
+    tlv_parser_t *p = FloatReceive_GetUARTParser();
+    TLV_SetErrorCallback(p, on_error);      /* count only: no NACKs back into the pty */
+    uint8_t buf[4096];
+    uint64_t bytes_rx = 0;
+    g_frames_rx = 0;
+    g_errors_rx = 0;
+
+    pthread_t th;
+    atomic_store(&g_writing, true);
+    uint64_t t0 = bench_now_ns();
+    uint64_t t_last = t0;
+    pthread_create(&th, NULL, writer_thread, w);
+
+    for (;;) {
+        uint64_t now = bench_now_ns();
+        if (atomic_load(&g_writing) && now - t0 >= RUN_MS * 1000000ull) {
+            atomic_store(&g_writing, false);
+        }
+        ssize_t n = serial_read(rx, buf, sizeof(buf), 50);
+        if (n > 0) {
+            bytes_rx += (uint64_t)n;
+            t_last = bench_now_ns();
+            (void)TLV_ProcessBuffer(p, buf, (size_t)n);
+        } else if (!atomic_load(&g_writing)) {
+            break; /* writer done and the line went quiet */
+        }
+    }
+    pthread_join(th, NULL);
+
+    double secs = (double)(t_last - t0) / 1e9;
+    double bps = secs > 0.0 ? (double)bytes_rx / secs : 0.0;
+    double line = (double)baud / 10.0;
+    printf("%-9s %9u %12.2f %10.1f%% %9llu %7llu\n", mode, baud, bps / 1e6, 100.0 * bps / line,
+           (unsigned long long)g_frames_rx, (unsigned long long)g_errors_rx);
+}
+
+static void bench_pty(unsigned int baud)
+{
+    int m = posix_openpt(O_RDWR | O_NOCTTY);
+    if (m < 0 || grantpt(m) != 0 || unlockpt(m) != 0) {
+        printf("%-9s %9u  cannot open pty\n", "pty", baud);
+        if (m >= 0) close(m);
+        return;
+    }
+    serial_t *s = serial_open(ptsname(m), baud);
+    if (!s) {
+        printf("%-9s %9u  unsupported (%s)\n", "pty", baud, strerror(errno));
+        close(m);
+        return;
+    }
+    writer_arg_t w = { m, NULL };
+    run_rate("pty", s, &w, baud);
+    serial_close(s);
+    close(m);
+}
+
+static void bench_loopback(const char *port, unsigned int baud)
+{
+    serial_t *s = serial_open(port, baud);
+    if (!s) {
+        printf("%-9s %9u  unsupported (%s)\n", "loopback", baud, strerror(errno));
+        return;
+    }
+    writer_arg_t w = { -1, s };
+    run_rate("loopback", s, &w, baud);
+    serial_close(s);
+}
+
+int main(void)
+{
+    static const unsigned int rates[] = { 921600u, 2000000u, 3000000u, 1234567u };
+    uint8_t value[VALUE_LEN];
+    memset(value, 0x5A, sizeof(value));
+    tlv_entry_t e[2];
+    TLV_CreateRawEntry(TLV_TYPE_NO_ACK, NULL, 0, &e[0]);
+    TLV_CreateRawEntry(BENCH_TLV_TYPE, value, VALUE_LEN, &e[1]);
+    TLV_BuildFrame(0x01, e, 2, g_frame, &g_frame_len);
+
+    FloatReceive_RegisterTLVHandler(BENCH_TLV_TYPE, on_tlv);
+
+    const char *loop_port = getenv("TVLCOM_LOOPBACK_PORT");
+    printf("%-9s %9s %12s %11s %9s %7s\n", "mode", "baud", "MB/s", "line %", "frames", "errors");
+    for (size_t i = 0; i < sizeof(rates) / sizeof(rates[0]); ++i) {
+        bench_pty(rates[i]);
+        if (loop_port && *loop_port) bench_loopback(loop_port, rates[i]);
+    }
+    return 0;
+}
+
+#else
+
+int main(void)
+{
+    printf("bench_serial_throughput: pty/termios2 benchmark, Linux only - skipped\n");
+    return 0;
+}
+
+#endif
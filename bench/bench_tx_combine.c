@@ -0,0 +1,192 @@
+/**
+ * @file bench_tx_combine.c
+ * @brief Benchmark: concurrent senders on one link, application lock vs combining writer.
+ * @author UF4OVER
+ * @date 2026-02-10
+ *
+ * N threads send small TLV frames on the same interface; the sender writes
+ * them into a pipe, a reader thread parses the other end and counts intact
+ * frames and CRC errors.
+ *
+ * Both modes install pthread mutexes in the HAL.
+ * - app lock  : every Transport_SendTLVsCtx() wrapped in one application
+ *               mutex (what callers had to do before): senders queue on that
+ *               lock, one write() per frame;
+ * - combining : no application lock: waiting senders' frames are written
+ *               together by whichever thread holds the interface's write lock.
+ *
+ * Reported: frames per second, write() calls per frame, broken frames
+ * (must be 0). Linux only.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__linux__)
+
+#include <stdlib.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include "bench_common.h"
+#include "HAL/hal.h"
+#include "S_TLV_PROTOCOL.h"
+#include "S_TRANSPORT_PROTOCOL.h"
+#include "S_CONTEXT.h"
+
+#define FRAMES_TOTAL 200000u
+#define MAX_THREADS 8u
+#define BENCH_TLV_TYPE 0x56u
+
+static tvl_hal_mutex_t bench_mutex_create(void)
+{
+    pthread_mutex_t *m = (pthread_mutex_t *)malloc(sizeof(*m));
+    if (m) pthread_mutex_init(m, NULL);
+    return m;
+}
+
+static void bench_mutex_destroy(tvl_hal_mutex_t m)
+{
+    pthread_mutex_destroy((pthread_mutex_t *)m);
+    free(m);
+}
+
+static void bench_mutex_lock(tvl_hal_mutex_t m)
+{
+    pthread_mutex_lock((pthread_mutex_t *)m);
+}
+
+static void bench_mutex_unlock(tvl_hal_mutex_t m)
+{
+    pthread_mutex_unlock((pthread_mutex_t *)m);
+}
+
+static const tvl_hal_vtable_t g_pthread_hal = {
+    .mutex_create = bench_mutex_create,
+    .mutex_destroy = bench_mutex_destroy,
+    .mutex_lock = bench_mutex_lock,
+    .mutex_unlock = bench_mutex_unlock,
+};
+
+static tvl_context_t g_ctx;
+static int g_pipe[2];
+static atomic_uint g_writes;
+static pthread_mutex_t g_app_lock = PTHREAD_MUTEX_INITIALIZER;
+static bool g_use_app_lock;
+static unsigned g_frames_per_thread;
+
+static uint32_t g_rx_frames;
+static uint32_t g_rx_errors;
+
+static int pipe_send(const uint8_t *data, uint16_t len)
+{
+    uint16_t off = 0;
+    while (off < len) {
+        ssize_t n = write(g_pipe[1], data + off, (size_t)(len - off));
+        atomic_fetch_add_explicit(&g_writes, 1u, memory_order_relaxed);
+        if (n <= 0) return -1;
+        off = (uint16_t)(off + n);
+    }
+    return (int)len;
+}
+
+static void on_rx_frame(uint8_t frame_id, const uint8_t *data, uint16_t length, tlv_interface_t iface)
+{
+    (void)frame_id;
+    (void)data;
+    (void)length;
+    (void)iface;
+    g_rx_frames++;
+}
+
+static void on_rx_error(uint8_t frame_id, tlv_interface_t iface, tlv_error_t error)
+{
+    (void)frame_id;
+    (void)iface;
+    (void)error;
+    g_rx_errors++;
+}
+
+static void *reader_thread(void *arg)
+{
+    tlv_parser_t *p = (tlv_parser_t *)arg;
+    uint8_t buf[4096];
+    ssize_t n;
+    while ((n = read(g_pipe[0], buf, sizeof(buf))) > 0) {
+        (void)TLV_ProcessBuffer(p, buf, (size_t)n);
+    }
+    return NULL;
+}
+
+static void *producer_thread(void *arg)
+{
+    uint8_t value[8];
+    memset(value, (int)(uintptr_t)arg, sizeof(value));
+    for (unsigned i = 0; i < g_frames_per_thread; ++i) {
+        tlv_entry_t e;
+        TLV_CreateRawEntry(BENCH_TLV_TYPE, value, sizeof(value), &e);
+        if (g_use_app_lock) pthread_mutex_lock(&g_app_lock);
+        (void)Transport_SendTLVsCtx(&g_ctx, TLV_INTERFACE_UART, (uint8_t)i, &e, 1);
+        if (g_use_app_lock) pthread_mutex_unlock(&g_app_lock);
+    }
+    return NULL;
+}
+
+static void run(const char *name, bool combining, unsigned threads)
+{
+    TVL_HAL_Set(&g_pthread_hal);
+    TVL_ContextInit(&g_ctx);
+    Transport_RegisterSenderCtx(&g_ctx, TLV_INTERFACE_UART, pipe_send);
+    g_use_app_lock = !combining;
+    g_frames_per_thread = FRAMES_TOTAL / threads;
+    atomic_store(&g_writes, 0u);
+    g_rx_frames = g_rx_errors = 0;
+
+    if (pipe(g_pipe) != 0) {
+        printf("%-10s cannot create pipe\n", name);
+        return;
+    }
+    tlv_parser_t far;
+    TLV_InitParser(&far, TLV_INTERFACE_UART, on_rx_frame);
+    TLV_SetErrorCallback(&far, on_rx_error);
+    pthread_t rd, prod[MAX_THREADS];
+    pthread_create(&rd, NULL, reader_thread, &far);
+
+    uint64_t t0 = bench_now_ns();
+    for (uintptr_t i = 0; i < threads; ++i) pthread_create(&prod[i], NULL, producer_thread, (void *)i);
+    for (unsigned i = 0; i < threads; ++i) pthread_join(prod[i], NULL);
+    uint64_t dt = bench_now_ns() - t0;
+
+    close(g_pipe[1]);
+    pthread_join(rd, NULL);
+    close(g_pipe[0]);
+    TVL_ContextDeinit(&g_ctx);
+    TVL_HAL_Set(NULL);
+
+    unsigned sent = g_frames_per_thread * threads;
+    printf("%-10s %7u %12.0f %12.3f %8u %8u\n", name, threads, (double)sent * 1e9 / (double)dt,
+           (double)atomic_load(&g_writes) / (double)sent, g_rx_frames, g_rx_errors);
+}
+
+int main(void)
+{
+    printf("%-10s %7s %12s %12s %8s %8s\n", "mode", "threads", "frames/s", "writes/frm", "rx ok", "broken");
+    static const unsigned counts[] = { 1u, 2u, 4u, 8u };
+    for (size_t i = 0; i < sizeof(counts) / sizeof(counts[0]); ++i) {
+        run("app lock", false, counts[i]);
+        run("combining", true, counts[i]);
+    }
+    return 0;
+}
+
+#else
+
+int main(void)
+{
+    printf("bench_tx_combine: pthread benchmark, Linux only - skipped\n");
+    return 0;
+}
+
+#endif
@@ -48,6 +48,158 @@ extern "C" {
  */
 #ifndef TLV_DEBUG_ENABLE
 #define TLV_DEBUG_ENABLE 1  /* 1: enable protocol debug prints; 0: disable */
+#endif
+
+/*
+ * CRC16 engine footprint (see S_CRC16.h).
+ * - TVLCOM_CRC16_SMALL_TABLE=1: nibble table only (32 bytes flash), for flash-limited MCUs.
+ * - TVLCOM_CRC16_SLICING=0: drop slice-by-4/8 tables (4 KiB RAM when used).
+ * - TVLCOM_CRC16_CLMUL=0: never build the x86 carry-less multiply path.
+ */
+#ifndef TVLCOM_CRC16_SMALL_TABLE
+#define TVLCOM_CRC16_SMALL_TABLE 0
+#endif
+#ifndef TVLCOM_CRC16_SLICING
+#define TVLCOM_CRC16_SLICING (!TVLCOM_CRC16_SMALL_TABLE)
+#endif
+#ifndef TVLCOM_CRC16_CLMUL
+#define TVLCOM_CRC16_CLMUL (!TVLCOM_CRC16_SMALL_TABLE)
+#endif
+
+/*
+ * Parser backtracking resync support (TLV_SetBacktracking).
+ * Costs TLV_MAX_FRAME_SIZE bytes of RAM per parser; set to 0 to compile it out.
+ */
+#ifndef TVLCOM_PARSER_BACKTRACK
+#define TVLCOM_PARSER_BACKTRACK 1
+#endif
+
+/*
+ * Largest data segment accepted/emitted in extended frames (DataLen escape 0xFF).
+ * Parsers only accept what fits in their data buffer (TLV_SetDataBuffer).
+ */
+#ifndef TVLCOM_EXT_MAX_DATA_LENGTH
+#define TVLCOM_EXT_MAX_DATA_LENGTH 4096
+#endif
+
+/*
+ * Fragment reassembly (S_FRAGMENT.h). RAM cost is roughly
+ * TVLCOM_FRAG_POOL_SIZE * TVLCOM_FRAG_MAX_MESSAGE bytes.
+ * - TVLCOM_FRAG_POOL_SIZE: messages reassembled concurrently (all interfaces).
+ * - TVLCOM_FRAG_MAX_MESSAGE: largest message accepted by the receiver.
+ * - TVLCOM_FRAG_MAX_FRAGMENTS: largest fragment count accepted by the receiver.
+ * - TVLCOM_FRAG_TIMEOUT_MS: a partial message idle this long is dropped (needs HAL tick_ms).
+ */
+#ifndef TVLCOM_FRAG_POOL_SIZE
+#define TVLCOM_FRAG_POOL_SIZE 2
+#endif
+#ifndef TVLCOM_FRAG_MAX_MESSAGE
+#define TVLCOM_FRAG_MAX_MESSAGE 2048
+#endif
+#ifndef TVLCOM_FRAG_MAX_FRAGMENTS
+#define TVLCOM_FRAG_MAX_FRAGMENTS 32
+#endif
+#ifndef TVLCOM_FRAG_TIMEOUT_MS
+#define TVLCOM_FRAG_TIMEOUT_MS 1000
+#endif
+
+/*
+ * Receiver duplicate suppression (S_RECEIVE_PROTOCOL.h). A retransmitted frame
+ * (same FrameID and CRC) that was ACKed is ACKed again instead of re-running
+ * handlers; NACKed frames are not cached, their retransmission is dispatched again.
+ * - TVLCOM_DUP_CACHE_SIZE: entries per interface, power of two (0 disables the cache).
+ * - TVLCOM_DUP_CACHE_TIMEOUT_MS: entries older than this never match (needs HAL tick_ms).
+ */
+#ifndef TVLCOM_DUP_CACHE_SIZE
+#define TVLCOM_DUP_CACHE_SIZE 8
+#endif
+#ifndef TVLCOM_DUP_CACHE_TIMEOUT_MS
+#define TVLCOM_DUP_CACHE_TIMEOUT_MS 2000
+#endif
+
+/*
+ * Receive dispatch tables (S_RECEIVE_PROTOCOL.c), indexed by the 8-bit TLV type / command id.
+ * - TVLCOM_DISPATCH_COMPACT=0: flat 256-entry tables (~3 KiB RAM on 32-bit targets).
+ * - TVLCOM_DISPATCH_COMPACT=1: two-level tables; one 16-entry page per high nibble in use,
+ *   at most TVLCOM_DISPATCH_PAGES pages each for types and commands. Registrations that
+ *   need a page beyond that are ignored.
+ */
+#ifndef TVLCOM_DISPATCH_COMPACT
+#define TVLCOM_DISPATCH_COMPACT 0
+#endif
+#ifndef TVLCOM_DISPATCH_PAGES
+#define TVLCOM_DISPATCH_PAGES 8
+#endif
+
+/*
+ * Lock-free handler lookups (S_RECEIVE_PROTOCOL.c): the registry is kept as two
+ * copy-on-write snapshots, so RX dispatch never takes the HAL mutex. Doubles the
+ * dispatch table RAM. Needs C11 <stdatomic.h>; set to 0 to use the mutex instead.
+ */
+#ifndef TVLCOM_REGISTRY_LOCKFREE
+#if defined(__STDC_NO_ATOMICS__)
+#define TVLCOM_REGISTRY_LOCKFREE 0
+#else
+#define TVLCOM_REGISTRY_LOCKFREE 1
+#endif
+#endif
+
+/*
+ * Alignment of tvl_context_t (S_CONTEXT.h) and of its transport half, so contexts
+ * driven by different threads don't share cache lines. 64 fits x86-64 and most
+ * ARMv8; use 128 on Apple M-series, 32 (or 4) on Cortex-M to save RAM.
+ */
+#ifndef TVLCOM_CACHE_LINE
+#define TVLCOM_CACHE_LINE 64
+#endif
+
+/*
+ * Worker-pool dispatch (S_DISPATCH.h): validated frames are copied into a bounded
+ * queue per worker and handlers run on the worker instead of the parsing thread.
+ * - TVLCOM_DISPATCH_MAX_WORKERS: workers per tvl_dispatch_t.
+ * - TVLCOM_DISPATCH_QUEUE_DEPTH: frames queued per worker; a frame arriving at a full
+ *   queue is NACKed (best-effort and ACK-only frames are dropped).
+ * - TVLCOM_DISPATCH_SLOT_DATA: data bytes per queued frame; larger (extended) frames
+ *   are refused with TLV_STATUS_TOO_LARGE (not retried), raise it to accept them.
+ */
+#ifndef TVLCOM_DISPATCH_MAX_WORKERS
+#define TVLCOM_DISPATCH_MAX_WORKERS 4
+#endif
+#ifndef TVLCOM_DISPATCH_QUEUE_DEPTH
+#define TVLCOM_DISPATCH_QUEUE_DEPTH 16
+#endif
+#ifndef TVLCOM_DISPATCH_SLOT_DATA
+#define TVLCOM_DISPATCH_SLOT_DATA 240
+#endif
+
+/*
+ * RX byte ring (S_RX_RING.h): wait-free SPSC ring between the byte producer (ISR,
+ * reader thread) and the parser. Uses C11 <stdatomic.h>; without it the indices are
+ * volatile + compiler barriers, valid only on single-core MCUs (ISR producer).
+ */
+#ifndef TVLCOM_RX_RING_ATOMIC
+#if defined(__STDC_NO_ATOMICS__)
+#define TVLCOM_RX_RING_ATOMIC 0
+#else
+#define TVLCOM_RX_RING_ATOMIC 1
+#endif
+#endif
+
+/*
+ * Asynchronous TX queue (S_TX_QUEUE.h): frames are built in a fixed pool of
+ * TVLCOM_TX_POOL_FRAMES buffers (power of two, TVLCOM_TX_FRAME_SIZE bytes each) and
+ * sent by a drain step (TX thread or DMA completion). Needs C11 atomics with
+ * compare-and-swap; with TVLCOM_TX_QUEUE_ATOMIC=0 queues can't be initialised.
+ */
+#ifndef TVLCOM_TX_POOL_FRAMES
+#define TVLCOM_TX_POOL_FRAMES 8
+#endif
+#ifndef TVLCOM_TX_QUEUE_ATOMIC
+#if defined(__STDC_NO_ATOMICS__)
+#define TVLCOM_TX_QUEUE_ATOMIC 0
+#else
+#define TVLCOM_TX_QUEUE_ATOMIC 1
+#endif
 #endif
 
     /* Info IDs */
@@ -17,6 +17,10 @@ static const tvl_hal_vtable_t g_default_hal = {
     .mutex_destroy = NULL,
     .mutex_lock = NULL,
     .mutex_unlock = NULL,
+    .event_create = NULL,
+    .event_destroy = NULL,
+    .event_signal = NULL,
+    .event_wait = NULL,
     .log = NULL,
 };
 
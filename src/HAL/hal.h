@@ -35,6 +35,13 @@ typedef void (*tvl_hal_log_fn_t)(const char *fmt, ...);
  */
 typedef void* tvl_hal_mutex_t;
 
+/**
+ * @brief Auto-reset event handle as an opaque pointer (a binary semaphore is enough).
+ *
+ * Used to wake idle dispatch workers (S_DISPATCH.h); without it they poll with sleep_ms.
+ */
+typedef void* tvl_hal_event_t;
+
 /** HAL vtable (all fields optional; NULL means "not supported"). */
 typedef struct tvl_hal_vtable {
     /** @brief Millisecond tick (monotonic). */
@@ -51,6 +58,14 @@ typedef struct tvl_hal_vtable {
     void (*mutex_lock)(tvl_hal_mutex_t m);
     void (*mutex_unlock)(tvl_hal_mutex_t m);
 
+    /** @brief Create/destroy an auto-reset event. */
+    tvl_hal_event_t (*event_create)(void);
+    void (*event_destroy)(tvl_hal_event_t e);
+
+    /** @brief Signal (safe from any thread) / wait up to timeout_ms; wait returns 0 if signalled, <0 on timeout. */
+    void (*event_signal)(tvl_hal_event_t e);
+    tvl_hal_status_t (*event_wait)(tvl_hal_event_t e, uint32_t timeout_ms);
+
     /** @brief Optional logger (printf-like). */
     tvl_hal_log_fn_t log;
 } tvl_hal_vtable_t;
@@ -31,3 +31,26 @@
 #  error "Select exactly one platform: TVLCOM_PLATFORM_STM32 or TVLCOM_PLATFORM_WINDOWS"
 #endif
 
+
+/*
+ * Thread-local storage class for per-thread protocol state (TVL_ContextCurrent).
+ * Bare-metal STM32 builds have one thread of control, so a plain static is used;
+ * RTOS builds with TLS support may define TVLCOM_THREAD_LOCAL themselves.
+ */
+#ifndef TVLCOM_THREAD_LOCAL
+#  if TVLCOM_PLATFORM_STM32
+#    define TVLCOM_THREAD_LOCAL
+#    ifndef TVLCOM_HAVE_THREAD_LOCAL
+#      define TVLCOM_HAVE_THREAD_LOCAL 0
+#    endif
+#  elif defined(_MSC_VER)
+#    define TVLCOM_THREAD_LOCAL __declspec(thread)
+#  else
+#    define TVLCOM_THREAD_LOCAL _Thread_local
+#  endif
+#endif
+
+/* 1 when TVLCOM_THREAD_LOCAL is really per thread (the transport's re-entry check needs it) */
+#ifndef TVLCOM_HAVE_THREAD_LOCAL
+#  define TVLCOM_HAVE_THREAD_LOCAL 1
+#endif
@@ -17,8 +17,10 @@
 /*
  * Example mapping (Cube HAL):
  *  - tick_ms -> HAL_GetTick
- *  - sleep_ms -> HAL_Delay
+ *  - sleep_ms -> HAL_Delay, or osDelay under an RTOS (must yield: a handler
+ *    registration waits in it for a preempted lower-priority reader)
  *  - mutex_* -> __disable_irq/__enable_irq or an RTOS mutex
+ *  - event_* -> RTOS binary semaphore (osSemaphoreRelease/osSemaphoreAcquire)
  */
 
 static uint32_t stm32_tick_ms(void)
@@ -40,6 +42,10 @@ static const tvl_hal_vtable_t g_stm32_hal = {
     .mutex_destroy = NULL,
     .mutex_lock = NULL,
     .mutex_unlock = NULL,
+    .event_create = NULL,
+    .event_destroy = NULL,
+    .event_signal = NULL,
+    .event_wait = NULL,
     .log = NULL,
 };
 
@@ -60,6 +60,27 @@ static void win_mutex_unlock(tvl_hal_mutex_t m)
     LeaveCriticalSection(&((hal_win_mutex_t *)m)->cs);
 }
 
+static tvl_hal_event_t win_event_create(void)
+{
+    return (tvl_hal_event_t)CreateEventA(NULL, FALSE, FALSE, NULL); /* auto-reset */
+}
+
+static void win_event_destroy(tvl_hal_event_t e)
+{
+    if (e) CloseHandle((HANDLE)e);
+}
+
+static void win_event_signal(tvl_hal_event_t e)
+{
+    if (e) SetEvent((HANDLE)e);
+}
+
+static tvl_hal_status_t win_event_wait(tvl_hal_event_t e, uint32_t timeout_ms)
+{
+    if (!e) return -1;
+    return WaitForSingleObject((HANDLE)e, (DWORD)timeout_ms) == WAIT_OBJECT_0 ? 0 : -1;
+}
+
 static const tvl_hal_vtable_t g_windows_hal = {
     .tick_ms = win_tick_ms,
     .sleep_ms = win_sleep_ms,
@@ -67,6 +88,10 @@ static const tvl_hal_vtable_t g_windows_hal = {
     .mutex_destroy = win_mutex_destroy,
     .mutex_lock = win_mutex_lock,
     .mutex_unlock = win_mutex_unlock,
+    .event_create = win_event_create,
+    .event_destroy = win_event_destroy,
+    .event_signal = win_event_signal,
+    .event_wait = win_event_wait,
     .log = NULL,
 };
 
@@ -9,7 +9,7 @@
   *
   * Timeout behavior:
   * - Windows: uses COMMTIMEOUTS; serial_read() returns 0 on timeout.
-  * - POSIX: uses select(); returns 0 on timeout.
+  * - POSIX: uses poll(); returns 0 on timeout.
   *
   ******************************************************************************
   */
@@ -24,6 +24,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdbool.h>
 
 #ifdef _WIN32
 #ifndef WIN32_LEAN_AND_MEAN
@@ -63,8 +64,14 @@
 #include <fcntl.h>
 #include <errno.h>
 #include <termios.h>
-#include <sys/select.h>
+#include <poll.h>
 #include <sys/types.h>
+#include <sys/uio.h>
+#include <sys/ioctl.h>
+#include "SERIAL_TERMIOS2.h"
+#if defined(__linux__)
+#include <linux/serial.h>   /* struct serial_struct, ASYNC_LOW_LATENCY */
+#endif
 #endif
 
 struct serial_t {
@@ -73,6 +80,7 @@ struct serial_t {
 #else
   int fd;
 #endif
+  bool low_latency;     /* serial_set_low_latency() */
 };
 
 /* USER CODE END Includes */
@@ -80,6 +88,7 @@ struct serial_t {
 /* Private typedef -----------------------------------------------------------*/
 /* USER CODE BEGIN PTD */
 
+
 /* USER CODE END PTD */
 
 /* Private define ------------------------------------------------------------*/
@@ -105,6 +114,60 @@ struct serial_t {
 /* Private user code ---------------------------------------------------------*/
 /* USER CODE BEGIN 0 */
 
+#ifndef _WIN32
+/* Bxxx constant for a standard rate, or 0 if termios has none */
+static speed_t serial_std_speed(unsigned int baud)
+{
+    static const struct { unsigned int baud; speed_t speed; } table[] = {
+        { 1200, B1200 }, { 2400, B2400 }, { 4800, B4800 }, { 9600, B9600 },
+        { 19200, B19200 }, { 38400, B38400 }, { 57600, B57600 }, { 115200, B115200 },
+#ifdef B230400
+        { 230400, B230400 },
+#endif
+#ifdef B460800
+        { 460800, B460800 },
+#endif
+#ifdef B500000
+        { 500000, B500000 },
+#endif
+#ifdef B576000
+        { 576000, B576000 },
+#endif
+#ifdef B921600
+        { 921600, B921600 },
+#endif
+#ifdef B1000000
+        { 1000000, B1000000 },
+#endif
+#ifdef B1152000
+        { 1152000, B1152000 },
+#endif
+#ifdef B1500000
+        { 1500000, B1500000 },
+#endif
+#ifdef B2000000
+        { 2000000, B2000000 },
+#endif
+#ifdef B2500000
+        { 2500000, B2500000 },
+#endif
+#ifdef B3000000
+        { 3000000, B3000000 },
+#endif
+#ifdef B3500000
+        { 3500000, B3500000 },
+#endif
+#ifdef B4000000
+        { 4000000, B4000000 },
+#endif
+    };
+    for (size_t i = 0; i < sizeof(table) / sizeof(table[0]); ++i) {
+        if (table[i].baud == baud) return table[i].speed;
+    }
+    return 0;
+}
+#endif
+
 /**
  * @brief Open and configure a serial port.
  */
@@ -174,20 +237,15 @@ serial_t *serial_open(const char *portname, unsigned int baud)
 
     cfmakeraw(&tio);
 
-    speed_t speed = B115200;
-    switch (baud) {
-        case 9600: speed = B9600; break;
-        case 19200: speed = B19200; break;
-        case 38400: speed = B38400; break;
-        case 57600: speed = B57600; break;
-        case 115200: speed = B115200; break;
-#ifdef B230400
-        case 230400: speed = B230400; break;
-#endif
-        default: speed = B115200; break;
+    /* Non-standard rates start from B38400 and are switched to BOTHER after tcsetattr() (SERIAL_TERMIOS2.c) */
+    speed_t speed = serial_std_speed(baud);
+    bool custom = speed == 0;
+    if (custom) speed = B38400;
+    if (cfsetispeed(&tio, speed) != 0 || cfsetospeed(&tio, speed) != 0) {
+        close(fd);
+        free(s);
+        return NULL;
     }
-    cfsetispeed(&tio, speed);
-    cfsetospeed(&tio, speed);
 
     tio.c_cflag &= ~PARENB;
     tio.c_cflag &= ~CSTOPB;
@@ -198,9 +256,11 @@ serial_t *serial_open(const char *portname, unsigned int baud)
     tio.c_cc[VTIME] = 1; /* 0.1s */
 
     tcflush(fd, TCIFLUSH);
-    if (tcsetattr(fd, TCSANOW, &tio) != 0) {
+    if (tcsetattr(fd, TCSANOW, &tio) != 0 || (custom && serial_termios2_set_speed(fd, baud) != 0)) {
+        int err = errno; /* EINVAL: rate not supported by the driver */
         close(fd);
         free(s);
+        errno = err;
         return NULL;
     }
 
@@ -230,6 +290,54 @@ ssize_t serial_write(serial_t *s, const void *buf, size_t len)
 #endif
 }
 
+/**
+ * @brief Write a list of buffers to serial (gather write).
+ */
+ssize_t serial_writev(serial_t *s, const serial_iovec_t *iov, int iovcnt)
+{
+    if (!s || !iov || iovcnt < 0 || iovcnt > SERIAL_WRITEV_MAX_IOV) return -1;
+#ifdef _WIN32
+    ssize_t total = 0;
+    for (int i = 0; i < iovcnt; ++i) {
+        DWORD written = 0;
+        if (iov[i].len == 0) continue;
+        if (!WriteFile(s->h, iov[i].base, (DWORD)iov[i].len, &written, NULL)) return -1;
+        total += (ssize_t)written;
+        if (written != (DWORD)iov[i].len) break; /* write timeout */
+    }
+    return total;
+#else
+    struct iovec vec[SERIAL_WRITEV_MAX_IOV];
+    for (int i = 0; i < iovcnt; ++i) {
+        vec[i].iov_base = (void *)iov[i].base;
+        vec[i].iov_len = iov[i].len;
+    }
+
+    /* A frame must not be cut short: resume after partial writes */
+    ssize_t total = 0;
+    struct iovec *v = vec;
+    int left = iovcnt;
+    while (left > 0) {
+        ssize_t n = writev(s->fd, v, left);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        total += n;
+        while (left > 0 && (size_t)n >= v->iov_len) {
+            n -= (ssize_t)v->iov_len;
+            v++;
+            left--;
+        }
+        if (left > 0) {
+            v->iov_base = (uint8_t *)v->iov_base + n;
+            v->iov_len -= (size_t)n;
+        }
+    }
+    return total;
+#endif
+}
+
 /**
  * @brief Read from serial with a timeout.
  */
@@ -243,6 +351,13 @@ ssize_t serial_read(serial_t *s, void *buf, size_t len, unsigned int timeout_ms)
     to.ReadIntervalTimeout = timeout_ms ? timeout_ms : 50;
     to.ReadTotalTimeoutMultiplier = 0;
     to.ReadTotalTimeoutConstant = timeout_ms;
+
+    if (s->low_latency) {
+        /* MAXDWORD/MAXDWORD/constant: return as soon as any byte is there, else after the constant */
+        to.ReadIntervalTimeout = MAXDWORD;
+        to.ReadTotalTimeoutMultiplier = MAXDWORD;
+        to.ReadTotalTimeoutConstant = timeout_ms ? timeout_ms : MAXDWORD - 1u;
+    }
     SetCommTimeouts(s->h, &to);
 
     DWORD readBytes = 0;
@@ -251,22 +366,79 @@ ssize_t serial_read(serial_t *s, void *buf, size_t len, unsigned int timeout_ms)
     if (!ok) return -1;
     return (ssize_t)readBytes;
 #else
-    fd_set rfds;
-    struct timeval tv;
-    FD_ZERO(&rfds);
-    FD_SET(s->fd, &rfds);
-
-    tv.tv_sec = timeout_ms / 1000;
-    tv.tv_usec = (timeout_ms % 1000) * 1000;
-
-    int rv = select(s->fd + 1, &rfds, NULL, NULL, timeout_ms ? &tv : NULL);
-    if (rv < 0) return -1;
+    struct pollfd pfd = { s->fd, POLLIN, 0 };
+    int rv = poll(&pfd, 1, timeout_ms ? (int)timeout_ms : -1);
+    if (rv < 0) return errno == EINTR ? 0 : -1;
     if (rv == 0) return 0;
     ssize_t n = read(s->fd, buf, len);
     return n;
 #endif
 }
 
+#if !defined(_WIN32) && defined(__linux__)
+/* FTDI: the USB latency timer (default 16 ms) lives in sysfs; needs write permission */
+static void serial_set_ftdi_latency_timer(int fd, bool low)
+{
+    const char *dev = ttyname(fd);
+    const char *base = dev ? strrchr(dev, '/') : NULL;
+    if (!base) return;
+    char path[128];
+    snprintf(path, sizeof(path), "/sys/bus/usb-serial/devices/%s/latency_timer", base + 1);
+    FILE *f = fopen(path, "w");
+    if (!f) return; /* not FTDI, or no permission */
+    fprintf(f, "%d", low ? 1 : 16);
+    fclose(f);
+}
+#endif
+
+/**
+ * @brief Switch the port between the default and the latency-optimised read mode.
+ */
+bool serial_set_low_latency(serial_t *s, bool enable)
+{
+    if (!s) return false;
+#ifdef _WIN32
+    s->low_latency = enable;
+    return true;
+#else
+    struct termios tio;
+    if (tcgetattr(s->fd, &tio) != 0) return false;
+    /* VMIN=1/VTIME=0: read() returns once a byte is there, no inter-byte timer */
+    tio.c_cc[VMIN] = enable ? 1 : 0;
+    tio.c_cc[VTIME] = enable ? 0 : 1;
+    if (tcsetattr(s->fd, TCSANOW, &tio) != 0) return false;
+
+#if defined(__linux__)
+    /* Best-effort driver tuning: ptys and some CDC-ACM drivers refuse it */
+    struct serial_struct ss;
+    if (ioctl(s->fd, TIOCGSERIAL, &ss) == 0) {
+        if (enable) {
+            ss.flags |= ASYNC_LOW_LATENCY;
+        } else {
+            ss.flags &= ~ASYNC_LOW_LATENCY;
+        }
+        (void)ioctl(s->fd, TIOCSSERIAL, &ss);
+    }
+    serial_set_ftdi_latency_timer(s->fd, enable);
+#endif
+    s->low_latency = enable;
+    return true;
+#endif
+}
+
+/**
+ * @brief Underlying file descriptor (POSIX only).
+ */
+int serial_fd(const serial_t *s)
+{
+#ifdef _WIN32
+    (void)s;
+    return -1;
+#else
+    return s ? s->fd : -1;
+#endif
+}
+
 /**
  * @brief Close serial and free resources.
  */
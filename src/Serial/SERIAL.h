@@ -12,6 +12,7 @@
   *   - serial_open/serial_close
   *   - serial_read with timeout
   *   - serial_write
+  *   - serial_set_low_latency
   *
   * It is used by the PC demo (src/main.c). On MCU targets you typically won't
   * use this module; instead, register a sender to Transport layer.
@@ -34,6 +35,7 @@ extern "C" {
 #include "stdint.h"
 /* USER CODE BEGIN Includes */
 #include <stddef.h>
+#include <stdbool.h>
 
 /* Provide ssize_t without pulling in windows.h in headers */
 #ifndef _SSIZE_T_DEFINED
@@ -46,11 +48,19 @@ typedef ptrdiff_t ssize_t;
 /* Exported types ------------------------------------------------------------*/
 /* USER CODE BEGIN ET */
 typedef struct serial_t serial_t;
+
+/* One slice for serial_writev() (mirrors POSIX struct iovec) */
+typedef struct {
+    const void *base;
+    size_t len;
+} serial_iovec_t;
 /* USER CODE END ET */
 
 /* Exported constants --------------------------------------------------------*/
 /* USER CODE BEGIN EC */
 
+#define SERIAL_WRITEV_MAX_IOV 64
+
 /* USER CODE END EC */
 
 /* Exported macro ------------------------------------------------------------*/
@@ -72,9 +82,16 @@ typedef struct serial_t serial_t;
  * - "/dev/ttyS0"
  * - "/dev/ttyUSB0"
  *
+ * Any baud rate is accepted; there is no silent fallback to another rate.
+ * - POSIX: standard Bxxx rates (up to 4000000 where termios defines them);
+ *   on Linux any other rate, e.g. 1234567, is programmed through
+ *   termios2/BOTHER and must land within 2% of the request.
+ * - Windows: passed to the driver via DCB.BaudRate.
+ *
  * @param portname Port name string.
- * @param baud     Baudrate, e.g. 115200.
- * @return serial_t* on success, NULL on failure.
+ * @param baud     Baudrate, e.g. 115200, 921600, 3000000.
+ * @return serial_t* on success, NULL on failure (POSIX: errno EINVAL if the
+ *         rate is not supported by the platform or driver).
  */
 serial_t *serial_open(const char *portname, unsigned int baud);
 
@@ -87,6 +104,19 @@ serial_t *serial_open(const char *portname, unsigned int baud);
  */
 ssize_t serial_write(serial_t *s, const void *buf, size_t len);
 
+/**
+ * @brief Write several buffers to the serial port as one contiguous stream.
+ *
+ * POSIX uses writev() (one syscall, no staging copy) and retries partial writes.
+ * Windows issues one WriteFile() per slice.
+ *
+ * @param s      Serial handle.
+ * @param iov    Slices, in order.
+ * @param iovcnt Number of slices (at most SERIAL_WRITEV_MAX_IOV).
+ * @return Total bytes written, or -1 on error.
+ */
+ssize_t serial_writev(serial_t *s, const serial_iovec_t *iov, int iovcnt);
+
 /**
  * @brief Read bytes from the serial port.
  * @param s          Serial handle.
@@ -97,6 +127,30 @@ ssize_t serial_write(serial_t *s, const void *buf, size_t len);
  */
 ssize_t serial_read(serial_t *s, void *buf, size_t len, unsigned int timeout_ms);
 
+/**
+ * @brief Latency-optimised read mode (off after serial_open).
+ *
+ * Enabled:
+ * - POSIX: VMIN=1/VTIME=0, so a read returns as soon as bytes arrive
+ *   instead of waiting out the 0.1 s inter-byte timer; on Linux also
+ *   ASYNC_LOW_LATENCY (TIOCSSERIAL) and, for FTDI adapters, a 1 ms USB
+ *   latency timer via sysfs. The driver tuning is best-effort (ptys and
+ *   some CDC-ACM drivers refuse it, sysfs may need root).
+ * - Windows: serial_read() returns on the first received byte.
+ *
+ * Pair it with serial_reader (SERIAL_READER.h) and don't sleep between reads.
+ *
+ * @return false if the terminal settings could not be changed.
+ */
+bool serial_set_low_latency(serial_t *s, bool enable);
+
+/**
+ * @brief POSIX file descriptor of the port, for poll()/epoll (see SERIAL_LOOP.h).
+ * @param s Serial handle.
+ * @return The descriptor, or -1 on Windows / NULL handle.
+ */
+int serial_fd(const serial_t *s);
+
 /**
  * @brief Close a serial port and free internal resources.
  * @param s Serial handle.
@@ -0,0 +1,575 @@
+/**
+  ******************************************************************************
+  * @file           : SERIAL_LOOP.c
+  * @brief          : Linux epoll event loop driving many serial links.
+  * @author         : UF4OVER
+  * @date           : 2026-02-04
+  ******************************************************************************
+  * @attention
+  *
+  * See SERIAL_LOOP.h. Ports stay in blocking mode with VMIN=0/VTIME=1 as set
+  * by serial_open(): after epoll reports them readable, read() returns the
+  * pending bytes at once, and serial_write() keeps its blocking semantics.
+  * epoll is level-triggered, so one read() per event is enough; anything
+  * left over is reported again by the next epoll_wait().
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE /* clock_gettime/CLOCK_MONOTONIC under -std=c11 */
+#endif
+#include "SERIAL_LOOP.h"
+/* USER CODE BEGIN Includes */
+
+#if defined(__linux__)
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+#include "S_RECEIVE_PROTOCOL.h"
+#include "S_TRANSPORT_PROTOCOL.h"
+#endif
+
+/* USER CODE END Includes */
+
+#if defined(__linux__)
+
+/* Private typedef -----------------------------------------------------------*/
+/* USER CODE BEGIN PTD */
+
+struct serial_loop_link {
+    int fd;
+    atomic_bool registered;         /* still in the epoll set; cleared by removal on any thread */
+    serial_t *serial;               /* NULL for serial_loop_add_fd() descriptors */
+    tvl_context_t *ctx;
+    tlv_interface_t interface;
+    bool timer_owner;               /* runs the context's timers (one link per context) */
+    serial_loop_fd_cb_t cb;
+    void *user;
+    unsigned shard;
+    serial_loop_link_t *next;       /* shard list, protected by the shard lock */
+    serial_loop_link_t *dead_next;  /* removed during run_once, freed at its end */
+};
+
+typedef struct {
+    int epfd;
+    int wakefd;
+    pthread_t thread;
+    bool thread_started;
+    bool in_run;                    /* run_once() active (epoll_wait included): defer frees */
+    uint64_t run_gen;               /* run_once() passes finished; bumped with in_run cleared */
+    pthread_mutex_t lock;
+    pthread_cond_t run_done;        /* signalled when a pass ends (serial_loop_remove waits on it) */
+    serial_loop_link_t *links;
+    serial_loop_link_t *dead;
+    uint32_t link_count;
+    uint64_t next_poll_ms;
+    serial_loop_stats_t local;      /* updated by the shard thread */
+    _Atomic uint64_t pub_wakeups;   /* 'local' published for serial_loop_stats() */
+    _Atomic uint64_t pub_reads;
+    _Atomic uint64_t pub_bytes;
+} loop_shard_t;
+
+struct serial_loop {
+    unsigned shard_count;
+    unsigned next_shard;
+    atomic_bool stop;
+    pthread_mutex_t lock;           /* shard choice */
+    loop_shard_t *shards;
+};
+
+typedef struct {
+    serial_loop_t *loop;
+    unsigned shard;
+} loop_thread_arg_t;
+
+/* USER CODE END PTD */
+
+/* Private variables ---------------------------------------------------------*/
+/* USER CODE BEGIN PV */
+
+/* Loop whose run_once() is running on this thread: removals from its handlers can't wait for the pass */
+static _Thread_local serial_loop_t *s_running_loop;
+
+/* USER CODE END PV */
+
+/* Private user code ---------------------------------------------------------*/
+/* USER CODE BEGIN 0 */
+
+static uint64_t loop_now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000u + (uint64_t)ts.tv_nsec / 1000000u;
+}
+
+/* transport_send_ex_func_t: replies/retransmissions of a link go out on its port */
+static int loop_link_send(void *user, const uint8_t *data, uint16_t len)
+{
+    ssize_t n = serial_write((serial_t *)user, data, len);
+    return n < 0 ? -1 : (int)n;
+}
+
+/* Caller holds sh->lock */
+static serial_loop_link_t *loop_find_ctx(loop_shard_t *sh, const tvl_context_t *ctx, const serial_loop_link_t *skip)
+{
+    for (serial_loop_link_t *k = sh->links; k; k = k->next) {
+        if (k != skip && k->ctx == ctx) return k;
+    }
+    return NULL;
+}
+
+/* Shard already serving ctx, else the next one round-robin */
+static unsigned loop_pick_shard(serial_loop_t *loop, const tvl_context_t *ctx)
+{
+    if (ctx) {
+        for (unsigned i = 0; i < loop->shard_count; ++i) {
+            loop_shard_t *sh = &loop->shards[i];
+            pthread_mutex_lock(&sh->lock);
+            bool found = loop_find_ctx(sh, ctx, NULL) != NULL;
+            pthread_mutex_unlock(&sh->lock);
+            if (found) return i;
+        }
+    }
+    pthread_mutex_lock(&loop->lock);
+    unsigned i = loop->next_shard++ % loop->shard_count;
+    pthread_mutex_unlock(&loop->lock);
+    return i;
+}
+
+static serial_loop_link_t *loop_add_link(serial_loop_t *loop, serial_loop_link_t *link)
+{
+    link->shard = loop_pick_shard(loop, link->ctx);
+    loop_shard_t *sh = &loop->shards[link->shard];
+
+    pthread_mutex_lock(&sh->lock);
+    link->timer_owner = link->ctx && !loop_find_ctx(sh, link->ctx, NULL);
+    link->next = sh->links;
+    sh->links = link;
+    sh->link_count++;
+    pthread_mutex_unlock(&sh->lock);
+
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.ptr = link;
+    atomic_store(&link->registered, true);
+    if (epoll_ctl(sh->epfd, EPOLL_CTL_ADD, link->fd, &ev) != 0) {
+        atomic_store(&link->registered, false);
+        serial_loop_remove(loop, link);
+        return NULL;
+    }
+    return link;
+}
+
+/* Drop a descriptor from the epoll set (hang-up, error or removal) */
+static void loop_unregister(loop_shard_t *sh, serial_loop_link_t *link)
+{
+    if (atomic_exchange(&link->registered, false)) {
+        (void)epoll_ctl(sh->epfd, EPOLL_CTL_DEL, link->fd, NULL);
+    }
+}
+
+static void loop_handle_event(loop_shard_t *sh, serial_loop_link_t *link, uint32_t events, uint8_t *buf)
+{
+    if (!atomic_load(&link->registered)) {
+        return; /* removed since epoll_wait() reported it; its memory lives until run_once() ends */
+    }
+    if (link->cb) {
+        link->cb(link->fd, link->user);
+        return;
+    }
+    if (events & EPOLLIN) {
+        ssize_t n = read(link->fd, buf, SERIAL_LOOP_READ_CHUNK);
+        sh->local.reads++;
+        if (n > 0) {
+            sh->local.bytes += (uint64_t)n;
+            (void)TLV_ProcessBuffer(FloatReceive_GetParserCtx(link->ctx, link->interface), buf, (size_t)n);
+        }
+    }
+    if (events & (EPOLLHUP | EPOLLERR)) {
+        loop_unregister(sh, link); /* port gone: stop polling it, the owner removes the link */
+    }
+}
+
+/* Transport/ACK timers of every context on this shard */
+/*
+ * Called inside run_once(): links removed meanwhile (on any thread) are only
+ * freed when it ends and keep their 'next', so 'k' stays valid while the lock
+ * is released. Removed links are skipped: their owner may be tearing the
+ * context down.
+ */
+static void loop_service_timers(loop_shard_t *sh)
+{
+    pthread_mutex_lock(&sh->lock);
+    serial_loop_link_t *k = sh->links;
+    while (k) {
+        tvl_context_t *ctx = (k->timer_owner && atomic_load(&k->registered)) ? k->ctx : NULL;
+        pthread_mutex_unlock(&sh->lock);
+        if (ctx) {
+            Transport_PollCtx(ctx);
+            FloatReceive_PollCtx(ctx);
+        }
+        pthread_mutex_lock(&sh->lock);
+        k = k->next;
+    }
+    pthread_mutex_unlock(&sh->lock);
+}
+
+static void *loop_thread(void *arg)
+{
+    loop_thread_arg_t *a = (loop_thread_arg_t *)arg;
+    serial_loop_t *loop = a->loop;
+    unsigned shard = a->shard;
+    free(a);
+
+    while (!atomic_load(&loop->stop)) {
+        if (serial_loop_run_once(loop, shard, SERIAL_LOOP_POLL_MS) < 0) {
+            break;
+        }
+    }
+    return NULL;
+}
+
+/* USER CODE END 0 */
+
+/* Exported functions --------------------------------------------------------*/
+/* USER CODE BEGIN 1 */
+
+serial_loop_t *serial_loop_create(unsigned shards)
+{
+    if (shards == 0) shards = 1;
+    serial_loop_t *loop = (serial_loop_t *)calloc(1, sizeof(*loop));
+    if (!loop) return NULL;
+    loop->shards = (loop_shard_t *)calloc(shards, sizeof(loop_shard_t));
+    if (!loop->shards) {
+        free(loop);
+        return NULL;
+    }
+    pthread_mutex_init(&loop->lock, NULL);
+    atomic_init(&loop->stop, false);
+
+    for (unsigned i = 0; i < shards; ++i) {
+        loop_shard_t *sh = &loop->shards[i];
+        pthread_mutex_init(&sh->lock, NULL);
+        pthread_cond_init(&sh->run_done, NULL);
+        sh->epfd = epoll_create1(EPOLL_CLOEXEC);
+        sh->wakefd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        loop->shard_count = i + 1;
+        if (sh->epfd < 0 || sh->wakefd < 0) {
+            serial_loop_destroy(loop);
+            return NULL;
+        }
+        struct epoll_event ev;
+        memset(&ev, 0, sizeof(ev));
+        ev.events = EPOLLIN;
+        ev.data.ptr = NULL; /* wake-up marker */
+        if (epoll_ctl(sh->epfd, EPOLL_CTL_ADD, sh->wakefd, &ev) != 0) {
+            serial_loop_destroy(loop);
+            return NULL;
+        }
+    }
+    return loop;
+}
+
+void serial_loop_destroy(serial_loop_t *loop)
+{
+    if (!loop) return;
+    serial_loop_stop(loop);
+    for (unsigned i = 0; i < loop->shard_count; ++i) {
+        loop_shard_t *sh = &loop->shards[i];
+        while (sh->links) {
+            serial_loop_remove(loop, sh->links);
+        }
+        if (sh->epfd >= 0) close(sh->epfd);
+        if (sh->wakefd >= 0) close(sh->wakefd);
+        pthread_cond_destroy(&sh->run_done);
+        pthread_mutex_destroy(&sh->lock);
+    }
+    pthread_mutex_destroy(&loop->lock);
+    free(loop->shards);
+    free(loop);
+}
+
+serial_loop_link_t *serial_loop_add(serial_loop_t *loop, serial_t *s, tvl_context_t *ctx, tlv_interface_t interface)
+{
+    if (!loop || !s || !ctx || serial_fd(s) < 0 || !FloatReceive_GetParserCtx(ctx, interface)) return NULL;
+    serial_loop_link_t *link = (serial_loop_link_t *)calloc(1, sizeof(*link));
+    if (!link) return NULL;
+    link->fd = serial_fd(s);
+    link->serial = s;
+    link->ctx = ctx;
+    link->interface = interface;
+
+    Transport_RegisterSenderExCtx(ctx, interface, loop_link_send, s);
+    return loop_add_link(loop, link);
+}
+
+serial_loop_link_t *serial_loop_add_fd(serial_loop_t *loop, int fd, serial_loop_fd_cb_t cb, void *user)
+{
+    if (!loop || fd < 0 || !cb) return NULL;
+    serial_loop_link_t *link = (serial_loop_link_t *)calloc(1, sizeof(*link));
+    if (!link) return NULL;
+    link->fd = fd;
+    link->cb = cb;
+    link->user = user;
+    return loop_add_link(loop, link);
+}
+
+void serial_loop_remove(serial_loop_t *loop, serial_loop_link_t *link)
+{
+    if (!loop || !link) return;
+    loop_shard_t *sh = &loop->shards[link->shard];
+    loop_unregister(sh, link);
+
+    pthread_mutex_lock(&sh->lock);
+    for (serial_loop_link_t **pp = &sh->links; *pp; pp = &(*pp)->next) {
+        if (*pp == link) {
+            *pp = link->next; /* link->next kept: the timer walk may be standing on 'link' */
+            sh->link_count--;
+            break;
+        }
+    }
+    if (link->timer_owner) {
+        serial_loop_link_t *heir = loop_find_ctx(sh, link->ctx, link);
+        if (heir) heir->timer_owner = true;
+    }
+    /*
+     * Called from a handler on one of this loop's threads: the pass can't be
+     * waited for, so the shard frees 'link' when it ends. Once on the dead list
+     * the shard may free it at any moment: copy what is still needed.
+     */
+    bool had_sender = link->serial != NULL;
+    tvl_context_t *ctx = link->ctx;
+    tlv_interface_t interface = link->interface;
+    bool defer = sh->in_run && s_running_loop == loop;
+    if (defer) {
+        link->dead_next = sh->dead;
+        sh->dead = link;
+    }
+    pthread_mutex_unlock(&sh->lock);
+
+    if (had_sender) {
+        Transport_RegisterSenderExCtx(ctx, interface, NULL, NULL);
+    }
+    if (defer) return;
+
+    /*
+     * Any other thread waits for the shard's current pass, which may still be
+     * handling an event of 'link' (parser, handlers, an ACK sent on its port).
+     * Afterwards nothing refers to the link, its context or its serial_t.
+     */
+    pthread_mutex_lock(&sh->lock);
+    if (sh->in_run) {
+        uint64_t gen = sh->run_gen;
+        uint64_t one = 1;
+        (void)write(sh->wakefd, &one, sizeof(one)); /* cut a blocking epoll_wait() short */
+        while (sh->in_run && sh->run_gen == gen) {
+            pthread_cond_wait(&sh->run_done, &sh->lock);
+        }
+    }
+    pthread_mutex_unlock(&sh->lock);
+    free(link);
+}
+
+int serial_loop_run_once(serial_loop_t *loop, unsigned shard, unsigned timeout_ms)
+{
+    if (!loop || shard >= loop->shard_count) return -1;
+    loop_shard_t *sh = &loop->shards[shard];
+    struct epoll_event ev[SERIAL_LOOP_MAX_EVENTS];
+    uint8_t buf[SERIAL_LOOP_READ_CHUNK];
+
+    /* Busy from here on: a link removed while epoll_wait() may still report it must not be freed yet */
+    pthread_mutex_lock(&sh->lock);
+    bool idle = sh->links == NULL;
+    sh->in_run = true;
+    pthread_mutex_unlock(&sh->lock);
+    serial_loop_t *outer = s_running_loop;
+    s_running_loop = loop;
+
+    uint64_t now = loop_now_ms();
+    if (sh->next_poll_ms == 0) sh->next_poll_ms = now + SERIAL_LOOP_POLL_MS;
+    if (idle) {
+        /* no timers to run: sleep until an fd/wake-up event */
+    } else if (sh->next_poll_ms <= now) {
+        timeout_ms = 0;
+    } else if (sh->next_poll_ms - now < timeout_ms) {
+        timeout_ms = (unsigned)(sh->next_poll_ms - now);
+    }
+
+    int n = epoll_wait(sh->epfd, ev, SERIAL_LOOP_MAX_EVENTS, (int)timeout_ms);
+    int rc = n;
+    if (n < 0) {
+        rc = (errno == EINTR) ? 0 : -1;
+        n = 0;
+    }
+
+    if (n > 0) sh->local.wakeups++;
+    for (int i = 0; i < n; ++i) {
+        if (ev[i].data.ptr == NULL) {
+            uint64_t v;
+            (void)read(sh->wakefd, &v, sizeof(v));
+            continue;
+        }
+        loop_handle_event(sh, (serial_loop_link_t *)ev[i].data.ptr, ev[i].events, buf);
+    }
+
+    now = loop_now_ms();
+    if (rc >= 0 && now >= sh->next_poll_ms) {
+        loop_service_timers(sh);
+        sh->next_poll_ms = now + SERIAL_LOOP_POLL_MS;
+    }
+
+    s_running_loop = outer;
+    pthread_mutex_lock(&sh->lock);
+    sh->in_run = false;
+    sh->run_gen++;
+    serial_loop_link_t *dead = sh->dead;
+    sh->dead = NULL;
+    pthread_cond_broadcast(&sh->run_done);
+    pthread_mutex_unlock(&sh->lock);
+    while (dead) {
+        serial_loop_link_t *next = dead->dead_next;
+        free(dead);
+        dead = next;
+    }
+
+    atomic_store_explicit(&sh->pub_wakeups, sh->local.wakeups, memory_order_relaxed);
+    atomic_store_explicit(&sh->pub_reads, sh->local.reads, memory_order_relaxed);
+    atomic_store_explicit(&sh->pub_bytes, sh->local.bytes, memory_order_relaxed);
+    return rc < 0 ? rc : n;
+}
+
+bool serial_loop_start(serial_loop_t *loop)
+{
+    if (!loop) return false;
+    atomic_store(&loop->stop, false);
+    for (unsigned i = 0; i < loop->shard_count; ++i) {
+        loop_shard_t *sh = &loop->shards[i];
+        if (sh->thread_started) continue;
+        loop_thread_arg_t *a = (loop_thread_arg_t *)malloc(sizeof(*a));
+        if (!a) {
+            serial_loop_stop(loop);
+            return false;
+        }
+        a->loop = loop;
+        a->shard = i;
+        if (pthread_create(&sh->thread, NULL, loop_thread, a) != 0) {
+            free(a);
+            serial_loop_stop(loop);
+            return false;
+        }
+        sh->thread_started = true;
+    }
+    return true;
+}
+
+void serial_loop_stop(serial_loop_t *loop)
+{
+    if (!loop) return;
+    atomic_store(&loop->stop, true);
+    for (unsigned i = 0; i < loop->shard_count; ++i) {
+        loop_shard_t *sh = &loop->shards[i];
+        if (!sh->thread_started) continue;
+        uint64_t one = 1;
+        (void)write(sh->wakefd, &one, sizeof(one));
+        pthread_join(sh->thread, NULL);
+        sh->thread_started = false;
+    }
+}
+
+unsigned serial_loop_shards(const serial_loop_t *loop)
+{
+    return loop ? loop->shard_count : 0u;
+}
+
+serial_loop_stats_t serial_loop_stats(serial_loop_t *loop, unsigned shard)
+{
+    serial_loop_stats_t st;
+    memset(&st, 0, sizeof(st));
+    if (!loop || shard >= loop->shard_count) return st;
+    loop_shard_t *sh = &loop->shards[shard];
+    st.wakeups = atomic_load_explicit(&sh->pub_wakeups, memory_order_relaxed);
+    st.reads = atomic_load_explicit(&sh->pub_reads, memory_order_relaxed);
+    st.bytes = atomic_load_explicit(&sh->pub_bytes, memory_order_relaxed);
+    pthread_mutex_lock(&sh->lock);
+    st.links = sh->link_count;
+    pthread_mutex_unlock(&sh->lock);
+    return st;
+}
+
+/* USER CODE END 1 */
+
+#else /* !__linux__ */
+
+/* USER CODE BEGIN 1 */
+
+serial_loop_t *serial_loop_create(unsigned shards)
+{
+    (void)shards;
+    return NULL;
+}
+
+void serial_loop_destroy(serial_loop_t *loop)
+{
+    (void)loop;
+}
+
+serial_loop_link_t *serial_loop_add(serial_loop_t *loop, serial_t *s, tvl_context_t *ctx, tlv_interface_t interface)
+{
+    (void)loop; (void)s; (void)ctx; (void)interface;
+    return NULL;
+}
+
+serial_loop_link_t *serial_loop_add_fd(serial_loop_t *loop, int fd, serial_loop_fd_cb_t cb, void *user)
+{
+    (void)loop; (void)fd; (void)cb; (void)user;
+    return NULL;
+}
+
+void serial_loop_remove(serial_loop_t *loop, serial_loop_link_t *link)
+{
+    (void)loop; (void)link;
+}
+
+int serial_loop_run_once(serial_loop_t *loop, unsigned shard, unsigned timeout_ms)
+{
+    (void)loop; (void)shard; (void)timeout_ms;
+    return -1;
+}
+
+bool serial_loop_start(serial_loop_t *loop)
+{
+    (void)loop;
+    return false;
+}
+
+void serial_loop_stop(serial_loop_t *loop)
+{
+    (void)loop;
+}
+
+unsigned serial_loop_shards(const serial_loop_t *loop)
+{
+    (void)loop;
+    return 0u;
+}
+
+serial_loop_stats_t serial_loop_stats(serial_loop_t *loop, unsigned shard)
+{
+    serial_loop_stats_t st = { 0, 0, 0, 0 };
+    (void)loop; (void)shard;
+    return st;
+}
+
+/* USER CODE END 1 */
+
+#endif /* __linux__ */
@@ -0,0 +1,173 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file           : SERIAL_LOOP.h
+  * @brief          : Linux epoll event loop driving many serial links.
+  * @author         : UF4OVER
+  * @date           : 2026-02-04
+  ******************************************************************************
+  * @attention
+  *
+  * Replaces one blocking rx thread per port (serial_read() + select()) with
+  * a few epoll loops. A link is a serial_t bound to one interface of a
+  * tvl_context_t (S_CONTEXT.h):
+  *   - when the port is readable, up to SERIAL_LOOP_READ_CHUNK bytes are read
+  *     in one read() and fed to the context's parser (TLV_ProcessBuffer);
+  *   - every SERIAL_LOOP_POLL_MS the loop runs Transport_PollCtx() and
+  *     FloatReceive_PollCtx() for the contexts it owns;
+  *   - replies and retransmissions go out through serial_write() on the
+  *     same port (registered with Transport_RegisterSenderExCtx()).
+  * Other descriptors (sockets, timers, ...) can be added with a callback.
+  *
+  * Sharding:
+  *   - The loop has N shards, each with its own epoll instance. Links are
+  *     spread round-robin, except that links of the same context always share
+  *     a shard, so a context's parsers, handlers and timers run on one thread.
+  *   - serial_loop_start() runs one thread per shard; alternatively call
+  *     serial_loop_run_once() from your own thread(s), one thread per shard.
+  *
+  * Thread-safety:
+  *   - serial_loop_add*() and serial_loop_remove() may be called at any
+  *     time, from any thread. A removed link is skipped from then on.
+  *   - From a thread not running this loop, serial_loop_remove() waits for
+  *     the shard's current serial_loop_run_once() pass to end (at most one
+  *     event batch plus timers). When it returns, the loop no longer touches
+  *     the link, its context or its serial_t, so the port can be closed and
+  *     the context deinitialised straight away (hot-unplug).
+  *   - Called from a handler/callback on one of the loop's own threads it
+  *     can't wait: the link is freed when that pass ends. Tear the context
+  *     down from another thread, or after stopping the loop.
+  *
+  * Linux only (epoll/eventfd). Elsewhere every function fails / returns NULL.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+/* Define to prevent recursive inclusion -------------------------------------*/
+
+#ifndef SERIAL_LOOP_H
+#define SERIAL_LOOP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "stdint.h"
+/* USER CODE BEGIN Includes */
+#include <stdbool.h>
+
+#include "SERIAL.h"
+#include "S_TLV_PROTOCOL.h"
+#include "S_CONTEXT.h"
+/* USER CODE END Includes */
+
+/* Exported types ------------------------------------------------------------*/
+/* USER CODE BEGIN ET */
+typedef struct serial_loop serial_loop_t;
+typedef struct serial_loop_link serial_loop_link_t;
+
+/* Readable-descriptor callback for serial_loop_add_fd(); runs on the shard's thread */
+typedef void (*serial_loop_fd_cb_t)(int fd, void *user);
+
+/* Counters of one shard (see serial_loop_stats) */
+typedef struct {
+    uint64_t wakeups;       /* epoll_wait() returns with at least one event */
+    uint64_t reads;         /* read() calls on serial links */
+    uint64_t bytes;         /* bytes fed to parsers */
+    uint32_t links;         /* links currently registered */
+} serial_loop_stats_t;
+/* USER CODE END ET */
+
+/* Exported constants --------------------------------------------------------*/
+/* USER CODE BEGIN EC */
+
+/* Bytes read per readiness event (one read() call) */
+#ifndef SERIAL_LOOP_READ_CHUNK
+#define SERIAL_LOOP_READ_CHUNK 4096
+#endif
+
+/* Interval of the Transport_PollCtx()/FloatReceive_PollCtx() timer service */
+#ifndef SERIAL_LOOP_POLL_MS
+#define SERIAL_LOOP_POLL_MS 10
+#endif
+
+/* Events handled per epoll_wait() */
+#ifndef SERIAL_LOOP_MAX_EVENTS
+#define SERIAL_LOOP_MAX_EVENTS 64
+#endif
+
+/* USER CODE END EC */
+
+/* Exported functions prototypes ---------------------------------------------*/
+/* USER CODE BEGIN EFP */
+
+/**
+ * @brief Create a loop.
+ * @param shards Number of epoll shards (threads); 0 is treated as 1.
+ * @return Loop handle, or NULL on failure / non-Linux.
+ */
+serial_loop_t *serial_loop_create(unsigned shards);
+
+/**
+ * @brief Stop the loop (if started), close its descriptors and free every link.
+ *
+ * Serial handles and contexts are not closed/freed; they belong to the caller.
+ */
+void serial_loop_destroy(serial_loop_t *loop);
+
+/**
+ * @brief Add a serial link: port 's' feeds ctx's parser for 'interface'.
+ *
+ * Also registers serial_write() on 's' as ctx's sender for 'interface'.
+ * Call FloatReceive_InitCtx(ctx, interface) before.
+ *
+ * @return Link handle (for serial_loop_remove), or NULL on failure.
+ */
+serial_loop_link_t *serial_loop_add(serial_loop_t *loop, serial_t *s, tvl_context_t *ctx, tlv_interface_t interface);
+
+/**
+ * @brief Add any descriptor; 'cb' runs on the shard's thread whenever it is readable.
+ */
+serial_loop_link_t *serial_loop_add_fd(serial_loop_t *loop, int fd, serial_loop_fd_cb_t cb, void *user);
+
+/**
+ * @brief Remove a link (see thread-safety note above). The sender registered by
+ *        serial_loop_add() is cleared.
+ */
+void serial_loop_remove(serial_loop_t *loop, serial_loop_link_t *link);
+
+/**
+ * @brief Wait up to timeout_ms for events on one shard and handle them, then run due timers.
+ * @return Number of events handled, or -1 on error.
+ */
+int serial_loop_run_once(serial_loop_t *loop, unsigned shard, unsigned timeout_ms);
+
+/**
+ * @brief Run every shard on its own thread until serial_loop_stop().
+ * @return false if a thread could not be created (the started ones are stopped).
+ */
+bool serial_loop_start(serial_loop_t *loop);
+
+/**
+ * @brief Wake and join the shard threads started by serial_loop_start().
+ */
+void serial_loop_stop(serial_loop_t *loop);
+
+/**
+ * @brief Number of shards.
+ */
+unsigned serial_loop_shards(const serial_loop_t *loop);
+
+/**
+ * @brief Counters of one shard (zeroed if 'shard' is out of range).
+ */
+serial_loop_stats_t serial_loop_stats(serial_loop_t *loop, unsigned shard);
+
+/* USER CODE END EFP */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //SERIAL_LOOP_H
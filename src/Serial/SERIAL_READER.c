@@ -0,0 +1,184 @@
+/**
+  ******************************************************************************
+  * @file           : SERIAL_READER.c
+  * @brief          : Low-latency receive path: one port feeding one TLV parser.
+  * @author         : UF4OVER
+  * @date           : 2026-02-07
+  ******************************************************************************
+  * @attention
+  *
+  * See SERIAL_READER.h. Buffered bytes live in [head, head + len) of the
+  * buffer; reads always go to the free space behind them. Every call parses
+  * the buffer empty before reading again (except after an until_frame early
+  * return), so a read normally gets the whole buffer.
+  *
+  * until_frame feeds the parser up to each 0x0D (possible frame tail) and
+  * checks tlv_parser_t::frames_ok in between; a 0x0D inside a payload only
+  * costs an extra check.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE /* clock_gettime/CLOCK_MONOTONIC under -std=c11 */
+#endif
+#include "SERIAL_READER.h"
+/* USER CODE BEGIN Includes */
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <poll.h>
+#endif
+
+/* USER CODE END Includes */
+
+/* Private typedef -----------------------------------------------------------*/
+/* USER CODE BEGIN PTD */
+
+struct serial_reader {
+    serial_t *port;
+    tlv_parser_t *parser;
+    uint8_t *buf;
+    size_t size;
+    size_t head;            /* first unparsed byte */
+    size_t len;             /* unparsed bytes */
+};
+
+/* USER CODE END PTD */
+
+/* Private user code ---------------------------------------------------------*/
+/* USER CODE BEGIN 0 */
+
+static uint64_t reader_now_ms(void)
+{
+#ifdef _WIN32
+    return (uint64_t)GetTickCount64();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000u + (uint64_t)ts.tv_nsec / 1000000u;
+#endif
+}
+
+/* Parse buffered bytes; with until_frame stop right after the first completed frame */
+static int reader_parse(serial_reader_t *r, bool until_frame)
+{
+    int frames = 0;
+    while (r->len) {
+        const uint8_t *p = r->buf + r->head;
+        size_t chunk = r->len;
+        if (until_frame) {
+            const uint8_t *tail = (const uint8_t *)memchr(p, TLV_FRAME_TAIL_1, chunk);
+            if (tail) chunk = (size_t)(tail - p) + 1u;
+        }
+
+        uint32_t before = r->parser->frames_ok;
+        (void)TLV_ProcessBuffer(r->parser, p, chunk);
+        frames += (int)(r->parser->frames_ok - before);
+        r->head += chunk;
+        r->len -= chunk;
+        if (until_frame && frames) break;
+    }
+    if (!r->len) r->head = 0;
+    return frames;
+}
+
+/* One wait + read into the free space; bytes read, 0 on timeout, -1 on error/hangup */
+static int reader_fill(serial_reader_t *r, unsigned timeout_ms)
+{
+    if (r->head + r->len == r->size) {
+        memmove(r->buf, r->buf + r->head, r->len);
+        r->head = 0;
+    }
+    uint8_t *dst = r->buf + r->head + r->len;
+    size_t room = r->size - r->head - r->len;
+
+#ifdef _WIN32
+    ssize_t n = serial_read(r->port, dst, room, timeout_ms);
+    if (n < 0) return -1;
+#else
+    struct pollfd pfd = { serial_fd(r->port), POLLIN, 0 };
+    int rv = poll(&pfd, 1, timeout_ms ? (int)timeout_ms : -1);
+    if (rv < 0) return errno == EINTR ? 0 : -1;
+    if (rv == 0) return 0;
+    if (!(pfd.revents & POLLIN)) return -1; /* POLLHUP/POLLERR only */
+
+    ssize_t n = read(pfd.fd, dst, room);
+    if (n < 0) return (errno == EINTR || errno == EAGAIN) ? 0 : -1;
+    if (n == 0) return -1; /* readable but empty: hangup */
+#endif
+    r->len += (size_t)n;
+    return (int)n;
+}
+
+/* USER CODE END 0 */
+
+/* Exported functions --------------------------------------------------------*/
+/* USER CODE BEGIN 1 */
+
+serial_reader_t *serial_reader_create(serial_t *s, tlv_parser_t *parser, size_t buffer_size)
+{
+    if (!s || !parser) return NULL;
+    if (buffer_size == 0) buffer_size = SERIAL_READER_BUFFER_SIZE;
+
+    serial_reader_t *r = (serial_reader_t *)calloc(1, sizeof(*r));
+    if (!r) return NULL;
+    r->buf = (uint8_t *)malloc(buffer_size);
+    if (!r->buf) {
+        free(r);
+        return NULL;
+    }
+    r->port = s;
+    r->parser = parser;
+    r->size = buffer_size;
+    return r;
+}
+
+void serial_reader_destroy(serial_reader_t *r)
+{
+    if (!r) return;
+    free(r->buf);
+    free(r);
+}
+
+int serial_reader_poll(serial_reader_t *r, unsigned timeout_ms, bool until_frame)
+{
+    if (!r) return -1;
+
+    int frames = reader_parse(r, until_frame);
+    if (frames) return frames; /* completed from bytes buffered by an earlier call */
+
+    const uint64_t deadline = reader_now_ms() + timeout_ms;
+    unsigned wait_ms = timeout_ms;
+    for (;;) {
+        int n = reader_fill(r, wait_ms);
+        if (n < 0) return -1;
+        frames = reader_parse(r, until_frame);
+        if (!until_frame || frames) return frames;
+
+        /* until_frame: partial frame so far, keep waiting for the rest */
+        if (timeout_ms) {
+            uint64_t now = reader_now_ms();
+            if (now >= deadline) return 0;
+            wait_ms = (unsigned)(deadline - now);
+        }
+    }
+}
+
+size_t serial_reader_pending(const serial_reader_t *r)
+{
+    return r ? r->len : 0u;
+}
+
+/* USER CODE END 1 */
@@ -0,0 +1,102 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file           : SERIAL_READER.h
+  * @brief          : Low-latency receive path: one port feeding one TLV parser.
+  * @author         : UF4OVER
+  * @date           : 2026-02-07
+  ******************************************************************************
+  * @attention
+  *
+  * The classic receive loop (serial_read() into a small stack buffer, then
+  * sleep when it times out) adds the VTIME inter-byte timer plus the idle
+  * sleep to every short frame. serial_reader replaces it with:
+  *   - one poll() on the port, then a single large read() of whatever is
+  *     pending into the reader's buffer (SERIAL_READER_BUFFER_SIZE);
+  *   - no sleeping: the caller simply calls serial_reader_poll() again;
+  *   - optional early return as soon as the parser completes a frame
+  *     (until_frame), with the remaining bytes kept for the next call.
+  * Enable serial_set_low_latency() on the port as well, so the kernel and
+  * the USB adapter don't hold bytes back.
+  *
+  * One reader per port, used from one thread. On Windows (no descriptor)
+  * the reader falls back to serial_read() with the same buffer.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+/* Define to prevent recursive inclusion -------------------------------------*/
+
+#ifndef SERIAL_READER_H
+#define SERIAL_READER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "stdint.h"
+/* USER CODE BEGIN Includes */
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "SERIAL.h"
+#include "S_TLV_PROTOCOL.h"
+/* USER CODE END Includes */
+
+/* Exported types ------------------------------------------------------------*/
+/* USER CODE BEGIN ET */
+typedef struct serial_reader serial_reader_t;
+/* USER CODE END ET */
+
+/* Exported constants --------------------------------------------------------*/
+/* USER CODE BEGIN EC */
+
+/* Default receive buffer: large enough that one read() drains a burst */
+#ifndef SERIAL_READER_BUFFER_SIZE
+#define SERIAL_READER_BUFFER_SIZE 65536u
+#endif
+
+/* USER CODE END EC */
+
+/* Exported functions prototypes ---------------------------------------------*/
+/* USER CODE BEGIN EFP */
+
+/**
+ * @brief Create a reader feeding 'parser' from port 's'.
+ * @param buffer_size Receive buffer in bytes; 0 selects SERIAL_READER_BUFFER_SIZE.
+ * @return Reader handle, or NULL on failure.
+ */
+serial_reader_t *serial_reader_create(serial_t *s, tlv_parser_t *parser, size_t buffer_size);
+
+/**
+ * @brief Free the reader. The port and the parser belong to the caller.
+ */
+void serial_reader_destroy(serial_reader_t *r);
+
+/**
+ * @brief Wait for data and feed it to the parser.
+ *
+ * Buffered bytes from an earlier call are parsed first. Then:
+ * - until_frame == false: waits up to timeout_ms, reads once and parses
+ *   everything that was read;
+ * - until_frame == true : keeps reading until the parser completes a frame
+ *   or timeout_ms expires, and returns right after that frame's last byte.
+ *
+ * @param timeout_ms 0 waits forever (as serial_read()).
+ * @return Frames completed (0 on timeout), or -1 on a read error / hangup.
+ */
+int serial_reader_poll(serial_reader_t *r, unsigned timeout_ms, bool until_frame);
+
+/**
+ * @brief Bytes read from the port but not yet parsed.
+ */
+size_t serial_reader_pending(const serial_reader_t *r);
+
+/* USER CODE END EFP */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //SERIAL_READER_H
@@ -0,0 +1,61 @@
+/**
+  ******************************************************************************
+  * @file           : SERIAL_TERMIOS2.c
+  * @brief          : Arbitrary baud rates on Linux (termios2 + BOTHER).
+  * @author         : UF4OVER
+  * @date           : 2026-02-12
+  ******************************************************************************
+  * @attention
+  *
+  * See SERIAL_TERMIOS2.h. Uses the kernel's own struct termios2 and BOTHER
+  * from <asm/termbits.h>, so the layout is right on every architecture
+  * (MIPS, SPARC and Alpha differ from asm-generic). Must not include
+  * <termios.h>.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "SERIAL_TERMIOS2.h"
+/* USER CODE BEGIN Includes */
+
+#include <errno.h>
+
+#if defined(__linux__)
+#include <sys/ioctl.h>      /* ioctl(), TCGETS2/TCSETS2 via <asm/ioctls.h> */
+#include <asm/termbits.h>   /* struct termios2, BOTHER, CBAUD */
+#endif
+
+/* USER CODE END Includes */
+
+/* Exported functions --------------------------------------------------------*/
+/* USER CODE BEGIN 1 */
+
+int serial_termios2_set_speed(int fd, unsigned int baud)
+{
+#if defined(__linux__) && defined(TCGETS2) && defined(BOTHER)
+    struct termios2 t2;
+    if (ioctl(fd, TCGETS2, &t2) != 0) return -1;
+    t2.c_cflag &= ~(tcflag_t)CBAUD;
+    t2.c_cflag |= BOTHER;
+    t2.c_ispeed = baud;
+    t2.c_ospeed = baud;
+    if (ioctl(fd, TCSETS2, &t2) != 0) return -1;
+
+    if (ioctl(fd, TCGETS2, &t2) != 0) return -1;
+    unsigned int got = (unsigned int)t2.c_ospeed;
+    unsigned int diff = got > baud ? got - baud : baud - got;
+    if (diff > baud / 50u) {
+        errno = EINVAL;
+        return -1;
+    }
+    return 0;
+#else
+    (void)fd;
+    (void)baud;
+    errno = EINVAL;
+    return -1;
+#endif
+}
+
+/* USER CODE END 1 */
@@ -0,0 +1,44 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file           : SERIAL_TERMIOS2.h
+  * @brief          : Arbitrary baud rates on Linux (termios2 + BOTHER), for SERIAL.c.
+  * @author         : UF4OVER
+  * @date           : 2026-02-12
+  ******************************************************************************
+  * @attention
+  *
+  * Internal to the serial module. The implementation lives in its own
+  * translation unit because the kernel's <asm/termbits.h> (struct termios2
+  * and BOTHER, whose layout and values differ per architecture) clashes with
+  * glibc's <termios.h>, which SERIAL.c needs.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+/* Define to prevent recursive inclusion -------------------------------------*/
+
+#ifndef SERIAL_TERMIOS2_H
+#define SERIAL_TERMIOS2_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Exported functions prototypes ---------------------------------------------*/
+/* USER CODE BEGIN EFP */
+
+/**
+ * @brief Switch an open tty to 'baud' through TCSETS2/BOTHER.
+ * @return 0 on success; -1 with errno set otherwise (EINVAL when termios2 is
+ *         unavailable, or the driver refuses or lands more than 2% off).
+ */
+int serial_termios2_set_speed(int fd, unsigned int baud);
+
+/* USER CODE END EFP */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SERIAL_TERMIOS2_H
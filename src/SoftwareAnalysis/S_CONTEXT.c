@@ -0,0 +1,89 @@
+/**
+ ******************************************************************************
+ * @file           : S_CONTEXT.c
+ * @brief          : Protocol context lifecycle and the default/current context.
+ * @author         : UF4OVER
+ * @date           : 2026-02-02
+ ******************************************************************************
+ * @attention
+ *
+ * See S_CONTEXT.h for what a context owns.
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "S_CONTEXT.h"
+
+/* USER CODE BEGIN Includes */
+#include <string.h>
+/* USER CODE END Includes */
+
+/* Private variables ---------------------------------------------------------*/
+/* USER CODE BEGIN PV */
+
+/* Used by the non-Ctx API; zero-initialised like a fresh TVL_ContextInit() */
+static tvl_context_t s_default_context;
+
+/* Context dispatching on this thread (NULL: none) */
+static TVLCOM_THREAD_LOCAL tvl_context_t *s_current_context = NULL;
+
+/* USER CODE END PV */
+
+/* Exported functions --------------------------------------------------------*/
+/* USER CODE BEGIN 1 */
+
+void TVL_ContextInit(tvl_context_t *ctx)
+{
+    if (!ctx) return;
+    memset(ctx, 0, sizeof(*ctx));
+#if TVLCOM_REGISTRY_LOCKFREE
+    atomic_init(&ctx->rx_registry_active, 0u);
+    atomic_init(&ctx->rx_registry_readers[0], 0u);
+    atomic_init(&ctx->rx_registry_readers[1], 0u);
+#endif
+}
+
+void TVL_ContextDeinit(tvl_context_t *ctx)
+{
+    if (!ctx) return;
+    const tvl_hal_vtable_t *hal = TVL_HAL_Get();
+    if (hal && hal->mutex_destroy) {
+        if (ctx->rx_lock) hal->mutex_destroy(ctx->rx_lock);
+        if (ctx->tx_lock) hal->mutex_destroy(ctx->tx_lock);
+        if (ctx->tx_window_lock) hal->mutex_destroy(ctx->tx_window_lock);
+        for (unsigned i = 0; i < TVL_CONTEXT_INTERFACES; i++) {
+            if (ctx->tx_write_lock[i]) hal->mutex_destroy(ctx->tx_write_lock[i]);
+        }
+    }
+    TVL_ContextInit(ctx);
+}
+
+tvl_context_t *TVL_ContextDefault(void)
+{
+    return &s_default_context;
+}
+
+tvl_context_t *TVL_ContextCurrent(void)
+{
+    return s_current_context ? s_current_context : &s_default_context;
+}
+
+tvl_context_t *TVL_ContextSwapCurrent(tvl_context_t *ctx)
+{
+    tvl_context_t *prev = s_current_context;
+    s_current_context = ctx;
+    return prev;
+}
+
+void TVL_ContextSetUser(tvl_context_t *ctx, void *user)
+{
+    if (ctx) ctx->user = user;
+}
+
+void *TVL_ContextGetUser(const tvl_context_t *ctx)
+{
+    return ctx ? ctx->user : NULL;
+}
+
+/* USER CODE END 1 */
@@ -0,0 +1,267 @@
+/* USER CODE BEGIN Header */
+/**
+ ******************************************************************************
+ * @file           : S_CONTEXT.h
+ * @brief          : Protocol context: all per-link receive/transport state.
+ * @author         : UF4OVER
+ * @date           : 2026-02-02
+ ******************************************************************************
+ * @attention
+ *
+ * A tvl_context_t owns everything one device link needs: the UART/USB
+ * parsers, the handler registry, ACK batching and duplicate cache, the
+ * senders, the frame id counter and the reliable-send window.
+ *
+ * Every FloatReceive_* / Transport_* function has a *Ctx variant taking the
+ * context as first argument; the original functions operate on
+ * TVL_ContextDefault(), so single-link firmware is unchanged. A host gateway
+ * declares one context per link (statically or on the heap) and calls
+ * TVL_ContextInit() on it.
+ *
+ * Layout:
+ * - The struct is public so contexts can be allocated without malloc; treat
+ *   the fields as private.
+ * - Contexts are aligned to TVLCOM_CACHE_LINE and the transport half starts on
+ *   its own line, so links (and RX vs TX of one link) don't false-share.
+ *
+ * Thread-safety:
+ * - Each context has its own optional HAL mutexes; contexts never share locks.
+ * - TVL_ContextCurrent() tells a handler which context is dispatching it.
+ *
+ ******************************************************************************
+ */
+/* USER CODE END Header */
+/* Define to prevent recursive inclusion -------------------------------------*/
+
+#ifndef STM32F407_LM5175_S_CONTEXT_H
+#define STM32F407_LM5175_S_CONTEXT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdbool.h>
+#include "stdint.h"
+/* USER CODE BEGIN Includes */
+
+#include "GLOBAL_CONFIG.h"
+#include "S_TLV_PROTOCOL.h"
+#include "S_RECEIVE_PROTOCOL.h"
+#include "S_TRANSPORT_PROTOCOL.h"
+#include "HAL/hal.h"
+#if TVLCOM_REGISTRY_LOCKFREE
+#include <stdatomic.h>
+#endif
+
+/* USER CODE END Includes */
+
+/* Exported constants --------------------------------------------------------*/
+/* USER CODE BEGIN EC */
+
+/* Interfaces per context (TLV_INTERFACE_UART, TLV_INTERFACE_USB) */
+#define TVL_CONTEXT_INTERFACES 2
+
+#if TVLCOM_DISPATCH_COMPACT
+#if TVLCOM_DISPATCH_PAGES < 1 || TVLCOM_DISPATCH_PAGES > 16
+#error "TVLCOM_DISPATCH_PAGES must be 1..16"
+#endif
+#define TVL_DISPATCH_PAGE_SIZE 16   /* ids sharing the high nibble share a page */
+#endif
+
+/* USER CODE END EC */
+
+/* Exported types ------------------------------------------------------------*/
+/* USER CODE BEGIN ET */
+
+/* Handlers registered for one TLV type: at most one of them is set */
+typedef struct {
+    tlv_type_handler_t fn;
+    tlv_status_handler_t status_fn;
+} tvl_type_slot_t;
+
+/* Handler tables indexed by the 8-bit TLV type / command id: O(1) dispatch */
+typedef struct {
+#if TVLCOM_DISPATCH_COMPACT
+    uint8_t type_page_of[16];       /* id >> 4 -> page + 1, 0: nothing registered */
+    uint8_t type_pages_used;
+    uint8_t cmd_page_of[16];
+    uint8_t cmd_pages_used;
+    tvl_type_slot_t type_pages[TVLCOM_DISPATCH_PAGES][TVL_DISPATCH_PAGE_SIZE];
+    cmd_handler_t cmd_pages[TVLCOM_DISPATCH_PAGES][TVL_DISPATCH_PAGE_SIZE];
+#else
+    tvl_type_slot_t types[256];
+    cmd_handler_t cmds[256];
+#endif
+} tvl_handler_registry_t;
+
+/* ACKs waiting to be coalesced into one TLV_TYPE_ACK_BITMAP frame */
+typedef struct {
+    uint8_t count;          /* distinct ids pending */
+    uint8_t base;           /* first pending id; bit k of bitmap = base + k */
+    uint8_t max_offset;     /* highest offset set */
+    uint32_t first_tick;    /* when the first pending id was queued */
+    uint8_t bitmap[32];
+} tvl_ack_batch_t;
+
+#if TVLCOM_DUP_CACHE_SIZE
+/* Recently ACKed frame, ACKed again (handlers not re-run) when it is retransmitted */
+typedef struct {
+    uint8_t state;          /* DUP_EMPTY / DUP_ACKED */
+    uint8_t frame_id;
+    uint16_t crc;           /* frame CRC: tells a retransmission from a new frame reusing the id */
+    uint32_t tick;
+} tvl_dup_entry_t;
+#endif
+
+/* One reliable frame awaiting ACK */
+typedef struct {
+    bool used;
+    uint8_t frame_id;
+    uint8_t retries;
+    uint16_t len;
+    uint32_t sent_tick;
+    transport_tx_done_t done;
+    void *user;
+    uint8_t frame[TLV_MAX_FRAME_SIZE];
+} tvl_tx_slot_t;
+
+/* One caller's frame waiting for the combining writer; lives on the caller's stack */
+typedef struct tvl_tx_request {
+    struct tvl_tx_request *next;
+    const transport_iovec_t *iov;
+    uint8_t iovcnt;
+    bool done;              /* written under tx_write_lock, read by the owner under it */
+    int result;
+} tvl_tx_request_t;
+
+struct tvl_context {
+    /* ---- receive (S_RECEIVE_PROTOCOL.c) ---- */
+    _Alignas(TVLCOM_CACHE_LINE) tlv_parser_t rx_parsers[TVL_CONTEXT_INTERFACES];
+
+    /* Optional lock: registry writers, ACK batching, duplicate cache */
+    tvl_hal_mutex_t rx_lock;
+
+    /*
+     * Handler registry. Lock-free build: two snapshots; readers use rx_registry[rx_registry_active]
+     * and count themselves in rx_registry_readers[], Register* rewrites the other one and swaps.
+     */
+#if TVLCOM_REGISTRY_LOCKFREE
+    tvl_handler_registry_t rx_registry[2];
+    atomic_uint rx_registry_active;
+    atomic_uint rx_registry_readers[2];
+#else
+    tvl_handler_registry_t rx_registry[1];
+#endif
+
+    ack_notify_t rx_ack_handler;
+    ack_notify_t rx_nack_handler;
+    nack_detail_notify_t rx_nack_detail_handler;
+
+    /* ACK batching: coalescing and/or piggybacking; rx_ack_flush_* is the effective policy */
+    tvl_ack_batch_t rx_ack_batch[TVL_CONTEXT_INTERFACES];
+    uint8_t rx_ack_coalesce_count;
+    uint32_t rx_ack_coalesce_delay_ms;
+    bool rx_ack_piggyback;
+    uint32_t rx_ack_piggyback_deadline_ms;
+    uint8_t rx_ack_flush_count;         /* 0: batching off, one ACK frame per accepted frame */
+    uint32_t rx_ack_flush_delay_ms;
+
+    /* Worker pool for handlers (FloatReceive_SetDispatchCtx); NULL: run them on the parsing thread */
+    tvl_dispatch_t *rx_dispatch;
+
+#if TVLCOM_DUP_CACHE_SIZE
+    /* Direct-mapped on frame_id: O(1) lookup, fixed RAM */
+    tvl_dup_entry_t rx_dup_cache[TVL_CONTEXT_INTERFACES][TVLCOM_DUP_CACHE_SIZE];
+#endif
+
+    /* ---- transport (S_TRANSPORT_PROTOCOL.c) ---- */
+    _Alignas(TVLCOM_CACHE_LINE) transport_send_func_t tx_senders[TVL_CONTEXT_INTERFACES];
+    transport_sendv_func_t tx_sendv[TVL_CONTEXT_INTERFACES];
+    transport_send_ex_func_t tx_senders_ex[TVL_CONTEXT_INTERFACES];
+    void *tx_sender_user[TVL_CONTEXT_INTERFACES];
+    tvl_tx_queue_t *tx_queue[TVL_CONTEXT_INTERFACES];   /* Transport_SetTxQueueCtx(); NULL: synchronous */
+    uint8_t tx_frame_id_counter;
+    transport_ack_source_t tx_ack_source;           /* Transport_SetAckSource() */
+    transport_ack_source_ctx_t tx_ack_source_ctx;   /* Transport_SetAckSourceCtx(), wins when set */
+    transport_ack_restore_ctx_t tx_ack_restore_ctx; /* Transport_SetAckRestoreCtx() */
+
+    /* Optional lock to protect shared state in multi-thread / ISR + main scenarios */
+    tvl_hal_mutex_t tx_lock;
+
+    /*
+     * Combining writer: callers append to tx_pending under tx_lock; whoever holds
+     * tx_write_lock takes the whole list and writes it (lock order: write, transport).
+     */
+    tvl_hal_mutex_t tx_write_lock[TVL_CONTEXT_INTERFACES];
+    tvl_tx_request_t *tx_pending[TVL_CONTEXT_INTERFACES];
+    tvl_tx_request_t *tx_pending_tail[TVL_CONTEXT_INTERFACES];
+    const void *tx_write_owner[TVL_CONTEXT_INTERFACES];  /* thread running the sender; under tx_lock */
+    transport_write_stats_t tx_write_stats[TVL_CONTEXT_INTERFACES];   /* under tx_write_lock */
+#if TRANSPORT_COMBINE_BYTES
+    uint8_t tx_batch[TVL_CONTEXT_INTERFACES][TRANSPORT_COMBINE_BYTES];  /* under tx_write_lock */
+#endif
+
+    /* Reliable-send window; frames are copied out and sent after its lock is released (lock order: window, transport) */
+    tvl_hal_mutex_t tx_window_lock;
+    tvl_tx_slot_t tx_window[TVL_CONTEXT_INTERFACES][TRANSPORT_TX_WINDOW];
+
+    /* Application pointer (TVL_ContextSetUser) */
+    void *user;
+};
+
+/* USER CODE END ET */
+
+/* Exported functions prototypes ---------------------------------------------*/
+/* USER CODE BEGIN EFP */
+
+/**
+ * @brief Reset a context to the freshly-declared state (no handlers, senders or locks).
+ *
+ * Call before first use on heap/stack storage; static contexts start out zeroed.
+ * Follow with FloatReceive_InitCtx() per interface, as for the default context.
+ */
+void TVL_ContextInit(tvl_context_t *ctx);
+
+/**
+ * @brief Destroy the HAL mutexes a context created and reset it.
+ *
+ * No other thread may use the context during or after the call.
+ */
+void TVL_ContextDeinit(tvl_context_t *ctx);
+
+/**
+ * @brief Context used by the non-Ctx FloatReceive_* / Transport_* functions.
+ */
+tvl_context_t *TVL_ContextDefault(void);
+
+/**
+ * @brief Context whose frame is being dispatched on the calling thread.
+ *
+ * Lets one handler function serve many links. Outside a dispatch (or on
+ * targets without thread-local storage, see TVLCOM_THREAD_LOCAL) this is the
+ * default context.
+ */
+tvl_context_t *TVL_ContextCurrent(void);
+
+/**
+ * @brief Attach/read an application pointer (e.g. the gateway's link object).
+ */
+void TVL_ContextSetUser(tvl_context_t *ctx, void *user);
+void *TVL_ContextGetUser(const tvl_context_t *ctx);
+
+/* USER CODE END EFP */
+
+/* Private defines -----------------------------------------------------------*/
+/* USER CODE BEGIN Private defines */
+
+/* Used by S_RECEIVE_PROTOCOL.c around handler dispatch; returns the previous value */
+tvl_context_t *TVL_ContextSwapCurrent(tvl_context_t *ctx);
+
+/* USER CODE END Private defines */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // STM32F407_LM5175_S_CONTEXT_H
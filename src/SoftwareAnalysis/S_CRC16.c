@@ -0,0 +1,491 @@
+/**
+ ******************************************************************************
+ * @file           : S_CRC16.c
+ * @brief          : CRC16-CCITT engines + runtime engine selection.
+ * @author         : UF4OVER
+ * @date           : 2026-01-12
+ ******************************************************************************
+ * @attention
+ *
+ * See S_CRC16.h for the engine list and build options.
+ *
+ * The CLMUL engine folds 16-byte blocks (4 lanes of 64 bytes when the input
+ * is long enough) with constants x^n mod P, then reduces the final 128-bit
+ * remainder with the 256-entry table. Inputs shorter than one block use the
+ * table engine directly.
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "S_CRC16.h"
+/* USER CODE BEGIN Includes */
+
+#include <string.h>
+
+#include "GLOBAL_CONFIG.h"
+
+#if TVLCOM_CRC16_SMALL_TABLE
+#  undef  TVLCOM_CRC16_SLICING
+#  define TVLCOM_CRC16_SLICING 0
+#  undef  TVLCOM_CRC16_CLMUL
+#  define TVLCOM_CRC16_CLMUL 0
+#endif
+
+#if TVLCOM_CRC16_CLMUL && (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#  define CRC16_HAVE_CLMUL 1
+#  include <immintrin.h>
+#  define CRC16_CLMUL_TARGET __attribute__((target("pclmul,ssse3")))
+#elif TVLCOM_CRC16_CLMUL && defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#  define CRC16_HAVE_CLMUL 1
+#  include <intrin.h>
+#  include <wmmintrin.h>
+#  include <tmmintrin.h>
+#  define CRC16_CLMUL_TARGET
+#else
+#  define CRC16_HAVE_CLMUL 0
+#endif
+
+/*
+ * The engine pointer is resolved lazily by whichever thread computes a CRC
+ * first, so it (and the slice tables) are published with C11 atomics.
+ * Without them, select the engine before starting other threads.
+ */
+#if !defined(__STDC_NO_ATOMICS__)
+#  include <stdatomic.h>
+#  define CRC16_ATOMIC 1
+#  define CRC16_SHARED(T)      _Atomic(T)
+#  define CRC16_LOAD(v)        atomic_load_explicit(&(v), memory_order_acquire)
+#  define CRC16_STORE(v, x)    atomic_store_explicit(&(v), (x), memory_order_release)
+#else
+#  define CRC16_ATOMIC 0
+#  define CRC16_SHARED(T)      volatile T
+#  define CRC16_LOAD(v)        (v)
+#  define CRC16_STORE(v, x)    ((v) = (x))
+#endif
+
+/* USER CODE END Includes */
+
+/* Private typedef -----------------------------------------------------------*/
+/* USER CODE BEGIN PTD */
+
+typedef uint16_t (*crc16_block_fn_t)(uint16_t crc, const uint8_t *data, size_t length);
+
+/* USER CODE END PTD */
+
+/* Private variables ---------------------------------------------------------*/
+/* USER CODE BEGIN PV */
+
+/* crc16_nibble[i] = CRC of the 4-bit value i shifted into the top of the register */
+static const uint16_t crc16_nibble[16] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+};
+
+#if !TVLCOM_CRC16_SMALL_TABLE
+/* crc16_table[i] = CRC (zero init) of the single byte i */
+static const uint16_t crc16_table[256] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+    0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
+    0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
+    0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
+    0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
+    0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
+    0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
+    0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+    0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
+    0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
+    0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
+    0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
+    0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
+    0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
+    0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
+    0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
+    0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+    0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
+    0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
+    0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
+    0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+    0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
+    0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
+    0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
+    0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
+    0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+    0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
+    0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
+    0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
+    0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
+    0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0,
+};
+#endif
+
+/* crc16_x8pow[k] = x^(8 * 2^k) mod P, for TLV_Crc16Shift() */
+static const uint16_t crc16_x8pow[15] = {
+    0x0100, 0x1021, 0x3730, 0xB861, 0xAEFC, 0x8E29, 0x13FC, 0x36C4,
+    0xFD50, 0xAA9E, 0x881C, 0x4458, 0x0002, 0x0004, 0x0010,
+};
+
+#if TVLCOM_CRC16_SLICING
+/* crc16_slice[k][i] = CRC (zero init) of byte i followed by k zero bytes */
+static uint16_t crc16_slice[8][256];
+/* 0: not built, 1: being built, 2: ready */
+static CRC16_SHARED(int) crc16_slice_state = 0;
+#endif
+
+static uint16_t crc16_resolve(uint16_t crc, const uint8_t *data, size_t length);
+
+static CRC16_SHARED(crc16_block_fn_t) s_crc16_active = crc16_resolve;
+static CRC16_SHARED(tlv_crc16_engine_t) s_crc16_engine = TLV_CRC16_ENGINE_AUTO;
+
+/* USER CODE END PV */
+
+/* Private user code ---------------------------------------------------------*/
+/* USER CODE BEGIN 0 */
+
+static uint16_t crc16_bitwise(uint16_t crc, const uint8_t *data, size_t length)
+{
+    for (size_t i = 0; i < length; i++) {
+        crc ^= (uint16_t)data[i] << 8;
+        for (uint8_t j = 0; j < 8; j++) {
+            if (crc & 0x8000) {
+                crc = (uint16_t)((crc << 1) ^ TLV_CRC16_POLY);
+            } else {
+                crc <<= 1;
+            }
+        }
+    }
+    return crc;
+}
+
+static inline uint16_t crc16_nibble_byte(uint16_t crc, uint8_t byte)
+{
+    crc = (uint16_t)((crc << 4) ^ crc16_nibble[((crc >> 12) ^ (byte >> 4)) & 0x0F]);
+    crc = (uint16_t)((crc << 4) ^ crc16_nibble[((crc >> 12) ^ byte) & 0x0F]);
+    return crc;
+}
+
+static uint16_t crc16_nibble_block(uint16_t crc, const uint8_t *data, size_t length)
+{
+    for (size_t i = 0; i < length; i++) {
+        crc = crc16_nibble_byte(crc, data[i]);
+    }
+    return crc;
+}
+
+#if !TVLCOM_CRC16_SMALL_TABLE
+static inline uint16_t crc16_table_byte(uint16_t crc, uint8_t byte)
+{
+    return (uint16_t)((crc << 8) ^ crc16_table[((crc >> 8) ^ byte) & 0xFF]);
+}
+
+static uint16_t crc16_table_block(uint16_t crc, const uint8_t *data, size_t length)
+{
+    for (size_t i = 0; i < length; i++) {
+        crc = crc16_table_byte(crc, data[i]);
+    }
+    return crc;
+}
+#endif
+
+#if TVLCOM_CRC16_SLICING
+static void crc16_slice_build(void)
+{
+    if (CRC16_LOAD(crc16_slice_state) == 2) return;
+#if CRC16_ATOMIC
+    int expected = 0;
+    if (!atomic_compare_exchange_strong(&crc16_slice_state, &expected, 1)) {
+        while (CRC16_LOAD(crc16_slice_state) != 2) {} /* another thread is building them (~4 KiB of stores) */
+        return;
+    }
+#endif
+    for (unsigned i = 0; i < 256; i++) {
+        crc16_slice[0][i] = crc16_table[i];
+    }
+    for (unsigned k = 1; k < 8; k++) {
+        for (unsigned i = 0; i < 256; i++) {
+            uint16_t prev = crc16_slice[k - 1][i];
+            crc16_slice[k][i] = (uint16_t)((prev << 8) ^ crc16_table[prev >> 8]);
+        }
+    }
+    CRC16_STORE(crc16_slice_state, 2);
+}
+
+static uint16_t crc16_slice4_block(uint16_t crc, const uint8_t *data, size_t length)
+{
+    crc16_slice_build();
+    while (length >= 4) {
+        crc = (uint16_t)(crc16_slice[3][(data[0] ^ (crc >> 8)) & 0xFF] ^
+                         crc16_slice[2][(data[1] ^ crc) & 0xFF] ^
+                         crc16_slice[1][data[2]] ^
+                         crc16_slice[0][data[3]]);
+        data += 4;
+        length -= 4;
+    }
+    return crc16_table_block(crc, data, length);
+}
+
+static uint16_t crc16_slice8_block(uint16_t crc, const uint8_t *data, size_t length)
+{
+    crc16_slice_build();
+    while (length >= 8) {
+        crc = (uint16_t)(crc16_slice[7][(data[0] ^ (crc >> 8)) & 0xFF] ^
+                         crc16_slice[6][(data[1] ^ crc) & 0xFF] ^
+                         crc16_slice[5][data[2]] ^
+                         crc16_slice[4][data[3]] ^
+                         crc16_slice[3][data[4]] ^
+                         crc16_slice[2][data[5]] ^
+                         crc16_slice[1][data[6]] ^
+                         crc16_slice[0][data[7]]);
+        data += 8;
+        length -= 8;
+    }
+    return crc16_table_block(crc, data, length);
+}
+#endif
+
+#if CRC16_HAVE_CLMUL
+/* x^n mod P for the fold distances used below (P = x^16 + x^12 + x^5 + 1) */
+#define CRC16_K_X128 0xAEFCu
+#define CRC16_K_X192 0x650Bu
+#define CRC16_K_X512 0x13FCu
+#define CRC16_K_X576 0x8832u
+
+static bool crc16_clmul_supported(void)
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    return ((info[2] >> 1) & 1) && ((info[2] >> 9) & 1); /* PCLMULQDQ + SSSE3 */
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("ssse3");
+#endif
+}
+
+/*
+ * Registers hold a 128-bit polynomial with the first message bit as x^127:
+ * bytes are reversed on load so lane 1 = bytes 0..7 (big-endian), lane 0 = bytes 8..15.
+ * Folding by d bits: A * x^d = A.hi * (x^(d+64) mod P) + A.lo * (x^d mod P), each product < 80 bits.
+ */
+CRC16_CLMUL_TARGET
+static inline __m128i crc16_clmul_fold(__m128i acc, __m128i k, __m128i next)
+{
+    __m128i hi = _mm_clmulepi64_si128(acc, k, 0x11);
+    __m128i lo = _mm_clmulepi64_si128(acc, k, 0x00);
+    return _mm_xor_si128(_mm_xor_si128(hi, lo), next);
+}
+
+/* Short inputs, the final 16-byte reduction and the tail use the fastest scalar engine */
+#if TVLCOM_CRC16_SLICING
+#  define crc16_clmul_scalar crc16_slice8_block
+#  define CRC16_CLMUL_MIN_LENGTH 64u
+#else
+#  define crc16_clmul_scalar crc16_table_block
+#  define CRC16_CLMUL_MIN_LENGTH 16u
+#endif
+
+CRC16_CLMUL_TARGET
+static uint16_t crc16_clmul_block(uint16_t crc, const uint8_t *data, size_t length)
+{
+    if (length < CRC16_CLMUL_MIN_LENGTH) {
+        return crc16_clmul_scalar(crc, data, length);
+    }
+
+    const __m128i bswap = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    const __m128i k128 = _mm_set_epi32(0, CRC16_K_X192, 0, CRC16_K_X128);
+    const __m128i k512 = _mm_set_epi32(0, CRC16_K_X576, 0, CRC16_K_X512);
+
+    /* The running CRC is the same as XOR-ing it into the first 16 message bits (zero init). */
+    __m128i acc = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)data), bswap);
+    acc = _mm_xor_si128(acc, _mm_set_epi32((int)((uint32_t)crc << 16), 0, 0, 0));
+    data += 16;
+    length -= 16;
+
+    if (length >= 64) {
+        __m128i a1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(data + 0)), bswap);
+        __m128i a2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(data + 16)), bswap);
+        __m128i a3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(data + 32)), bswap);
+        __m128i a0 = acc;
+        data += 48;
+        length -= 48;
+        while (length >= 64) {
+            a0 = crc16_clmul_fold(a0, k512, _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(data + 0)), bswap));
+            a1 = crc16_clmul_fold(a1, k512, _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(data + 16)), bswap));
+            a2 = crc16_clmul_fold(a2, k512, _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(data + 32)), bswap));
+            a3 = crc16_clmul_fold(a3, k512, _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(data + 48)), bswap));
+            data += 64;
+            length -= 64;
+        }
+        acc = crc16_clmul_fold(a0, k128, a1);
+        acc = crc16_clmul_fold(acc, k128, a2);
+        acc = crc16_clmul_fold(acc, k128, a3);
+    }
+
+    while (length >= 16) {
+        acc = crc16_clmul_fold(acc, k128, _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)data), bswap));
+        data += 16;
+        length -= 16;
+    }
+
+    /* Reduce: CRC(zero init) of the 16 remainder bytes is remainder * x^16 mod P */
+    uint8_t rem[16];
+    _mm_storeu_si128((__m128i *)rem, _mm_shuffle_epi8(acc, bswap));
+    crc = crc16_clmul_scalar(0, rem, sizeof(rem));
+    return crc16_clmul_scalar(crc, data, length);
+}
+#endif
+
+/* a * b mod P over GF(2) */
+static uint16_t crc16_mulmod(uint16_t a, uint16_t b)
+{
+    /* Branchless 16x16 carry-less product; the high half reduces like a CRC over two zero bytes */
+    uint32_t p = 0;
+    for (unsigned i = 0; i < 16; ++i) {
+        p ^= ((uint32_t)a << i) & (0u - (uint32_t)((b >> i) & 1u));
+    }
+    uint16_t hi = (uint16_t)(p >> 16);
+#if !TVLCOM_CRC16_SMALL_TABLE
+    hi = crc16_table_byte(hi, 0);
+    hi = crc16_table_byte(hi, 0);
+#else
+    hi = crc16_nibble_byte(hi, 0);
+    hi = crc16_nibble_byte(hi, 0);
+#endif
+    return (uint16_t)(hi ^ (uint16_t)p);
+}
+
+static crc16_block_fn_t crc16_engine_fn(tlv_crc16_engine_t engine)
+{
+    switch (engine) {
+    case TLV_CRC16_ENGINE_BITWISE: return crc16_bitwise;
+    case TLV_CRC16_ENGINE_NIBBLE:  return crc16_nibble_block;
+#if !TVLCOM_CRC16_SMALL_TABLE
+    case TLV_CRC16_ENGINE_TABLE:   return crc16_table_block;
+#endif
+#if TVLCOM_CRC16_SLICING
+    case TLV_CRC16_ENGINE_SLICE4:  return crc16_slice4_block;
+    case TLV_CRC16_ENGINE_SLICE8:  return crc16_slice8_block;
+#endif
+#if CRC16_HAVE_CLMUL
+    case TLV_CRC16_ENGINE_CLMUL:   return crc16_clmul_supported() ? crc16_clmul_block : NULL;
+#endif
+    default:                       return NULL;
+    }
+}
+
+static tlv_crc16_engine_t crc16_best_engine(void)
+{
+    /* Preference order; the first available engine wins. */
+    static const tlv_crc16_engine_t order[] = {
+        TLV_CRC16_ENGINE_CLMUL,
+        TLV_CRC16_ENGINE_SLICE8,
+        TLV_CRC16_ENGINE_TABLE,
+        TLV_CRC16_ENGINE_NIBBLE,
+    };
+    for (size_t i = 0; i < sizeof(order) / sizeof(order[0]); i++) {
+        if (crc16_engine_fn(order[i])) return order[i];
+    }
+    return TLV_CRC16_ENGINE_BITWISE;
+}
+
+/*
+ * First call through s_crc16_active lands here and installs the best engine.
+ * Threads racing here all pick the same engine; each store is atomic.
+ */
+static uint16_t crc16_resolve(uint16_t crc, const uint8_t *data, size_t length)
+{
+    (void)TLV_Crc16SetEngine(TLV_CRC16_ENGINE_AUTO);
+    return CRC16_LOAD(s_crc16_active)(crc, data, length);
+}
+
+/* USER CODE END 0 */
+
+/* Exported functions --------------------------------------------------------*/
+/* USER CODE BEGIN 1 */
+
+uint16_t TLV_Crc16Compute(tlv_crc16_engine_t engine, uint16_t crc, const uint8_t *data, size_t length)
+{
+    if (engine == TLV_CRC16_ENGINE_AUTO) {
+        return CRC16_LOAD(s_crc16_active)(crc, data, length);
+    }
+    crc16_block_fn_t fn = crc16_engine_fn(engine);
+    if (!fn) fn = crc16_bitwise;
+    return fn(crc, data, length);
+}
+
+uint16_t TLV_Crc16Block(uint16_t crc, const uint8_t *data, size_t length)
+{
+    return CRC16_LOAD(s_crc16_active)(crc, data, length);
+}
+
+uint16_t TLV_Crc16Byte(uint16_t crc, uint8_t byte)
+{
+#if !TVLCOM_CRC16_SMALL_TABLE
+    return crc16_table_byte(crc, byte);
+#else
+    return crc16_nibble_byte(crc, byte);
+#endif
+}
+
+uint16_t TLV_Crc16Shift(uint16_t crc, size_t length)
+{
+    /* x has order 32767 modulo P, so x^(8n) only depends on n mod 32767 (< 2^15) */
+    length %= 32767u;
+    for (unsigned k = 0; k < 15 && length; k++, length >>= 1) {
+        if (length & 1) {
+            crc = crc16_mulmod(crc, crc16_x8pow[k]);
+        }
+    }
+    return crc;
+}
+
+bool TLV_Crc16EngineAvailable(tlv_crc16_engine_t engine)
+{
+    if (engine == TLV_CRC16_ENGINE_AUTO) return true;
+    return crc16_engine_fn(engine) != NULL;
+}
+
+bool TLV_Crc16SetEngine(tlv_crc16_engine_t engine)
+{
+    if (engine == TLV_CRC16_ENGINE_AUTO) {
+        engine = crc16_best_engine();
+    }
+    crc16_block_fn_t fn = crc16_engine_fn(engine);
+    if (!fn) {
+        return false;
+    }
+#if TVLCOM_CRC16_SLICING
+    /* Build tables before publishing the engine so readers never see half-built tables */
+    if (engine == TLV_CRC16_ENGINE_SLICE4 || engine == TLV_CRC16_ENGINE_SLICE8) {
+        crc16_slice_build();
+    }
+#endif
+    CRC16_STORE(s_crc16_engine, engine);
+    CRC16_STORE(s_crc16_active, fn);
+    return true;
+}
+
+tlv_crc16_engine_t TLV_Crc16GetEngine(void)
+{
+    if (CRC16_LOAD(s_crc16_engine) == TLV_CRC16_ENGINE_AUTO) {
+        (void)TLV_Crc16SetEngine(TLV_CRC16_ENGINE_AUTO);
+    }
+    return CRC16_LOAD(s_crc16_engine);
+}
+
+const char *TLV_Crc16EngineName(tlv_crc16_engine_t engine)
+{
+    switch (engine) {
+    case TLV_CRC16_ENGINE_AUTO:    return "auto";
+    case TLV_CRC16_ENGINE_BITWISE: return "bitwise";
+    case TLV_CRC16_ENGINE_NIBBLE:  return "nibble";
+    case TLV_CRC16_ENGINE_TABLE:   return "table256";
+    case TLV_CRC16_ENGINE_SLICE4:  return "slice4";
+    case TLV_CRC16_ENGINE_SLICE8:  return "slice8";
+    case TLV_CRC16_ENGINE_CLMUL:   return "clmul";
+    default:                       return "?";
+    }
+}
+
+/* USER CODE END 1 */
@@ -0,0 +1,172 @@
+/* USER CODE BEGIN Header */
+/**
+ ******************************************************************************
+ * @file           : S_CRC16.h
+ * @brief          : CRC16-CCITT engines (bitwise/nibble/table/slice-by-N/CLMUL).
+ * @author         : UF4OVER
+ * @date           : 2026-01-12
+ ******************************************************************************
+ * @attention
+ *
+ * All engines compute the same CRC as TLV_CalculateCRC16():
+ *   CRC16-CCITT, polynomial 0x1021, MSB-first, no final XOR.
+ *
+ * Engines:
+ * - BITWISE : reference implementation, 8 shifts per byte, no table.
+ * - NIBBLE  : 16-entry table (32 bytes of flash), 2 lookups per byte.
+ * - TABLE   : 256-entry table (512 bytes of flash), 1 lookup per byte.
+ * - SLICE4/8: 4/8 x 256-entry tables built on first use (2/4 KiB of RAM).
+ * - CLMUL   : x86 PCLMULQDQ folding, selected at runtime when the CPU supports it.
+ *
+ * Build options (see GLOBAL_CONFIG.h):
+ * - TVLCOM_CRC16_SMALL_TABLE=1 : only BITWISE/NIBBLE are compiled (flash-limited MCUs).
+ * - TVLCOM_CRC16_SLICING=0     : drop the slice-by-N RAM tables.
+ * - TVLCOM_CRC16_CLMUL=0       : never compile the carry-less multiply path.
+ *
+ * Thread-safety:
+ * - Computing is reentrant. The AUTO engine is resolved on first use by
+ *   whichever thread gets there first; the engine pointer and the slice tables
+ *   are published with C11 atomics, so that race is harmless. Compilers
+ *   without <stdatomic.h> should call TLV_Crc16SetEngine() before starting
+ *   other threads.
+ *
+ ******************************************************************************
+ */
+/* Define to prevent recursive inclusion -------------------------------------*/
+
+#ifndef STM32F407_LM5175_S_CRC16_H
+#define STM32F407_LM5175_S_CRC16_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stddef.h>
+#include "stdint.h"
+/* USER CODE BEGIN Includes */
+
+/* USER CODE END Includes */
+
+/* Exported types ------------------------------------------------------------*/
+/* USER CODE BEGIN ET */
+
+/* CRC16 engine selector */
+typedef enum {
+    TLV_CRC16_ENGINE_AUTO = 0,  /* best available engine for this build/CPU */
+    TLV_CRC16_ENGINE_BITWISE,
+    TLV_CRC16_ENGINE_NIBBLE,
+    TLV_CRC16_ENGINE_TABLE,
+    TLV_CRC16_ENGINE_SLICE4,
+    TLV_CRC16_ENGINE_SLICE8,
+    TLV_CRC16_ENGINE_CLMUL,
+    TLV_CRC16_ENGINE_COUNT
+} tlv_crc16_engine_t;
+
+/* USER CODE END ET */
+
+/* Exported constants --------------------------------------------------------*/
+/* USER CODE BEGIN EC */
+
+#define TLV_CRC16_POLY          0x1021
+#define TLV_CRC16_INIT          0xFFFF
+
+/* USER CODE END EC */
+
+/* Exported functions prototypes ---------------------------------------------*/
+/* USER CODE BEGIN EFP */
+
+/**
+ * @brief Continue a CRC16 over a block using a specific engine.
+ *
+ * @param engine Engine to use (AUTO = currently selected engine).
+ * @param crc    Running CRC (TLV_CRC16_INIT for a fresh computation).
+ * @param data   Input bytes.
+ * @param length Number of bytes.
+ * @return Updated CRC. Falls back to BITWISE if the engine is not available.
+ */
+uint16_t TLV_Crc16Compute(tlv_crc16_engine_t engine, uint16_t crc, const uint8_t *data, size_t length);
+
+/**
+ * @brief Continue a CRC16 over a block using the currently selected engine.
+ */
+uint16_t TLV_Crc16Block(uint16_t crc, const uint8_t *data, size_t length);
+
+/**
+ * @brief Fold one byte into a running CRC16 (cheapest available single-byte step).
+ */
+uint16_t TLV_Crc16Byte(uint16_t crc, uint8_t byte);
+
+/* Streaming API ------------------------------------------------------------
+ * Usage:
+ *   uint16_t crc = TLV_Crc16Init();
+ *   crc = TLV_Crc16Update(crc, part1, len1);
+ *   crc = TLV_Crc16UpdateByte(crc, b);
+ *   uint16_t result = TLV_Crc16Final(crc);
+ * The result equals TLV_CalculateCRC16() over the concatenated input.
+ */
+
+/** @brief Start a streaming CRC16. */
+static inline uint16_t TLV_Crc16Init(void)
+{
+    return (uint16_t)TLV_CRC16_INIT;
+}
+
+/** @brief Feed a block into a streaming CRC16. */
+static inline uint16_t TLV_Crc16Update(uint16_t crc, const uint8_t *data, size_t length)
+{
+    return TLV_Crc16Block(crc, data, length);
+}
+
+/** @brief Feed one byte into a streaming CRC16. */
+static inline uint16_t TLV_Crc16UpdateByte(uint16_t crc, uint8_t byte)
+{
+    return TLV_Crc16Byte(crc, byte);
+}
+
+/** @brief Finish a streaming CRC16 (CCITT-FALSE has no final XOR). */
+static inline uint16_t TLV_Crc16Final(uint16_t crc)
+{
+    return crc;
+}
+
+/**
+ * @brief Advance a CRC register over 'length' zero bytes in O(log length).
+ *
+ * Lets a CRC be assembled out of order:
+ *   CRC(A || B) == TLV_Crc16Shift(CRC(A), len(B)) ^ TLV_Crc16Update(0, B, len(B))
+ * e.g. the frame writer hashes the payload before DataLen is known.
+ */
+uint16_t TLV_Crc16Shift(uint16_t crc, size_t length);
+
+/**
+ * @brief Check whether an engine is compiled in and supported by the running CPU.
+ */
+bool TLV_Crc16EngineAvailable(tlv_crc16_engine_t engine);
+
+/**
+ * @brief Select the engine used by TLV_CalculateCRC16()/TLV_Crc16Block().
+ *
+ * @param engine Engine to use, or AUTO to pick the fastest available one.
+ * @return false if the engine is not available (selection unchanged).
+ */
+bool TLV_Crc16SetEngine(tlv_crc16_engine_t engine);
+
+/**
+ * @brief Get the engine currently in use (never AUTO).
+ */
+tlv_crc16_engine_t TLV_Crc16GetEngine(void);
+
+/**
+ * @brief Human readable engine name (for logs/benchmarks).
+ */
+const char *TLV_Crc16EngineName(tlv_crc16_engine_t engine);
+
+/* USER CODE END EFP */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // STM32F407_LM5175_S_CRC16_H
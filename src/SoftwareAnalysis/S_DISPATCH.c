@@ -0,0 +1,190 @@
+/**
+ ******************************************************************************
+ * @file           : S_DISPATCH.c
+ * @brief          : Worker-pool handler dispatch implementation.
+ * @author         : UF4OVER
+ * @date           : 2026-02-05
+ ******************************************************************************
+ * @attention
+ *
+ * See S_DISPATCH.h. Each worker owns a ring of TVLCOM_DISPATCH_QUEUE_DEPTH
+ * slots. A slot stays counted in 'count' while its frame is being handled,
+ * so producers never overwrite it; the lock is not held while handlers run.
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "S_DISPATCH.h"
+
+/* USER CODE BEGIN Includes */
+#include <string.h>
+#include "S_RECEIVE_PROTOCOL.h"
+/* USER CODE END Includes */
+
+/* Private define ------------------------------------------------------------*/
+/* USER CODE BEGIN PD */
+
+#if TVLCOM_DISPATCH_MAX_WORKERS < 1 || TVLCOM_DISPATCH_QUEUE_DEPTH < 1
+#error "TVLCOM_DISPATCH_MAX_WORKERS and TVLCOM_DISPATCH_QUEUE_DEPTH must be at least 1"
+#endif
+
+/* USER CODE END PD */
+
+/* Private user code ---------------------------------------------------------*/
+/* USER CODE BEGIN 0 */
+
+static void dispatch_lock(tvl_dispatch_worker_t *w)
+{
+    const tvl_hal_vtable_t *hal = TVL_HAL_Get();
+    if (w->lock && hal && hal->mutex_lock) hal->mutex_lock(w->lock);
+}
+
+static void dispatch_unlock(tvl_dispatch_worker_t *w)
+{
+    const tvl_hal_vtable_t *hal = TVL_HAL_Get();
+    if (w->lock && hal && hal->mutex_unlock) hal->mutex_unlock(w->lock);
+}
+
+static void dispatch_signal(tvl_dispatch_worker_t *w)
+{
+    const tvl_hal_vtable_t *hal = TVL_HAL_Get();
+    if (w->wake && hal && hal->event_signal) hal->event_signal(w->wake);
+}
+
+static tvl_dispatch_worker_t *dispatch_worker(tvl_dispatch_t *pool, uint8_t worker)
+{
+    if (!pool || worker >= pool->worker_count) return NULL;
+    return &pool->workers[worker];
+}
+
+/* USER CODE END 0 */
+
+/* Exported functions --------------------------------------------------------*/
+/* USER CODE BEGIN 1 */
+
+void TVL_DispatchInit(tvl_dispatch_t *pool, uint8_t workers)
+{
+    if (!pool) return;
+    memset(pool, 0, sizeof(*pool));
+    if (workers < 1) workers = 1;
+    if (workers > TVLCOM_DISPATCH_MAX_WORKERS) workers = TVLCOM_DISPATCH_MAX_WORKERS;
+    pool->worker_count = workers;
+
+    const tvl_hal_vtable_t *hal = TVL_HAL_Get();
+    for (uint8_t i = 0; i < workers; ++i) {
+        tvl_dispatch_worker_t *w = &pool->workers[i];
+        if (hal && hal->mutex_create) w->lock = hal->mutex_create();
+        if (hal && hal->event_create) w->wake = hal->event_create();
+    }
+}
+
+void TVL_DispatchDeinit(tvl_dispatch_t *pool)
+{
+    if (!pool) return;
+    const tvl_hal_vtable_t *hal = TVL_HAL_Get();
+    for (uint8_t i = 0; i < pool->worker_count; ++i) {
+        tvl_dispatch_worker_t *w = &pool->workers[i];
+        if (w->lock && hal && hal->mutex_destroy) hal->mutex_destroy(w->lock);
+        if (w->wake && hal && hal->event_destroy) hal->event_destroy(w->wake);
+    }
+    memset(pool, 0, sizeof(*pool));
+}
+
+uint8_t TVL_DispatchWorkerOf(const tvl_dispatch_t *pool, const tvl_context_t *ctx, tlv_interface_t interface)
+{
+    if (!pool || pool->worker_count <= 1) return 0;
+    /* Contexts are cache-line aligned: drop the always-zero low bits before mixing in the interface */
+    uintptr_t h = (uintptr_t)ctx / TVLCOM_CACHE_LINE;
+    h = h * 2u + (uintptr_t)interface;
+    return (uint8_t)(h % pool->worker_count);
+}
+
+bool TVL_DispatchSubmit(tvl_dispatch_t *pool, tvl_context_t *ctx, uint8_t frame_id,
+                        const uint8_t *data, uint16_t length, tlv_interface_t interface)
+{
+    tvl_dispatch_worker_t *w = dispatch_worker(pool, TVL_DispatchWorkerOf(pool, ctx, interface));
+    if (!w) return false;
+
+    dispatch_lock(w);
+    if (w->count >= TVLCOM_DISPATCH_QUEUE_DEPTH || length > TVLCOM_DISPATCH_SLOT_DATA) {
+        w->stats.rejected++;
+        dispatch_unlock(w);
+        return false;
+    }
+    tvl_dispatch_slot_t *s = &w->slots[(w->head + w->count) % TVLCOM_DISPATCH_QUEUE_DEPTH];
+    s->ctx = ctx;
+    s->frame_id = frame_id;
+    s->interface = (uint8_t)interface;
+    s->length = length;
+    memcpy(s->data, data, length);
+    w->count++;
+    w->stats.queued++;
+    if (w->count > w->stats.high_water) w->stats.high_water = w->count;
+    dispatch_unlock(w);
+
+    dispatch_signal(w);
+    return true;
+}
+
+uint16_t TVL_DispatchRunOnce(tvl_dispatch_t *pool, uint8_t worker, uint16_t max_frames)
+{
+    tvl_dispatch_worker_t *w = dispatch_worker(pool, worker);
+    if (!w) return 0;
+
+    uint16_t done = 0;
+    while (done < max_frames) {
+        dispatch_lock(w);
+        tvl_dispatch_slot_t *s = w->count ? &w->slots[w->head] : NULL;
+        dispatch_unlock(w);
+        if (!s) break;
+
+        /* Slot still counted: producers can't reuse it while the handlers run */
+        FloatReceive_ProcessFrameCtx(s->ctx, s->frame_id, s->data, s->length, (tlv_interface_t)s->interface);
+
+        dispatch_lock(w);
+        w->head = (uint16_t)((w->head + 1u) % TVLCOM_DISPATCH_QUEUE_DEPTH);
+        w->count--;
+        w->stats.handled++;
+        dispatch_unlock(w);
+        done++;
+    }
+    return done;
+}
+
+uint16_t TVL_DispatchRun(tvl_dispatch_t *pool, uint8_t worker, uint32_t timeout_ms)
+{
+    tvl_dispatch_worker_t *w = dispatch_worker(pool, worker);
+    if (!w) return 0;
+
+    uint16_t done = TVL_DispatchRunOnce(pool, worker, UINT16_MAX);
+    if (done) return done;
+
+    const tvl_hal_vtable_t *hal = TVL_HAL_Get();
+    if (w->wake && hal && hal->event_wait) {
+        (void)hal->event_wait(w->wake, timeout_ms);
+    } else if (hal && hal->sleep_ms && timeout_ms) {
+        hal->sleep_ms(1u); /* no event: poll */
+    }
+    return TVL_DispatchRunOnce(pool, worker, UINT16_MAX);
+}
+
+void TVL_DispatchWake(tvl_dispatch_t *pool, uint8_t worker)
+{
+    tvl_dispatch_worker_t *w = dispatch_worker(pool, worker);
+    if (w) dispatch_signal(w);
+}
+
+void TVL_DispatchGetStats(tvl_dispatch_t *pool, uint8_t worker, tvl_dispatch_stats_t *stats)
+{
+    if (!stats) return;
+    memset(stats, 0, sizeof(*stats));
+    tvl_dispatch_worker_t *w = dispatch_worker(pool, worker);
+    if (!w) return;
+    dispatch_lock(w);
+    *stats = w->stats;
+    stats->pending = w->count;
+    dispatch_unlock(w);
+}
+
+/* USER CODE END 1 */
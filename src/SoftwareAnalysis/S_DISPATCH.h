@@ -0,0 +1,159 @@
+/* USER CODE BEGIN Header */
+/**
+ ******************************************************************************
+ * @file           : S_DISPATCH.h
+ * @brief          : Worker-pool handler dispatch with per-interface ordering.
+ * @author         : UF4OVER
+ * @date           : 2026-02-05
+ ******************************************************************************
+ * @attention
+ *
+ * By default FloatReceive_FrameCallback() runs every handler on the thread
+ * that feeds the parser, so a slow handler stalls byte ingestion. With a
+ * dispatch pool attached (FloatReceive_SetDispatchCtx), the parse thread only
+ * frames and CRC-checks: each valid frame is copied into the bounded queue of
+ * one worker and the worker later runs the handlers and sends the ACK/NACK,
+ * following the same policy as synchronous dispatch (coalescing,
+ * piggybacking, duplicate cache, best-effort frames).
+ *
+ * Ordering:
+ * - All frames of one (context, interface) pair go to the same worker, so
+ *   they are handled in arrival order. Different links may run in parallel.
+ *
+ * Back-pressure:
+ * - A frame that finds its worker's queue full is NACKed so the sender
+ *   retransmits it later. A frame larger than TVLCOM_DISPATCH_SLOT_DATA never
+ *   fits: its TLVs are NACKed with TLV_STATUS_TOO_LARGE and the sender's
+ *   reliable window fails it without retrying. Best-effort and ACK-only
+ *   frames are dropped. All are counted as rejected.
+ *
+ * Workers:
+ * - The application owns the threads/tasks: one per worker, each looping
+ *   TVL_DispatchRun(pool, index, timeout). Idle workers sleep on the HAL event
+ *   (event_* in hal.h) or, without one, poll with sleep_ms(1).
+ * - Queues are guarded by the optional HAL mutex; each worker's queue must be
+ *   drained by exactly one thread.
+ *
+ * The pool is a plain struct (no heap) and can be allocated statically.
+ *
+ ******************************************************************************
+ */
+/* USER CODE END Header */
+/* Define to prevent recursive inclusion -------------------------------------*/
+
+#ifndef STM32F407_LM5175_S_DISPATCH_H
+#define STM32F407_LM5175_S_DISPATCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdbool.h>
+#include "stdint.h"
+/* USER CODE BEGIN Includes */
+
+#include "GLOBAL_CONFIG.h"
+#include "S_TLV_PROTOCOL.h"
+#include "HAL/hal.h"
+
+/* USER CODE END Includes */
+
+/* Exported types ------------------------------------------------------------*/
+/* USER CODE BEGIN ET */
+
+/* Per-link protocol state, defined in S_CONTEXT.h */
+typedef struct tvl_context tvl_context_t;
+
+/* One queued frame (data copied out of the parser) */
+typedef struct {
+    tvl_context_t *ctx;
+    uint16_t length;
+    uint8_t frame_id;
+    uint8_t interface;
+    uint8_t data[TVLCOM_DISPATCH_SLOT_DATA];
+} tvl_dispatch_slot_t;
+
+/* Worker counters (see TVL_DispatchGetStats) */
+typedef struct {
+    uint32_t queued;        /* frames accepted into the queue */
+    uint32_t handled;       /* frames handed to the handlers */
+    uint32_t rejected;      /* queue full / frame too large: NACKed or dropped */
+    uint16_t pending;       /* frames waiting right now */
+    uint16_t high_water;    /* deepest the queue has been */
+} tvl_dispatch_stats_t;
+
+/* One worker's queue; cache-line aligned so workers don't false-share */
+typedef struct {
+    _Alignas(TVLCOM_CACHE_LINE) tvl_hal_mutex_t lock;
+    tvl_hal_event_t wake;
+    uint16_t head;          /* next slot to handle */
+    uint16_t count;         /* queued, including the one being handled */
+    tvl_dispatch_stats_t stats;
+    tvl_dispatch_slot_t slots[TVLCOM_DISPATCH_QUEUE_DEPTH];
+} tvl_dispatch_worker_t;
+
+typedef struct tvl_dispatch {
+    uint8_t worker_count;
+    tvl_dispatch_worker_t workers[TVLCOM_DISPATCH_MAX_WORKERS];
+} tvl_dispatch_t;
+
+/* USER CODE END ET */
+
+/* Exported functions prototypes ---------------------------------------------*/
+/* USER CODE BEGIN EFP */
+
+/**
+ * @brief Initialise a pool with 'workers' queues (clamped to 1..TVLCOM_DISPATCH_MAX_WORKERS).
+ *
+ * Creates the HAL mutex/event of each worker when the HAL provides them.
+ */
+void TVL_DispatchInit(tvl_dispatch_t *pool, uint8_t workers);
+
+/**
+ * @brief Release the HAL objects. Stop the worker threads and detach the pool
+ *        from its contexts first; frames still queued are discarded.
+ */
+void TVL_DispatchDeinit(tvl_dispatch_t *pool);
+
+/**
+ * @brief Worker that handles frames of (ctx, interface).
+ */
+uint8_t TVL_DispatchWorkerOf(const tvl_dispatch_t *pool, const tvl_context_t *ctx, tlv_interface_t interface);
+
+/**
+ * @brief Queue a copy of a validated frame for its worker (called by the receive layer).
+ * @return false if the queue is full or the frame exceeds TVLCOM_DISPATCH_SLOT_DATA.
+ */
+bool TVL_DispatchSubmit(tvl_dispatch_t *pool, tvl_context_t *ctx, uint8_t frame_id,
+                        const uint8_t *data, uint16_t length, tlv_interface_t interface);
+
+/**
+ * @brief Handle up to max_frames queued frames of one worker without waiting.
+ * @return Frames handled.
+ */
+uint16_t TVL_DispatchRunOnce(tvl_dispatch_t *pool, uint8_t worker, uint16_t max_frames);
+
+/**
+ * @brief Worker loop body: wait up to timeout_ms for frames, then handle everything queued.
+ * @return Frames handled.
+ */
+uint16_t TVL_DispatchRun(tvl_dispatch_t *pool, uint8_t worker, uint32_t timeout_ms);
+
+/**
+ * @brief Wake a worker blocked in TVL_DispatchRun() (e.g. to let its thread exit).
+ */
+void TVL_DispatchWake(tvl_dispatch_t *pool, uint8_t worker);
+
+/**
+ * @brief Snapshot of a worker's counters (zeroed for an invalid index).
+ */
+void TVL_DispatchGetStats(tvl_dispatch_t *pool, uint8_t worker, tvl_dispatch_stats_t *stats);
+
+/* USER CODE END EFP */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //STM32F407_LM5175_S_DISPATCH_H
@@ -0,0 +1,331 @@
+/**
+ ******************************************************************************
+ * @file           : S_FRAGMENT.c
+ * @brief          : Fragmentation/reassembly implementation.
+ * @author         : UF4OVER
+ * @date           : 2026-01-26
+ ******************************************************************************
+ * @attention
+ *
+ * See S_FRAGMENT.h for the wire layout and pool policy.
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "S_FRAGMENT.h"
+
+/* USER CODE BEGIN Includes */
+#include <string.h>
+#include "S_RECEIVE_PROTOCOL.h"
+#include "S_TRANSPORT_PROTOCOL.h"
+#include "HAL/hal.h"
+/* USER CODE END Includes */
+
+/* Private typedef -----------------------------------------------------------*/
+/* USER CODE BEGIN PTD */
+
+typedef enum {
+    FRAG_SLOT_FREE = 0,
+    FRAG_SLOT_FILLING,
+    FRAG_SLOT_DELIVERING,   /* buffer handed to the message handler, lock released */
+} frag_slot_state_t;
+
+typedef struct {
+    frag_slot_state_t state;
+    tlv_interface_t interface;
+    uint8_t msg_type;
+    uint8_t msg_id;
+    uint16_t count;
+    uint16_t received;
+    uint32_t total;
+    uint32_t last_tick;
+    uint8_t bitmap[(TVLCOM_FRAG_MAX_FRAGMENTS + 7) / 8];
+    uint8_t buffer[TVLCOM_FRAG_MAX_MESSAGE];
+} frag_slot_t;
+
+/* USER CODE END PTD */
+
+/* Private define ------------------------------------------------------------*/
+/* USER CODE BEGIN PD */
+
+#if TVLCOM_FRAG_POOL_SIZE < 1 || TVLCOM_FRAG_MAX_FRAGMENTS < 1
+#error "TVLCOM_FRAG_POOL_SIZE and TVLCOM_FRAG_MAX_FRAGMENTS must be at least 1"
+#endif
+
+/* USER CODE END PD */
+
+/* Private variables ---------------------------------------------------------*/
+/* USER CODE BEGIN PV */
+
+static frag_slot_t s_slots[TVLCOM_FRAG_POOL_SIZE];
+static fragment_message_handler_t s_message_handler = NULL;
+static uint8_t s_msg_id_counter = 0;
+
+/* Optional lock protecting the pool and the message id counter */
+static tvl_hal_mutex_t s_fragment_lock = NULL;
+
+/* USER CODE END PV */
+
+/* Private function prototypes -----------------------------------------------*/
+/* USER CODE BEGIN PFP */
+static bool fragment_on_tlv(const tlv_entry_t *entry, tlv_interface_t interface);
+/* USER CODE END PFP */
+
+/* Private user code ---------------------------------------------------------*/
+/* USER CODE BEGIN 0 */
+
+static void fragment_lock(void)
+{
+    const tvl_hal_vtable_t *hal = TVL_HAL_Get();
+    if (s_fragment_lock && hal && hal->mutex_lock) hal->mutex_lock(s_fragment_lock);
+}
+
+static void fragment_unlock(void)
+{
+    const tvl_hal_vtable_t *hal = TVL_HAL_Get();
+    if (s_fragment_lock && hal && hal->mutex_unlock) hal->mutex_unlock(s_fragment_lock);
+}
+
+static uint32_t fragment_now(void)
+{
+    const tvl_hal_vtable_t *hal = TVL_HAL_Get();
+    return (hal && hal->tick_ms) ? hal->tick_ms() : 0u;
+}
+
+static uint16_t get_le16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get_le32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void put_le16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put_le32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+/* Payload bytes of every fragment but the last */
+static uint32_t fragment_chunk(uint32_t total, uint16_t count)
+{
+    return (total + count - 1u) / count;
+}
+
+/* Caller holds the lock */
+static void fragment_evict_expired(uint32_t now)
+{
+    for (uint8_t i = 0; i < TVLCOM_FRAG_POOL_SIZE; ++i) {
+        frag_slot_t *s = &s_slots[i];
+        if (s->state == FRAG_SLOT_FILLING && (uint32_t)(now - s->last_tick) >= TVLCOM_FRAG_TIMEOUT_MS) {
+            s->state = FRAG_SLOT_FREE;
+        }
+    }
+}
+
+/* Caller holds the lock. Returns the slot for this message, claiming a free one if needed. */
+static frag_slot_t *fragment_find_slot(tlv_interface_t interface, uint8_t msg_type, uint8_t msg_id,
+                                       uint16_t count, uint32_t total)
+{
+    frag_slot_t *free_slot = NULL;
+    for (uint8_t i = 0; i < TVLCOM_FRAG_POOL_SIZE; ++i) {
+        frag_slot_t *s = &s_slots[i];
+        if (s->state == FRAG_SLOT_FREE) {
+            if (!free_slot) free_slot = s;
+            continue;
+        }
+        if (s->state == FRAG_SLOT_FILLING && s->interface == interface &&
+            s->msg_type == msg_type && s->msg_id == msg_id) {
+            if (s->count == count && s->total == total) {
+                return s;
+            }
+            /* Same id, different shape: the sender moved on (id wrapped), restart */
+            free_slot = s;
+            break;
+        }
+    }
+    if (free_slot) {
+        free_slot->state = FRAG_SLOT_FILLING;
+        free_slot->interface = interface;
+        free_slot->msg_type = msg_type;
+        free_slot->msg_id = msg_id;
+        free_slot->count = count;
+        free_slot->received = 0;
+        free_slot->total = total;
+        memset(free_slot->bitmap, 0, sizeof(free_slot->bitmap));
+    }
+    return free_slot;
+}
+
+static bool fragment_on_tlv(const tlv_entry_t *entry, tlv_interface_t interface)
+{
+    if (!entry || !entry->value || entry->length < FRAGMENT_HEADER_SIZE) return false;
+
+    const uint8_t *v = entry->value;
+    uint8_t msg_type = v[0];
+    uint8_t msg_id = v[1];
+    uint16_t index = get_le16(&v[2]);
+    uint16_t count = get_le16(&v[4]);
+    uint32_t total = get_le32(&v[6]);
+    const uint8_t *payload = &v[FRAGMENT_HEADER_SIZE];
+    uint16_t payload_len = (uint16_t)(entry->length - FRAGMENT_HEADER_SIZE);
+
+    if (count == 0 || index >= count) return false;
+
+    /* Single-fragment message: hand the parser buffer straight to the handler */
+    if (count == 1) {
+        if (payload_len != total) return false;
+        fragment_lock();
+        fragment_message_handler_t fn = s_message_handler;
+        fragment_unlock();
+        return fn ? fn(msg_type, msg_id, payload, total, interface) : true;
+    }
+
+    if (total < count) return false;
+    uint32_t chunk = fragment_chunk(total, count);
+    uint32_t offset = (uint32_t)index * chunk;
+    if (offset >= total) return false;
+    uint32_t expected = total - offset;
+    if (expected > chunk) expected = chunk;
+    if (payload_len != expected) return false;
+
+    if (count > TVLCOM_FRAG_MAX_FRAGMENTS || total > TVLCOM_FRAG_MAX_MESSAGE) return false;
+
+    fragment_lock();
+    uint32_t now = fragment_now();
+    fragment_evict_expired(now);
+    frag_slot_t *s = fragment_find_slot(interface, msg_type, msg_id, count, total);
+    if (!s) {
+        fragment_unlock();
+        return false; /* pool exhausted: NACK, the sender may retry later */
+    }
+    s->last_tick = now;
+
+    uint8_t bit = (uint8_t)(1u << (index & 7u));
+    if (s->bitmap[index >> 3] & bit) {
+        fragment_unlock();
+        return true; /* duplicate (e.g. our ACK was lost): already stored */
+    }
+    memcpy(&s->buffer[offset], payload, payload_len);
+    s->bitmap[index >> 3] |= bit;
+    s->received = (uint16_t)(s->received + 1);
+    if (s->received < s->count) {
+        fragment_unlock();
+        return true;
+    }
+
+    s->state = FRAG_SLOT_DELIVERING;
+    fragment_message_handler_t fn = s_message_handler;
+    fragment_unlock();
+
+    bool ok = fn ? fn(msg_type, msg_id, s->buffer, total, interface) : true;
+
+    fragment_lock();
+    if (ok) {
+        s->state = FRAG_SLOT_FREE;
+    } else {
+        /* Keep the message; the NACKed fragment's resend completes it again */
+        s->bitmap[index >> 3] &= (uint8_t)~bit;
+        s->received = (uint16_t)(s->received - 1);
+        s->last_tick = fragment_now();
+        s->state = FRAG_SLOT_FILLING;
+    }
+    fragment_unlock();
+    return ok;
+}
+
+/* USER CODE END 0 */
+
+/* Exported functions --------------------------------------------------------*/
+/* USER CODE BEGIN 1 */
+
+void Fragment_Init(void)
+{
+    const tvl_hal_vtable_t *hal = TVL_HAL_Get();
+    if (!s_fragment_lock && hal && hal->mutex_create) {
+        s_fragment_lock = hal->mutex_create();
+    }
+
+    fragment_lock();
+    for (uint8_t i = 0; i < TVLCOM_FRAG_POOL_SIZE; ++i) {
+        s_slots[i].state = FRAG_SLOT_FREE;
+    }
+    fragment_unlock();
+
+    FloatReceive_RegisterTLVHandler(TLV_TYPE_FRAGMENT, fragment_on_tlv);
+}
+
+void Fragment_RegisterHandler(fragment_message_handler_t handler)
+{
+    fragment_lock();
+    s_message_handler = handler;
+    fragment_unlock();
+}
+
+bool Fragment_Send(tlv_interface_t interface, uint8_t msg_type, const uint8_t *data, uint32_t length)
+{
+    if (!data && length) return false;
+
+    uint32_t count32 = (length + FRAGMENT_MAX_PAYLOAD - 1u) / FRAGMENT_MAX_PAYLOAD;
+    if (count32 == 0) count32 = 1;
+    if (count32 > 0xFFFFu) return false;
+    uint16_t count = (uint16_t)count32;
+    uint32_t chunk = fragment_chunk(length, count);
+
+    fragment_lock();
+    uint8_t msg_id = s_msg_id_counter++;
+    fragment_unlock();
+
+    uint8_t value[FRAGMENT_HEADER_SIZE + FRAGMENT_MAX_PAYLOAD];
+    value[0] = msg_type;
+    value[1] = msg_id;
+    put_le16(&value[4], count);
+    put_le32(&value[6], length);
+
+    uint32_t offset = 0;
+    for (uint16_t index = 0; index < count; ++index) {
+        uint32_t n = length - offset;
+        if (n > chunk) n = chunk;
+        put_le16(&value[2], index);
+        if (n) memcpy(&value[FRAGMENT_HEADER_SIZE], &data[offset], n);
+
+        tlv_entry_t entry;
+        TLV_CreateRawEntry(TLV_TYPE_FRAGMENT, value, (uint16_t)(FRAGMENT_HEADER_SIZE + n), &entry);
+        if (!Transport_SendTLVs(interface, Transport_NextFrameId(), &entry, 1)) {
+            return false;
+        }
+        offset += n;
+    }
+    return true;
+}
+
+void Fragment_Poll(void)
+{
+    fragment_lock();
+    fragment_evict_expired(fragment_now());
+    fragment_unlock();
+}
+
+uint8_t Fragment_PendingCount(void)
+{
+    uint8_t n = 0;
+    fragment_lock();
+    for (uint8_t i = 0; i < TVLCOM_FRAG_POOL_SIZE; ++i) {
+        if (s_slots[i].state != FRAG_SLOT_FREE) n++;
+    }
+    fragment_unlock();
+    return n;
+}
+
+/* USER CODE END 1 */
@@ -0,0 +1,129 @@
+/* USER CODE BEGIN Header */
+/**
+ ******************************************************************************
+ * @file           : S_FRAGMENT.h
+ * @brief          : Fragmentation/reassembly of messages larger than one frame.
+ * @author         : UF4OVER
+ * @date           : 2026-01-26
+ ******************************************************************************
+ * @attention
+ *
+ * A message (e.g. a DEVICE_ESPFU firmware chunk or a long DEVICE_NAME/config
+ * blob) is split into frames that each carry one TLV_TYPE_FRAGMENT TLV:
+ *
+ *   [MsgType 1B][MsgId 1B][Index 2B][Count 2B][Total 4B][Payload]
+ *
+ * Multi-byte fields are little-endian (PROTOCOL.md 4.2). Every fragment
+ * except the last carries exactly ceil(Total / Count) payload bytes, so the
+ * receiver can place fragments arriving in any order without extra fields.
+ *
+ * Sending goes through Transport_SendTLVs(); receiving hooks into
+ * FloatReceive_FrameCallback() as a regular TLV type handler, so each
+ * fragment frame is ACKed/NACKed like any other frame.
+ *
+ * Reassembly uses a fixed pool of TVLCOM_FRAG_POOL_SIZE buffers
+ * (GLOBAL_CONFIG.h). A partial message that receives nothing for
+ * TVLCOM_FRAG_TIMEOUT_MS (HAL tick_ms) is dropped; when the pool is full,
+ * fragments of new messages are NACKed.
+ *
+ * Thread-safety:
+ * - The pool is protected by the optional HAL mutex. The message handler runs
+ *   without the lock held.
+ *
+ ******************************************************************************
+ */
+/* Define to prevent recursive inclusion -------------------------------------*/
+
+#ifndef STM32F407_LM5175_S_FRAGMENT_H
+#define STM32F407_LM5175_S_FRAGMENT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdbool.h>
+#include "stdint.h"
+/* USER CODE BEGIN Includes */
+
+#include "S_TLV_PROTOCOL.h"
+
+/* USER CODE END Includes */
+
+/* Exported types ------------------------------------------------------------*/
+/* USER CODE BEGIN ET */
+
+/**
+ * Complete message notification.
+ *
+ * 'data' points into the reassembly pool (or, for single-fragment messages,
+ * into the parser buffer) and is only valid during the call.
+ * Return false to NACK the frame that completed the message; the message stays
+ * in the pool (subject to TVLCOM_FRAG_TIMEOUT_MS) and is delivered again when
+ * that fragment is resent.
+ */
+typedef bool (*fragment_message_handler_t)(uint8_t msg_type, uint8_t msg_id,
+                                           const uint8_t *data, uint32_t length,
+                                           tlv_interface_t interface);
+
+/* USER CODE END ET */
+
+/* Exported constants --------------------------------------------------------*/
+/* USER CODE BEGIN EC */
+
+#define FRAGMENT_HEADER_SIZE       10
+
+/* Payload bytes per fragment: one TLV_TYPE_FRAGMENT filling a classic frame */
+#define FRAGMENT_MAX_PAYLOAD       (TLV_MAX_DATA_LENGTH - 2 - FRAGMENT_HEADER_SIZE)
+
+/* USER CODE END EC */
+
+/* Exported functions prototypes ---------------------------------------------*/
+/* USER CODE BEGIN EFP */
+
+/**
+ * @brief Register the TLV_TYPE_FRAGMENT handler with the receiver and reset the pool.
+ *
+ * Call after FloatReceive_Init().
+ */
+void Fragment_Init(void);
+
+/**
+ * @brief Register the complete-message handler (NULL to drop messages).
+ */
+void Fragment_RegisterHandler(fragment_message_handler_t handler);
+
+/**
+ * @brief Split a message into fragment frames and send them in order.
+ *
+ * Each fragment uses its own frame id (Transport_NextFrameId()).
+ * Fragments are not retransmitted here; NACKed ones must be resent by the caller.
+ *
+ * @param interface Interface to send via.
+ * @param msg_type  Application type of the message (e.g. DEVICE_ESPFU).
+ * @param data      Message bytes.
+ * @param length    Message length; at most 0xFFFF * FRAGMENT_MAX_PAYLOAD.
+ * @return true if every fragment was handed to the transport.
+ */
+bool Fragment_Send(tlv_interface_t interface, uint8_t msg_type, const uint8_t *data, uint32_t length);
+
+/**
+ * @brief Drop partial messages idle for TVLCOM_FRAG_TIMEOUT_MS.
+ *
+ * Expired messages are also dropped whenever a fragment arrives; call this
+ * from an idle loop to free the pool when the link goes quiet.
+ */
+void Fragment_Poll(void);
+
+/**
+ * @brief Number of pool buffers currently holding a partial message.
+ */
+uint8_t Fragment_PendingCount(void);
+
+/* USER CODE END EFP */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // STM32F407_LM5175_S_FRAGMENT_H
@@ -19,6 +19,8 @@
 /* USER CODE BEGIN Includes */
 #include <string.h>
 #include "S_TRANSPORT_PROTOCOL.h"
+#include "S_CONTEXT.h"
+#include "S_DISPATCH.h"
 #include "HAL/hal.h"
 /* USER CODE END Includes */
 
@@ -28,13 +30,22 @@
 /* Private typedef -----------------------------------------------------------*/
 /* USER CODE BEGIN PTD */
 
+/* Handler tables, ACK batches and duplicate cache entries live in tvl_context_t (S_CONTEXT.h) */
+
 /* USER CODE END PTD */
 
 /* Private define ------------------------------------------------------------*/
 /* USER CODE BEGIN PD */
 
-#define MAX_TLV_TYPE_HANDLERS 32
-#define MAX_CMD_HANDLERS      32
+#define RECEIVE_INTERFACE_COUNT TVL_CONTEXT_INTERFACES
+#define MAX_FRAME_TLVS          16
+
+#if TVLCOM_DUP_CACHE_SIZE & (TVLCOM_DUP_CACHE_SIZE - 1)
+#error "TVLCOM_DUP_CACHE_SIZE must be 0 or a power of two"
+#endif
+
+#define DUP_EMPTY  0
+#define DUP_ACKED  1
 
 /* USER CODE END PD */
 
@@ -46,51 +57,78 @@
 /* Private variables ---------------------------------------------------------*/
 /* USER CODE BEGIN PV */
 
-static tlv_parser_t uart_parser;
-static tlv_parser_t usb_parser;
-
-static tlv_type_handler_t tlv_type_handlers[MAX_TLV_TYPE_HANDLERS];
-static uint8_t tlv_type_ids[MAX_TLV_TYPE_HANDLERS];
-static uint8_t tlv_type_handler_count = 0;
-
-static cmd_handler_t cmd_handlers[MAX_CMD_HANDLERS];
-static uint8_t cmd_ids[MAX_CMD_HANDLERS];
-static uint8_t cmd_handler_count = 0;
-
-static ack_notify_t s_ack_handler = NULL;
-static ack_notify_t s_nack_handler = NULL;
-
-/* Optional lock to protect handler registry in multi-thread / ISR contexts */
-static tvl_hal_mutex_t s_receive_lock = NULL;
+/* All receive state is per context (tvl_context_t rx_* fields) */
 
 /* USER CODE END PV */
 
 /* Private function prototypes -----------------------------------------------*/
 /* USER CODE BEGIN PFP */
-static bool dispatch_tlv_entries(uint8_t frame_id, tlv_entry_t *entries, uint8_t count, tlv_interface_t interface);
+static bool dispatch_tlv_entries(tvl_context_t *ctx, tlv_entry_t *entries, uint8_t count,
+                                 tlv_interface_t interface, tlv_nack_info_t *nack);
+static void queue_ack(tvl_context_t *ctx, uint8_t frame_id, tlv_interface_t interface);
+static void update_ack_policy(tvl_context_t *ctx);
 /* USER CODE END PFP */
 
 /* Private user code ---------------------------------------------------------*/
 /* USER CODE BEGIN 0 */
 
+static void receive_lock(tvl_context_t *ctx)
+{
+    const tvl_hal_vtable_t *hal = TVL_HAL_Get();
+    if (ctx->rx_lock && hal && hal->mutex_lock) hal->mutex_lock(ctx->rx_lock);
+}
+
+static void receive_unlock(tvl_context_t *ctx)
+{
+    const tvl_hal_vtable_t *hal = TVL_HAL_Get();
+    if (ctx->rx_lock && hal && hal->mutex_unlock) hal->mutex_unlock(ctx->rx_lock);
+}
+
+/* tlv_frame_callback_ex_t / tlv_error_callback_ex_t: parser->user is the owning context */
+static void receive_on_frame(void *user, uint8_t frame_id, const uint8_t *data, uint16_t length,
+                             tlv_interface_t interface)
+{
+    FloatReceive_FrameCallbackCtx((tvl_context_t *)user, frame_id, data, length, interface);
+}
+
+static void receive_on_error(void *user, uint8_t frame_id, tlv_interface_t interface, tlv_error_t error)
+{
+    FloatReceive_ErrorCallbackCtx((tvl_context_t *)user, frame_id, interface, error);
+}
+
 /**
  * @brief Initialize TLV receiver
  * @param interface Communication interface type (UART or USB)
  */
-void FloatReceive_Init(tlv_interface_t interface)
+void FloatReceive_InitCtx(tvl_context_t *ctx, tlv_interface_t interface)
 {
     const tvl_hal_vtable_t *hal = TVL_HAL_Get();
-    if (!s_receive_lock && hal && hal->mutex_create) {
-        s_receive_lock = hal->mutex_create();
+    if (!ctx->rx_lock && hal && hal->mutex_create) {
+        ctx->rx_lock = hal->mutex_create();
     }
-
-    if (interface == TLV_INTERFACE_UART) {
-        TLV_InitParser(&uart_parser, TLV_INTERFACE_UART, FloatReceive_FrameCallback);
-        TLV_SetErrorCallback(&uart_parser, FloatReceive_ErrorCallback);
-    } else if (interface == TLV_INTERFACE_USB) {
-        TLV_InitParser(&usb_parser, TLV_INTERFACE_USB, FloatReceive_FrameCallback);
-        TLV_SetErrorCallback(&usb_parser, FloatReceive_ErrorCallback);
+    if ((unsigned)interface >= RECEIVE_INTERFACE_COUNT) {
+        return;
     }
+
+#if TVLCOM_DUP_CACHE_SIZE
+    receive_lock(ctx);
+    memset(ctx->rx_dup_cache[interface], 0, sizeof(ctx->rx_dup_cache[interface]));
+    receive_unlock(ctx);
+#endif
+
+    tlv_parser_t *p = &ctx->rx_parsers[interface];
+    TLV_InitParser(p, interface, NULL);
+    TLV_SetCallbacksEx(p, receive_on_frame, receive_on_error, ctx);
+}
+
+void FloatReceive_Init(tlv_interface_t interface)
+{
+    FloatReceive_InitCtx(TVL_ContextDefault(), interface);
+}
+
+tlv_parser_t* FloatReceive_GetParserCtx(tvl_context_t *ctx, tlv_interface_t interface)
+{
+    return ((unsigned)interface < RECEIVE_INTERFACE_COUNT) ? &ctx->rx_parsers[interface] : NULL;
 }
 
 /**
@@ -98,7 +136,7 @@ void FloatReceive_Init(tlv_interface_t interface)
  */
 tlv_parser_t* FloatReceive_GetUARTParser(void)
 {
-    return &uart_parser;
+    return FloatReceive_GetParserCtx(TVL_ContextDefault(), TLV_INTERFACE_UART);
 }
 
 /**
@@ -106,31 +144,59 @@ tlv_parser_t* FloatReceive_GetUARTParser(void)
  */
 tlv_parser_t* FloatReceive_GetUSBParser(void)
 {
-    return &usb_parser;
+    return FloatReceive_GetParserCtx(TVL_ContextDefault(), TLV_INTERFACE_USB);
 }
 
 /**
  * @brief Send ACK frame
  */
-void FloatReceive_SendAck(uint8_t frame_id, tlv_interface_t interface)
+void FloatReceive_SendAckCtx(tvl_context_t *ctx, uint8_t frame_id, tlv_interface_t interface)
 {
     uint8_t ack_frame[20];
     uint16_t ack_size;
 
     TLV_BuildAckFrame(frame_id, ack_frame, &ack_size);
-    Transport_Send(interface, ack_frame, ack_size);
+    Transport_SendCtx(ctx, interface, ack_frame, ack_size);
+}
+
+void FloatReceive_SendAck(uint8_t frame_id, tlv_interface_t interface)
+{
+    FloatReceive_SendAckCtx(TVL_ContextDefault(), frame_id, interface);
 }
 
 /**
  * @brief Send NACK frame
  */
-void FloatReceive_SendNack(uint8_t frame_id, tlv_interface_t interface)
+void FloatReceive_SendNackCtx(tvl_context_t *ctx, uint8_t frame_id, tlv_interface_t interface)
 {
     uint8_t nack_frame[20];
     uint16_t nack_size;
 
     TLV_BuildNackFrame(frame_id, nack_frame, &nack_size);
-    Transport_Send(interface, nack_frame, nack_size);
+    Transport_SendCtx(ctx, interface, nack_frame, nack_size);
+}
+
+void FloatReceive_SendNack(uint8_t frame_id, tlv_interface_t interface)
+{
+    FloatReceive_SendNackCtx(TVL_ContextDefault(), frame_id, interface);
+}
+
+/**
+ * @brief Send selective NACK frame
+ */
+void FloatReceive_SendNackExCtx(tvl_context_t *ctx, const tlv_nack_info_t *nack, tlv_interface_t interface)
+{
+    uint8_t nack_frame[TLV_OVERHEAD_SIZE + 2 + 1 + 3 * TLV_NACK_MAX_ITEMS];
+    uint16_t nack_size;
+
+    if (TLV_BuildNackFrameEx(nack, nack_frame, &nack_size)) {
+        Transport_SendCtx(ctx, interface, nack_frame, nack_size);
+    }
+}
+
+void FloatReceive_SendNackEx(const tlv_nack_info_t *nack, tlv_interface_t interface)
+{
+    FloatReceive_SendNackExCtx(TVL_ContextDefault(), nack, interface);
 }
 
 /**
@@ -139,176 +205,742 @@ void FloatReceive_SendNack(uint8_t frame_id, tlv_interface_t interface)
  * Current policy: any parser error results in immediate NACK.
  * The 'error' parameter can be used for diagnostics/logging.
  */
-void FloatReceive_ErrorCallback(uint8_t frame_id, tlv_interface_t interface, tlv_error_t error)
+void FloatReceive_ErrorCallbackCtx(tvl_context_t *ctx, uint8_t frame_id, tlv_interface_t interface, tlv_error_t error)
 {
     (void)error;
     /* On parser error, immediately NACK */
-    FloatReceive_SendNack(frame_id, interface);
+    FloatReceive_SendNackCtx(ctx, frame_id, interface);
 }
 
-/**
- * @brief TLV帧回调——接收到有效帧时调用
+void FloatReceive_ErrorCallback(uint8_t frame_id, tlv_interface_t interface, tlv_error_t error)
+{
+    FloatReceive_ErrorCallbackCtx(TVL_ContextDefault(), frame_id, interface, error);
+}
+
+static bool is_ack_type(uint8_t type)
+{
+    return type == TLV_TYPE_ACK || type == TLV_TYPE_NACK || type == TLV_TYPE_ACK_BITMAP;
+}
+
+static uint32_t receive_now(void)
+{
+    const tvl_hal_vtable_t *hal = TVL_HAL_Get();
+    return (hal && hal->tick_ms) ? hal->tick_ms() : 0u;
+}
+
+/* Size of the ACK TLV value take_ack_batch() would produce */
+static uint8_t ack_batch_value_length(const tvl_ack_batch_t *b)
+{
+    return (b->count == 1) ? 1u : (uint8_t)(1u + (b->max_offset >> 3) + 1u);
+}
+
+/*
+ * Caller holds ctx->rx_lock. Moves the batch into one ACK TLV value:
+ * a lone id as a plain TLV_TYPE_ACK, several as TLV_TYPE_ACK_BITMAP ([base][bitmap]).
+ * Returns the value length.
  */
-void FloatReceive_FrameCallback(uint8_t frame_id, const uint8_t *data, uint8_t length, tlv_interface_t interface)
+static uint8_t take_ack_batch(tvl_ack_batch_t *b, uint8_t *type, uint8_t *value)
 {
-    tlv_entry_t tlv_entries[16];
-    uint8_t tlv_count = TLV_ParseData(data, length, tlv_entries, 16);
+    uint8_t len = ack_batch_value_length(b);
+    value[0] = b->base;
+    if (b->count == 1) {
+        *type = TLV_TYPE_ACK;
+    } else {
+        *type = TLV_TYPE_ACK_BITMAP;
+        memcpy(&value[1], b->bitmap, (size_t)(len - 1u));
+    }
+    memset(b->bitmap, 0, sizeof(b->bitmap));
+    b->count = 0;
+    b->max_offset = 0;
+    return len;
+}
+
+static void send_ack_batch(tvl_context_t *ctx, uint8_t type, const uint8_t *value, uint8_t len,
+                           tlv_interface_t interface)
+{
+    tlv_entry_t e;
+    uint8_t frame[TLV_OVERHEAD_SIZE + 2 + 33];
+    uint16_t size = 0;
+    TLV_CreateRawEntry(type, value, len, &e);
+    if (TLV_BuildFrame(0 /* reply frame id policy: 0 */, &e, 1, frame, &size)) {
+        Transport_SendCtx(ctx, interface, frame, size);
+    }
+}
+
+/* Caller holds ctx->rx_lock. Adds one id to the batch (no-op when already pending) */
+static void ack_batch_add(tvl_ack_batch_t *b, uint8_t frame_id, uint32_t now)
+{
+    if (b->count == 0) {
+        b->base = frame_id;
+        b->first_tick = now;
+    }
+    uint8_t off = (uint8_t)(frame_id - b->base);
+    uint8_t bit = (uint8_t)(1u << (off & 7u));
+    if (!(b->bitmap[off >> 3] & bit)) {
+        b->bitmap[off >> 3] |= bit;
+        b->count++;
+        if (off > b->max_offset) b->max_offset = off;
+    }
+}
+
+/* Queue an ACK, flushing the batch when the count threshold or deadline is reached */
+static void queue_ack(tvl_context_t *ctx, uint8_t frame_id, tlv_interface_t interface)
+{
+    receive_lock(ctx);
+
+    if (ctx->rx_ack_flush_count == 0 || (unsigned)interface >= RECEIVE_INTERFACE_COUNT) {
+        receive_unlock(ctx);
+        FloatReceive_SendAckCtx(ctx, frame_id, interface);
+        return;
+    }
+
+    tvl_ack_batch_t *b = &ctx->rx_ack_batch[interface];
+    uint32_t now = receive_now();
+    ack_batch_add(b, frame_id, now);
+
+    uint8_t type = 0;
+    uint8_t value[33];
+    uint8_t len = 0;
+    if (b->count >= ctx->rx_ack_flush_count || (uint32_t)(now - b->first_tick) >= ctx->rx_ack_flush_delay_ms) {
+        len = take_ack_batch(b, &type, value);
+    }
+    receive_unlock(ctx);
+
+    if (len) send_ack_batch(ctx, type, value, len, interface);
+}
+
+/* Caller holds ctx->rx_lock */
+static void update_ack_policy(tvl_context_t *ctx)
+{
+    bool coalesce = (ctx->rx_ack_coalesce_count > 1);
+    if (ctx->rx_ack_piggyback) {
+        ctx->rx_ack_flush_count = coalesce ? ctx->rx_ack_coalesce_count : 255u;
+        ctx->rx_ack_flush_delay_ms = (coalesce && ctx->rx_ack_coalesce_delay_ms < ctx->rx_ack_piggyback_deadline_ms)
+                                   ? ctx->rx_ack_coalesce_delay_ms : ctx->rx_ack_piggyback_deadline_ms;
+    } else {
+        ctx->rx_ack_flush_count = coalesce ? ctx->rx_ack_coalesce_count : 0u;
+        ctx->rx_ack_flush_delay_ms = ctx->rx_ack_coalesce_delay_ms;
+    }
+}
+
+/* transport_ack_source_ctx_t: hand the pending batch to Transport_SendTLVsCtx() */
+static uint8_t take_piggyback_acks(tvl_context_t *ctx, tlv_interface_t interface,
+                                   uint8_t *type, uint8_t *value, uint8_t max_len)
+{
+    if ((unsigned)interface >= RECEIVE_INTERFACE_COUNT) return 0;
+
+    receive_lock(ctx);
+
+    tvl_ack_batch_t *b = &ctx->rx_ack_batch[interface];
+    uint8_t len = 0;
+    if (b->count && ack_batch_value_length(b) <= max_len) {
+        len = take_ack_batch(b, type, value);
+    }
+
+    receive_unlock(ctx);
+    return len;
+}
+
+/*
+ * transport_ack_restore_ctx_t: the frame carrying a batch from take_piggyback_acks()
+ * was not sent; merge its ids back so the next frame, poll or flush still acknowledges them.
+ */
+static void restore_piggyback_acks(tvl_context_t *ctx, tlv_interface_t interface,
+                                   uint8_t type, const uint8_t *value, uint8_t len)
+{
+    if ((unsigned)interface >= RECEIVE_INTERFACE_COUNT || len == 0) return;
+
+    receive_lock(ctx);
+
+    tvl_ack_batch_t *b = &ctx->rx_ack_batch[interface];
+    uint32_t now = receive_now();
+    if (type == TLV_TYPE_ACK) {
+        ack_batch_add(b, value[0], now);
+    } else if (type == TLV_TYPE_ACK_BITMAP) {
+        for (uint16_t i = 1; i < len; ++i) {
+            for (uint8_t k = 0; k < 8u; ++k) {
+                if (value[i] & (1u << k)) ack_batch_add(b, (uint8_t)(value[0] + (i - 1u) * 8u + k), now);
+            }
+        }
+    }
+
+    receive_unlock(ctx);
+}
+
+/* Pass every id acknowledged by a TLV_TYPE_ACK_BITMAP entry to the transport and the ACK handler */
+static void fan_out_ack_bitmap(tvl_context_t *ctx, const tlv_entry_t *e, ack_notify_t on_ack,
+                               tlv_interface_t interface)
+{
+    uint8_t base = e->value[0];
+    for (uint16_t i = 1; i < e->length && i <= 32u; ++i) {
+        uint8_t bits = e->value[i];
+        for (uint8_t k = 0; bits; ++k, bits >>= 1) {
+            if (bits & 1u) {
+                uint8_t id = (uint8_t)(base + (i - 1u) * 8u + k);
+                Transport_HandleAckCtx(ctx, id, interface);
+                if (on_ack) on_ack(id, interface);
+            }
+        }
+    }
+}
+
+/* Report one ACK/NACK TLV (ACK-only frame or piggybacked on a data frame) */
+static void notify_ack_entry(tvl_context_t *ctx, const tlv_entry_t *e, tlv_interface_t interface)
+{
+    if (e->length < 1) return;
+
+    receive_lock(ctx);
+    ack_notify_t on_ack = ctx->rx_ack_handler;
+    ack_notify_t on_nack = ctx->rx_nack_handler;
+    nack_detail_notify_t on_detail = ctx->rx_nack_detail_handler;
+    receive_unlock(ctx);
+
+    uint8_t original_id = e->value[0];
+    if (e->type == TLV_TYPE_ACK) {
+        Transport_HandleAckCtx(ctx, original_id, interface);
+        if (on_ack) on_ack(original_id, interface);
+    } else if (e->type == TLV_TYPE_NACK) {
+        tlv_nack_info_t info;
+        (void)TLV_ParseNack(e, &info);
+        Transport_HandleNackExCtx(ctx, &info, interface);
+        if (on_nack) on_nack(original_id, interface);
+        if (on_detail) on_detail(&info, interface);
+    } else {
+        fan_out_ack_bitmap(ctx, e, on_ack, interface);
+    }
+}
+
+#if TVLCOM_DUP_CACHE_SIZE
+/* CRC of a delivered frame: taken from the parser that delivered it, recomputed otherwise */
+static uint16_t frame_crc(tvl_context_t *ctx, uint8_t frame_id, const uint8_t *data, uint16_t length,
+                          tlv_interface_t interface)
+{
+    const tlv_parser_t *p = &ctx->rx_parsers[interface];
+    const uint8_t *p_data = p->data_external ? p->data_external : p->data_storage;
+    if (p_data == data && p->frame_id == frame_id && p->data_length == length) {
+        return p->crc_received;
+    }
+    /* Same CRC the sender's TLV_BuildFrame() put on the wire */
+    uint8_t header[4] = { frame_id, (uint8_t)length, 0, 0 };
+    uint8_t header_len = 2;
+    if (length > TLV_MAX_DATA_LENGTH) {
+        header[1] = TLV_DATA_LEN_EXT;
+        header[2] = (uint8_t)(length >> 8);
+        header[3] = (uint8_t)length;
+        header_len = 4;
+    }
+    uint16_t crc = TLV_Crc16Update(TLV_Crc16Init(), header, header_len);
+    return TLV_Crc16Final(TLV_Crc16Update(crc, data, length));
+}
+
+/* Re-send the ACK of an already accepted frame; false if the frame is new */
+static bool dup_replay(tvl_context_t *ctx, uint8_t frame_id, uint16_t crc, tlv_interface_t interface)
+{
+    receive_lock(ctx);
+
+    const tvl_dup_entry_t *d = &ctx->rx_dup_cache[interface][frame_id & (TVLCOM_DUP_CACHE_SIZE - 1)];
+    bool acked = d->state == DUP_ACKED && d->frame_id == frame_id && d->crc == crc &&
+                 (uint32_t)(receive_now() - d->tick) < TVLCOM_DUP_CACHE_TIMEOUT_MS;
+
+    receive_unlock(ctx);
+
+    if (acked) {
+        queue_ack(ctx, frame_id, interface);
+    }
+    return acked;
+}
+
+/*
+ * Remember that frame_id was ACKed. NACKed frames are not cached: their
+ * retransmission is dispatched again, so a handler that failed transiently
+ * (e.g. TLV_STATUS_BUSY) gets another chance.
+ */
+static void dup_store(tvl_context_t *ctx, uint8_t frame_id, uint16_t crc, tlv_interface_t interface)
+{
+    receive_lock(ctx);
+
+    tvl_dup_entry_t *d = &ctx->rx_dup_cache[interface][frame_id & (TVLCOM_DUP_CACHE_SIZE - 1)];
+    d->state = DUP_ACKED;
+    d->frame_id = frame_id;
+    d->crc = crc;
+    d->tick = receive_now();
+
+    receive_unlock(ctx);
+}
+#endif
+
+static void receive_frame(tvl_context_t *ctx, uint8_t frame_id, const uint8_t *data, uint16_t length,
+                          tlv_interface_t interface)
+{
+    tlv_entry_t tlv_entries[MAX_FRAME_TLVS];
+    uint8_t tlv_count = TLV_ParseData(data, length, tlv_entries, MAX_FRAME_TLVS);
 
-    bool has_non_ack = false;
     bool all_ack_or_nack = true;
+    bool best_effort = false;
     for (uint8_t i = 0; i < tlv_count; i++) {
-        uint8_t t = tlv_entries[i].type;
-        if (t != TLV_TYPE_ACK && t != TLV_TYPE_NACK) {
-            has_non_ack = true;
-        }
-        if (t != TLV_TYPE_ACK && t != TLV_TYPE_NACK) {
+        if (!is_ack_type(tlv_entries[i].type)) {
             all_ack_or_nack = false;
         }
+        if (tlv_entries[i].type == TLV_TYPE_NO_ACK) {
+            best_effort = true;
+        }
     }
     if (tlv_count == 0) return;
 
-    if (all_ack_or_nack && !has_non_ack) {
+    if (all_ack_or_nack) {
         /* Notify upper layer but do not respond */
         for (uint8_t i = 0; i < tlv_count; ++i) {
-            const tlv_entry_t *e = &tlv_entries[i];
-            if (e->length >= 1) {
-                uint8_t original_id = e->value[0];
-                if (e->type == TLV_TYPE_ACK && s_ack_handler) s_ack_handler(original_id, interface);
-                else if (e->type == TLV_TYPE_NACK && s_nack_handler) s_nack_handler(original_id, interface);
-            }
+            notify_ack_entry(ctx, &tlv_entries[i], interface);
         }
         return;
     }
 
-    bool ok = dispatch_tlv_entries(frame_id, tlv_entries, tlv_count, interface);
+#if TVLCOM_DUP_CACHE_SIZE
+    /* Retransmission of a frame we already ACKed (our ACK was lost): ACK again, don't re-run handlers */
+    bool cached = !best_effort && (unsigned)interface < RECEIVE_INTERFACE_COUNT;
+    uint16_t crc = 0;
+    if (cached) {
+        crc = frame_crc(ctx, frame_id, data, length, interface);
+        if (dup_replay(ctx, frame_id, crc, interface)) return;
+    }
+#endif
+
+    tlv_nack_info_t nack;
+    nack.frame_id = frame_id;
+    nack.count = 0;
+    bool ok = dispatch_tlv_entries(ctx, tlv_entries, tlv_count, interface, &nack);
+    if (best_effort) {
+        return; /* dispatched, never answered */
+    }
+#if TVLCOM_DUP_CACHE_SIZE
+    if (cached && ok) dup_store(ctx, frame_id, crc, interface);
+#endif
     if (ok) {
-        FloatReceive_SendAck(frame_id, interface);
+        queue_ack(ctx, frame_id, interface);
     } else {
-        FloatReceive_SendNack(frame_id, interface);
+        FloatReceive_SendNackExCtx(ctx, &nack, interface);
     }
 }
 
-void FloatReceive_RegisterTLVHandler(uint8_t type, tlv_type_handler_t handler)
+/*
+ * Not queued for the dispatch pool, unless nobody would retransmit:
+ * - queue full: plain NACK, the sender retransmits later;
+ * - frame over TVLCOM_DISPATCH_SLOT_DATA: it never fits, so every data TLV is
+ *   NACKed with TLV_STATUS_TOO_LARGE and the sender gives up instead of retrying.
+ */
+static void receive_reject(tvl_context_t *ctx, uint8_t frame_id, const uint8_t *data, uint16_t length,
+                           tlv_interface_t interface)
 {
-    const tvl_hal_vtable_t *hal = TVL_HAL_Get();
-    if (s_receive_lock && hal && hal->mutex_lock) hal->mutex_lock(s_receive_lock);
+    tlv_entry_t tlv_entries[MAX_FRAME_TLVS];
+    uint8_t tlv_count = TLV_ParseData(data, length, tlv_entries, MAX_FRAME_TLVS);
+    tlv_nack_info_t nack;
+    nack.frame_id = frame_id;
+    nack.count = 0;
+    bool answer = false;
+    for (uint8_t i = 0; i < tlv_count; i++) {
+        if (tlv_entries[i].type == TLV_TYPE_NO_ACK) return;
+        if (is_ack_type(tlv_entries[i].type)) continue;
+        answer = true;
+        if (nack.count < TLV_NACK_MAX_ITEMS) {
+            nack.items[nack.count].index = i;
+            nack.items[nack.count].type = tlv_entries[i].type;
+            nack.items[nack.count].status = TLV_STATUS_TOO_LARGE;
+            nack.count++;
+        }
+    }
+    if (!answer) return;
+    if (length > TVLCOM_DISPATCH_SLOT_DATA) {
+        FloatReceive_SendNackExCtx(ctx, &nack, interface);
+    } else {
+        FloatReceive_SendNackCtx(ctx, frame_id, interface);
+    }
+}
 
-    uint8_t i;
-    for (i = 0; i < tlv_type_handler_count; i++) {
-        if (tlv_type_ids[i] == type) {
-            tlv_type_handlers[i] = handler;
-            if (s_receive_lock && hal && hal->mutex_unlock) hal->mutex_unlock(s_receive_lock);
-            return;
+void FloatReceive_ProcessFrameCtx(tvl_context_t *ctx, uint8_t frame_id, const uint8_t *data, uint16_t length,
+                                  tlv_interface_t interface)
+{
+    /* Handlers may ask TVL_ContextCurrent() which link they are serving */
+    tvl_context_t *prev = TVL_ContextSwapCurrent(ctx);
+    receive_frame(ctx, frame_id, data, length, interface);
+    (void)TVL_ContextSwapCurrent(prev);
+}
+
+/**
+ * @brief TLV帧回调——接收到有效帧时调用
+ */
+void FloatReceive_FrameCallbackCtx(tvl_context_t *ctx, uint8_t frame_id, const uint8_t *data, uint16_t length,
+                                   tlv_interface_t interface)
+{
+    tvl_dispatch_t *pool = ctx->rx_dispatch;
+    if (pool) {
+        if (!TVL_DispatchSubmit(pool, ctx, frame_id, data, length, interface)) {
+            receive_reject(ctx, frame_id, data, length, interface);
         }
+        return;
     }
-    if (tlv_type_handler_count < MAX_TLV_TYPE_HANDLERS) {
-        tlv_type_ids[tlv_type_handler_count] = type;
-        tlv_type_handlers[tlv_type_handler_count] = handler;
-        tlv_type_handler_count = (uint8_t)(tlv_type_handler_count + 1);
+    FloatReceive_ProcessFrameCtx(ctx, frame_id, data, length, interface);
+}
+
+void FloatReceive_FrameCallback(uint8_t frame_id, const uint8_t *data, uint16_t length, tlv_interface_t interface)
+{
+    FloatReceive_FrameCallbackCtx(TVL_ContextDefault(), frame_id, data, length, interface);
+}
+
+/* Slot for 'type', or NULL (compact tables: no page yet and !create, or pages exhausted) */
+static tvl_type_slot_t *type_slot(tvl_handler_registry_t *r, uint8_t type, bool create)
+{
+#if TVLCOM_DISPATCH_COMPACT
+    uint8_t page = r->type_page_of[type >> 4];
+    if (page == 0) {
+        if (!create || r->type_pages_used >= TVLCOM_DISPATCH_PAGES) return NULL;
+        page = ++r->type_pages_used;
+        r->type_page_of[type >> 4] = page;
     }
+    return &r->type_pages[page - 1][type & (TVL_DISPATCH_PAGE_SIZE - 1)];
+#else
+    (void)create;
+    return &r->types[type];
+#endif
+}
 
-    if (s_receive_lock && hal && hal->mutex_unlock) hal->mutex_unlock(s_receive_lock);
+/* Same as type_slot() for command handlers */
+static cmd_handler_t *cmd_slot(tvl_handler_registry_t *r, uint8_t command, bool create)
+{
+#if TVLCOM_DISPATCH_COMPACT
+    uint8_t page = r->cmd_page_of[command >> 4];
+    if (page == 0) {
+        if (!create || r->cmd_pages_used >= TVLCOM_DISPATCH_PAGES) return NULL;
+        page = ++r->cmd_pages_used;
+        r->cmd_page_of[command >> 4] = page;
+    }
+    return &r->cmd_pages[page - 1][command & (TVL_DISPATCH_PAGE_SIZE - 1)];
+#else
+    (void)create;
+    return &r->cmds[command];
+#endif
 }
 
-void FloatReceive_RegisterCmdHandler(uint8_t command, cmd_handler_t handler)
+/*
+ * Pin the current registry for a lookup. Lock-free build: no lock, the snapshot
+ * stays untouched until registry_unpin(). Otherwise takes ctx->rx_lock.
+ */
+static tvl_handler_registry_t *registry_pin(tvl_context_t *ctx, unsigned *idx)
 {
-    const tvl_hal_vtable_t *hal = TVL_HAL_Get();
-    if (s_receive_lock && hal && hal->mutex_lock) hal->mutex_lock(s_receive_lock);
+#if TVLCOM_REGISTRY_LOCKFREE
+    for (;;) {
+        unsigned i = atomic_load(&ctx->rx_registry_active);
+        atomic_fetch_add(&ctx->rx_registry_readers[i], 1u);
+        if (atomic_load(&ctx->rx_registry_active) == i) {
+            *idx = i;
+            return &ctx->rx_registry[i];
+        }
+        /* a writer swapped in between: it may be rewriting snapshot i, retry */
+        atomic_fetch_sub(&ctx->rx_registry_readers[i], 1u);
+    }
+#else
+    receive_lock(ctx);
+    *idx = 0;
+    return &ctx->rx_registry[0];
+#endif
+}
 
-    uint8_t i;
-    for (i = 0; i < cmd_handler_count; i++) {
-        if (cmd_ids[i] == command) {
-            cmd_handlers[i] = handler;
-            if (s_receive_lock && hal && hal->mutex_unlock) hal->mutex_unlock(s_receive_lock);
-            return;
+static void registry_unpin(tvl_context_t *ctx, unsigned idx)
+{
+#if TVLCOM_REGISTRY_LOCKFREE
+    atomic_fetch_sub_explicit(&ctx->rx_registry_readers[idx], 1u, memory_order_release);
+#else
+    (void)idx;
+    receive_unlock(ctx);
+#endif
+}
+
+/* Busy polls of a pinned snapshot before the writer starts sleeping between polls */
+#define REGISTRY_SPIN_LIMIT 64u
+
+/*
+ * Caller holds ctx->rx_lock (serialises writers). Returns the registry to modify:
+ * the inactive snapshot, refreshed from the active one once its last reader left
+ * (grace period; readers only stay pinned for a table lookup).
+ * A reader preempted while pinned may have a lower priority than the writer
+ * (RTOS): after a short spin the writer sleeps through the HAL so it can finish.
+ */
+static tvl_handler_registry_t *registry_begin_update(tvl_context_t *ctx)
+{
+#if TVLCOM_REGISTRY_LOCKFREE
+    unsigned cur = atomic_load(&ctx->rx_registry_active);
+    unsigned next = cur ^ 1u;
+    const tvl_hal_vtable_t *hal = TVL_HAL_Get();
+    for (unsigned spins = 0;
+         atomic_load_explicit(&ctx->rx_registry_readers[next], memory_order_acquire) != 0u; spins++) {
+        /* a reader pinned the old snapshot just before the previous swap */
+        if (spins >= REGISTRY_SPIN_LIMIT && hal && hal->sleep_ms) {
+            hal->sleep_ms(1);
         }
     }
-    if (cmd_handler_count < MAX_CMD_HANDLERS) {
-        cmd_ids[cmd_handler_count] = command;
-        cmd_handlers[cmd_handler_count] = handler;
-        cmd_handler_count = (uint8_t)(cmd_handler_count + 1);
+    memcpy(&ctx->rx_registry[next], &ctx->rx_registry[cur], sizeof(ctx->rx_registry[next]));
+    return &ctx->rx_registry[next];
+#else
+    return &ctx->rx_registry[0];
+#endif
+}
+
+/* Caller holds ctx->rx_lock. Publish the registry returned by registry_begin_update(). */
+static void registry_publish(tvl_context_t *ctx)
+{
+#if TVLCOM_REGISTRY_LOCKFREE
+    atomic_store(&ctx->rx_registry_active, atomic_load(&ctx->rx_registry_active) ^ 1u);
+#else
+    (void)ctx;
+#endif
+}
+
+/* Store either a bool handler or a status handler for 'type' (the other one is cleared) */
+static void register_type_handler(tvl_context_t *ctx, uint8_t type, tlv_type_handler_t handler,
+                                  tlv_status_handler_t status_handler)
+{
+    receive_lock(ctx);
+
+    tvl_handler_registry_t *r = registry_begin_update(ctx);
+    tvl_type_slot_t *slot = type_slot(r, type, handler || status_handler);
+    if (slot) {
+        slot->fn = handler;
+        slot->status_fn = status_handler;
+    }
+    registry_publish(ctx);
+
+    receive_unlock(ctx);
+}
+
+void FloatReceive_RegisterTLVHandlerCtx(tvl_context_t *ctx, uint8_t type, tlv_type_handler_t handler)
+{
+    register_type_handler(ctx, type, handler, NULL);
+}
+
+void FloatReceive_RegisterTLVHandler(uint8_t type, tlv_type_handler_t handler)
+{
+    register_type_handler(TVL_ContextDefault(), type, handler, NULL);
+}
+
+void FloatReceive_RegisterTLVStatusHandlerCtx(tvl_context_t *ctx, uint8_t type, tlv_status_handler_t handler)
+{
+    register_type_handler(ctx, type, NULL, handler);
+}
+
+void FloatReceive_RegisterTLVStatusHandler(uint8_t type, tlv_status_handler_t handler)
+{
+    register_type_handler(TVL_ContextDefault(), type, NULL, handler);
+}
+
+void FloatReceive_RegisterCmdHandlerCtx(tvl_context_t *ctx, uint8_t command, cmd_handler_t handler)
+{
+    receive_lock(ctx);
+
+    tvl_handler_registry_t *r = registry_begin_update(ctx);
+    cmd_handler_t *slot = cmd_slot(r, command, handler != NULL);
+    if (slot) {
+        *slot = handler;
     }
+    registry_publish(ctx);
 
-    if (s_receive_lock && hal && hal->mutex_unlock) hal->mutex_unlock(s_receive_lock);
+    receive_unlock(ctx);
+}
+
+void FloatReceive_RegisterCmdHandler(uint8_t command, cmd_handler_t handler)
+{
+    FloatReceive_RegisterCmdHandlerCtx(TVL_ContextDefault(), command, handler);
+}
+
+void FloatReceive_RegisterAckHandlerCtx(tvl_context_t *ctx, ack_notify_t handler)
+{
+    receive_lock(ctx);
+    ctx->rx_ack_handler = handler;
+    receive_unlock(ctx);
 }
 
 void FloatReceive_RegisterAckHandler(ack_notify_t handler)
 {
-    const tvl_hal_vtable_t *hal = TVL_HAL_Get();
-    if (s_receive_lock && hal && hal->mutex_lock) hal->mutex_lock(s_receive_lock);
-    s_ack_handler = handler;
-    if (s_receive_lock && hal && hal->mutex_unlock) hal->mutex_unlock(s_receive_lock);
+    FloatReceive_RegisterAckHandlerCtx(TVL_ContextDefault(), handler);
+}
+
+void FloatReceive_RegisterNackHandlerCtx(tvl_context_t *ctx, ack_notify_t handler)
+{
+    receive_lock(ctx);
+    ctx->rx_nack_handler = handler;
+    receive_unlock(ctx);
 }
 
 void FloatReceive_RegisterNackHandler(ack_notify_t handler)
 {
-    const tvl_hal_vtable_t *hal = TVL_HAL_Get();
-    if (s_receive_lock && hal && hal->mutex_lock) hal->mutex_lock(s_receive_lock);
-    s_nack_handler = handler;
-    if (s_receive_lock && hal && hal->mutex_unlock) hal->mutex_unlock(s_receive_lock);
+    FloatReceive_RegisterNackHandlerCtx(TVL_ContextDefault(), handler);
 }
 
-static bool handle_control_cmd(const tlv_entry_t *entry, tlv_interface_t interface)
+void FloatReceive_RegisterNackDetailHandlerCtx(tvl_context_t *ctx, nack_detail_notify_t handler)
 {
-    if (entry->length < 1 || entry->value == NULL) return false;
-    uint8_t cmd = entry->value[0];
+    receive_lock(ctx);
+    ctx->rx_nack_detail_handler = handler;
+    receive_unlock(ctx);
+}
 
-    const tvl_hal_vtable_t *hal = TVL_HAL_Get();
-    if (s_receive_lock && hal && hal->mutex_lock) hal->mutex_lock(s_receive_lock);
+void FloatReceive_RegisterNackDetailHandler(nack_detail_notify_t handler)
+{
+    FloatReceive_RegisterNackDetailHandlerCtx(TVL_ContextDefault(), handler);
+}
 
-    uint8_t i;
-    for (i = 0; i < cmd_handler_count; i++) {
-        if (cmd_ids[i] == cmd && cmd_handlers[i]) {
-            cmd_handler_t fn = cmd_handlers[i];
-            if (s_receive_lock && hal && hal->mutex_unlock) hal->mutex_unlock(s_receive_lock);
-            return fn(cmd, interface);
-        }
+void FloatReceive_SetAckCoalescingCtx(tvl_context_t *ctx, uint8_t max_count, uint32_t max_delay_ms)
+{
+    for (uint8_t i = 0; i < RECEIVE_INTERFACE_COUNT; ++i) {
+        FloatReceive_FlushAcksCtx(ctx, (tlv_interface_t)i); /* don't strand ACKs queued under the old policy */
+    }
+
+    receive_lock(ctx);
+    ctx->rx_ack_coalesce_count = max_count;
+    ctx->rx_ack_coalesce_delay_ms = max_delay_ms;
+    update_ack_policy(ctx);
+    receive_unlock(ctx);
+}
+
+void FloatReceive_SetAckCoalescing(uint8_t max_count, uint32_t max_delay_ms)
+{
+    FloatReceive_SetAckCoalescingCtx(TVL_ContextDefault(), max_count, max_delay_ms);
+}
+
+void FloatReceive_SetAckPiggybackCtx(tvl_context_t *ctx, bool enable, uint32_t deadline_ms)
+{
+    for (uint8_t i = 0; i < RECEIVE_INTERFACE_COUNT; ++i) {
+        FloatReceive_FlushAcksCtx(ctx, (tlv_interface_t)i);
     }
 
-    if (s_receive_lock && hal && hal->mutex_unlock) hal->mutex_unlock(s_receive_lock);
-    return false; /* no handler */
+    receive_lock(ctx);
+    ctx->rx_ack_piggyback = enable;
+    ctx->rx_ack_piggyback_deadline_ms = deadline_ms;
+    update_ack_policy(ctx);
+    receive_unlock(ctx);
+
+    Transport_SetAckRestoreCtx(ctx, enable ? restore_piggyback_acks : NULL);
+    Transport_SetAckSourceCtx(ctx, enable ? take_piggyback_acks : NULL);
 }
 
-static bool dispatch_tlv_entries(uint8_t frame_id, tlv_entry_t *entries, uint8_t count, tlv_interface_t interface)
+void FloatReceive_SetAckPiggyback(bool enable, uint32_t deadline_ms)
+{
+    FloatReceive_SetAckPiggybackCtx(TVL_ContextDefault(), enable, deadline_ms);
+}
+
+void FloatReceive_FlushAcksCtx(tvl_context_t *ctx, tlv_interface_t interface)
+{
+    if ((unsigned)interface >= RECEIVE_INTERFACE_COUNT) return;
+
+    receive_lock(ctx);
+    uint8_t type = 0;
+    uint8_t value[33];
+    uint8_t len = 0;
+    if (ctx->rx_ack_batch[interface].count) {
+        len = take_ack_batch(&ctx->rx_ack_batch[interface], &type, value);
+    }
+    receive_unlock(ctx);
+
+    if (len) send_ack_batch(ctx, type, value, len, interface);
+}
+
+void FloatReceive_FlushAcks(tlv_interface_t interface)
+{
+    FloatReceive_FlushAcksCtx(TVL_ContextDefault(), interface);
+}
+
+void FloatReceive_PollCtx(tvl_context_t *ctx)
+{
+    uint32_t now = receive_now();
+    for (uint8_t i = 0; i < RECEIVE_INTERFACE_COUNT; ++i) {
+        receive_lock(ctx);
+        tvl_ack_batch_t *b = &ctx->rx_ack_batch[i];
+        bool due = b->count && (uint32_t)(now - b->first_tick) >= ctx->rx_ack_flush_delay_ms;
+        receive_unlock(ctx);
+        if (due) FloatReceive_FlushAcksCtx(ctx, (tlv_interface_t)i);
+    }
+}
+
+void FloatReceive_Poll(void)
+{
+    FloatReceive_PollCtx(TVL_ContextDefault());
+}
+
+void FloatReceive_SetDispatchCtx(tvl_context_t *ctx, tvl_dispatch_t *pool)
+{
+    ctx->rx_dispatch = pool;
+}
+
+void FloatReceive_SetDispatch(tvl_dispatch_t *pool)
+{
+    FloatReceive_SetDispatchCtx(TVL_ContextDefault(), pool);
+}
+
+static uint8_t handle_control_cmd(const tlv_entry_t *entry, cmd_handler_t fn, tlv_interface_t interface)
+{
+    if (entry->length < 1 || entry->value == NULL) return TLV_STATUS_BAD_VALUE;
+    if (!fn) return TLV_STATUS_UNKNOWN_TYPE; /* no handler */
+    return fn(entry->value[0], interface) ? TLV_STATUS_OK : TLV_STATUS_FAILED;
+}
+
+/* Run the handler registered for e->type and return its TLV_STATUS_* */
+static uint8_t handle_typed_entry(const tlv_entry_t *e, const tvl_type_slot_t *slot, tlv_interface_t interface)
+{
+    if (slot->status_fn) return slot->status_fn(e, interface);
+    if (slot->fn) return slot->fn(e, interface) ? TLV_STATUS_OK : TLV_STATUS_FAILED;
+    return TLV_STATUS_UNKNOWN_TYPE;
+}
+
+/* Dispatch every TLV; failed ones are listed in 'nack' (index, type, status) */
+static bool dispatch_tlv_entries(tvl_context_t *ctx, tlv_entry_t *entries, uint8_t count,
+                                 tlv_interface_t interface, tlv_nack_info_t *nack)
 {
-    (void)frame_id;
     bool all_ok = true;
+    tvl_type_slot_t targets[MAX_FRAME_TLVS];
+    cmd_handler_t cmd_targets[MAX_FRAME_TLVS];
 
-    const tvl_hal_vtable_t *hal = TVL_HAL_Get();
+    if (count > MAX_FRAME_TLVS) count = MAX_FRAME_TLVS;
 
+    /* Resolve every handler under one registry pin; handlers then run unpinned */
+    unsigned idx;
+    tvl_handler_registry_t *r = registry_pin(ctx, &idx);
     uint8_t i;
     for (i = 0; i < count; i++) {
         const tlv_entry_t *e = &entries[i];
-
-        if (e->type == TLV_TYPE_ACK || e->type == TLV_TYPE_NACK) {
-            /* treat as handled, but outer logic avoids responding */
-            continue;
+        targets[i].fn = NULL;
+        targets[i].status_fn = NULL;
+        cmd_targets[i] = NULL;
+        if (e->type == TLV_TYPE_CONTROL_CMD) {
+            const cmd_handler_t *c = (e->length >= 1 && e->value) ? cmd_slot(r, e->value[0], false) : NULL;
+            if (c) cmd_targets[i] = *c;
+        } else {
+            const tvl_type_slot_t *t = type_slot(r, e->type, false);
+            if (t) targets[i] = *t;
         }
+    }
+    registry_unpin(ctx, idx);
 
-        if (e->type == TLV_TYPE_CONTROL_CMD) {
-            bool ok = handle_control_cmd(e, interface);
-            all_ok = all_ok && ok;
+    for (i = 0; i < count; i++) {
+        const tlv_entry_t *e = &entries[i];
+
+        if (is_ack_type(e->type)) {
+            /* piggybacked on a data frame: report it, the frame itself is answered for its data */
+            notify_ack_entry(ctx, e, interface);
             continue;
         }
 
-        /* Try custom type handler first */
-        bool handled = false;
-
-        if (s_receive_lock && hal && hal->mutex_lock) hal->mutex_lock(s_receive_lock);
-        uint8_t j;
-        for (j = 0; j < tlv_type_handler_count; j++) {
-            if (tlv_type_ids[j] == e->type && tlv_type_handlers[j]) {
-                tlv_type_handler_t fn = tlv_type_handlers[j];
-                if (s_receive_lock && hal && hal->mutex_unlock) hal->mutex_unlock(s_receive_lock);
-                handled = fn(e, interface);
-                goto done_one;
-            }
+        if (e->type == TLV_TYPE_NO_ACK) {
+            continue; /* delivery flag, not data */
         }
-        if (s_receive_lock && hal && hal->mutex_unlock) hal->mutex_unlock(s_receive_lock);
 
-done_one:
-        if (!handled) {
+        uint8_t status = (e->type == TLV_TYPE_CONTROL_CMD)
+                       ? handle_control_cmd(e, cmd_targets[i], interface)
+                       : handle_typed_entry(e, &targets[i], interface);
+        if (status != TLV_STATUS_OK) {
             all_ok = false; /* unknown or failed */
+            if (nack->count < TLV_NACK_MAX_ITEMS) {
+                tlv_nack_item_t *it = &nack->items[nack->count++];
+                it->index = i;
+                it->type = e->type;
+                it->status = status;
+            }
         }
     }
     return all_ok;
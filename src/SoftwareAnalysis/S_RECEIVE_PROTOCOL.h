@@ -14,14 +14,26 @@
  * - Dispatches TLVs to registered type handlers / control cmd handlers.
  * - Applies ACK/NACK policy:
  *   - If all non-ACK/NACK TLVs are handled successfully => send ACK for received frame_id.
- *   - Otherwise => send NACK.
+ *   - Otherwise => send NACK listing each failed TLV (index, type, TLV_STATUS_*).
  *   - If the received frame contains only ACK/NACK TLVs, it will NOT respond (prevents storms).
+ *   - ACK/NACK TLVs piggybacked on a data frame are reported, the frame is answered for its data.
+ *   - Frames flagged with TLV_TYPE_NO_ACK (best-effort) are dispatched but never answered.
+ *   - A retransmitted frame (same frame_id and CRC as one ACKed within
+ *     TVLCOM_DUP_CACHE_TIMEOUT_MS) is ACKed again; handlers do not run twice.
+ *     A NACKed frame is not cached: its retransmission is dispatched again.
  *
  * Lifetime rules:
  * - tlv_entry_t.value points into an internal parser buffer; copy out if you need persistence.
  *
  * Thread-safety:
- * - This module uses optional HAL mutex to protect handler tables when available.
+ * - Handler lookups are lock-free (TVLCOM_REGISTRY_LOCKFREE): Register* publishes a new
+ *   copy of the handler tables, so several RX threads can dispatch concurrently. Handlers
+ *   are resolved once per frame; a registration takes effect from the next frame.
+ * - Register* calls, ACK batching and the duplicate cache use the optional HAL mutex.
+ *
+ * Multiple links:
+ * - All state above lives in a tvl_context_t (S_CONTEXT.h). Each function has a
+ *   *Ctx variant taking the context first; the plain functions use TVL_ContextDefault().
  *
  ******************************************************************************
  */
@@ -47,9 +59,18 @@ extern "C" {
 /* USER CODE BEGIN ET */
 
 typedef bool (*tlv_type_handler_t)(const tlv_entry_t *entry, tlv_interface_t interface);
+/* Like tlv_type_handler_t, but reports why a TLV was rejected (TLV_STATUS_OK on success) */
+typedef uint8_t (*tlv_status_handler_t)(const tlv_entry_t *entry, tlv_interface_t interface);
 typedef bool (*cmd_handler_t)(uint8_t command, tlv_interface_t interface);
 /* ACK/NACK notification (value carries original frame id) */
 typedef void (*ack_notify_t)(uint8_t original_frame_id, tlv_interface_t interface);
+/* NACK notification with the rejected TLV list (count 0 for a legacy NACK) */
+typedef void (*nack_detail_notify_t)(const tlv_nack_info_t *nack, tlv_interface_t interface);
+
+/* Per-link protocol state, defined in S_CONTEXT.h */
+typedef struct tvl_context tvl_context_t;
+/* Worker pool for asynchronous dispatch, defined in S_DISPATCH.h */
+typedef struct tvl_dispatch tvl_dispatch_t;
 
 /* USER CODE END ET */
 
@@ -108,6 +129,13 @@ void FloatReceive_SendAck(uint8_t frame_id, tlv_interface_t interface);
  */
 void FloatReceive_SendNack(uint8_t frame_id, tlv_interface_t interface);
 
+/**
+ * @brief Send a selective NACK listing the rejected TLVs of a received frame.
+ * @param nack      Frame id and rejected TLVs.
+ * @param interface Interface to send via.
+ */
+void FloatReceive_SendNackEx(const tlv_nack_info_t *nack, tlv_interface_t interface);
+
 /**
  * @brief TLV frame callback (wired into TLV parser).
  *
@@ -116,7 +144,27 @@ void FloatReceive_SendNack(uint8_t frame_id, tlv_interface_t interface);
  * @param length    Length of TLV data segment.
  * @param interface Interface this frame came from.
  */
-void FloatReceive_FrameCallback(uint8_t frame_id, const uint8_t *data, uint8_t length, tlv_interface_t interface);
+void FloatReceive_FrameCallback(uint8_t frame_id, const uint8_t *data, uint16_t length, tlv_interface_t interface);
+
+/**
+ * @brief Hand frames to a worker pool instead of running handlers on the parsing thread.
+ *
+ * With a pool attached, FloatReceive_FrameCallback() only queues a copy of the
+ * frame (S_DISPATCH.h); handlers and the ACK/NACK run when the worker calls
+ * FloatReceive_ProcessFrameCtx(). Frames of one interface keep their order.
+ * Set it while no bytes are being fed to the parsers.
+ *
+ * @param pool Initialised pool, or NULL for synchronous dispatch (default).
+ */
+void FloatReceive_SetDispatch(tvl_dispatch_t *pool);
+
+/**
+ * @brief Run handlers and answer a frame on the calling thread, ignoring any dispatch pool.
+ *
+ * Used by the dispatch workers; same as FloatReceive_FrameCallbackCtx() without a pool.
+ */
+void FloatReceive_ProcessFrameCtx(tvl_context_t *ctx, uint8_t frame_id, const uint8_t *data, uint16_t length,
+                                  tlv_interface_t interface);
 
 /**
  * @brief Parser error callback.
@@ -138,6 +186,15 @@ void FloatReceive_ErrorCallback(uint8_t frame_id, tlv_interface_t interface, tlv
  */
 void FloatReceive_RegisterTLVHandler(uint8_t type, tlv_type_handler_t handler);
 
+/**
+ * @brief Register a TLV type handler that returns a status code.
+ *
+ * Return TLV_STATUS_OK when handled; any other TLV_STATUS_* value (or an
+ * application code >= TLV_STATUS_USER) rejects the TLV and is reported to the
+ * sender in the frame's NACK. Replaces a bool handler registered for the same type.
+ */
+void FloatReceive_RegisterTLVStatusHandler(uint8_t type, tlv_status_handler_t handler);
+
 /**
  * @brief Register a control command handler.
  *
@@ -148,7 +205,8 @@ void FloatReceive_RegisterCmdHandler(uint8_t command, cmd_handler_t handler);
 /**
  * @brief Register ACK notification handler.
  *
- * When a received frame contains only ACK TLV(s), this handler is notified with original frame id.
+ * When a received frame contains only ACK TLV(s), this handler is notified with original frame id
+ * (once per id for a coalesced TLV_TYPE_ACK_BITMAP). The id is first passed to Transport_HandleAck() to complete reliable sends.
  */
 void FloatReceive_RegisterAckHandler(ack_notify_t handler);
 
@@ -156,9 +214,82 @@ void FloatReceive_RegisterAckHandler(ack_notify_t handler);
  * @brief Register NACK notification handler.
  *
  * When a received frame contains only NACK TLV(s), this handler is notified with original frame id.
+ * The id is first passed to Transport_HandleNack() to retransmit reliable sends.
  */
 void FloatReceive_RegisterNackHandler(ack_notify_t handler);
 
+/**
+ * @brief Coalesce ACKs into one TLV_TYPE_ACK_BITMAP frame per flush.
+ *
+ * Accepted frames are acknowledged in batches: the batch is sent once it holds
+ * max_count ids, or once its oldest id has waited max_delay_ms (checked on the
+ * next accepted frame and by FloatReceive_Poll()). NACKs are never delayed.
+ * The peer's receiver reports every id in the bitmap to s_ack_handler.
+ * A batch holding a single id is sent as a plain TLV_TYPE_ACK.
+ *
+ * @param max_count    Ids per ACK frame; 0 or 1 restores the default one-ACK-per-frame.
+ * @param max_delay_ms Longest time an ACK may be held (HAL tick_ms).
+ */
+void FloatReceive_SetAckCoalescing(uint8_t max_count, uint32_t max_delay_ms);
+
+/**
+ * @brief Piggyback ACKs on outgoing data frames.
+ *
+ * Accepted frames are not acknowledged right away: the next Transport_SendTLVs()
+ * on the same interface carries the pending ids as one extra ACK (or
+ * TLV_TYPE_ACK_BITMAP) TLV. If nothing is sent within deadline_ms, a standalone
+ * ACK frame goes out (checked on the next accepted frame and by FloatReceive_Poll()).
+ * Combines with FloatReceive_SetAckCoalescing(): the shorter delay wins.
+ *
+ * @param enable      true to piggyback, false for standalone ACKs.
+ * @param deadline_ms Longest time an ACK waits for a data frame (HAL tick_ms).
+ */
+void FloatReceive_SetAckPiggyback(bool enable, uint32_t deadline_ms);
+
+/**
+ * @brief Send the pending coalesced ACKs of an interface now (no-op if none).
+ */
+void FloatReceive_FlushAcks(tlv_interface_t interface);
+
+/**
+ * @brief Flush held ACKs whose delay expired. Call periodically when coalescing/piggybacking is on.
+ */
+void FloatReceive_Poll(void);
+
+/**
+ * @brief Register NACK detail handler.
+ *
+ * Called after the NACK handler with the decoded NACK; pass it to
+ * Transport_ResendRejected() to resend only the rejected entries.
+ */
+void FloatReceive_RegisterNackDetailHandler(nack_detail_notify_t handler);
+
+/*
+ * Context variants: same behaviour as the functions above, applied to 'ctx'
+ * instead of TVL_ContextDefault(). Parsers initialised by FloatReceive_InitCtx()
+ * deliver their frames to FloatReceive_FrameCallbackCtx() for that context.
+ */
+void FloatReceive_InitCtx(tvl_context_t *ctx, tlv_interface_t interface);
+/* Parser bound to 'interface' in ctx (NULL for an unknown interface) */
+tlv_parser_t* FloatReceive_GetParserCtx(tvl_context_t *ctx, tlv_interface_t interface);
+void FloatReceive_SendAckCtx(tvl_context_t *ctx, uint8_t frame_id, tlv_interface_t interface);
+void FloatReceive_SendNackCtx(tvl_context_t *ctx, uint8_t frame_id, tlv_interface_t interface);
+void FloatReceive_SendNackExCtx(tvl_context_t *ctx, const tlv_nack_info_t *nack, tlv_interface_t interface);
+void FloatReceive_FrameCallbackCtx(tvl_context_t *ctx, uint8_t frame_id, const uint8_t *data, uint16_t length,
+                                   tlv_interface_t interface);
+void FloatReceive_ErrorCallbackCtx(tvl_context_t *ctx, uint8_t frame_id, tlv_interface_t interface, tlv_error_t error);
+void FloatReceive_RegisterTLVHandlerCtx(tvl_context_t *ctx, uint8_t type, tlv_type_handler_t handler);
+void FloatReceive_RegisterTLVStatusHandlerCtx(tvl_context_t *ctx, uint8_t type, tlv_status_handler_t handler);
+void FloatReceive_RegisterCmdHandlerCtx(tvl_context_t *ctx, uint8_t command, cmd_handler_t handler);
+void FloatReceive_RegisterAckHandlerCtx(tvl_context_t *ctx, ack_notify_t handler);
+void FloatReceive_RegisterNackHandlerCtx(tvl_context_t *ctx, ack_notify_t handler);
+void FloatReceive_RegisterNackDetailHandlerCtx(tvl_context_t *ctx, nack_detail_notify_t handler);
+void FloatReceive_SetAckCoalescingCtx(tvl_context_t *ctx, uint8_t max_count, uint32_t max_delay_ms);
+void FloatReceive_SetAckPiggybackCtx(tvl_context_t *ctx, bool enable, uint32_t deadline_ms);
+void FloatReceive_FlushAcksCtx(tvl_context_t *ctx, tlv_interface_t interface);
+void FloatReceive_PollCtx(tvl_context_t *ctx);
+void FloatReceive_SetDispatchCtx(tvl_context_t *ctx, tvl_dispatch_t *pool);
+
 /* USER CODE END EFP */
 
 /* Private defines -----------------------------------------------------------*/
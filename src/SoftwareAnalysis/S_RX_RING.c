@@ -0,0 +1,241 @@
+/**
+ ******************************************************************************
+ * @file           : S_RX_RING.c
+ * @brief          : Wait-free single-producer/single-consumer RX byte ring.
+ * @author         : UF4OVER
+ * @date           : 2026-02-08
+ ******************************************************************************
+ * @attention
+ *
+ * See S_RX_RING.h. head and tail count bytes since init and wrap at 2^32;
+ * head - tail is the fill level as long as size <= 2^31. The producer
+ * publishes bytes with a release store of head, the consumer frees space
+ * with a release store of tail; each side acquires the other's index only
+ * when its cached copy says full/empty.
+ *
+ * The counters are written by the producer alone (plain load + store, no
+ * read-modify-write), so they also work on cores without atomic RMW.
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "S_RX_RING.h"
+
+/* USER CODE BEGIN Includes */
+#include <string.h>
+/* USER CODE END Includes */
+
+/* Private define ------------------------------------------------------------*/
+/* USER CODE BEGIN PD */
+
+#if !TVLCOM_RX_RING_ATOMIC
+#if defined(__GNUC__) || defined(__clang__)
+#define RING_BARRIER() __asm__ volatile("" ::: "memory")
+#else
+#define RING_BARRIER() do { } while (0)
+#endif
+#endif
+
+/* USER CODE END PD */
+
+/* Private user code ---------------------------------------------------------*/
+/* USER CODE BEGIN 0 */
+
+#if TVLCOM_RX_RING_ATOMIC
+
+static inline uint32_t ring_load_acquire(tvl_rx_ring_index_t *p)
+{
+    return atomic_load_explicit(p, memory_order_acquire);
+}
+
+static inline uint32_t ring_load_relaxed(tvl_rx_ring_index_t *p)
+{
+    return atomic_load_explicit(p, memory_order_relaxed);
+}
+
+static inline void ring_store_release(tvl_rx_ring_index_t *p, uint32_t v)
+{
+    atomic_store_explicit(p, v, memory_order_release);
+}
+
+static inline void ring_store_relaxed(tvl_rx_ring_index_t *p, uint32_t v)
+{
+    atomic_store_explicit(p, v, memory_order_relaxed);
+}
+
+#else
+
+static inline uint32_t ring_load_acquire(tvl_rx_ring_index_t *p)
+{
+    uint32_t v = *p;
+    RING_BARRIER();
+    return v;
+}
+
+static inline uint32_t ring_load_relaxed(tvl_rx_ring_index_t *p)
+{
+    return *p;
+}
+
+static inline void ring_store_release(tvl_rx_ring_index_t *p, uint32_t v)
+{
+    RING_BARRIER();
+    *p = v;
+}
+
+static inline void ring_store_relaxed(tvl_rx_ring_index_t *p, uint32_t v)
+{
+    *p = v;
+}
+
+#endif
+
+/* Producer: free space, refreshing the cached tail only when the cached view is short */
+static uint32_t ring_free(tvl_rx_ring_t *ring, uint32_t head, uint32_t want)
+{
+    uint32_t size = ring->mask + 1u;
+    uint32_t free_bytes = size - (head - ring->tail_cache);
+    if (free_bytes < want) {
+        ring->tail_cache = ring_load_acquire(&ring->tail);
+        free_bytes = size - (head - ring->tail_cache);
+    }
+    return free_bytes;
+}
+
+/* Producer: the estimate from the cached tail only over-counts, so confirm before raising the mark */
+static void ring_note_level(tvl_rx_ring_t *ring, uint32_t head)
+{
+    uint32_t hw = ring_load_relaxed(&ring->high_water);
+    if (head - ring->tail_cache <= hw) return;
+    ring->tail_cache = ring_load_acquire(&ring->tail);
+    uint32_t used = head - ring->tail_cache;
+    if (used > hw) ring_store_relaxed(&ring->high_water, used);
+}
+
+static void ring_note_drop(tvl_rx_ring_t *ring, uint32_t lost)
+{
+    ring_store_relaxed(&ring->dropped, ring_load_relaxed(&ring->dropped) + lost);
+    ring_store_relaxed(&ring->overflows, ring_load_relaxed(&ring->overflows) + 1u);
+}
+
+/* USER CODE END 0 */
+
+/* Exported functions --------------------------------------------------------*/
+/* USER CODE BEGIN 1 */
+
+bool TVL_RxRingInit(tvl_rx_ring_t *ring, uint8_t *storage, uint32_t size)
+{
+    if (!ring || !storage || size < 2u || size > 0x80000000u || (size & (size - 1u)) != 0u) return false;
+    memset(ring, 0, sizeof(*ring));
+#if TVLCOM_RX_RING_ATOMIC
+    atomic_init(&ring->head, 0u);
+    atomic_init(&ring->tail, 0u);
+    atomic_init(&ring->high_water, 0u);
+    atomic_init(&ring->dropped, 0u);
+    atomic_init(&ring->overflows, 0u);
+#endif
+    ring->buf = storage;
+    ring->mask = size - 1u;
+    return true;
+}
+
+uint32_t TVL_RxRingPush(tvl_rx_ring_t *ring, const uint8_t *data, uint32_t length)
+{
+    if (!ring || !data || length == 0u) return 0u;
+
+    uint32_t head = ring_load_relaxed(&ring->head);
+    uint32_t n = ring_free(ring, head, length);
+    if (n > length) n = length;
+
+    uint32_t off = head & ring->mask;
+    uint32_t first = ring->mask + 1u - off;
+    if (first > n) first = n;
+    memcpy(ring->buf + off, data, first);
+    memcpy(ring->buf, data + first, n - first);
+
+    head += n;
+    ring_store_release(&ring->head, head);
+    ring_note_level(ring, head);
+    if (n < length) ring_note_drop(ring, length - n);
+    return n;
+}
+
+bool TVL_RxRingPushByte(tvl_rx_ring_t *ring, uint8_t byte)
+{
+    if (!ring) return false;
+
+    uint32_t head = ring_load_relaxed(&ring->head);
+    if (ring_free(ring, head, 1u) == 0u) {
+        ring_note_drop(ring, 1u);
+        return false;
+    }
+    ring->buf[head & ring->mask] = byte;
+    head++;
+    ring_store_release(&ring->head, head);
+    ring_note_level(ring, head);
+    return true;
+}
+
+uint32_t TVL_RxRingPeek(tvl_rx_ring_t *ring, const uint8_t **data)
+{
+    if (!ring || !data) return 0u;
+
+    uint32_t tail = ring_load_relaxed(&ring->tail);
+    uint32_t avail = ring->head_cache - tail;
+    if (avail == 0u || avail > ring->mask + 1u) { /* empty, or consumed past the cached head */
+        ring->head_cache = ring_load_acquire(&ring->head);
+        avail = ring->head_cache - tail;
+        if (avail == 0u) return 0u;
+    }
+
+    uint32_t off = tail & ring->mask;
+    uint32_t run = ring->mask + 1u - off;
+    *data = ring->buf + off;
+    return run < avail ? run : avail;
+}
+
+void TVL_RxRingConsume(tvl_rx_ring_t *ring, uint32_t length)
+{
+    if (!ring || length == 0u) return;
+    ring_store_release(&ring->tail, ring_load_relaxed(&ring->tail) + length);
+}
+
+uint32_t TVL_RxRingDrain(tvl_rx_ring_t *ring, tlv_parser_t *parser, uint32_t max_bytes)
+{
+    if (!ring || !parser) return 0u;
+
+    uint32_t fed = 0u;
+    for (int pass = 0; pass < 2; ++pass) { /* at most: up to the end of storage, then from its start */
+        const uint8_t *p = NULL;
+        uint32_t n = TVL_RxRingPeek(ring, &p);
+        if (max_bytes && n > max_bytes - fed) n = max_bytes - fed;
+        if (n == 0u) break;
+        (void)TLV_ProcessBuffer(parser, p, n);
+        TVL_RxRingConsume(ring, n);
+        fed += n;
+    }
+    return fed;
+}
+
+uint32_t TVL_RxRingUsed(tvl_rx_ring_t *ring)
+{
+    if (!ring) return 0u;
+    uint32_t tail = ring_load_acquire(&ring->tail);
+    return ring_load_acquire(&ring->head) - tail;
+}
+
+void TVL_RxRingGetStats(tvl_rx_ring_t *ring, tvl_rx_ring_stats_t *stats)
+{
+    if (!stats) return;
+    memset(stats, 0, sizeof(*stats));
+    if (!ring || !ring->buf) return;
+    stats->size = ring->mask + 1u;
+    stats->used = TVL_RxRingUsed(ring);
+    stats->high_water = ring_load_relaxed(&ring->high_water);
+    stats->pushed = ring_load_relaxed(&ring->head);
+    stats->dropped = ring_load_relaxed(&ring->dropped);
+    stats->overflows = ring_load_relaxed(&ring->overflows);
+}
+
+/* USER CODE END 1 */
@@ -0,0 +1,151 @@
+/* USER CODE BEGIN Header */
+/**
+ ******************************************************************************
+ * @file           : S_RX_RING.h
+ * @brief          : Wait-free single-producer/single-consumer RX byte ring.
+ * @author         : UF4OVER
+ * @date           : 2026-02-08
+ ******************************************************************************
+ * @attention
+ *
+ * Decouples byte reception from parsing: the UART ISR, DMA IDLE callback or
+ * a reader thread pushes raw bytes (producer), the main loop or a worker
+ * drains them into a parser in bulk (consumer). The parser, CRC and the
+ * handlers then run outside interrupt context.
+ *
+ * - Storage is supplied by the user; its size must be a power of two.
+ *   All of it is usable (free-running 32-bit indices).
+ * - Both sides are wait-free: no locks, no retries. When the ring is full
+ *   the bytes that don't fit are dropped and counted (the parser then sees
+ *   a broken frame, CRC-fails it and resynchronises).
+ * - Producer and consumer indices live on separate cache lines
+ *   (TVLCOM_CACHE_LINE) and each side caches the other's index, so the
+ *   shared lines are touched only when the cached view runs out.
+ * - Exactly one producer and one consumer. Stats may be read from anywhere.
+ *
+ * With TVLCOM_RX_RING_ATOMIC=0 (no C11 atomics) the indices are volatile
+ * with compiler barriers, which is only correct on single-core MCUs where
+ * the producer is an ISR.
+ *
+ ******************************************************************************
+ */
+/* USER CODE END Header */
+/* Define to prevent recursive inclusion -------------------------------------*/
+
+#ifndef STM32F407_LM5175_S_RX_RING_H
+#define STM32F407_LM5175_S_RX_RING_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdbool.h>
+#include "stdint.h"
+/* USER CODE BEGIN Includes */
+
+#include "GLOBAL_CONFIG.h"
+#include "S_TLV_PROTOCOL.h"
+#if TVLCOM_RX_RING_ATOMIC
+#include <stdatomic.h>
+#endif
+
+/* USER CODE END Includes */
+
+/* Exported types ------------------------------------------------------------*/
+/* USER CODE BEGIN ET */
+
+#if TVLCOM_RX_RING_ATOMIC
+typedef atomic_uint tvl_rx_ring_index_t;
+#else
+typedef volatile uint32_t tvl_rx_ring_index_t;
+#endif
+
+/* Ring counters (see TVL_RxRingGetStats) */
+typedef struct {
+    uint32_t size;          /* capacity in bytes */
+    uint32_t used;          /* bytes waiting right now */
+    uint32_t high_water;    /* most bytes ever waiting */
+    uint32_t pushed;        /* bytes accepted (wraps) */
+    uint32_t dropped;       /* bytes lost to a full ring (wraps) */
+    uint32_t overflows;     /* pushes that lost at least one byte */
+} tvl_rx_ring_stats_t;
+
+typedef struct {
+    /* Producer line */
+    _Alignas(TVLCOM_CACHE_LINE) tvl_rx_ring_index_t head;  /* bytes pushed so far */
+    uint32_t tail_cache;                                    /* producer's view of tail */
+    tvl_rx_ring_index_t high_water;
+    tvl_rx_ring_index_t dropped;
+    tvl_rx_ring_index_t overflows;
+
+    /* Consumer line */
+    _Alignas(TVLCOM_CACHE_LINE) tvl_rx_ring_index_t tail;  /* bytes consumed so far */
+    uint32_t head_cache;                                    /* consumer's view of head */
+
+    /* Read-only after init */
+    _Alignas(TVLCOM_CACHE_LINE) uint8_t *buf;
+    uint32_t mask;          /* size - 1 */
+} tvl_rx_ring_t;
+
+/* USER CODE END ET */
+
+/* Exported functions prototypes ---------------------------------------------*/
+/* USER CODE BEGIN EFP */
+
+/**
+ * @brief Initialise an empty ring over user storage.
+ * @param storage Byte buffer, owned by the caller for the ring's lifetime.
+ * @param size    Power of two, at least 2.
+ * @return false on bad arguments.
+ */
+bool TVL_RxRingInit(tvl_rx_ring_t *ring, uint8_t *storage, uint32_t size);
+
+/**
+ * @brief Producer: append bytes (ISR / reader thread).
+ * @return Bytes stored; the rest did not fit and were dropped (counted).
+ */
+uint32_t TVL_RxRingPush(tvl_rx_ring_t *ring, const uint8_t *data, uint32_t length);
+
+/**
+ * @brief Producer: append one byte (UART RXNE interrupt).
+ * @return false if the ring was full (byte dropped and counted).
+ */
+bool TVL_RxRingPushByte(tvl_rx_ring_t *ring, uint8_t byte);
+
+/**
+ * @brief Consumer: contiguous run of waiting bytes, without consuming them.
+ * @param data Set to the first waiting byte.
+ * @return Length of the run (0 if empty); call TVL_RxRingConsume() after use.
+ */
+uint32_t TVL_RxRingPeek(tvl_rx_ring_t *ring, const uint8_t **data);
+
+/**
+ * @brief Consumer: release 'length' bytes returned by TVL_RxRingPeek().
+ */
+void TVL_RxRingConsume(tvl_rx_ring_t *ring, uint32_t length);
+
+/**
+ * @brief Consumer: feed up to max_bytes waiting bytes to the parser (0 = all),
+ *        in at most two TLV_ProcessBuffer() calls.
+ * @return Bytes fed.
+ */
+uint32_t TVL_RxRingDrain(tvl_rx_ring_t *ring, tlv_parser_t *parser, uint32_t max_bytes);
+
+/**
+ * @brief Bytes waiting (exact for the consumer, a snapshot for anyone else).
+ */
+uint32_t TVL_RxRingUsed(tvl_rx_ring_t *ring);
+
+/**
+ * @brief Snapshot of the counters; safe from any thread.
+ */
+void TVL_RxRingGetStats(tvl_rx_ring_t *ring, tvl_rx_ring_stats_t *stats);
+
+/* USER CODE END EFP */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //STM32F407_LM5175_S_RX_RING_H
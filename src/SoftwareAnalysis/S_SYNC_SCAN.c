@@ -0,0 +1,261 @@
+/**
+ ******************************************************************************
+ * @file           : S_SYNC_SCAN.c
+ * @brief          : Sync-word scanner implementations + runtime selection.
+ * @author         : UF4OVER
+ * @date           : 2026-01-16
+ ******************************************************************************
+ * @attention
+ *
+ * Vector versions compare the block against 0xF0 and the block shifted by one
+ * byte against 0x0F, AND the masks, and take the lowest set bit. A block is
+ * only processed while both loads stay inside the buffer; the remainder goes
+ * through the scalar version.
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "S_SYNC_SCAN.h"
+/* USER CODE BEGIN Includes */
+
+#include <string.h>
+
+#include "S_TLV_PROTOCOL.h"
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || (defined(__i386__) && defined(__SSE2__)))
+#  define SYNC_HAVE_SSE2 1
+#  define SYNC_HAVE_AVX2 1
+#  include <immintrin.h>
+#  define SYNC_AVX2_TARGET __attribute__((target("avx2")))
+#  define SYNC_CTZ(x) ((unsigned)__builtin_ctz(x))
+#elif defined(_MSC_VER) && (defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#  define SYNC_HAVE_SSE2 1
+#  define SYNC_HAVE_AVX2 1
+#  include <intrin.h>
+#  include <immintrin.h>
+#  define SYNC_AVX2_TARGET
+static inline unsigned sync_ctz_msvc(unsigned long x) { unsigned long i; _BitScanForward(&i, x); return (unsigned)i; }
+#  define SYNC_CTZ(x) sync_ctz_msvc((unsigned long)(x))
+#else
+#  define SYNC_HAVE_SSE2 0
+#  define SYNC_HAVE_AVX2 0
+#endif
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#  define SYNC_HAVE_NEON 1
+#  include <arm_neon.h>
+#else
+#  define SYNC_HAVE_NEON 0
+#endif
+
+/* Resolved lazily by whichever thread scans first: published with C11 atomics (as in S_CRC16.c) */
+#if !defined(__STDC_NO_ATOMICS__)
+#  include <stdatomic.h>
+#  define SYNC_SHARED(T)      _Atomic(T)
+#  define SYNC_LOAD(v)        atomic_load_explicit(&(v), memory_order_acquire)
+#  define SYNC_STORE(v, x)    atomic_store_explicit(&(v), (x), memory_order_release)
+#else
+#  define SYNC_SHARED(T)      volatile T
+#  define SYNC_LOAD(v)        (v)
+#  define SYNC_STORE(v, x)    ((v) = (x))
+#endif
+
+/* USER CODE END Includes */
+
+/* Private typedef -----------------------------------------------------------*/
+/* USER CODE BEGIN PTD */
+
+typedef size_t (*sync_find_fn_t)(const uint8_t *data, size_t length);
+
+/* USER CODE END PTD */
+
+/* Private variables ---------------------------------------------------------*/
+/* USER CODE BEGIN PV */
+
+static size_t sync_resolve(const uint8_t *data, size_t length);
+
+static SYNC_SHARED(sync_find_fn_t) s_sync_active = sync_resolve;
+static SYNC_SHARED(tlv_sync_impl_t) s_sync_impl = TLV_SYNC_IMPL_AUTO;
+
+/* USER CODE END PV */
+
+/* Private user code ---------------------------------------------------------*/
+/* USER CODE BEGIN 0 */
+
+static size_t sync_find_scalar(const uint8_t *data, size_t length)
+{
+    size_t i = 0;
+    while (i < length) {
+        const uint8_t *hit = (const uint8_t *)memchr(&data[i], TLV_FRAME_HEADER_0, length - i);
+        if (hit == NULL) {
+            return length;
+        }
+        i = (size_t)(hit - data);
+        if (i + 1 >= length || data[i + 1] == TLV_FRAME_HEADER_1) {
+            return i; /* full pair, or lone trailing 0xF0 */
+        }
+        i++;
+    }
+    return length;
+}
+
+#if SYNC_HAVE_SSE2
+static size_t sync_find_sse2(const uint8_t *data, size_t length)
+{
+    const __m128i h0 = _mm_set1_epi8((char)TLV_FRAME_HEADER_0);
+    const __m128i h1 = _mm_set1_epi8((char)TLV_FRAME_HEADER_1);
+    size_t i = 0;
+
+    while (i + 17 <= length) {
+        __m128i a = _mm_loadu_si128((const __m128i *)&data[i]);
+        __m128i b = _mm_loadu_si128((const __m128i *)&data[i + 1]);
+        unsigned mask = (unsigned)_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(a, h0), _mm_cmpeq_epi8(b, h1)));
+        if (mask) {
+            return i + SYNC_CTZ(mask);
+        }
+        i += 16;
+    }
+    return i + sync_find_scalar(&data[i], length - i);
+}
+
+static bool sync_avx2_supported(void)
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    if (!((info[2] >> 27) & 1)) return false;           /* OSXSAVE */
+    if ((_xgetbv(0) & 0x6) != 0x6) return false;        /* OS saves XMM/YMM */
+    __cpuidex(info, 7, 0);
+    return (info[1] >> 5) & 1;                          /* AVX2 */
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+SYNC_AVX2_TARGET
+static size_t sync_find_avx2(const uint8_t *data, size_t length)
+{
+    const __m256i h0 = _mm256_set1_epi8((char)TLV_FRAME_HEADER_0);
+    const __m256i h1 = _mm256_set1_epi8((char)TLV_FRAME_HEADER_1);
+    size_t i = 0;
+
+    while (i + 33 <= length) {
+        __m256i a = _mm256_loadu_si256((const __m256i *)&data[i]);
+        __m256i b = _mm256_loadu_si256((const __m256i *)&data[i + 1]);
+        unsigned mask = (unsigned)_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(a, h0), _mm256_cmpeq_epi8(b, h1)));
+        if (mask) {
+            return i + SYNC_CTZ(mask);
+        }
+        i += 32;
+    }
+    return i + sync_find_sse2(&data[i], length - i);
+}
+#endif
+
+#if SYNC_HAVE_NEON
+static size_t sync_find_neon(const uint8_t *data, size_t length)
+{
+    const uint8x16_t h0 = vdupq_n_u8(TLV_FRAME_HEADER_0);
+    const uint8x16_t h1 = vdupq_n_u8(TLV_FRAME_HEADER_1);
+    size_t i = 0;
+
+    while (i + 17 <= length) {
+        uint8x16_t m = vandq_u8(vceqq_u8(vld1q_u8(&data[i]), h0), vceqq_u8(vld1q_u8(&data[i + 1]), h1));
+        if (vmaxvq_u8(m)) {
+            /* Narrow to a 64-bit nibble mask: 4 bits per input byte */
+            uint64_t bits = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(m), 4)), 0);
+            return i + (size_t)(__builtin_ctzll(bits) >> 2);
+        }
+        i += 16;
+    }
+    return i + sync_find_scalar(&data[i], length - i);
+}
+#endif
+
+static sync_find_fn_t sync_impl_fn(tlv_sync_impl_t impl)
+{
+    switch (impl) {
+    case TLV_SYNC_IMPL_SCALAR: return sync_find_scalar;
+#if SYNC_HAVE_SSE2
+    case TLV_SYNC_IMPL_SSE2:   return sync_find_sse2;
+    case TLV_SYNC_IMPL_AVX2:   return sync_avx2_supported() ? sync_find_avx2 : NULL;
+#endif
+#if SYNC_HAVE_NEON
+    case TLV_SYNC_IMPL_NEON:   return sync_find_neon;
+#endif
+    default:                   return NULL;
+    }
+}
+
+/* First call through s_sync_active lands here and installs the best implementation. */
+static size_t sync_resolve(const uint8_t *data, size_t length)
+{
+    (void)TLV_SyncSetImpl(TLV_SYNC_IMPL_AUTO);
+    return SYNC_LOAD(s_sync_active)(data, length);
+}
+
+/* USER CODE END 0 */
+
+/* Exported functions --------------------------------------------------------*/
+/* USER CODE BEGIN 1 */
+
+size_t TLV_SyncFind(const uint8_t *data, size_t length)
+{
+    return SYNC_LOAD(s_sync_active)(data, length);
+}
+
+bool TLV_SyncImplAvailable(tlv_sync_impl_t impl)
+{
+    if (impl == TLV_SYNC_IMPL_AUTO) return true;
+    return sync_impl_fn(impl) != NULL;
+}
+
+bool TLV_SyncSetImpl(tlv_sync_impl_t impl)
+{
+    if (impl == TLV_SYNC_IMPL_AUTO) {
+        /* Preference order; the first available implementation wins. */
+        static const tlv_sync_impl_t order[] = {
+            TLV_SYNC_IMPL_AVX2,
+            TLV_SYNC_IMPL_SSE2,
+            TLV_SYNC_IMPL_NEON,
+            TLV_SYNC_IMPL_SCALAR,
+        };
+        for (size_t i = 0; i < sizeof(order) / sizeof(order[0]); i++) {
+            if (sync_impl_fn(order[i])) {
+                impl = order[i];
+                break;
+            }
+        }
+    }
+    sync_find_fn_t fn = sync_impl_fn(impl);
+    if (!fn) {
+        return false;
+    }
+    SYNC_STORE(s_sync_impl, impl);
+    SYNC_STORE(s_sync_active, fn);
+    return true;
+}
+
+tlv_sync_impl_t TLV_SyncGetImpl(void)
+{
+    if (SYNC_LOAD(s_sync_impl) == TLV_SYNC_IMPL_AUTO) {
+        (void)TLV_SyncSetImpl(TLV_SYNC_IMPL_AUTO);
+    }
+    return SYNC_LOAD(s_sync_impl);
+}
+
+const char *TLV_SyncImplName(tlv_sync_impl_t impl)
+{
+    switch (impl) {
+    case TLV_SYNC_IMPL_AUTO:   return "auto";
+    case TLV_SYNC_IMPL_SCALAR: return "scalar";
+    case TLV_SYNC_IMPL_SSE2:   return "sse2";
+    case TLV_SYNC_IMPL_AVX2:   return "avx2";
+    case TLV_SYNC_IMPL_NEON:   return "neon";
+    default:                   return "?";
+    }
+}
+
+/* USER CODE END 1 */
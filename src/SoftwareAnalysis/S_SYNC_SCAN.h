@@ -0,0 +1,95 @@
+/* USER CODE BEGIN Header */
+/**
+ ******************************************************************************
+ * @file           : S_SYNC_SCAN.h
+ * @brief          : Sync-word (0xF0 0x0F) scanner for fast resynchronisation.
+ * @author         : UF4OVER
+ * @date           : 2026-01-16
+ ******************************************************************************
+ * @attention
+ *
+ * Finds the next frame header pair in a byte block, 16/32 bytes per step:
+ * - AVX2  : x86, selected at runtime when the CPU supports it.
+ * - SSE2  : x86-64 baseline.
+ * - NEON  : AArch64.
+ * - SCALAR: memchr() for 0xF0 then a check of the following byte (MCU default).
+ *
+ * Used by TLV_ProcessBuffer() while hunting for a header. Offline decoders of
+ * capture files can call TLV_SyncFind() directly to skip garbage runs.
+ *
+ * AUTO is resolved on first use by whichever thread scans first; the choice
+ * is published atomically (C11). Without <stdatomic.h>, call TLV_SyncSetImpl()
+ * before starting other threads.
+ *
+ ******************************************************************************
+ */
+/* Define to prevent recursive inclusion -------------------------------------*/
+
+#ifndef STM32F407_LM5175_S_SYNC_SCAN_H
+#define STM32F407_LM5175_S_SYNC_SCAN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stddef.h>
+#include "stdint.h"
+
+/* Exported types ------------------------------------------------------------*/
+/* USER CODE BEGIN ET */
+
+/* Scanner implementation selector */
+typedef enum {
+    TLV_SYNC_IMPL_AUTO = 0,  /* best available implementation */
+    TLV_SYNC_IMPL_SCALAR,
+    TLV_SYNC_IMPL_SSE2,
+    TLV_SYNC_IMPL_AVX2,
+    TLV_SYNC_IMPL_NEON,
+    TLV_SYNC_IMPL_COUNT
+} tlv_sync_impl_t;
+
+/* USER CODE END ET */
+
+/* Exported functions prototypes ---------------------------------------------*/
+/* USER CODE BEGIN EFP */
+
+/**
+ * @brief Find the next header candidate (0xF0 0x0F) in a block.
+ *
+ * @param data   Bytes to scan.
+ * @param length Number of bytes.
+ * @return Index of the first 0xF0 0x0F pair; otherwise the index of a lone
+ *         trailing 0xF0 (the pair may be split across chunks); otherwise length.
+ */
+size_t TLV_SyncFind(const uint8_t *data, size_t length);
+
+/**
+ * @brief Check whether an implementation is compiled in and supported by the CPU.
+ */
+bool TLV_SyncImplAvailable(tlv_sync_impl_t impl);
+
+/**
+ * @brief Select the implementation used by TLV_SyncFind().
+ * @return false if the implementation is not available (selection unchanged).
+ */
+bool TLV_SyncSetImpl(tlv_sync_impl_t impl);
+
+/**
+ * @brief Get the implementation currently in use (never AUTO).
+ */
+tlv_sync_impl_t TLV_SyncGetImpl(void);
+
+/**
+ * @brief Human readable implementation name (for logs/benchmarks).
+ */
+const char *TLV_SyncImplName(tlv_sync_impl_t impl);
+
+/* USER CODE END EFP */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // STM32F407_LM5175_S_SYNC_SCAN_H
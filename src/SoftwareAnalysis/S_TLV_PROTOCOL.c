@@ -17,10 +17,12 @@
 /* USER CODE BEGIN Includes */
 
 #include <memory.h>
+#include <string.h>
 #include <stddef.h>
 #include <stdio.h>
 
 #include "GLOBAL_CONFIG.h"
+#include "S_SYNC_SCAN.h"
 #if TLV_DEBUG_ENABLE
 #define TLV_DBG_PRINTF(...) do { printf(__VA_ARGS__); } while(0)
 #else
@@ -62,23 +64,17 @@
  * @param data   Input bytes.
  * @param length Number of bytes.
  * @return CRC16.
+ * @note Uses the engine selected in S_CRC16 (fastest available by default).
  */
 uint16_t TLV_CalculateCRC16(const uint8_t *data, uint16_t length)
 {
-    uint16_t crc = 0xFFFF;
-
-    for (uint16_t i = 0; i < length; i++) {
-        crc ^= (uint16_t)data[i] << 8;
-        for (uint8_t j = 0; j < 8; j++) {
-            if (crc & 0x8000) {
-                crc = (uint16_t)((crc << 1) ^ 0x1021);
-            } else {
-                crc <<= 1;
-            }
-        }
-    }
+    return TLV_Crc16Block(TLV_CRC16_INIT, data, length);
+}
 
-    return crc;
+/* Data segment buffer: the caller's (TLV_SetDataBuffer) or the inline storage */
+static inline uint8_t *tlv_parser_data(tlv_parser_t *parser)
+{
+    return parser->data_external ? parser->data_external : parser->data_storage;
 }
 
 /**
@@ -95,28 +91,139 @@ void TLV_InitParser(tlv_parser_t *parser,
     parser->state = TLV_STATE_HEADER_0;
     parser->interface = interface;
     parser->frame_callback = callback;
+    parser->data_capacity = TLV_MAX_DATA_LENGTH;
+}
+
+bool TLV_SetDataBuffer(tlv_parser_t *parser, uint8_t *buffer, uint16_t capacity)
+{
+    if (!parser) return false;
+    if (buffer == NULL) {
+        parser->data_external = NULL;
+        parser->data_capacity = TLV_MAX_DATA_LENGTH;
+        return true;
+    }
+    if (capacity < TLV_MAX_DATA_LENGTH) {
+        return false;
+    }
+    parser->data_external = buffer;
+    parser->data_capacity = capacity;
+    return true;
 }
 
 void TLV_SetErrorCallback(tlv_parser_t *parser, tlv_error_callback_t err_cb)
 {
     if (parser) {
         parser->error_callback = err_cb;
+        parser->error_callback_ex = NULL; /* last setter wins */
+    }
+}
+
+void TLV_SetCallbacksEx(tlv_parser_t *parser, tlv_frame_callback_ex_t on_frame,
+                        tlv_error_callback_ex_t on_error, void *user)
+{
+    if (parser) {
+        parser->frame_callback_ex = on_frame;
+        parser->error_callback_ex = on_error;
+        parser->user = user;
+    }
+}
+
+bool TLV_SetBacktracking(tlv_parser_t *parser, bool enable)
+{
+#if TVLCOM_PARSER_BACKTRACK
+    if (parser) {
+        parser->backtrack = enable;
+        return true;
+    }
+    return false;
+#else
+    (void)parser;
+    return !enable;
+#endif
+}
+
+static void tlv_report_error(tlv_parser_t *parser, tlv_error_t error)
+{
+    if (parser->error_callback_ex) {
+        parser->error_callback_ex(parser->user, parser->frame_id, parser->interface, error);
+    } else if (parser->error_callback) {
+        parser->error_callback(parser->frame_id, parser->interface, error);
     }
 }
 
+#if TVLCOM_PARSER_BACKTRACK
 /**
- * @brief Process a single byte through the parser state machine.
+ * @brief Save the bytes consumed after the header of the frame that is failing on 'byte'.
+ *
+ * The window is rebuilt from parser fields instead of being recorded per byte:
+ * FrameID, DataLen (1B or 3B), Data[0..data_index), CRC (2B), tail bytes seen, failing byte.
+ * Extended frames longer than replay_buffer are not re-scanned.
+ */
+static void tlv_capture_window(tlv_parser_t *parser, uint8_t byte)
+{
+    uint8_t *w = parser->replay_buffer;
+    uint16_t n = 0;
+
+    parser->replay_length = 0;
+    if (!parser->backtrack || parser->replaying) {
+        return; /* during a replay the window is already inside replay_buffer */
+    }
+
+    if ((uint32_t)parser->data_index + TLV_EXT_OVERHEAD_SIZE > sizeof(parser->replay_buffer)) {
+        return;
+    }
+
+    w[n++] = parser->frame_id;
+    if (parser->state == TLV_STATE_DATA_LEN) {
+        w[n++] = byte;
+    } else if (parser->state == TLV_STATE_DATA_LEN_LO) {
+        w[n++] = TLV_DATA_LEN_EXT;
+        w[n++] = (uint8_t)(parser->data_length >> 8);
+        w[n++] = byte;
+    } else {
+        if (parser->extended) {
+            w[n++] = TLV_DATA_LEN_EXT;
+            w[n++] = (uint8_t)(parser->data_length >> 8);
+            w[n++] = (uint8_t)(parser->data_length & 0xFF);
+        } else {
+            w[n++] = (uint8_t)parser->data_length;
+        }
+        memcpy(&w[n], tlv_parser_data(parser), parser->data_index);
+        n = (uint16_t)(n + parser->data_index);
+        if (parser->state == TLV_STATE_TAIL_0 || parser->state == TLV_STATE_TAIL_1) {
+            w[n++] = (uint8_t)(parser->crc_received >> 8);
+            w[n++] = (uint8_t)(parser->crc_received & 0xFF);
+        }
+        if (parser->state == TLV_STATE_TAIL_1) {
+            w[n++] = TLV_FRAME_TAIL_0;
+        }
+        w[n++] = byte;
+    }
+    parser->replay_length = n;
+}
+#else
+#define tlv_capture_window(parser, byte) do { (void)(parser); (void)(byte); } while(0)
+#endif
+
+/**
+ * @brief Advance the state machine by one byte.
+ * @return true if a frame attempt failed after its header (bad length/tail/CRC).
  *
  * State machine overview:
- * - Hunt header 0xF0 0x0F
- * - Read FrameID, DataLen
+ * - Hunt header 0xF0 0x0F (a repeated 0xF0 keeps the hunt in HEADER_1)
+ * - Read FrameID, DataLen (0xFF: extended frame, 16-bit DataLen follows)
  * - Read DataLen bytes of data
  * - Read CRC16 (big-endian)
  * - Verify tail 0xE0 0x0D
  * - Verify CRC; on success call frame_callback
+ *
+ * The CRC is accumulated as FrameID/DataLen/Data bytes arrive, so the end of
+ * a frame costs a compare instead of a pass over the whole payload.
  */
-void TLV_ProcessByte(tlv_parser_t *parser, uint8_t byte)
+static bool tlv_step(tlv_parser_t *parser, uint8_t byte)
 {
+    bool failed = false;
+
     switch (parser->state) {
     case TLV_STATE_HEADER_0:
         if (byte == TLV_FRAME_HEADER_0) {
@@ -125,16 +232,27 @@ void TLV_ProcessByte(tlv_parser_t *parser, uint8_t byte)
         }
         break;
     case TLV_STATE_HEADER_1:
-        parser->state = (byte == TLV_FRAME_HEADER_1) ? TLV_STATE_FRAME_ID : TLV_STATE_HEADER_0;
+        if (byte == TLV_FRAME_HEADER_1) {
+            parser->state = TLV_STATE_FRAME_ID;
+        } else if (byte != TLV_FRAME_HEADER_0) {
+            parser->state = TLV_STATE_HEADER_0;
+        } /* else: 0xF0 0xF0 0x0F, the second 0xF0 may start the header */
         break;
     case TLV_STATE_FRAME_ID:
         parser->frame_id = byte;
+        parser->crc_calculated = TLV_Crc16UpdateByte(TLV_Crc16Init(), byte);
         parser->state = TLV_STATE_DATA_LEN;
         break;
     case TLV_STATE_DATA_LEN:
         parser->data_length = byte;
-        if (parser->data_length > TLV_MAX_DATA_LENGTH) {
-            if (parser->error_callback) parser->error_callback(parser->frame_id, parser->interface, TLV_ERR_LEN);
+        parser->crc_calculated = TLV_Crc16UpdateByte(parser->crc_calculated, byte);
+        parser->extended = (byte == TLV_DATA_LEN_EXT);
+        if (parser->extended) {
+            parser->state = TLV_STATE_DATA_LEN_HI;
+        } else if (parser->data_length > TLV_MAX_DATA_LENGTH) {
+            tlv_capture_window(parser, byte);
+            failed = true;
+            tlv_report_error(parser, TLV_ERR_LEN);
             parser->state = TLV_STATE_HEADER_0;
             parser->data_index = 0;
         } else if (parser->data_length == 0) {
@@ -143,14 +261,37 @@ void TLV_ProcessByte(tlv_parser_t *parser, uint8_t byte)
             parser->state = TLV_STATE_DATA;
         }
         break;
+    case TLV_STATE_DATA_LEN_HI:
+        parser->data_length = (uint16_t)((uint16_t)byte << 8);
+        parser->crc_calculated = TLV_Crc16UpdateByte(parser->crc_calculated, byte);
+        parser->state = TLV_STATE_DATA_LEN_LO;
+        break;
+    case TLV_STATE_DATA_LEN_LO:
+        parser->data_length = (uint16_t)(parser->data_length | byte);
+        parser->crc_calculated = TLV_Crc16UpdateByte(parser->crc_calculated, byte);
+        if (parser->data_length > parser->data_capacity) {
+            tlv_capture_window(parser, byte);
+            failed = true;
+            tlv_report_error(parser, TLV_ERR_LEN);
+            parser->state = TLV_STATE_HEADER_0;
+            parser->data_index = 0;
+        } else if (parser->data_length == 0) {
+            parser->state = TLV_STATE_CRC_LOW;
+        } else {
+            parser->state = TLV_STATE_DATA;
+        }
+        break;
     case TLV_STATE_DATA:
         if (parser->data_index < parser->data_length) {
-            parser->data_buffer[parser->data_index++] = byte;
+            tlv_parser_data(parser)[parser->data_index++] = byte;
+            parser->crc_calculated = TLV_Crc16UpdateByte(parser->crc_calculated, byte);
             if (parser->data_index >= parser->data_length) {
                 parser->state = TLV_STATE_CRC_LOW; /* first CRC byte (high) */
             }
         } else {
-            if (parser->error_callback) parser->error_callback(parser->frame_id, parser->interface, TLV_ERR_LEN);
+            tlv_capture_window(parser, byte);
+            failed = true;
+            tlv_report_error(parser, TLV_ERR_LEN);
             parser->state = TLV_STATE_HEADER_0;
             parser->data_index = 0;
         }
@@ -164,42 +305,57 @@ void TLV_ProcessByte(tlv_parser_t *parser, uint8_t byte)
         parser->state = TLV_STATE_TAIL_0;
         break;
     case TLV_STATE_TAIL_0:
-        parser->state = (byte == TLV_FRAME_TAIL_0) ? TLV_STATE_TAIL_1 : TLV_STATE_HEADER_0;
+        if (byte == TLV_FRAME_TAIL_0) {
+            parser->state = TLV_STATE_TAIL_1;
+        } else {
+            tlv_capture_window(parser, byte);
+            failed = true;
+            parser->state = TLV_STATE_HEADER_0;
+        }
         break;
     case TLV_STATE_TAIL_1:
         if (byte == TLV_FRAME_TAIL_1) {
-            uint8_t crc_buffer[2 + TLV_MAX_DATA_LENGTH];
-            crc_buffer[0] = parser->frame_id;
-            crc_buffer[1] = parser->data_length;
-            memcpy(&crc_buffer[2], parser->data_buffer, parser->data_length);
-            parser->crc_calculated = TLV_CalculateCRC16(crc_buffer, (uint16_t)(2 + parser->data_length));
+            parser->crc_calculated = TLV_Crc16Final(parser->crc_calculated);
             if (parser->crc_calculated == parser->crc_received) {
+#if TLV_DEBUG_ENABLE
                 TLV_DBG_PRINTF("[FRAME id=0x%02X len=%u] ", parser->frame_id, parser->data_length);
-                for (uint8_t i = 0; i < parser->data_length; ++i) {
-                    TLV_DBG_PRINTF("%02X", parser->data_buffer[i]);
+                for (uint16_t i = 0; i < parser->data_length; ++i) {
+                    TLV_DBG_PRINTF("%02X", tlv_parser_data(parser)[i]);
                     if (i + 1 < parser->data_length) TLV_DBG_PRINTF(" ");
                 }
                 TLV_DBG_PRINTF("\n");
                 tlv_entry_t entries[16];
-                uint8_t cnt = TLV_ParseData(parser->data_buffer, parser->data_length, entries, 16);
+                uint8_t cnt = TLV_ParseData(tlv_parser_data(parser), parser->data_length, entries, 16);
                 for (uint8_t k = 0; k < cnt; ++k) {
                     TLV_DBG_PRINTF("  [TLV type=0x%02X len=%u] ", entries[k].type, entries[k].length);
-                    for (uint8_t j = 0; j < entries[k].length; ++j) {
+                    for (uint16_t j = 0; j < entries[k].length; ++j) {
                         TLV_DBG_PRINTF("%02X", entries[k].value[j]);
                         if (j + 1 < entries[k].length) TLV_DBG_PRINTF(" ");
                     }
                     TLV_DBG_PRINTF("\n");
                 }
-                if (parser->frame_callback) {
-                    /* Pass the entire TLV data segment (all concatenated TLVs) */
+#endif
+                /* Pass the entire TLV data segment (all concatenated TLVs) */
+                parser->frames_ok++;
+                if (parser->frame_callback_ex) {
+                    parser->frame_callback_ex(parser->user, parser->frame_id,
+                                              (const uint8_t*)tlv_parser_data(parser),
+                                              parser->data_length,
+                                              parser->interface);
+                } else if (parser->frame_callback) {
                     parser->frame_callback(parser->frame_id,
-                                           (const uint8_t*)parser->data_buffer,
+                                           (const uint8_t*)tlv_parser_data(parser),
                                            parser->data_length,
                                            parser->interface);
                 }
             } else {
-                if (parser->error_callback) parser->error_callback(parser->frame_id, parser->interface, TLV_ERR_CRC);
+                tlv_capture_window(parser, byte);
+                failed = true;
+                tlv_report_error(parser, TLV_ERR_CRC);
             }
+        } else {
+            tlv_capture_window(parser, byte);
+            failed = true;
         }
         parser->state = TLV_STATE_HEADER_0;
         parser->data_index = 0;
@@ -209,6 +365,95 @@ void TLV_ProcessByte(tlv_parser_t *parser, uint8_t byte)
         parser->data_index = 0;
         break;
     }
+
+    return failed;
+}
+
+#if TVLCOM_PARSER_BACKTRACK
+/**
+ * @brief Re-scan the window of a failed frame for a header it may have swallowed.
+ *
+ * Replays replay_buffer (bytes after the false header) through the state
+ * machine. A failure inside the replay restarts the scan right after that
+ * frame's header, so the scan start only moves forward and terminates.
+ */
+static void tlv_backtrack(tlv_parser_t *parser)
+{
+    const uint8_t *buf = parser->replay_buffer;
+    uint16_t len = parser->replay_length;
+    uint16_t pos = 0;
+    uint16_t frame_start = 0;
+
+    parser->replaying = true;
+    parser->state = TLV_STATE_HEADER_0;
+    parser->data_index = 0;
+    while (pos < len) {
+        tlv_parser_state_t before = parser->state;
+        if (tlv_step(parser, buf[pos++])) {
+            pos = frame_start;
+            continue;
+        }
+        if (before == TLV_STATE_HEADER_1 && parser->state == TLV_STATE_FRAME_ID) {
+            frame_start = pos; /* first byte after this header */
+        }
+    }
+    parser->replaying = false;
+    parser->replay_length = 0;
+}
+#endif
+
+/**
+ * @brief Process a single byte through the parser state machine.
+ *
+ * With backtracking enabled (TLV_SetBacktracking), a failed frame does not
+ * drop the bytes it consumed: they are re-scanned from the byte after the
+ * false header, so a real frame hidden behind a spurious 0xF0 0x0F survives.
+ */
+void TLV_ProcessByte(tlv_parser_t *parser, uint8_t byte)
+{
+#if TVLCOM_PARSER_BACKTRACK
+    if (tlv_step(parser, byte) && parser->replay_length) {
+        tlv_backtrack(parser);
+    }
+#else
+    (void)tlv_step(parser, byte);
+#endif
+}
+
+/**
+ * @brief Process a block of bytes through the parser state machine.
+ *
+ * Only the two hot states get a block fast path (header hunt via the sync
+ * scanner, and payload);
+ * every other state is a single byte and goes through TLV_ProcessByte() so
+ * the two entry points cannot drift apart.
+ */
+size_t TLV_ProcessBuffer(tlv_parser_t *parser, const uint8_t *data, size_t length)
+{
+    size_t i = 0;
+
+    while (i < length) {
+        if (parser->state == TLV_STATE_HEADER_0) {
+            i += TLV_SyncFind(&data[i], length - i);
+            if (i >= length) {
+                break; /* no header candidate in the rest of this chunk */
+            }
+        } else if (parser->state == TLV_STATE_DATA && parser->data_index < parser->data_length) {
+            size_t run = (size_t)(parser->data_length - parser->data_index);
+            if (run > length - i) run = length - i;
+            memcpy(&tlv_parser_data(parser)[parser->data_index], &data[i], run);
+            parser->crc_calculated = TLV_Crc16Update(parser->crc_calculated, &data[i], run);
+            parser->data_index = (uint16_t)(parser->data_index + run);
+            i += run;
+            if (parser->data_index >= parser->data_length) {
+                parser->state = TLV_STATE_CRC_LOW; /* first CRC byte (high) */
+            }
+            continue;
+        }
+        TLV_ProcessByte(parser, data[i++]);
+    }
+
+    return length;
 }
 
 /**
@@ -219,11 +464,14 @@ bool TLV_BuildFrame(uint8_t frame_id, const tlv_entry_t *tlv_entries, uint8_t tl
                     uint8_t *output_buffer, uint16_t *output_size)
 {
     uint16_t idx = 0;
-    uint16_t data_length = 0;
+    uint32_t data_length = 0; /* 32-bit: 16-bit entry lengths must not wrap the sum */
 
     /* Calculate total data length */
     for (uint8_t i = 0; i < tlv_count; i++) {
-        data_length += (uint16_t)(2 + tlv_entries[i].length); /* Type + Length + Value */
+        if (tlv_entries[i].length >= TLV_LEN_EXT) {
+            return false; /* needs the extended format (TLV_BuildFrameExt) */
+        }
+        data_length += 2u + tlv_entries[i].length; /* Type + Length + Value */
     }
 
     /* Check if frame will fit */
@@ -244,7 +492,7 @@ bool TLV_BuildFrame(uint8_t frame_id, const tlv_entry_t *tlv_entries, uint8_t tl
     /* TLV Data Segment */
     for (uint8_t i = 0; i < tlv_count; i++) {
         output_buffer[idx++] = tlv_entries[i].type;
-        output_buffer[idx++] = tlv_entries[i].length;
+        output_buffer[idx++] = (uint8_t)tlv_entries[i].length; /* < TLV_LEN_EXT: data <= TLV_MAX_DATA_LENGTH */
         if (tlv_entries[i].length) {
             const uint8_t *src = tlv_entries[i].value ? tlv_entries[i].value : tlv_entries[i].inline_storage;
             memcpy(&output_buffer[idx], src, tlv_entries[i].length);
@@ -266,6 +514,303 @@ bool TLV_BuildFrame(uint8_t frame_id, const tlv_entry_t *tlv_entries, uint8_t tl
     return true;
 }
 
+/* Type + Len (+ 16-bit length after the TLV_LEN_EXT escape) */
+static inline uint16_t tlv_entry_header_size(uint16_t length)
+{
+    return (length < TLV_LEN_EXT) ? 2u : 4u;
+}
+
+static inline uint8_t *tlv_put_entry_header(uint8_t *p, uint8_t type, uint16_t length)
+{
+    *p++ = type;
+    if (length < TLV_LEN_EXT) {
+        *p++ = (uint8_t)length;
+    } else {
+        *p++ = TLV_LEN_EXT;
+        *p++ = (uint8_t)(length >> 8);
+        *p++ = (uint8_t)(length & 0xFF);
+    }
+    return p;
+}
+
+/**
+ * @brief Build an extended frame (16-bit DataLen).
+ * @return true on success; false on overflow.
+ */
+bool TLV_BuildFrameExt(uint8_t frame_id, const tlv_entry_t *tlv_entries, uint8_t tlv_count,
+                       uint8_t *output_buffer, uint16_t output_capacity, uint16_t *output_size)
+{
+    uint32_t data_length = 0;
+    for (uint8_t i = 0; i < tlv_count; i++) {
+        data_length += tlv_entry_header_size(tlv_entries[i].length) + tlv_entries[i].length;
+    }
+    if (data_length > TLV_EXT_MAX_DATA_LENGTH ||
+        data_length + TLV_EXT_OVERHEAD_SIZE > output_capacity) {
+        return false;
+    }
+
+    uint8_t *p = output_buffer;
+    *p++ = TLV_FRAME_HEADER_0;
+    *p++ = TLV_FRAME_HEADER_1;
+    *p++ = frame_id;
+    *p++ = TLV_DATA_LEN_EXT;
+    *p++ = (uint8_t)(data_length >> 8);
+    *p++ = (uint8_t)(data_length & 0xFF);
+
+    for (uint8_t i = 0; i < tlv_count; i++) {
+        p = tlv_put_entry_header(p, tlv_entries[i].type, tlv_entries[i].length);
+        if (tlv_entries[i].length) {
+            const uint8_t *src = tlv_entries[i].value ? tlv_entries[i].value : tlv_entries[i].inline_storage;
+            memcpy(p, src, tlv_entries[i].length);
+            p += tlv_entries[i].length;
+        }
+    }
+
+    uint16_t crc = TLV_CalculateCRC16(&output_buffer[2], (uint16_t)(TLV_FRAME_ID_SIZE + TLV_EXT_DATA_LEN_SIZE + data_length));
+    *p++ = (uint8_t)((crc >> 8) & 0xFF); /* CRC high byte */
+    *p++ = (uint8_t)(crc & 0xFF);        /* CRC low byte */
+    *p++ = TLV_FRAME_TAIL_0;
+    *p++ = TLV_FRAME_TAIL_1;
+
+    *output_size = (uint16_t)(p - output_buffer);
+    return true;
+}
+
+/* Offset of the first TLV byte inside a classic frame (Header + FrameID + DataLen) */
+#define TLV_WRITER_DATA_OFFSET (TLV_HEADER_SIZE + TLV_FRAME_ID_SIZE + TLV_DATA_LEN_SIZE)
+
+/*
+ * The writer runs the CRC with DataLen = 0 and fixes it up at the end. CRC is
+ * linear, so the fix-up is the CRC (zero init) of {0x00, n} followed by n zero
+ * bytes, which only depends on n:
+ *   tlv_writer_len_fix[n] = TLV_Crc16Shift(TLV_Crc16Update(0, {0x00, n}, 2), n)
+ */
+#if !TVLCOM_CRC16_SMALL_TABLE
+static const uint16_t tlv_writer_len_fix[256] = {
+    0x0000, 0x3331, 0x6E60, 0x9BDC, 0x8906, 0x4301, 0xA125, 0xC718,
+    0x29FF, 0x250E, 0x023D, 0x1E37, 0x0EF7, 0x6DAF, 0xF12E, 0x791A,
+    0x1E01, 0x02CE, 0x9C42, 0x3586, 0xE976, 0x77DF, 0x7E6D, 0xC55A,
+    0x1626, 0xF896, 0xC7BD, 0x303F, 0xFBA3, 0xF46B, 0x46C1, 0xB044,
+    0xB990, 0x3AD7, 0xE946, 0x0346, 0x9BD0, 0x0649, 0x4238, 0xBE22,
+    0xE973, 0xD9D4, 0x31CA, 0xAB9E, 0x962A, 0x6186, 0xBC80, 0x0CB6,
+    0xA97D, 0x4BB5, 0x803A, 0xD0C8, 0x9CEA, 0x3452, 0x4B88, 0x3068,
+    0x0E27, 0x5198, 0x2D17, 0x5980, 0xD7ED, 0x2D46, 0x87CB, 0xF43D,
+    0xDF3F, 0x490D, 0xEE35, 0x1317, 0x053C, 0x1903, 0x086F, 0xCC88,
+    0x5DC7, 0xBD54, 0x2715, 0xA0F9, 0x8BA4, 0x187B, 0x9647, 0xFB48,
+    0x028C, 0xF477, 0xFBBD, 0x0294, 0x976F, 0x42F3, 0x0372, 0x100C,
+    0xDB8C, 0x0382, 0xCEAD, 0xBA8B, 0xBA70, 0xF160, 0xAF8F, 0xB634,
+    0x3F17, 0x88CB, 0x3EA6, 0xF8FB, 0xB451, 0x1B3F, 0x9093, 0x173D,
+    0x66FE, 0xBAFB, 0x0AC5, 0xD2FD, 0x564D, 0x14A4, 0xBADB, 0x70B6,
+    0x5EED, 0x699C, 0xC04B, 0x42EA, 0x90D4, 0x97B2, 0x27AB, 0x58BA,
+    0x0713, 0x20B2, 0xE08B, 0x24E1, 0xBD80, 0xB608, 0x9451, 0x00A8,
+    0xDEDA, 0x5D26, 0xAEB0, 0x5C1A, 0xCB40, 0x681E, 0x61E2, 0x3431,
+    0x5F71, 0xEFB2, 0xFDFA, 0x0A30, 0x84A7, 0xF29D, 0x9249, 0xAE3F,
+    0x29EC, 0x018B, 0xB726, 0xAF66, 0xA5E6, 0xD540, 0x2634, 0x3ECA,
+    0x307F, 0xEAF8, 0xD7FF, 0x0836, 0x4DF0, 0x55AE, 0xF531, 0x67E9,
+    0xF059, 0x76A3, 0x1285, 0xC770, 0xB96F, 0x61C8, 0x334B, 0x5615,
+    0xFE82, 0x279F, 0x1406, 0x3C3B, 0xF6B4, 0xC91C, 0x4A82, 0x97C4,
+    0x258B, 0x40E5, 0x3198, 0xB461, 0xA9CA, 0x235A, 0xEC03, 0x4D3A,
+    0x856E, 0xC3A7, 0x2751, 0x7B00, 0x8873, 0x89FB, 0x920D, 0x9E7E,
+    0x5372, 0xDC2E, 0x46A9, 0x7D41, 0xFEE2, 0xC2DA, 0x60DB, 0x2324,
+    0xCE39, 0x6467, 0x3006, 0x6907, 0x15F8, 0x14C2, 0x96D9, 0x3E3D,
+    0xDB61, 0xBF54, 0xCBA7, 0x761B, 0x318F, 0xFA38, 0x17EF, 0x3FB4,
+    0xB71E, 0xFDB7, 0x9FEA, 0x71E4, 0xB0E1, 0x6B68, 0x7E9C, 0xE45B,
+    0xC1D2, 0xB20A, 0x49DC, 0xBE4A, 0x2866, 0xC490, 0x86C0, 0xE68C,
+    0x91BC, 0x5A26, 0x7DC8, 0xD683, 0x005D, 0x46CE, 0x51EC, 0x41DF,
+    0xBCAD, 0xF319, 0xDDB0, 0x8FE6, 0x5A13, 0x4739, 0x570D, 0xDB1C,
+    0x9156, 0x72FA, 0x6BB0, 0xA6B3, 0x04D9, 0xCC73, 0x7C11, 0xC0A9,
+};
+#endif
+
+/* Pending TLV bytes are folded into the CRC in chunks of at least this size (block engines need runs) */
+#define TLV_WRITER_CRC_CHUNK 64u
+
+static uint16_t tlv_writer_crc_fix(const tlv_frame_writer_t *writer)
+{
+    uint16_t n = writer->data_length;
+    if (writer->data_offset != TLV_WRITER_DATA_OFFSET) {
+        /* Extended: the 16-bit DataLen was hashed as 00 00 */
+        const uint8_t len_bytes[2] = { (uint8_t)(n >> 8), (uint8_t)(n & 0xFF) };
+        return TLV_Crc16Shift(TLV_Crc16Update(0, len_bytes, 2), n);
+    }
+#if !TVLCOM_CRC16_SMALL_TABLE
+    return tlv_writer_len_fix[n];
+#else
+    const uint8_t len_bytes[2] = { 0x00, (uint8_t)n };
+    return TLV_Crc16Shift(TLV_Crc16Update(0, len_bytes, 2), n);
+#endif
+}
+
+static bool tlv_writer_begin(tlv_frame_writer_t *writer, uint8_t frame_id, uint8_t *buffer,
+                             uint16_t capacity, bool extended)
+{
+    uint16_t overhead = extended ? TLV_EXT_OVERHEAD_SIZE : TLV_OVERHEAD_SIZE;
+    uint16_t max_data = extended ? TLV_EXT_MAX_DATA_LENGTH : TLV_MAX_DATA_LENGTH;
+
+    memset(writer, 0, sizeof(*writer));
+    if (buffer == NULL || capacity < overhead) {
+        writer->overflow = true;
+        return false;
+    }
+    writer->buffer = buffer;
+    writer->data_limit = (uint16_t)(capacity - overhead);
+    if (writer->data_limit > max_data) {
+        writer->data_limit = max_data;
+    }
+    buffer[0] = TLV_FRAME_HEADER_0;
+    buffer[1] = TLV_FRAME_HEADER_1;
+    buffer[2] = frame_id;
+    /* FrameID and the zeroed DataLen are folded together with the first TLV bytes (one run) */
+    writer->crc = TLV_Crc16Init();
+    if (extended) {
+        buffer[3] = TLV_DATA_LEN_EXT;
+        buffer[4] = 0; /* 16-bit DataLen, patched by TLV_WriterFinish() */
+        buffer[5] = 0;
+        writer->data_offset = TLV_HEADER_SIZE + TLV_FRAME_ID_SIZE + TLV_EXT_DATA_LEN_SIZE;
+    } else {
+        buffer[3] = 0; /* DataLen, patched by TLV_WriterFinish() */
+        writer->data_offset = TLV_WRITER_DATA_OFFSET;
+    }
+    return true;
+}
+
+bool TLV_WriterBegin(tlv_frame_writer_t *writer, uint8_t frame_id, uint8_t *buffer, uint16_t capacity)
+{
+    return tlv_writer_begin(writer, frame_id, buffer, capacity, false);
+}
+
+bool TLV_WriterBeginExt(tlv_frame_writer_t *writer, uint8_t frame_id, uint8_t *buffer, uint16_t capacity)
+{
+    return tlv_writer_begin(writer, frame_id, buffer, capacity, true);
+}
+
+uint16_t TLV_WriterRemaining(const tlv_frame_writer_t *writer)
+{
+    if (writer->overflow || writer->buffer == NULL) return 0;
+    return (uint16_t)(writer->data_limit - writer->data_length);
+}
+
+/* Reserve Type+Len+Value; returns the value slot, or NULL (overflow) without writing anything */
+static inline uint8_t *tlv_writer_reserve(tlv_frame_writer_t *writer, uint8_t type, uint16_t length)
+{
+    if (writer->overflow ||
+        (uint32_t)writer->data_length + tlv_entry_header_size(length) + length > writer->data_limit) {
+        writer->overflow = true;
+        return NULL;
+    }
+    return tlv_put_entry_header(&writer->buffer[writer->data_offset + writer->data_length], type, length);
+}
+
+/* Bytes from FrameID up to the end of the TLV data written so far */
+static inline uint16_t tlv_writer_hash_end(const tlv_frame_writer_t *writer)
+{
+    return (uint16_t)(writer->data_offset - TLV_HEADER_SIZE + writer->data_length);
+}
+
+static void tlv_writer_fold_crc(tlv_frame_writer_t *writer)
+{
+    const uint8_t *p = &writer->buffer[TLV_HEADER_SIZE + writer->crc_length];
+    uint16_t end = tlv_writer_hash_end(writer);
+    writer->crc = TLV_Crc16Update(writer->crc, p, (size_t)(end - writer->crc_length));
+    writer->crc_length = end;
+}
+
+static inline void tlv_writer_commit(tlv_frame_writer_t *writer, uint16_t length)
+{
+    writer->data_length = (uint16_t)(writer->data_length + tlv_entry_header_size(length) + length);
+    if ((uint16_t)(tlv_writer_hash_end(writer) - writer->crc_length) >= TLV_WRITER_CRC_CHUNK) {
+        tlv_writer_fold_crc(writer);
+    }
+}
+
+bool TLV_WriterAppendBytes(tlv_frame_writer_t *writer, uint8_t type, const uint8_t *value, uint16_t length)
+{
+    if (writer->overflow ||
+        (uint32_t)writer->data_length + tlv_entry_header_size(length) + length > writer->data_limit) {
+        writer->overflow = true;
+        return false;
+    }
+    /*
+     * Value first, header after: with the copy behind the short/long header branch
+     * the compiler inlines it as "rep movsq" for the short case, which costs more
+     * than the CRC on a full frame.
+     */
+    uint8_t *entry = &writer->buffer[writer->data_offset + writer->data_length];
+    if (length) memcpy(entry + tlv_entry_header_size(length), value, length);
+    (void)tlv_put_entry_header(entry, type, length);
+    tlv_writer_commit(writer, length);
+    return true;
+}
+
+bool TLV_WriterAppendU8(tlv_frame_writer_t *writer, uint8_t type, uint8_t value)
+{
+    return TLV_WriterAppendBytes(writer, type, &value, 1);
+}
+
+bool TLV_WriterAppendI32(tlv_frame_writer_t *writer, uint8_t type, int32_t value)
+{
+    uint8_t *dst = tlv_writer_reserve(writer, type, 4);
+    if (dst == NULL) return false;
+    uint32_t u = (uint32_t)value;
+    dst[0] = (uint8_t)(u & 0xFF);
+    dst[1] = (uint8_t)((u >> 8) & 0xFF);
+    dst[2] = (uint8_t)((u >> 16) & 0xFF);
+    dst[3] = (uint8_t)((u >> 24) & 0xFF);
+    tlv_writer_commit(writer, 4);
+    return true;
+}
+
+bool TLV_WriterAppendF32(tlv_frame_writer_t *writer, uint8_t type, float value)
+{
+    union { float f; uint32_t u; } u = { .f = value };
+    return TLV_WriterAppendI32(writer, type, (int32_t)u.u);
+}
+
+bool TLV_WriterAppendScaled(tlv_frame_writer_t *writer, uint8_t type, float value)
+{
+    return TLV_WriterAppendI32(writer, type, (int32_t)(value * 10000.0f));
+}
+
+bool TLV_WriterAppendString(tlv_frame_writer_t *writer, uint8_t type, const char *str)
+{
+    size_t len = 0;
+    while (str && str[len] && len <= 255) len++;
+    if (len > 255) {
+        /* Too long: rejected like any other oversize append, never truncated */
+        writer->overflow = true;
+        return false;
+    }
+    return TLV_WriterAppendBytes(writer, type, (const uint8_t *)str, (uint16_t)len);
+}
+
+bool TLV_WriterFinish(tlv_frame_writer_t *writer, uint16_t *frame_size)
+{
+    if (writer->overflow || writer->buffer == NULL) {
+        return false;
+    }
+    uint8_t *buf = writer->buffer;
+    uint16_t idx = (uint16_t)(writer->data_offset + writer->data_length);
+
+    tlv_writer_fold_crc(writer);
+
+    if (writer->data_offset == TLV_WRITER_DATA_OFFSET) {
+        buf[3] = (uint8_t)writer->data_length;
+    } else {
+        buf[4] = (uint8_t)(writer->data_length >> 8);
+        buf[5] = (uint8_t)(writer->data_length & 0xFF);
+    }
+
+    uint16_t crc = TLV_Crc16Final((uint16_t)(writer->crc ^ tlv_writer_crc_fix(writer)));
+
+    buf[idx++] = (uint8_t)((crc >> 8) & 0xFF); /* CRC high byte */
+    buf[idx++] = (uint8_t)(crc & 0xFF);        /* CRC low byte */
+    buf[idx++] = TLV_FRAME_TAIL_0;
+    buf[idx++] = TLV_FRAME_TAIL_1;
+
+    if (frame_size) *frame_size = idx;
+    return true;
+}
+
 /**
  * @brief Build an ACK frame.
  * @note ACK payload is 1 byte: original frame id.
@@ -294,11 +839,52 @@ void TLV_BuildNackFrame(uint8_t frame_id, uint8_t *output_buffer, uint16_t *outp
     TLV_BuildFrame(0, &nack_entry, 1, output_buffer, output_size);
 }
 
+/**
+ * @brief Build a selective NACK frame.
+ * @note Payload: original frame id, then [index][type][status] per rejected TLV.
+ */
+bool TLV_BuildNackFrameEx(const tlv_nack_info_t *info, uint8_t *output_buffer, uint16_t *output_size)
+{
+    if (!info || info->count > TLV_NACK_MAX_ITEMS) {
+        return false;
+    }
+    uint8_t value[1 + 3 * TLV_NACK_MAX_ITEMS];
+    uint8_t len = 0;
+    value[len++] = info->frame_id;
+    for (uint8_t i = 0; i < info->count; i++) {
+        value[len++] = info->items[i].index;
+        value[len++] = info->items[i].type;
+        value[len++] = info->items[i].status;
+    }
+    tlv_entry_t nack_entry;
+    TLV_CreateRawEntry(TLV_TYPE_NACK, value, len, &nack_entry);
+    return TLV_BuildFrame(0, &nack_entry, 1, output_buffer, output_size);
+}
+
+/**
+ * @brief Decode a NACK TLV into frame id + rejected TLV list.
+ */
+bool TLV_ParseNack(const tlv_entry_t *entry, tlv_nack_info_t *info)
+{
+    if (!entry || !info || entry->type != TLV_TYPE_NACK || entry->length < 1 || !entry->value) {
+        return false;
+    }
+    info->frame_id = entry->value[0];
+    info->count = 0;
+    for (uint16_t idx = 1; idx + 3u <= entry->length && info->count < TLV_NACK_MAX_ITEMS; idx += 3u) {
+        tlv_nack_item_t *it = &info->items[info->count++];
+        it->index = entry->value[idx];
+        it->type = entry->value[idx + 1u];
+        it->status = entry->value[idx + 2u];
+    }
+    return true;
+}
+
 /**
  * @brief Parse TLV data segment into individual TLV entries.
  * @note Value pointers reference the input data_buffer.
  */
-uint8_t TLV_ParseData(const uint8_t *data_buffer, uint8_t data_length,
+uint8_t TLV_ParseData(const uint8_t *data_buffer, uint16_t data_length,
                       tlv_entry_t *tlv_entries, uint8_t max_entries)
 {
     uint8_t count = 0;
@@ -311,7 +897,16 @@ uint8_t TLV_ParseData(const uint8_t *data_buffer, uint8_t data_length,
         }
 
         uint8_t type = data_buffer[idx++];
-        uint8_t len  = data_buffer[idx++];
+        uint16_t len = data_buffer[idx++];
+
+        if (len == TLV_LEN_EXT) {
+            /* 16-bit length escape (extended frames) */
+            if (idx + 2 > data_length) {
+                break;
+            }
+            len = (uint16_t)(((uint16_t)data_buffer[idx] << 8) | data_buffer[idx + 1]);
+            idx += 2;
+        }
 
         /* Check if we have enough data for the value */
         if ((uint16_t)idx + len > data_length) {
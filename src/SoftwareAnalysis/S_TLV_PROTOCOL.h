@@ -16,6 +16,9 @@
  *   [CRC16 2B]            // CRC16-CCITT over (FrameID + DataLen + Data)
  *   [Tail 2B: 0xE0 0x0D]
  *
+ * Extended frames use DataLen = 0xFF followed by a 16-bit big-endian DataLen,
+ * and a TLV Len of 0xFF followed by a 16-bit big-endian length (see TLV_DATA_LEN_EXT).
+ *
  * Endianness rules:
  * - CRC field is stored big-endian (high byte first).
  * - Integer payload helpers (e.g. TLV_CreateInt32Entry/TLV_ExtractInt32Value) are little-endian.
@@ -46,6 +49,9 @@ extern "C" {
 #include "stdint.h"
 /* USER CODE BEGIN Includes */
 
+#include "GLOBAL_CONFIG.h"
+#include "S_CRC16.h"
+
 /* USER CODE END Includes */
 
 /* Exported types ------------------------------------------------------------*/
@@ -65,11 +71,16 @@ typedef enum {
 } tlv_error_t;
 
 /* Callback type for a valid frame */
-typedef void (*tlv_frame_callback_t)(uint8_t frame_id, const uint8_t *data, uint8_t length, tlv_interface_t interface);
+typedef void (*tlv_frame_callback_t)(uint8_t frame_id, const uint8_t *data, uint16_t length, tlv_interface_t interface);
 
 /* Callback type for parser error */
 typedef void (*tlv_error_callback_t)(uint8_t frame_id, tlv_interface_t interface, tlv_error_t error);
 
+/* Frame/error callbacks carrying the pointer given to TLV_SetCallbacksEx() (e.g. a tvl_context_t) */
+typedef void (*tlv_frame_callback_ex_t)(void *user, uint8_t frame_id, const uint8_t *data, uint16_t length,
+                                        tlv_interface_t interface);
+typedef void (*tlv_error_callback_ex_t)(void *user, uint8_t frame_id, tlv_interface_t interface, tlv_error_t error);
+
 /* USER CODE END ET */
 
 /* Exported constants --------------------------------------------------------*/
@@ -93,12 +104,47 @@ typedef void (*tlv_error_callback_t)(uint8_t frame_id, tlv_interface_t interface
 #define TLV_MAX_DATA_LENGTH     240 /* Maximum TLV data segment length */
 #define TLV_MAX_FRAME_SIZE      (TLV_OVERHEAD_SIZE + TLV_MAX_DATA_LENGTH)
 
+/*
+ * Extended frames (v1): DataLen byte 0xFF followed by a 16-bit big-endian DataLen.
+ * [F0 0F][FrameID][FF][LenHi][LenLo][Data...][CRC16][E0 0D], CRC over FrameID..Data.
+ * Classic parsers reject them as a bad length, so both formats can share a link.
+ */
+#define TLV_DATA_LEN_EXT        0xFF
+#define TLV_EXT_DATA_LEN_SIZE   3   /* 0xFF + 16-bit DataLen */
+#define TLV_EXT_OVERHEAD_SIZE   (TLV_OVERHEAD_SIZE - TLV_DATA_LEN_SIZE + TLV_EXT_DATA_LEN_SIZE)
+#define TLV_EXT_MAX_DATA_LENGTH TVLCOM_EXT_MAX_DATA_LENGTH
+#define TLV_EXT_MAX_FRAME_SIZE  (TLV_EXT_OVERHEAD_SIZE + TLV_EXT_MAX_DATA_LENGTH)
+
+/*
+ * TLV Length byte 0xFF: a 16-bit big-endian length follows (values >= 255 bytes).
+ * Only occurs in extended frames; TLV_ParseData() accepts it in either format.
+ */
+#define TLV_LEN_EXT             0xFF
+
 /* TLV Type definitions (generic utility types, user can define custom IDs) */
 #define TLV_TYPE_CONTROL_CMD 0x01
 #define TLV_TYPE_INTEGER     0x02
 #define TLV_TYPE_STRING      0x03
 #define TLV_TYPE_ACK         0x08
 #define TLV_TYPE_NACK        0x09
+#define TLV_TYPE_FRAGMENT    0x0A  /* one piece of a fragmented message (S_FRAGMENT.h) */
+#define TLV_TYPE_ACK_BITMAP  0x0B  /* coalesced ACK: [base id][bitmap], bit k of the bitmap acks base+k */
+#define TLV_TYPE_NO_ACK      0x0C  /* zero-length flag: best-effort frame, receiver never ACKs/NACKs it */
+
+/*
+ * Per-TLV status codes carried by a selective NACK (see tlv_nack_info_t).
+ * Values >= TLV_STATUS_USER are application defined.
+ */
+#define TLV_STATUS_OK           0x00
+#define TLV_STATUS_UNKNOWN_TYPE 0x01  /* no handler registered for the type / command */
+#define TLV_STATUS_FAILED       0x02  /* bool handler returned false */
+#define TLV_STATUS_BAD_VALUE    0x03  /* malformed or out-of-range value */
+#define TLV_STATUS_BUSY         0x04  /* temporarily unable, worth retrying */
+#define TLV_STATUS_TOO_LARGE    0x05  /* frame larger than the receiver can take, retrying won't help */
+#define TLV_STATUS_USER         0x80
+
+/* Max rejected TLVs listed in one selective NACK */
+#define TLV_NACK_MAX_ITEMS      16
 
 /* USER CODE END EC */
 
@@ -111,6 +157,8 @@ typedef enum {
     TLV_STATE_HEADER_1,
     TLV_STATE_FRAME_ID,
     TLV_STATE_DATA_LEN,
+    TLV_STATE_DATA_LEN_HI,  /* extended frame: DataLen high byte */
+    TLV_STATE_DATA_LEN_LO,  /* extended frame: DataLen low byte */
     TLV_STATE_DATA,
     TLV_STATE_CRC_LOW,
     TLV_STATE_CRC_HIGH,
@@ -121,25 +169,66 @@ typedef enum {
 /* TLV entry structure: supports inline storage for small values and pointer for large */
 typedef struct {
     uint8_t type;           /* TLV type (user-defined ID) */
-    uint8_t length;         /* TLV value length */
+    uint16_t length;        /* TLV value length (>= 255 only in extended frames) */
     const uint8_t *value;   /* Pointer to value bytes */
     uint8_t inline_storage[32]; /* Optional inline storage for small values (created by helpers) */
 } tlv_entry_t;
 
+/* One rejected TLV in a selective NACK */
+typedef struct {
+    uint8_t index;          /* position of the TLV in the NACKed frame (0-based) */
+    uint8_t type;           /* its type, so the sender can cross-check */
+    uint8_t status;         /* TLV_STATUS_* reported by the receiver */
+} tlv_nack_item_t;
+
+/*
+ * Decoded NACK. Wire value: [frame id] followed by count x [index][type][status].
+ * A legacy 1-byte NACK decodes with count = 0 (whole frame rejected).
+ */
+typedef struct {
+    uint8_t frame_id;
+    uint8_t count;
+    tlv_nack_item_t items[TLV_NACK_MAX_ITEMS];
+} tlv_nack_info_t;
+
 /* Frame parser context */
 typedef struct {
     tlv_parser_state_t state;
     uint8_t frame_id;
-    uint8_t data_length;
-    uint8_t data_buffer[TLV_MAX_DATA_LENGTH];
+    bool extended;                          /* Current frame uses the 16-bit DataLen */
+    uint16_t data_length;
+    uint8_t *data_external;                 /* TLV_SetDataBuffer() buffer; NULL: data_storage (no self-pointer) */
+    uint16_t data_capacity;
+    uint8_t data_storage[TLV_MAX_DATA_LENGTH];
     uint16_t data_index;
     uint16_t crc_received;
-    uint16_t crc_calculated;
+    uint16_t crc_calculated;                /* Running CRC over FrameID+DataLen+Data, updated per byte */
     tlv_interface_t interface;              /* Which interface this parser is bound to */
     tlv_frame_callback_t frame_callback;    /* Called on valid frame */
     tlv_error_callback_t error_callback;    /* Called on parser errors */
+    tlv_frame_callback_ex_t frame_callback_ex; /* Used instead of frame_callback when set */
+    tlv_error_callback_ex_t error_callback_ex; /* Used instead of error_callback when set */
+    void *user;                             /* First argument of the *_ex callbacks */
+    uint32_t frames_ok;                     /* Valid frames delivered since init (wraps) */
+#if TVLCOM_PARSER_BACKTRACK
+    bool backtrack;                         /* Re-scan consumed bytes after a failed frame */
+    bool replaying;
+    uint16_t replay_length;
+    uint8_t replay_buffer[TLV_MAX_FRAME_SIZE]; /* Bytes after the false header of a failed frame */
+#endif
 } tlv_parser_t;
 
+/* Single-pass frame writer: TLVs are encoded straight into the caller's buffer */
+typedef struct {
+    uint8_t *buffer;        /* Output frame buffer (caller owned) */
+    uint8_t data_offset;    /* First TLV byte: 4 (classic) or 6 (extended) */
+    uint16_t data_limit;    /* Max TLV data bytes (TLV_MAX_DATA_LENGTH or less for a small buffer) */
+    uint16_t data_length;   /* TLV data bytes written so far */
+    uint16_t crc_length;    /* Bytes from FrameID on (DataLen hashed as 0) already folded into crc */
+    uint16_t crc;           /* Running CRC over those bytes */
+    bool overflow;          /* Sticky: an append did not fit, TLV_WriterFinish() fails */
+} tlv_frame_writer_t;
+
 
 /* USER CODE END EM */
 
@@ -152,6 +241,9 @@ typedef struct {
  * Polynomial: 0x1021
  * Initial value: 0xFFFF
  *
+ * Runs on the engine selected via TLV_Crc16SetEngine() (see S_CRC16.h);
+ * every engine yields the same value.
+ *
  * @param data   Pointer to input bytes.
  * @param length Number of bytes.
  * @return CRC16 value.
@@ -164,7 +256,8 @@ uint16_t TLV_CalculateCRC16(const uint8_t *data, uint16_t length);
  * @param parser    Parser object to initialize.
  * @param interface Which interface this parser belongs to (UART/USB).
  * @param callback  Called when a full valid frame is decoded.
- * @note The parser keeps an internal receive buffer of size TLV_MAX_DATA_LENGTH.
+ * @note The parser keeps an internal receive buffer of size TLV_MAX_DATA_LENGTH;
+ *       give it a larger one with TLV_SetDataBuffer() to accept extended frames.
  */
 void TLV_InitParser(tlv_parser_t *parser,
                     tlv_interface_t interface,
@@ -178,6 +271,47 @@ void TLV_InitParser(tlv_parser_t *parser,
  */
 void TLV_SetErrorCallback(tlv_parser_t *parser, tlv_error_callback_t err_cb);
 
+/**
+ * @brief Set frame/error callbacks that also receive a user pointer.
+ *
+ * They take precedence over the callback given to TLV_InitParser(); a later
+ * TLV_SetErrorCallback() replaces on_error.
+ * Lets one callback serve many parsers (one per tvl_context_t link, for instance).
+ *
+ * @param parser   Parser instance.
+ * @param on_frame Called on a valid frame (NULL: fall back to frame_callback).
+ * @param on_error Called on length/CRC errors (NULL: fall back to error_callback).
+ * @param user     Passed as the first argument.
+ */
+void TLV_SetCallbacksEx(tlv_parser_t *parser, tlv_frame_callback_ex_t on_frame,
+                        tlv_error_callback_ex_t on_error, void *user);
+
+/**
+ * @brief Use a caller-provided data buffer (per parser instance).
+ *
+ * Extended frames whose DataLen exceeds the buffer are rejected with TLV_ERR_LEN,
+ * so the capacity sets the largest extended frame this parser accepts.
+ * Classic frames keep working with any buffer.
+ *
+ * @param parser   Parser instance (call while no frame is in progress, e.g. after init).
+ * @param buffer   Buffer, or NULL to go back to the internal TLV_MAX_DATA_LENGTH storage.
+ * @param capacity Buffer size, at least TLV_MAX_DATA_LENGTH.
+ * @return false if capacity is too small (configuration unchanged).
+ */
+bool TLV_SetDataBuffer(tlv_parser_t *parser, uint8_t *buffer, uint16_t capacity);
+
+/**
+ * @brief Enable/disable backtracking resync for a parser (default: off).
+ *
+ * Without it, a bad tail or CRC mismatch drops every byte the false frame
+ * consumed (up to 246 bytes), including any real frame that started inside
+ * them. With it, those bytes are re-scanned from the byte after the false
+ * header. Needs TVLCOM_PARSER_BACKTRACK (adds TLV_MAX_FRAME_SIZE bytes per parser).
+ *
+ * @return false if backtracking is compiled out and enable was requested.
+ */
+bool TLV_SetBacktracking(tlv_parser_t *parser, bool enable);
+
 /**
  * @brief Feed one byte into the TLV parser state machine.
  *
@@ -188,12 +322,33 @@ void TLV_SetErrorCallback(tlv_parser_t *parser, tlv_error_callback_t err_cb);
  * Error handling:
  * - On length overflow or CRC mismatch, the parser resets to header hunt state and (if set)
  *   invokes error_callback(frame_id, interface, error).
+ * - With backtracking enabled, the bytes of the failed frame are re-scanned (see TLV_SetBacktracking).
  *
  * @param parser Parser instance.
  * @param byte   Received byte.
  */
 void TLV_ProcessByte(tlv_parser_t *parser, uint8_t byte);
 
+/**
+ * @brief Feed a block of received bytes into the TLV parser.
+ *
+ * Produces exactly the same frame/error callbacks as calling TLV_ProcessByte()
+ * for every byte, but:
+ * - while hunting for a header, jumps to the next 0xF0 0x0F pair with the
+ *   SIMD sync scanner (S_SYNC_SCAN.h);
+ * - in the DATA state, copies the remaining payload run with one memcpy()
+ *   and folds it into the running CRC as a block.
+ *
+ * Usage: call from a PC read loop or a DMA/IDLE callback with each new chunk.
+ * Chunks may split frames anywhere.
+ *
+ * @param parser Parser instance.
+ * @param data   Received bytes.
+ * @param length Number of bytes.
+ * @return Number of bytes consumed (always length).
+ */
+size_t TLV_ProcessBuffer(tlv_parser_t *parser, const uint8_t *data, size_t length);
+
 /**
  * @brief Build a TLV frame from a list of TLV entries.
  *
@@ -203,11 +358,93 @@ void TLV_ProcessByte(tlv_parser_t *parser, uint8_t byte);
  * @param output_buffer  Output frame buffer.
  * @param output_size    Output frame size (bytes).
  *
- * @return true on success; false if the total TLV data length exceeds TLV_MAX_DATA_LENGTH.
+ * @return true on success; false if the total TLV data length exceeds TLV_MAX_DATA_LENGTH
+ *         or an entry is TLV_LEN_EXT bytes or longer (use TLV_BuildFrameExt()).
  */
 bool TLV_BuildFrame(uint8_t frame_id, const tlv_entry_t *tlv_entries, uint8_t tlv_count,
                     uint8_t *output_buffer, uint16_t *output_size);
 
+/**
+ * @brief Build an extended frame (16-bit DataLen, see TLV_DATA_LEN_EXT).
+ *
+ * Entries of 255 bytes or more are encoded with the TLV_LEN_EXT length escape.
+ *
+ * @param frame_id        Frame ID.
+ * @param tlv_entries     Array of TLV entries.
+ * @param tlv_count       Number of entries.
+ * @param output_buffer   Output frame buffer.
+ * @param output_capacity Size of output_buffer (TLV_EXT_MAX_FRAME_SIZE always suffices).
+ * @param output_size     Output frame size (bytes).
+ *
+ * @return false if the data exceeds TLV_EXT_MAX_DATA_LENGTH or the buffer.
+ */
+bool TLV_BuildFrameExt(uint8_t frame_id, const tlv_entry_t *tlv_entries, uint8_t tlv_count,
+                       uint8_t *output_buffer, uint16_t output_capacity, uint16_t *output_size);
+
+/**
+ * @brief Start a frame in a caller buffer (single-pass writer).
+ *
+ * Usage:
+ *   tlv_frame_writer_t w;
+ *   uint8_t frame[TLV_MAX_FRAME_SIZE];
+ *   TLV_WriterBegin(&w, Transport_NextFrameId(), frame, sizeof(frame));
+ *   TLV_WriterAppendI32(&w, TLV_TYPE_INTEGER, 42);
+ *   TLV_WriterAppendString(&w, TLV_TYPE_STRING, "HELLO");
+ *   if (TLV_WriterFinish(&w, &size)) Transport_Send(ifc, frame, size);
+ *
+ * Each append is checked against TLV_MAX_DATA_LENGTH and the buffer before
+ * anything is written; a rejected append leaves the frame unchanged and marks
+ * the writer as overflowed. The CRC runs alongside the appends (folded in
+ * 64-byte runs while the data is still in cache) and DataLen is patched by
+ * TLV_WriterFinish() without re-reading the frame.
+ *
+ * @param writer   Writer state.
+ * @param frame_id Frame ID (typically Transport_NextFrameId()).
+ * @param buffer   Output buffer (TLV_MAX_FRAME_SIZE always suffices).
+ * @param capacity Output buffer size.
+ * @return false if the buffer cannot hold even an empty frame.
+ */
+bool TLV_WriterBegin(tlv_frame_writer_t *writer, uint8_t frame_id, uint8_t *buffer, uint16_t capacity);
+
+/**
+ * @brief Start an extended frame (16-bit DataLen, up to TLV_EXT_MAX_DATA_LENGTH).
+ *
+ * Same usage as TLV_WriterBegin(); values of 255 bytes or more may be appended.
+ */
+bool TLV_WriterBeginExt(tlv_frame_writer_t *writer, uint8_t frame_id, uint8_t *buffer, uint16_t capacity);
+
+/**
+ * @brief Number of TLV data bytes (Type+Len+Value) that can still be appended.
+ */
+uint16_t TLV_WriterRemaining(const tlv_frame_writer_t *writer);
+
+/** @brief Append a TLV with raw value bytes. */
+bool TLV_WriterAppendBytes(tlv_frame_writer_t *writer, uint8_t type, const uint8_t *value, uint16_t length);
+
+/** @brief Append a 1-byte TLV. */
+bool TLV_WriterAppendU8(tlv_frame_writer_t *writer, uint8_t type, uint8_t value);
+
+/** @brief Append an int32 TLV (little-endian, as read by TLV_ExtractInt32Value()). */
+bool TLV_WriterAppendI32(tlv_frame_writer_t *writer, uint8_t type, int32_t value);
+
+/** @brief Append a float32 TLV (IEEE-754 binary32, little-endian). */
+bool TLV_WriterAppendF32(tlv_frame_writer_t *writer, uint8_t type, float value);
+
+/** @brief Append a scaled value TLV (int32 = value x10000, as read by TLV_ExtractFloatValue()). */
+bool TLV_WriterAppendScaled(tlv_frame_writer_t *writer, uint8_t type, float value);
+
+/** @brief Append a UTF-8 string TLV (no terminator, up to 255 bytes; longer strings overflow the writer). */
+bool TLV_WriterAppendString(tlv_frame_writer_t *writer, uint8_t type, const char *str);
+
+/**
+ * @brief Finish the frame: patch DataLen, write CRC and tail.
+ *
+ * @param writer     Writer state.
+ * @param frame_size Output: total frame size in bytes.
+ * @return false if any append overflowed (no frame is produced).
+ */
+bool TLV_WriterFinish(tlv_frame_writer_t *writer, uint16_t *frame_size);
+
 /**
  * @brief Build an ACK frame.
  *
@@ -230,6 +467,27 @@ void TLV_BuildAckFrame(uint8_t frame_id, uint8_t *output_buffer, uint16_t *outpu
  */
 void TLV_BuildNackFrame(uint8_t frame_id, uint8_t *output_buffer, uint16_t *output_size);
 
+/**
+ * @brief Build a selective NACK frame listing the rejected TLVs.
+ *
+ * With info->count == 0 this is the same frame as TLV_BuildNackFrame().
+ *
+ * @param info          Original frame id and rejected TLVs (count <= TLV_NACK_MAX_ITEMS).
+ * @param output_buffer Output buffer (TLV_OVERHEAD_SIZE + 3 + 3 * TLV_NACK_MAX_ITEMS bytes suffice).
+ * @param output_size   Output size.
+ * @return false if info->count is too large.
+ */
+bool TLV_BuildNackFrameEx(const tlv_nack_info_t *info, uint8_t *output_buffer, uint16_t *output_size);
+
+/**
+ * @brief Decode a NACK TLV (legacy 1-byte or selective).
+ *
+ * @param entry TLV entry of type TLV_TYPE_NACK.
+ * @param info  Output. Truncated items are ignored.
+ * @return false if the entry is not a NACK or is empty.
+ */
+bool TLV_ParseNack(const tlv_entry_t *entry, tlv_nack_info_t *info);
+
 /**
  * @brief Parse a TLV data segment into TLV entries.
  *
@@ -241,7 +499,7 @@ void TLV_BuildNackFrame(uint8_t frame_id, uint8_t *output_buffer, uint16_t *outp
  * @param max_entries Capacity of tlv_entries.
  * @return Parsed entry count (0..max_entries).
  */
-uint8_t TLV_ParseData(const uint8_t *data_buffer, uint8_t data_length,
+uint8_t TLV_ParseData(const uint8_t *data_buffer, uint16_t data_length,
                       tlv_entry_t *tlv_entries, uint8_t max_entries);
 
 /**
@@ -271,7 +529,7 @@ int32_t TLV_ExtractInt32Value(const tlv_entry_t *entry);
 /* Convenience creators */
 
 /** Create a raw TLV entry from a buffer (no copy at build time beyond the frame build). */
-static inline void TLV_CreateRawEntry(uint8_t type, const uint8_t *buf, uint8_t len, tlv_entry_t *entry)
+static inline void TLV_CreateRawEntry(uint8_t type, const uint8_t *buf, uint16_t len, tlv_entry_t *entry)
 {
     entry->type = type;
     entry->length = len;
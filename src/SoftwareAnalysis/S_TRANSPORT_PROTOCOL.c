@@ -27,6 +27,8 @@
 /* USER CODE BEGIN Includes */
 
 #include "S_TLV_PROTOCOL.h"
+#include "S_CONTEXT.h"
+#include "S_TX_QUEUE.h"
 #include <string.h>
 #include "HAL/hal.h"
 
@@ -35,11 +37,38 @@
 /* Private typedef -----------------------------------------------------------*/
 /* USER CODE BEGIN PTD */
 
+/* Window slots (tvl_tx_slot_t) and senders live in tvl_context_t (S_CONTEXT.h) */
+
+/* Completion collected under the window lock, reported after unlocking */
+typedef struct {
+    transport_tx_done_t done;
+    void *user;
+    uint8_t frame_id;
+    transport_tx_status_t status;
+} transport_tx_event_t;
+
+/* Sender functions of one interface, read under the transport lock */
+typedef struct {
+    transport_send_func_t fn;
+    transport_send_ex_func_t fn_ex;
+    void *user;
+    transport_sendv_func_t fnv;
+} transport_backend_t;
+
 /* USER CODE END PTD */
 
 /* Private define ------------------------------------------------------------*/
 /* USER CODE BEGIN PD */
 
+#define TRANSPORT_INTERFACE_COUNT TVL_CONTEXT_INTERFACES
+
+#if TRANSPORT_COMBINE_BYTES > 0xFFFF
+#error "TRANSPORT_COMBINE_BYTES must fit a uint16_t frame length"
+#endif
+#if TRANSPORT_COMBINE_MAX_IOV > 255 || TRANSPORT_COMBINE_MAX_IOV < TRANSPORT_SENDV_MAX_IOV
+#error "TRANSPORT_COMBINE_MAX_IOV must be TRANSPORT_SENDV_MAX_IOV..255"
+#endif
+
 /* USER CODE END PD */
 
 /* Private macro -------------------------------------------------------------*/
@@ -50,12 +79,7 @@
 /* Private variables ---------------------------------------------------------*/
 /* USER CODE BEGIN PV */
 
-static transport_send_func_t s_uart_sender = NULL;
-static transport_send_func_t s_usb_sender  = NULL;
-static uint8_t s_frame_id_counter = 0;
-
-/* Optional lock to protect shared state in multi-thread / ISR + main scenarios */
-static tvl_hal_mutex_t s_transport_lock = NULL;
+/* All transport state is per context (tvl_context_t tx_* fields) */
 
 /* USER CODE END PV */
 
@@ -67,6 +91,532 @@ static tvl_hal_mutex_t s_transport_lock = NULL;
 /* Private user code ---------------------------------------------------------*/
 /* USER CODE BEGIN 0 */
 
+static void transport_lock_init(tvl_context_t *ctx)
+{
+    const tvl_hal_vtable_t *hal = TVL_HAL_Get();
+    if (!ctx->tx_lock && hal && hal->mutex_create) {
+        /* Best-effort, avoid dynamic allocation in MCU builds by leaving mutex_* NULL */
+        ctx->tx_lock = hal->mutex_create();
+    }
+    if (!ctx->tx_window_lock && hal && hal->mutex_create) {
+        ctx->tx_window_lock = hal->mutex_create();
+    }
+    for (unsigned i = 0; i < TRANSPORT_INTERFACE_COUNT; i++) {
+        if (!ctx->tx_write_lock[i] && hal && hal->mutex_create) {
+            ctx->tx_write_lock[i] = hal->mutex_create();
+        }
+    }
+}
+
+static void transport_lock(tvl_context_t *ctx)
+{
+    const tvl_hal_vtable_t *hal = TVL_HAL_Get();
+    if (ctx->tx_lock && hal && hal->mutex_lock) hal->mutex_lock(ctx->tx_lock);
+}
+
+static void transport_unlock(tvl_context_t *ctx)
+{
+    const tvl_hal_vtable_t *hal = TVL_HAL_Get();
+    if (ctx->tx_lock && hal && hal->mutex_unlock) hal->mutex_unlock(ctx->tx_lock);
+}
+
+static void transport_window_lock(tvl_context_t *ctx)
+{
+    const tvl_hal_vtable_t *hal = TVL_HAL_Get();
+    if (ctx->tx_window_lock && hal && hal->mutex_lock) hal->mutex_lock(ctx->tx_window_lock);
+}
+
+static void transport_window_unlock(tvl_context_t *ctx)
+{
+    const tvl_hal_vtable_t *hal = TVL_HAL_Get();
+    if (ctx->tx_window_lock && hal && hal->mutex_unlock) hal->mutex_unlock(ctx->tx_window_lock);
+}
+
+static uint32_t transport_now(void)
+{
+    const tvl_hal_vtable_t *hal = TVL_HAL_Get();
+    return (hal && hal->tick_ms) ? hal->tick_ms() : 0u;
+}
+
+/* Caller holds the window lock */
+static tvl_tx_slot_t *transport_find_inflight(tvl_context_t *ctx, tlv_interface_t interface, uint8_t frame_id)
+{
+    for (uint8_t i = 0; i < TRANSPORT_TX_WINDOW; i++) {
+        tvl_tx_slot_t *t = &ctx->tx_window[interface][i];
+        if (t->used && t->frame_id == frame_id) {
+            return t;
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Caller holds the window lock. Retire a frame into 'ev' once out of retries
+ * (returns true), or count a retry and copy the frame to 'resend' (*resend_len
+ * bytes, 0 if none) for the caller to send after unlocking.
+ */
+static bool transport_retry_or_fail(tvl_tx_slot_t *t, transport_tx_status_t status, uint32_t now,
+                                    transport_tx_event_t *ev, uint8_t *resend, uint16_t *resend_len)
+{
+    if (t->retries >= TRANSPORT_TX_MAX_RETRIES) {
+        ev->done = t->done;
+        ev->user = t->user;
+        ev->frame_id = t->frame_id;
+        ev->status = status;
+        t->used = false;
+        *resend_len = 0;
+        return true;
+    }
+    t->retries++;
+    t->sent_tick = now;
+    memcpy(resend, t->frame, t->len);
+    *resend_len = t->len;
+    return false;
+}
+
+/* Caller holds the window lock. True if 'frame_id' awaits an ACK on any interface. */
+static bool transport_id_in_flight(tvl_context_t *ctx, uint8_t frame_id)
+{
+    for (uint8_t ifc = 0; ifc < TRANSPORT_INTERFACE_COUNT; ifc++) {
+        if (transport_find_inflight(ctx, (tlv_interface_t)ifc, frame_id)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ * Caller holds the window lock. Next id from the shared counter, skipping ids
+ * still awaiting an ACK, so an unrelated frame's ACK can't complete a reliable one
+ * (at most TRANSPORT_INTERFACE_COUNT * TRANSPORT_TX_WINDOW skips).
+ */
+static uint8_t transport_next_id(tvl_context_t *ctx)
+{
+    uint8_t id;
+    do {
+        transport_lock(ctx);
+        /* 0 is a valid ID; allow wrap naturally */
+        id = (uint8_t)(++ctx->tx_frame_id_counter);
+        transport_unlock(ctx);
+    } while (transport_id_in_flight(ctx, id));
+    return id;
+}
+
+/* A retransmission can't succeed: some TLV was refused as TLV_STATUS_TOO_LARGE */
+static bool transport_nack_is_final(const tlv_nack_info_t *nack)
+{
+    for (uint8_t k = 0; k < nack->count; k++) {
+        if (nack->items[k].status == TLV_STATUS_TOO_LARGE) return true;
+    }
+    return false;
+}
+
+/* Copy the entries a selective NACK rejected (matching index and type), in frame order */
+static uint8_t transport_select_rejected(const tlv_entry_t *entries, uint8_t count,
+                                         const tlv_nack_info_t *nack, tlv_entry_t *out)
+{
+    uint8_t n = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        for (uint8_t k = 0; k < nack->count; k++) {
+            if (nack->items[k].index == i && nack->items[k].type == entries[i].type) {
+                out[n++] = entries[i];
+                break;
+            }
+        }
+    }
+    return n;
+}
+
+/* Caller holds the window lock. Shrink a stored frame to the TLVs a selective NACK rejected. */
+static void transport_trim_to_rejected(tvl_tx_slot_t *t, const tlv_nack_info_t *nack)
+{
+    tlv_entry_t parsed[TLV_NACK_MAX_ITEMS];
+    tlv_entry_t keep[TLV_NACK_MAX_ITEMS];
+    uint8_t rebuilt[TLV_MAX_FRAME_SIZE];
+    uint16_t size = 0;
+
+    uint8_t count = TLV_ParseData(&t->frame[4], t->frame[3], parsed, TLV_NACK_MAX_ITEMS);
+    uint8_t n = transport_select_rejected(parsed, count, nack, keep);
+    if (n && TLV_BuildFrame(t->frame_id, keep, n, rebuilt, &size)) {
+        memcpy(t->frame, rebuilt, size);
+        t->len = size;
+    }
+}
+
+static void transport_report(const transport_tx_event_t *ev, uint8_t n)
+{
+    for (uint8_t i = 0; i < n; i++) {
+        if (ev[i].done) ev[i].done(ev[i].frame_id, ev[i].status, ev[i].user);
+    }
+}
+
+static tvl_tx_queue_t *transport_get_queue(tvl_context_t *ctx, tlv_interface_t interface)
+{
+    if ((unsigned)interface >= TRANSPORT_INTERFACE_COUNT) {
+        return NULL;
+    }
+    transport_lock(ctx);
+    tvl_tx_queue_t *q = ctx->tx_queue[interface];
+    transport_unlock(ctx);
+    return q;
+}
+
+static transport_sendv_func_t transport_get_sendv(tvl_context_t *ctx, tlv_interface_t interface)
+{
+    if ((unsigned)interface >= TRANSPORT_INTERFACE_COUNT) {
+        return NULL;
+    }
+    transport_lock(ctx);
+    transport_sendv_func_t fn = ctx->tx_sendv[interface];
+    transport_unlock(ctx);
+    return fn;
+}
+
+/* Caller holds the transport lock */
+static void transport_get_backend(tvl_context_t *ctx, tlv_interface_t interface, transport_backend_t *b)
+{
+    b->fn = ctx->tx_senders[interface];
+    b->fn_ex = ctx->tx_senders_ex[interface];
+    b->user = ctx->tx_sender_user[interface];
+    b->fnv = ctx->tx_sendv[interface];
+}
+
+static int transport_backend_send(const transport_backend_t *b, const uint8_t *data, uint16_t len)
+{
+    if (b->fn_ex) {
+        return b->fn_ex(b->user, data, len);
+    }
+    if (b->fn == NULL) {
+        return -1; /* not registered */
+    }
+    return b->fn(data, len);
+}
+
+/* One frame in one sender call: a single slice goes to the plain sender, several to sendv or gathered */
+static int transport_write_one(const transport_backend_t *b, const transport_iovec_t *iov, uint8_t iovcnt)
+{
+    if (iovcnt == 1 && (b->fn || b->fn_ex || !b->fnv)) {
+        return transport_backend_send(b, iov[0].base, iov[0].len);
+    }
+    if (b->fnv) {
+        return b->fnv(iov, iovcnt);
+    }
+
+    uint8_t buffer[TLV_MAX_FRAME_SIZE];
+    uint32_t size = 0;
+    for (uint8_t i = 0; i < iovcnt; i++) {
+        size += iov[i].len;
+    }
+    if (size > sizeof(buffer)) {
+        /* Extended frame: one call per slice, back to back (the caller keeps other frames out) */
+        int sent = 0;
+        for (uint8_t i = 0; i < iovcnt; i++) {
+            int rc = transport_backend_send(b, iov[i].base, iov[i].len);
+            if (rc < 0) return sent ? sent : rc;
+            sent += rc;
+            if (rc < (int)iov[i].len) break;
+        }
+        return sent;
+    }
+    size = 0;
+    for (uint8_t i = 0; i < iovcnt; i++) {
+        memcpy(&buffer[size], iov[i].base, iov[i].len);
+        size += iov[i].len;
+    }
+    return transport_backend_send(b, buffer, (uint16_t)size);
+}
+
+static uint32_t transport_request_len(const tvl_tx_request_t *r)
+{
+    uint32_t len = 0;
+    for (uint8_t i = 0; i < r->iovcnt; i++) {
+        len += r->iov[i].len;
+    }
+    return len;
+}
+
+/* Leading requests whose slices fit one sendv call; packs them only if there are at least two */
+static uint16_t transport_pack_iov(tvl_tx_request_t *head, transport_iovec_t *iov, uint8_t *iovcnt,
+                                   tvl_tx_request_t **end)
+{
+    uint16_t frames = 0;
+    uint32_t n = 0;
+    tvl_tx_request_t *r = head;
+    for (; r && n + r->iovcnt <= TRANSPORT_COMBINE_MAX_IOV; r = r->next) {
+        n += r->iovcnt;
+        frames++;
+    }
+    if (frames < 2) {
+        return frames;
+    }
+    n = 0;
+    for (tvl_tx_request_t *p = head; p != r; p = p->next) {
+        memcpy(&iov[n], p->iov, (size_t)p->iovcnt * sizeof(*iov));
+        n += p->iovcnt;
+    }
+    *iovcnt = (uint8_t)n;
+    *end = r;
+    return frames;
+}
+
+#if TRANSPORT_COMBINE_BYTES
+/* Leading requests that fit the batch buffer; copies them only if there are at least two */
+static uint16_t transport_pack_bytes(tvl_tx_request_t *head, uint8_t *batch, uint16_t *size,
+                                     tvl_tx_request_t **end)
+{
+    uint16_t frames = 0;
+    uint32_t used = 0;
+    tvl_tx_request_t *r = head;
+    for (; r; r = r->next) {
+        uint32_t len = transport_request_len(r);
+        if (used + len > TRANSPORT_COMBINE_BYTES) break;
+        used += len;
+        frames++;
+    }
+    if (frames < 2) {
+        return frames;
+    }
+    used = 0;
+    for (tvl_tx_request_t *p = head; p != r; p = p->next) {
+        for (uint8_t i = 0; i < p->iovcnt; i++) {
+            memcpy(&batch[used], p->iov[i].base, p->iov[i].len);
+            used += p->iov[i].len;
+        }
+    }
+    *size = (uint16_t)used;
+    *end = r;
+    return frames;
+}
+#endif
+
+/* Hand one sender call's result out to the frames it carried, in order (a short write cuts the tail) */
+static void transport_settle(tvl_tx_request_t *head, tvl_tx_request_t *end, int rc)
+{
+    int left = rc;
+    for (tvl_tx_request_t *r = head; r != end; r = r->next) {
+        if (rc < 0) {
+            r->result = rc;
+        } else {
+            int len = (int)transport_request_len(r);
+            r->result = left < len ? left : len;
+            left -= r->result;
+        }
+        r->done = true;
+    }
+}
+
+/* Caller holds the write lock (or has no mutexes) */
+static void transport_note_writes(tvl_context_t *ctx, tlv_interface_t interface, const transport_write_stats_t *d)
+{
+    transport_write_stats_t *st = &ctx->tx_write_stats[interface];
+    st->frames += d->frames;
+    st->writes += d->writes;
+    st->combined += d->combined;
+    if (d->max_batch > st->max_batch) st->max_batch = d->max_batch;
+}
+
+/*
+ * Caller holds the write lock. Write the detached requests in order, packing
+ * consecutive frames into one sender call: their slices for sendv, copies in
+ * the interface's batch buffer for the plain sender.
+ */
+static void transport_combine(tvl_context_t *ctx, tlv_interface_t interface, const transport_backend_t *b,
+                              tvl_tx_request_t *head)
+{
+    transport_write_stats_t d = { 0 };
+    transport_iovec_t iov[TRANSPORT_COMBINE_MAX_IOV];
+
+    while (head) {
+        tvl_tx_request_t *end = head->next;
+        uint16_t frames = 0;
+        uint8_t n = 0;
+#if TRANSPORT_COMBINE_BYTES
+        uint16_t size = 0;
+#endif
+        int rc;
+        if (b->fnv && (frames = transport_pack_iov(head, iov, &n, &end)) > 1) {
+            rc = b->fnv(iov, n);
+        }
+#if TRANSPORT_COMBINE_BYTES
+        else if (!b->fnv && (frames = transport_pack_bytes(head, ctx->tx_batch[interface], &size, &end)) > 1) {
+            rc = transport_backend_send(b, ctx->tx_batch[interface], size);
+        }
+#endif
+        else {
+            frames = 1;
+            rc = transport_write_one(b, head->iov, head->iovcnt);
+        }
+        transport_settle(head, end, rc);
+
+        d.frames += frames;
+        d.writes++;
+        if (frames > 1) d.combined += frames;
+        if (frames > d.max_batch) d.max_batch = frames;
+        head = end;
+    }
+    transport_note_writes(ctx, interface, &d);
+}
+
+#if TVLCOM_HAVE_THREAD_LOCAL
+/* Its address identifies the calling thread (tx_write_owner) */
+static TVLCOM_THREAD_LOCAL uint8_t s_thread_tag;
+#define TRANSPORT_THIS_THREAD ((const void *)&s_thread_tag)
+#else
+#define TRANSPORT_THIS_THREAD NULL
+#endif
+
+/*
+ * Write one frame, given as slices, to the interface. With HAL mutexes the
+ * frame joins the interface's pending list and the thread that gets the write
+ * lock writes every pending frame (combining): each frame goes out whole and
+ * in queue order, and waiting callers cost no sender calls of their own.
+ * Without mutexes the frame is written directly. A sender sending on its own
+ * interface would block on the (non-recursive) write lock it already holds,
+ * so that send fails with -4 instead.
+ */
+static int transport_write(tvl_context_t *ctx, tlv_interface_t interface, const transport_iovec_t *iov, uint8_t iovcnt)
+{
+    if ((unsigned)interface >= TRANSPORT_INTERFACE_COUNT) {
+        return -1;
+    }
+    const tvl_hal_vtable_t *hal = TVL_HAL_Get();
+    tvl_hal_mutex_t write_lock = ctx->tx_write_lock[interface];
+    transport_backend_t b;
+
+    if (!write_lock || !ctx->tx_lock || !hal || !hal->mutex_lock || !hal->mutex_unlock) {
+        transport_lock(ctx);
+        transport_get_backend(ctx, interface, &b);
+        transport_unlock(ctx);
+        int rc = transport_write_one(&b, iov, iovcnt);
+        const transport_write_stats_t d = { 1u, 1u, 0u, 1u };
+        transport_note_writes(ctx, interface, &d);
+        return rc;
+    }
+
+    const void *self = TRANSPORT_THIS_THREAD;
+    tvl_tx_request_t req = { NULL, iov, iovcnt, false, 0 };
+    transport_lock(ctx);
+    if (self && ctx->tx_write_owner[interface] == self) {
+        transport_unlock(ctx);
+        return -4; /* called from this interface's own sender */
+    }
+    if (ctx->tx_pending_tail[interface]) {
+        ctx->tx_pending_tail[interface]->next = &req;
+    } else {
+        ctx->tx_pending[interface] = &req;
+    }
+    ctx->tx_pending_tail[interface] = &req;
+    transport_unlock(ctx);
+
+    hal->mutex_lock(write_lock);
+    if (!req.done) {
+        /* Nobody took our frame yet: write it together with every other queued frame */
+        transport_lock(ctx);
+        tvl_tx_request_t *head = ctx->tx_pending[interface];
+        ctx->tx_pending[interface] = NULL;
+        ctx->tx_pending_tail[interface] = NULL;
+        ctx->tx_write_owner[interface] = self;
+        transport_get_backend(ctx, interface, &b);
+        transport_unlock(ctx);
+        transport_combine(ctx, interface, &b, head);
+        transport_lock(ctx);
+        ctx->tx_write_owner[interface] = NULL;
+        transport_unlock(ctx);
+    }
+    hal->mutex_unlock(write_lock);
+    return req.result;
+}
+
+/*
+ * Describe a frame as slices without copying large values.
+ * scratch (scratch_size bytes) receives the frame header, TLV headers, short
+ * values and CRC/tail. Data segments over TLV_MAX_DATA_LENGTH use the
+ * extended format (16-bit DataLen, TLV_LEN_EXT length escape).
+ * Returns the slice count, or 0 if the frame is too long or does not fit in
+ * the slice array / scratch buffer.
+ */
+static uint32_t transport_data_length(const tlv_entry_t *entries, uint8_t count)
+{
+    uint32_t data_length = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        data_length += (entries[i].length < TLV_LEN_EXT ? 2u : 4u) + entries[i].length;
+    }
+    return data_length;
+}
+
+static uint8_t transport_build_iov(uint8_t frame_id, const tlv_entry_t *entries, uint8_t count,
+                                   uint8_t *scratch, uint16_t scratch_size, transport_iovec_t *iov)
+{
+    uint32_t data_length = transport_data_length(entries, count);
+    if (data_length > TLV_EXT_MAX_DATA_LENGTH) {
+        return 0;
+    }
+    bool extended = (data_length > TLV_MAX_DATA_LENGTH);
+
+    uint16_t used = 0;         /* scratch bytes used */
+    uint16_t open_start = 0;   /* start of the scratch run not yet turned into a slice */
+    uint8_t n = 0;
+
+    scratch[used++] = TLV_FRAME_HEADER_0;
+    scratch[used++] = TLV_FRAME_HEADER_1;
+    scratch[used++] = frame_id;
+    if (extended) {
+        scratch[used++] = TLV_DATA_LEN_EXT;
+        scratch[used++] = (uint8_t)(data_length >> 8);
+        scratch[used++] = (uint8_t)(data_length & 0xFF);
+    } else {
+        scratch[used++] = (uint8_t)data_length;
+    }
+    uint16_t crc = TLV_Crc16Update(TLV_Crc16Init(), &scratch[2], (size_t)(used - 2u));
+
+    for (uint8_t i = 0; i < count; i++) {
+        const tlv_entry_t *e = &entries[i];
+        const uint8_t *src = e->value ? e->value : e->inline_storage;
+        bool copy = (e->length < TRANSPORT_SENDV_COPY_BELOW);
+        /* header (<= 4) + copied value + CRC/tail must still fit */
+        if ((uint32_t)used + 4u + (copy ? e->length : 0u) + TLV_CRC_SIZE + TLV_TAIL_SIZE > scratch_size) {
+            return 0;
+        }
+        uint16_t hdr = used;
+        scratch[used++] = e->type;
+        if (e->length < TLV_LEN_EXT) {
+            scratch[used++] = (uint8_t)e->length;
+        } else {
+            scratch[used++] = TLV_LEN_EXT;
+            scratch[used++] = (uint8_t)(e->length >> 8);
+            scratch[used++] = (uint8_t)(e->length & 0xFF);
+        }
+        crc = TLV_Crc16Update(crc, &scratch[hdr], (size_t)(used - hdr));
+        if (e->length == 0) continue;
+        crc = TLV_Crc16Update(crc, src, e->length);
+        if (copy) {
+            memcpy(&scratch[used], src, e->length);
+            used = (uint16_t)(used + e->length);
+            continue;
+        }
+        /* Close the scratch run, then reference the caller's value directly */
+        if (n + 2 > TRANSPORT_SENDV_MAX_IOV - 1) {
+            return 0; /* keep one slot for the trailing scratch run */
+        }
+        iov[n].base = &scratch[open_start];
+        iov[n].len = (uint16_t)(used - open_start);
+        n++;
+        iov[n].base = src;
+        iov[n].len = e->length;
+        n++;
+        open_start = used;
+    }
+
+    crc = TLV_Crc16Final(crc);
+    scratch[used++] = (uint8_t)((crc >> 8) & 0xFF); /* CRC high byte */
+    scratch[used++] = (uint8_t)(crc & 0xFF);        /* CRC low byte */
+    scratch[used++] = TLV_FRAME_TAIL_0;
+    scratch[used++] = TLV_FRAME_TAIL_1;
+    iov[n].base = &scratch[open_start];
+    iov[n].len = (uint16_t)(used - open_start);
+    n++;
+    return n;
+}
 
 /* USER CODE END 0 */
 
@@ -84,80 +634,556 @@ static tvl_hal_mutex_t s_transport_lock = NULL;
  * This is typically called once during startup.
  * If HAL provides mutex_create/lock/unlock, registration is protected.
  */
+void Transport_RegisterSenderCtx(tvl_context_t *ctx, tlv_interface_t interface, transport_send_func_t fn)
+{
+    transport_lock_init(ctx);
+    if ((unsigned)interface >= TRANSPORT_INTERFACE_COUNT) {
+        return;
+    }
+    transport_lock(ctx);
+    ctx->tx_senders[interface] = fn;
+    transport_unlock(ctx);
+}
+
 void Transport_RegisterSender(tlv_interface_t interface, transport_send_func_t fn)
 {
-    const tvl_hal_vtable_t *hal = TVL_HAL_Get();
-    if (!s_transport_lock && hal && hal->mutex_create) {
-        /* Best-effort, avoid dynamic allocation in MCU builds by leaving mutex_* NULL */
-        s_transport_lock = hal->mutex_create();
+    Transport_RegisterSenderCtx(TVL_ContextDefault(), interface, fn);
+}
+
+/**
+ * @brief Register a scatter-gather sender for an interface.
+ */
+void Transport_RegisterSenderVCtx(tvl_context_t *ctx, tlv_interface_t interface, transport_sendv_func_t fn)
+{
+    transport_lock_init(ctx);
+    if ((unsigned)interface >= TRANSPORT_INTERFACE_COUNT) {
+        return;
+    }
+    transport_lock(ctx);
+    ctx->tx_sendv[interface] = fn;
+    transport_unlock(ctx);
+}
+
+void Transport_RegisterSenderV(tlv_interface_t interface, transport_sendv_func_t fn)
+{
+    Transport_RegisterSenderVCtx(TVL_ContextDefault(), interface, fn);
+}
+
+/**
+ * @brief Register a sender that receives a user pointer (one function, many links).
+ */
+void Transport_RegisterSenderExCtx(tvl_context_t *ctx, tlv_interface_t interface,
+                                   transport_send_ex_func_t fn, void *user)
+{
+    transport_lock_init(ctx);
+    if ((unsigned)interface >= TRANSPORT_INTERFACE_COUNT) {
+        return;
     }
-    if (s_transport_lock && hal && hal->mutex_lock) hal->mutex_lock(s_transport_lock);
+    transport_lock(ctx);
+    ctx->tx_senders_ex[interface] = fn;
+    ctx->tx_sender_user[interface] = user;
+    transport_unlock(ctx);
+}
 
-    if (interface == TLV_INTERFACE_UART) {
-        s_uart_sender = fn;
-    } else if (interface == TLV_INTERFACE_USB) {
-        s_usb_sender = fn;
+/**
+ * @brief Attach (or detach with NULL) an asynchronous TX queue.
+ */
+void Transport_SetTxQueueCtx(tvl_context_t *ctx, tlv_interface_t interface, tvl_tx_queue_t *q)
+{
+    transport_lock_init(ctx);
+    if ((unsigned)interface >= TRANSPORT_INTERFACE_COUNT) {
+        return;
+    }
+    if (q) {
+        q->ctx = ctx;
+        q->interface = interface;
     }
+    transport_lock(ctx);
+    ctx->tx_queue[interface] = q;
+    transport_unlock(ctx);
+}
 
-    if (s_transport_lock && hal && hal->mutex_unlock) hal->mutex_unlock(s_transport_lock);
+void Transport_SetTxQueue(tlv_interface_t interface, tvl_tx_queue_t *q)
+{
+    Transport_SetTxQueueCtx(TVL_ContextDefault(), interface, q);
 }
 
 /**
- * @brief Send raw bytes to the interface.
+ * @brief Send raw bytes to the interface (queued when a TX queue is attached).
  *
- * @return <0 when sender is not registered or sender reports an error.
+ * @return <0 when sender is not registered or sender reports an error;
+ *         -3 when the TX queue has no free buffer.
+ */
+int Transport_SendCtx(tvl_context_t *ctx, tlv_interface_t interface, const uint8_t *data, uint16_t len)
+{
+    tvl_tx_queue_t *q = transport_get_queue(ctx, interface);
+    if (q) {
+        return TVL_TxQueuePost(q, data, len) ? (int)len : -3;
+    }
+    return Transport_SendDirectCtx(ctx, interface, data, len);
+}
+
+/**
+ * @brief Send raw bytes through the registered sender, ignoring any TX queue.
  */
+int Transport_SendDirectCtx(tvl_context_t *ctx, tlv_interface_t interface, const uint8_t *data, uint16_t len)
+{
+    const transport_iovec_t iov = { data, len };
+    return transport_write(ctx, interface, &iov, 1);
+}
+
 int Transport_Send(tlv_interface_t interface, const uint8_t *data, uint16_t len)
 {
-    const tvl_hal_vtable_t *hal = TVL_HAL_Get();
-    if (s_transport_lock && hal && hal->mutex_lock) hal->mutex_lock(s_transport_lock);
+    return Transport_SendCtx(TVL_ContextDefault(), interface, data, len);
+}
 
-    transport_send_func_t fn = NULL;
-    if (interface == TLV_INTERFACE_UART) {
-        fn = s_uart_sender;
-    } else if (interface == TLV_INTERFACE_USB) {
-        fn = s_usb_sender;
+/**
+ * @brief Send a frame given as slices (gathered into a stack buffer without a sendv backend).
+ */
+int Transport_SendVCtx(tvl_context_t *ctx, tlv_interface_t interface, const transport_iovec_t *iov, uint8_t iovcnt)
+{
+    tvl_tx_queue_t *q = transport_get_queue(ctx, interface);
+    if (q) {
+        /* Gather straight into a pool buffer */
+        tvl_tx_buffer_t *buf = TVL_TxQueueAcquire(q);
+        if (!buf) {
+            return -3;
+        }
+        uint16_t size = 0;
+        for (uint8_t i = 0; i < iovcnt; i++) {
+            if ((uint32_t)size + iov[i].len > sizeof(buf->data)) {
+                TVL_TxQueueRelease(q, buf);
+                return -2;
+            }
+            memcpy(&buf->data[size], iov[i].base, iov[i].len);
+            size = (uint16_t)(size + iov[i].len);
+        }
+        buf->len = size;
+        TVL_TxQueueSubmit(q, buf);
+        return size;
     }
+    return transport_write(ctx, interface, iov, iovcnt);
+}
 
-    if (s_transport_lock && hal && hal->mutex_unlock) hal->mutex_unlock(s_transport_lock);
+int Transport_SendV(tlv_interface_t interface, const transport_iovec_t *iov, uint8_t iovcnt)
+{
+    return Transport_SendVCtx(TVL_ContextDefault(), interface, iov, iovcnt);
+}
 
-    if (fn == NULL) {
-        return -1; /* not registered */
-    }
-    return fn(data, len);
+/**
+ * @brief Snapshot of the interface's writer counters.
+ */
+void Transport_GetWriteStatsCtx(tvl_context_t *ctx, tlv_interface_t interface, transport_write_stats_t *stats)
+{
+    if (!stats) return;
+    memset(stats, 0, sizeof(*stats));
+    if ((unsigned)interface >= TRANSPORT_INTERFACE_COUNT) return;
+    const tvl_hal_vtable_t *hal = TVL_HAL_Get();
+    tvl_hal_mutex_t write_lock = ctx->tx_write_lock[interface];
+    if (write_lock && hal && hal->mutex_lock) hal->mutex_lock(write_lock);
+    *stats = ctx->tx_write_stats[interface];
+    if (write_lock && hal && hal->mutex_unlock) hal->mutex_unlock(write_lock);
+}
+
+void Transport_GetWriteStats(tlv_interface_t interface, transport_write_stats_t *stats)
+{
+    Transport_GetWriteStatsCtx(TVL_ContextDefault(), interface, stats);
 }
 
 /**
  * @brief Build a TLV frame into a stack buffer and send it.
  *
+ * With a sendv backend, large values are passed as slices of entry memory.
+ * Data segments over TLV_MAX_DATA_LENGTH go out as extended frames on every path.
+ *
  * Failure cases:
  * - TLV_BuildFrame() fails if total TLV payload > TLV_MAX_DATA_LENGTH.
  * - Transport_Send() fails if sender not registered.
  */
+bool Transport_SendTLVsCtx(tvl_context_t *ctx, tlv_interface_t interface, uint8_t frame_id,
+                           const tlv_entry_t *entries, uint8_t count)
+{
+    return Transport_SendTLVsExCtx(ctx, interface, frame_id, entries, count, TRANSPORT_DELIVERY_ACKED);
+}
+
 bool Transport_SendTLVs(tlv_interface_t interface, uint8_t frame_id,
                         const tlv_entry_t *entries, uint8_t count)
+{
+    return Transport_SendTLVsExCtx(TVL_ContextDefault(), interface, frame_id, entries, count,
+                                   TRANSPORT_DELIVERY_ACKED);
+}
+
+/*
+ * Build the (already framed) entries and hand them to the queue or the sender.
+ * Data segments over TLV_MAX_DATA_LENGTH use the extended format on every path.
+ */
+static bool transport_send_entries(tvl_context_t *ctx, tlv_interface_t interface, uint8_t frame_id,
+                                   const tlv_entry_t *entries, uint8_t count)
 {
     uint8_t buffer[TLV_MAX_FRAME_SIZE];
     uint16_t size = 0;
+    bool extended = (transport_data_length(entries, count) > TLV_MAX_DATA_LENGTH);
+
+    tvl_tx_queue_t *q = transport_get_queue(ctx, interface);
+    if (q) {
+        /* Build in place in a pool buffer: nothing on this stack outlives the call */
+        tvl_tx_buffer_t *buf = TVL_TxQueueAcquire(q);
+        if (!buf) {
+            return false;
+        }
+        bool built = extended
+            ? TLV_BuildFrameExt(frame_id, entries, count, buf->data, (uint16_t)sizeof(buf->data), &size)
+            : TLV_BuildFrame(frame_id, entries, count, buf->data, &size);
+        if (!built) {
+            TVL_TxQueueRelease(q, buf);
+            return false;
+        }
+        buf->len = size;
+        TVL_TxQueueSubmit(q, buf);
+        return true;
+    }
+
+    /* Slices for sendv; for a plain sender only when the frame is too big for one copy */
+    if (extended || transport_get_sendv(ctx, interface)) {
+        transport_iovec_t iov[TRANSPORT_SENDV_MAX_IOV];
+        uint8_t n = transport_build_iov(frame_id, entries, count, buffer, (uint16_t)sizeof(buffer), iov);
+        if (n) {
+            return transport_write(ctx, interface, iov, n) >= 0;
+        }
+        if (extended) {
+            return false; /* more large values than TRANSPORT_SENDV_MAX_IOV slices, or over TLV_EXT_MAX_DATA_LENGTH */
+        }
+        /* Too many large values for the slice array: fall through to the copy path */
+    }
+
     if (!TLV_BuildFrame(frame_id, entries, count, buffer, &size)) {
         return false;
     }
-    return Transport_Send(interface, buffer, size) >= 0;
+    return Transport_SendCtx(ctx, interface, buffer, size) >= 0;
+}
+
+/**
+ * @brief Transport_SendTLVs() with a per-call delivery class.
+ *
+ * Piggybacked ACKs go back to the ACK source's restore hook when the frame
+ * is not sent (pool exhausted, frame too large, sender failure).
+ */
+bool Transport_SendTLVsExCtx(tvl_context_t *ctx, tlv_interface_t interface, uint8_t frame_id,
+                             const tlv_entry_t *entries, uint8_t count, transport_delivery_t delivery)
+{
+    transport_lock(ctx);
+    transport_ack_source_ctx_t ack_source_ctx = ctx->tx_ack_source_ctx;
+    transport_ack_source_t ack_source = ctx->tx_ack_source;
+    transport_ack_restore_ctx_t ack_restore = ctx->tx_ack_restore_ctx;
+    transport_unlock(ctx);
+
+    /* Extra TLVs: the best-effort flag first (always within the receiver's entry limit), ACKs last */
+    tlv_entry_t framed[TRANSPORT_PIGGYBACK_MAX_ENTRIES + 1];
+    uint8_t extra = 0;
+    if (delivery == TRANSPORT_DELIVERY_BEST_EFFORT) {
+        if (count > TRANSPORT_PIGGYBACK_MAX_ENTRIES) {
+            return false;
+        }
+        TLV_CreateRawEntry(TLV_TYPE_NO_ACK, NULL, 0, &framed[extra++]);
+    }
+
+    /* Piggyback pending ACKs as one extra TLV when the frame has room */
+    uint8_t ack_value[33];
+    uint8_t ack_type = 0;
+    uint8_t ack_len = 0;
+    if ((ack_source_ctx || ack_source) && (uint16_t)count + extra < TRANSPORT_PIGGYBACK_MAX_ENTRIES) {
+        uint32_t data_length = transport_data_length(entries, count) + 2u * extra;
+        if (data_length + 2u < TLV_MAX_DATA_LENGTH) {
+            uint32_t room = TLV_MAX_DATA_LENGTH - data_length - 2u;
+            uint8_t max_len = (uint8_t)(room < sizeof(ack_value) ? room : sizeof(ack_value));
+            ack_len = ack_source_ctx ? ack_source_ctx(ctx, interface, &ack_type, ack_value, max_len)
+                                     : ack_source(interface, &ack_type, ack_value, max_len);
+        }
+    }
+
+    if (extra || ack_len) {
+        if (count) memcpy(&framed[extra], entries, (size_t)count * sizeof(tlv_entry_t));
+        count = (uint8_t)(count + extra);
+        if (ack_len) {
+            TLV_CreateRawEntry(ack_type, ack_value, ack_len, &framed[count++]);
+        }
+        entries = framed;
+    }
+
+    bool ok = transport_send_entries(ctx, interface, frame_id, entries, count);
+    if (!ok && ack_len && ack_source_ctx && ack_restore) {
+        ack_restore(ctx, interface, ack_type, ack_value, ack_len);
+    }
+    return ok;
+}
+
+bool Transport_SendTLVsEx(tlv_interface_t interface, uint8_t frame_id,
+                          const tlv_entry_t *entries, uint8_t count, transport_delivery_t delivery)
+{
+    return Transport_SendTLVsExCtx(TVL_ContextDefault(), interface, frame_id, entries, count, delivery);
+}
+
+/**
+ * @brief Set the piggyback ACK source used by Transport_SendTLVs().
+ */
+void Transport_SetAckSource(transport_ack_source_t source)
+{
+    tvl_context_t *ctx = TVL_ContextDefault();
+    transport_lock_init(ctx);
+    transport_lock(ctx);
+    ctx->tx_ack_source = source;
+    transport_unlock(ctx);
+}
+
+void Transport_SetAckSourceCtx(tvl_context_t *ctx, transport_ack_source_ctx_t source)
+{
+    transport_lock_init(ctx);
+    transport_lock(ctx);
+    ctx->tx_ack_source_ctx = source;
+    transport_unlock(ctx);
+}
+
+void Transport_SetAckRestoreCtx(tvl_context_t *ctx, transport_ack_restore_ctx_t restore)
+{
+    transport_lock_init(ctx);
+    transport_lock(ctx);
+    ctx->tx_ack_restore_ctx = restore;
+    transport_unlock(ctx);
 }
 
 /**
  * @brief Allocate a frame id for outgoing frames.
  *
- * @note Wraps naturally (uint8_t overflow).
+ * @note Wraps naturally (uint8_t overflow); ids of reliable frames still in flight are skipped.
  */
-uint8_t Transport_NextFrameId(void)
+uint8_t Transport_NextFrameIdCtx(tvl_context_t *ctx)
 {
-    const tvl_hal_vtable_t *hal = TVL_HAL_Get();
-    if (s_transport_lock && hal && hal->mutex_lock) hal->mutex_lock(s_transport_lock);
-    /* 0 is a valid ID; allow wrap naturally */
-    uint8_t id = (uint8_t)(++s_frame_id_counter);
-    if (s_transport_lock && hal && hal->mutex_unlock) hal->mutex_unlock(s_transport_lock);
+    transport_window_lock(ctx);
+    uint8_t id = transport_next_id(ctx);
+    transport_window_unlock(ctx);
     return id;
 }
 
+uint8_t Transport_NextFrameId(void)
+{
+    return Transport_NextFrameIdCtx(TVL_ContextDefault());
+}
+
+/**
+ * @brief Send a frame and keep it in the window until ACKed (see header for policy).
+ */
+bool Transport_SendReliableCtx(tvl_context_t *ctx, tlv_interface_t interface, const tlv_entry_t *entries,
+                               uint8_t count, transport_tx_done_t done, void *user, uint8_t *frame_id)
+{
+    if ((unsigned)interface >= TRANSPORT_INTERFACE_COUNT) {
+        return false;
+    }
+    transport_lock_init(ctx);
+    transport_window_lock(ctx);
+
+    tvl_tx_slot_t *t = NULL;
+    for (uint8_t i = 0; i < TRANSPORT_TX_WINDOW; i++) {
+        if (!ctx->tx_window[interface][i].used) {
+            t = &ctx->tx_window[interface][i];
+            break;
+        }
+    }
+    if (!t) {
+        transport_window_unlock(ctx);
+        return false; /* window full */
+    }
+
+    /* Never reuse an id that is still awaiting its ACK */
+    uint8_t id = transport_next_id(ctx);
+    uint8_t frame[TLV_MAX_FRAME_SIZE];
+    uint16_t len = 0;
+    if (!TLV_BuildFrame(id, entries, count, frame, &len)) {
+        transport_window_unlock(ctx);
+        return false;
+    }
+    /* Claim the slot first (an ACK may beat us back), then send without the window lock */
+    memcpy(t->frame, frame, len);
+    t->len = len;
+    t->used = true;
+    t->frame_id = id;
+    t->retries = 0;
+    t->sent_tick = transport_now();
+    t->done = done;
+    t->user = user;
+    transport_window_unlock(ctx);
+
+    if (Transport_SendCtx(ctx, interface, frame, len) < 0) {
+        /* Not sent: give the slot back, unless something already retired it */
+        transport_window_lock(ctx);
+        bool ours = (transport_find_inflight(ctx, interface, id) == t);
+        if (ours) t->used = false;
+        transport_window_unlock(ctx);
+        return false;
+    }
+
+    if (frame_id) *frame_id = id;
+    return true;
+}
+
+bool Transport_SendReliable(tlv_interface_t interface, const tlv_entry_t *entries, uint8_t count,
+                            transport_tx_done_t done, void *user, uint8_t *frame_id)
+{
+    return Transport_SendReliableCtx(TVL_ContextDefault(), interface, entries, count, done, user, frame_id);
+}
+
+/**
+ * @brief Drive the RTO timer (call from the main loop / a periodic task).
+ */
+void Transport_PollCtx(tvl_context_t *ctx)
+{
+    uint8_t frame[TLV_MAX_FRAME_SIZE];
+
+    /* One slot per lock hold: retransmissions and callbacks run unlocked */
+    for (uint8_t ifc = 0; ifc < TRANSPORT_INTERFACE_COUNT; ifc++) {
+        for (uint8_t i = 0; i < TRANSPORT_TX_WINDOW; i++) {
+            transport_tx_event_t ev;
+            uint8_t n = 0;
+            uint16_t len = 0;
+
+            transport_window_lock(ctx);
+            uint32_t now = transport_now();
+            tvl_tx_slot_t *t = &ctx->tx_window[ifc][i];
+            if (t->used && (uint32_t)(now - t->sent_tick) >= TRANSPORT_TX_RTO_MS) {
+                n = transport_retry_or_fail(t, TRANSPORT_TX_TIMEOUT, now, &ev, frame, &len) ? 1u : 0u;
+            }
+            transport_window_unlock(ctx);
+
+            if (len) (void)Transport_SendCtx(ctx, (tlv_interface_t)ifc, frame, len); /* a failed write is just another lost frame */
+            transport_report(&ev, n);
+        }
+    }
+}
+
+void Transport_Poll(void)
+{
+    Transport_PollCtx(TVL_ContextDefault());
+}
+
+uint8_t Transport_InFlightCtx(tvl_context_t *ctx, tlv_interface_t interface)
+{
+    if ((unsigned)interface >= TRANSPORT_INTERFACE_COUNT) {
+        return 0;
+    }
+    uint8_t n = 0;
+    transport_window_lock(ctx);
+    for (uint8_t i = 0; i < TRANSPORT_TX_WINDOW; i++) {
+        if (ctx->tx_window[interface][i].used) n++;
+    }
+    transport_window_unlock(ctx);
+    return n;
+}
+
+uint8_t Transport_InFlight(tlv_interface_t interface)
+{
+    return Transport_InFlightCtx(TVL_ContextDefault(), interface);
+}
+
+void Transport_HandleAckCtx(tvl_context_t *ctx, uint8_t frame_id, tlv_interface_t interface)
+{
+    if ((unsigned)interface >= TRANSPORT_INTERFACE_COUNT) {
+        return;
+    }
+    transport_tx_event_t ev;
+    uint8_t n = 0;
+
+    transport_window_lock(ctx);
+    tvl_tx_slot_t *t = transport_find_inflight(ctx, interface, frame_id);
+    if (t) {
+        ev.done = t->done;
+        ev.user = t->user;
+        ev.frame_id = frame_id;
+        ev.status = TRANSPORT_TX_ACKED;
+        t->used = false;
+        n = 1;
+    }
+    transport_window_unlock(ctx);
+
+    transport_report(&ev, n);
+}
+
+void Transport_HandleAck(uint8_t frame_id, tlv_interface_t interface)
+{
+    Transport_HandleAckCtx(TVL_ContextDefault(), frame_id, interface);
+}
+
+void Transport_HandleNackCtx(tvl_context_t *ctx, uint8_t frame_id, tlv_interface_t interface)
+{
+    tlv_nack_info_t info;
+    info.frame_id = frame_id;
+    info.count = 0;
+    Transport_HandleNackExCtx(ctx, &info, interface);
+}
+
+void Transport_HandleNack(uint8_t frame_id, tlv_interface_t interface)
+{
+    Transport_HandleNackCtx(TVL_ContextDefault(), frame_id, interface);
+}
+
+void Transport_HandleNackExCtx(tvl_context_t *ctx, const tlv_nack_info_t *nack, tlv_interface_t interface)
+{
+    if (!nack || (unsigned)interface >= TRANSPORT_INTERFACE_COUNT) {
+        return;
+    }
+    transport_tx_event_t ev;
+    uint8_t n = 0;
+    uint8_t frame[TLV_MAX_FRAME_SIZE];
+    uint16_t len = 0;
+
+    transport_window_lock(ctx);
+    tvl_tx_slot_t *t = transport_find_inflight(ctx, interface, nack->frame_id);
+    if (t) {
+        if (transport_nack_is_final(nack)) {
+            t->retries = TRANSPORT_TX_MAX_RETRIES; /* the receiver can never take it: fail now */
+        } else if (nack->count && t->retries < TRANSPORT_TX_MAX_RETRIES) {
+            transport_trim_to_rejected(t, nack);
+        }
+        if (transport_retry_or_fail(t, TRANSPORT_TX_NACKED, transport_now(), &ev, frame, &len)) {
+            n = 1;
+        }
+    }
+    transport_window_unlock(ctx);
+
+    if (len) (void)Transport_SendCtx(ctx, interface, frame, len); /* a failed write is just another lost frame */
+    transport_report(&ev, n);
+}
+
+void Transport_HandleNackEx(const tlv_nack_info_t *nack, tlv_interface_t interface)
+{
+    Transport_HandleNackExCtx(TVL_ContextDefault(), nack, interface);
+}
+
+/**
+ * @brief Resend only the entries a selective NACK rejected, as a new frame.
+ */
+bool Transport_ResendRejectedCtx(tvl_context_t *ctx, tlv_interface_t interface, const tlv_entry_t *entries,
+                                 uint8_t count, const tlv_nack_info_t *nack, uint8_t *frame_id)
+{
+    if (!entries || !nack || transport_nack_is_final(nack)) {
+        return false;
+    }
+    tlv_entry_t keep[TLV_NACK_MAX_ITEMS];
+    uint8_t n = count;
+    if (nack->count) {
+        n = transport_select_rejected(entries, count, nack, keep);
+        entries = keep;
+    }
+    if (n == 0) {
+        return false;
+    }
+    uint8_t id = Transport_NextFrameIdCtx(ctx);
+    if (frame_id) *frame_id = id;
+    return Transport_SendTLVsCtx(ctx, interface, id, entries, n);
+}
+
+bool Transport_ResendRejected(tlv_interface_t interface, const tlv_entry_t *entries, uint8_t count,
+                              const tlv_nack_info_t *nack, uint8_t *frame_id)
+{
+    return Transport_ResendRejectedCtx(TVL_ContextDefault(), interface, entries, count, nack, frame_id);
+}
+
 /* USER CODE END 1 */
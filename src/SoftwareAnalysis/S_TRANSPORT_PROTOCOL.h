@@ -15,6 +15,18 @@
  * Thread-safety:
  * - Internally uses optional HAL mutex (see src/HAL/hal.h) when available.
  * - If no mutex is provided, functions are not thread-safe.
+ * - With mutexes, writes to one interface never interleave: concurrent
+ *   Transport_Send*() callers queue their frames and one of them (the
+ *   combiner) writes all queued frames, in order, in as few sender calls as
+ *   possible; the others just wait for their result. The sender therefore
+ *   never runs on two threads at once for the same interface, and must not
+ *   send on that interface itself (HAL mutexes need not be recursive): such a
+ *   send fails with -4 instead of deadlocking (where TVLCOM_HAVE_THREAD_LOCAL).
+ *
+ * Multiple links:
+ * - Senders, the frame id counter and the reliable-send window live in a
+ *   tvl_context_t (S_CONTEXT.h). Each function has a *Ctx variant taking the
+ *   context first; the plain functions use TVL_ContextDefault().
  *
  ******************************************************************************
  */
@@ -50,11 +62,118 @@ extern "C" {
  */
 typedef int (*transport_send_func_t)(const uint8_t *data, uint16_t len);
 
+/* One contiguous slice of an outgoing frame */
+typedef struct {
+    const uint8_t *base;
+    uint16_t len;
+} transport_iovec_t;
+
+/* Function pointer for scatter-gather TX (e.g., POSIX writev)
+ *
+ * Expected semantics:
+ * - The slices form complete frames, in order; send all of them or fail.
+ *   Usually one frame; the combining writer passes several queued frames at once.
+ * - Return >=0 on success (typically total bytes written), <0 on error.
+ * - Slices may point into caller memory; they are only valid during the call.
+ */
+typedef int (*transport_sendv_func_t)(const transport_iovec_t *iov, uint8_t iovcnt);
+
+/* Delivery class of one Transport_SendTLVsEx() call */
+typedef enum {
+    TRANSPORT_DELIVERY_ACKED = 0,     /* receiver answers with ACK/NACK (default) */
+    TRANSPORT_DELIVERY_BEST_EFFORT,   /* TLV_TYPE_NO_ACK flag: dispatched, never answered */
+} transport_delivery_t;
+
+/* Final outcome of a reliable send */
+typedef enum {
+    TRANSPORT_TX_ACKED = 0,   /* peer ACKed the frame */
+    TRANSPORT_TX_NACKED,      /* peer NACKed every attempt */
+    TRANSPORT_TX_TIMEOUT,     /* no answer after the last retransmission */
+} transport_tx_status_t;
+
+/*
+ * Source of pending ACKs to piggyback on outgoing frames (see Transport_SetAckSource).
+ * Writes one ACK TLV (type + value, value at most max_len bytes) and removes those
+ * ids from its queue. Returns the value length, or 0 when nothing fits or is pending.
+ */
+typedef uint8_t (*transport_ack_source_t)(tlv_interface_t interface, uint8_t *type, uint8_t *value, uint8_t max_len);
+
+/* Per-link protocol state, defined in S_CONTEXT.h */
+typedef struct tvl_context tvl_context_t;
+
+/* Asynchronous TX queue with a frame buffer pool, defined in S_TX_QUEUE.h */
+typedef struct tvl_tx_queue tvl_tx_queue_t;
+
+/* transport_send_func_t carrying the pointer given at registration (e.g. the link's serial handle) */
+typedef int (*transport_send_ex_func_t)(void *user, const uint8_t *data, uint16_t len);
+
+/* transport_ack_source_t for one context (see Transport_SetAckSourceCtx) */
+typedef uint8_t (*transport_ack_source_ctx_t)(tvl_context_t *ctx, tlv_interface_t interface,
+                                              uint8_t *type, uint8_t *value, uint8_t max_len);
+
+/*
+ * Gives back an ACK TLV taken from a transport_ack_source_ctx_t when the frame
+ * carrying it could not be sent (see Transport_SetAckRestoreCtx).
+ */
+typedef void (*transport_ack_restore_ctx_t)(tvl_context_t *ctx, tlv_interface_t interface,
+                                            uint8_t type, const uint8_t *value, uint8_t len);
+
+/* Per-frame completion callback for Transport_SendReliable() (called without locks held) */
+typedef void (*transport_tx_done_t)(uint8_t frame_id, transport_tx_status_t status, void *user);
+
+/* Writer counters of one interface (see Transport_GetWriteStats) */
+typedef struct {
+    uint32_t frames;        /* frames handed to the sender */
+    uint32_t writes;        /* sender calls; below 'frames' when frames were combined */
+    uint32_t combined;      /* frames that shared a sender call with others */
+    uint16_t max_batch;     /* most frames in one sender call */
+} transport_write_stats_t;
+
 /* USER CODE END ET */
 
 /* Exported constants --------------------------------------------------------*/
 /* USER CODE BEGIN EC */
 
+/* Max slices Transport_SendTLVs() hands to a sendv backend; frames needing more are copied */
+#ifndef TRANSPORT_SENDV_MAX_IOV
+#define TRANSPORT_SENDV_MAX_IOV     32
+#endif
+
+/* Values shorter than this are copied next to their TLV header instead of getting a slice */
+#ifndef TRANSPORT_SENDV_COPY_BELOW
+#define TRANSPORT_SENDV_COPY_BELOW  16
+#endif
+
+/* Piggybacked ACKs are only added to frames with fewer entries (receivers parse 16 per frame) */
+#ifndef TRANSPORT_PIGGYBACK_MAX_ENTRIES
+#define TRANSPORT_PIGGYBACK_MAX_ENTRIES 15
+#endif
+
+/* Reliable send: frames in flight per interface (each keeps a TLV_MAX_FRAME_SIZE copy) */
+#ifndef TRANSPORT_TX_WINDOW
+#define TRANSPORT_TX_WINDOW         4
+#endif
+
+/* Reliable send: retransmission timeout, measured with HAL tick_ms */
+#ifndef TRANSPORT_TX_RTO_MS
+#define TRANSPORT_TX_RTO_MS         200
+#endif
+
+/* Reliable send: retransmissions before the frame is reported as failed */
+#ifndef TRANSPORT_TX_MAX_RETRIES
+#define TRANSPORT_TX_MAX_RETRIES    3
+#endif
+
+/* Combining writer: bytes per interface to gather frames for one plain-sender call (0: one call per frame) */
+#ifndef TRANSPORT_COMBINE_BYTES
+#define TRANSPORT_COMBINE_BYTES     1024
+#endif
+
+/* Combining writer: most slices in one sendv call (several frames) */
+#ifndef TRANSPORT_COMBINE_MAX_IOV
+#define TRANSPORT_COMBINE_MAX_IOV   (2 * TRANSPORT_SENDV_MAX_IOV)
+#endif
+
 /* USER CODE END EC */
 
 /* Exported macro ------------------------------------------------------------*/
@@ -73,6 +192,19 @@ typedef int (*transport_send_func_t)(const uint8_t *data, uint16_t len);
  */
 void Transport_RegisterSender(tlv_interface_t interface, transport_send_func_t fn);
 
+/**
+ * @brief Register a scatter-gather sender for a given interface (optional).
+ *
+ * When set, Transport_SendTLVs() passes large TLV values to the backend as
+ * slices of the caller's memory instead of copying them into a frame buffer.
+ * The plain sender (Transport_RegisterSender) is still used by Transport_Send();
+ * frames of concurrent senders combined into one write go through sendv.
+ *
+ * @param interface TLV interface (UART/USB).
+ * @param fn        Sender callback. Pass NULL to clear.
+ */
+void Transport_RegisterSenderV(tlv_interface_t interface, transport_sendv_func_t fn);
+
 /**
  * @brief Send a raw byte buffer over the selected interface.
  *
@@ -80,12 +212,56 @@ void Transport_RegisterSender(tlv_interface_t interface, transport_send_func_t f
  * @param data      Buffer pointer.
  * @param len       Buffer length in bytes.
  * @return >=0 on success, <0 on error (or when sender is not registered).
+ *         With a TX queue attached the frame is copied and queued: -3 when
+ *         the queue's buffer pool is exhausted; -4 when called from the
+ *         interface's own sender (see Thread-safety above).
  */
 int Transport_Send(tlv_interface_t interface, const uint8_t *data, uint16_t len);
 
+/**
+ * @brief Counters of the interface's writer (frames, sender calls, combining).
+ */
+void Transport_GetWriteStats(tlv_interface_t interface, transport_write_stats_t *stats);
+
+/**
+ * @brief Send asynchronously through a TX queue (S_TX_QUEUE.h); NULL restores synchronous sends.
+ *
+ * Every send on the interface (frames, ACK/NACK replies, retransmissions) is
+ * then built in a pool buffer and queued; the queue's drain step calls the
+ * registered sender. Frames must fit a pool buffer (TVLCOM_TX_FRAME_SIZE;
+ * raise it to queue extended frames) and the sendv backend is not used. Initialise the queue with
+ * TVL_TxQueueInit() first; a queue serves one (context, interface).
+ */
+void Transport_SetTxQueue(tlv_interface_t interface, tvl_tx_queue_t *q);
+
+/**
+ * @brief Send a frame given as a list of slices.
+ *
+ * Uses the sendv backend when registered; otherwise the slices are gathered
+ * into a TLV_MAX_FRAME_SIZE stack buffer and passed to the plain sender, or
+ * (larger frames) passed to it one slice per call, with no other frame between.
+ *
+ * @param interface TLV interface.
+ * @param iov       Slices, in frame order.
+ * @param iovcnt    Number of slices.
+ * @return >=0 on success, <0 on error (no sender, or gathered frame too large).
+ */
+int Transport_SendV(tlv_interface_t interface, const transport_iovec_t *iov, uint8_t iovcnt);
+
 /**
  * @brief Build a frame from TLVs and send it.
  *
+ * With a sendv backend, values of TRANSPORT_SENDV_COPY_BELOW bytes or more
+ * are sent straight from entry->value (no copy); the frame header, TLV headers,
+ * short values and CRC/tail are packed into a small scratch buffer.
+ * TLVs over TLV_MAX_DATA_LENGTH are sent as an extended frame (up to
+ * TLV_EXT_MAX_DATA_LENGTH) on every path: as slices to sendv or to the plain
+ * sender, or built in a TX queue pool buffer. It fails if the frame needs more
+ * than TRANSPORT_SENDV_MAX_IOV slices or does not fit the pool buffer.
+ *
+ * When an ACK source is set (Transport_SetAckSource), pending ACKs are
+ * appended as one more TLV if the frame stays within TLV_MAX_DATA_LENGTH.
+ *
  * @param interface TLV interface.
  * @param frame_id  Frame ID (match for ACK/NACK). Use Transport_NextFrameId().
  * @param entries   TLV entries.
@@ -95,15 +271,150 @@ int Transport_Send(tlv_interface_t interface, const uint8_t *data, uint16_t len)
 bool Transport_SendTLVs(tlv_interface_t interface, uint8_t frame_id,
                         const tlv_entry_t *entries, uint8_t count);
 
+/**
+ * @brief Build a frame from TLVs and send it with an explicit delivery class.
+ *
+ * TRANSPORT_DELIVERY_BEST_EFFORT prepends a zero-length TLV_TYPE_NO_ACK entry
+ * (2 bytes): the receiver dispatches the frame but sends neither ACK nor NACK.
+ * Meant for periodic telemetry where the next sample supersedes a lost one.
+ * Best-effort frames take at most TRANSPORT_PIGGYBACK_MAX_ENTRIES entries.
+ *
+ * @param interface TLV interface.
+ * @param frame_id  Frame ID. Use Transport_NextFrameId().
+ * @param entries   TLV entries.
+ * @param count     Number of entries.
+ * @param delivery  TRANSPORT_DELIVERY_ACKED (same as Transport_SendTLVs) or _BEST_EFFORT.
+ * @return true if frame was built and sent successfully.
+ */
+bool Transport_SendTLVsEx(tlv_interface_t interface, uint8_t frame_id,
+                          const tlv_entry_t *entries, uint8_t count, transport_delivery_t delivery);
+
+/**
+ * @brief Set the source of ACKs piggybacked by Transport_SendTLVs() (NULL to disable).
+ *
+ * Installed by FloatReceive_SetAckPiggyback(); applications normally don't call this.
+ */
+void Transport_SetAckSource(transport_ack_source_t source);
+
 /**
  * @brief Allocate the next frame id.
  *
- * The counter is monotonic and wraps naturally at 0xFF back to 0x00.
+ * The counter is monotonic and wraps naturally at 0xFF back to 0x00; ids of
+ * reliable frames still awaiting an ACK (on any interface) are skipped, so a
+ * plain frame's ACK never completes a Transport_SendReliable() frame.
  *
  * @return Next frame id.
  */
 uint8_t Transport_NextFrameId(void);
 
+/**
+ * @brief Build a frame and send it with retransmission until it is ACKed.
+ *
+ * Up to TRANSPORT_TX_WINDOW frames per interface may be outstanding at once
+ * (sliding window, no stop-and-wait). A frame is resent unchanged, with the
+ * same frame id, on NACK or when TRANSPORT_TX_RTO_MS pass without an answer;
+ * after TRANSPORT_TX_MAX_RETRIES retransmissions 'done' reports failure.
+ *
+ * Frame ids come from Transport_NextFrameId(); ids still in flight are
+ * skipped, so the 8-bit counter can wrap freely while frames are outstanding.
+ * The window lock is never held while the sender runs: a sender may call back
+ * into the transport (e.g. Transport_InFlight()) without deadlocking.
+ *
+ * ACK/NACK frames received by FloatReceive_FrameCallback() are routed here
+ * automatically. Call Transport_Poll() periodically to drive the RTO timer.
+ *
+ * @param interface TLV interface.
+ * @param entries   TLV entries (copied; classic frames only).
+ * @param count     Number of entries.
+ * @param done      Completion callback (may be NULL).
+ * @param user      Passed back to 'done'.
+ * @param frame_id  Optional out: id assigned to the frame.
+ * @return false if the window is full, the frame cannot be built or the first send fails.
+ */
+bool Transport_SendReliable(tlv_interface_t interface, const tlv_entry_t *entries, uint8_t count,
+                            transport_tx_done_t done, void *user, uint8_t *frame_id);
+
+/**
+ * @brief Retransmit reliable frames whose RTO expired; report those out of retries.
+ */
+void Transport_Poll(void);
+
+/**
+ * @brief Number of reliable frames awaiting ACK on an interface.
+ */
+uint8_t Transport_InFlight(tlv_interface_t interface);
+
+/**
+ * @brief ACK received for frame_id: complete the matching reliable frame (if any).
+ */
+void Transport_HandleAck(uint8_t frame_id, tlv_interface_t interface);
+
+/**
+ * @brief NACK received for frame_id: retransmit the matching reliable frame (if any).
+ */
+void Transport_HandleNack(uint8_t frame_id, tlv_interface_t interface);
+
+/**
+ * @brief Selective NACK received: retransmit only the rejected TLVs of the matching reliable frame.
+ *
+ * The frame keeps its id and is rebuilt from the stored copy with just the
+ * listed entries; a NACK without items resends the frame unchanged.
+ */
+void Transport_HandleNackEx(const tlv_nack_info_t *nack, tlv_interface_t interface);
+
+/**
+ * @brief Resend only the entries rejected by a selective NACK, as a new frame.
+ *
+ * For frames sent with Transport_SendTLVs(): pass the same entries array and
+ * the NACK decoded with TLV_ParseNack() (e.g. in a NACK detail handler).
+ * An entry is resent when the NACK lists its index with a matching type.
+ * A legacy NACK (no items) resends all entries.
+ *
+ * @param interface TLV interface.
+ * @param entries   Entries of the original frame, in the original order.
+ * @param count     Number of entries.
+ * @param nack      Decoded NACK for that frame.
+ * @param frame_id  Optional out: id of the new frame.
+ * @return false if nothing matched or sending failed.
+ */
+bool Transport_ResendRejected(tlv_interface_t interface, const tlv_entry_t *entries, uint8_t count,
+                              const tlv_nack_info_t *nack, uint8_t *frame_id);
+
+/*
+ * Context variants: same behaviour as the functions above, applied to 'ctx'
+ * instead of TVL_ContextDefault(). Frame ids and the reliable-send window are
+ * per context, so links never wait on each other's ACKs.
+ */
+void Transport_RegisterSenderCtx(tvl_context_t *ctx, tlv_interface_t interface, transport_send_func_t fn);
+void Transport_RegisterSenderVCtx(tvl_context_t *ctx, tlv_interface_t interface, transport_sendv_func_t fn);
+/* Sender with a user pointer, so one function can serve many links; takes precedence over RegisterSender */
+void Transport_RegisterSenderExCtx(tvl_context_t *ctx, tlv_interface_t interface,
+                                   transport_send_ex_func_t fn, void *user);
+int Transport_SendCtx(tvl_context_t *ctx, tlv_interface_t interface, const uint8_t *data, uint16_t len);
+void Transport_SetTxQueueCtx(tvl_context_t *ctx, tlv_interface_t interface, tvl_tx_queue_t *q);
+/* Registered sender, bypassing an attached TX queue (the queue's drain step) */
+int Transport_SendDirectCtx(tvl_context_t *ctx, tlv_interface_t interface, const uint8_t *data, uint16_t len);
+int Transport_SendVCtx(tvl_context_t *ctx, tlv_interface_t interface, const transport_iovec_t *iov, uint8_t iovcnt);
+void Transport_GetWriteStatsCtx(tvl_context_t *ctx, tlv_interface_t interface, transport_write_stats_t *stats);
+bool Transport_SendTLVsCtx(tvl_context_t *ctx, tlv_interface_t interface, uint8_t frame_id,
+                           const tlv_entry_t *entries, uint8_t count);
+bool Transport_SendTLVsExCtx(tvl_context_t *ctx, tlv_interface_t interface, uint8_t frame_id,
+                             const tlv_entry_t *entries, uint8_t count, transport_delivery_t delivery);
+/* Takes precedence over a source set with Transport_SetAckSource() on the same context */
+void Transport_SetAckSourceCtx(tvl_context_t *ctx, transport_ack_source_ctx_t source);
+/* Called with the piggybacked ACKs when a frame fails to send, so they are not lost */
+void Transport_SetAckRestoreCtx(tvl_context_t *ctx, transport_ack_restore_ctx_t restore);
+uint8_t Transport_NextFrameIdCtx(tvl_context_t *ctx);
+bool Transport_SendReliableCtx(tvl_context_t *ctx, tlv_interface_t interface, const tlv_entry_t *entries,
+                               uint8_t count, transport_tx_done_t done, void *user, uint8_t *frame_id);
+void Transport_PollCtx(tvl_context_t *ctx);
+uint8_t Transport_InFlightCtx(tvl_context_t *ctx, tlv_interface_t interface);
+void Transport_HandleAckCtx(tvl_context_t *ctx, uint8_t frame_id, tlv_interface_t interface);
+void Transport_HandleNackCtx(tvl_context_t *ctx, uint8_t frame_id, tlv_interface_t interface);
+void Transport_HandleNackExCtx(tvl_context_t *ctx, const tlv_nack_info_t *nack, tlv_interface_t interface);
+bool Transport_ResendRejectedCtx(tvl_context_t *ctx, tlv_interface_t interface, const tlv_entry_t *entries,
+                                 uint8_t count, const tlv_nack_info_t *nack, uint8_t *frame_id);
+
 /* USER CODE END EFP */
 
 /* Private defines -----------------------------------------------------------*/
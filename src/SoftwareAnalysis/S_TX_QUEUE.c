@@ -0,0 +1,363 @@
+/**
+ ******************************************************************************
+ * @file           : S_TX_QUEUE.c
+ * @brief          : Asynchronous TX queue with a fixed frame buffer pool.
+ * @author         : UF4OVER
+ * @date           : 2026-02-09
+ ******************************************************************************
+ * @attention
+ *
+ * See S_TX_QUEUE.h. Buffers move between two index rings of
+ * TVLCOM_TX_POOL_FRAMES cells: free_ring (pool) and send_ring (queued, in
+ * order). Each buffer index is in at most one ring at a time, so pushing
+ * to a ring never finds it full.
+ *
+ * Ring algorithm (bounded MPMC queue with per-cell sequence numbers):
+ * cell i starts with seq = i. A producer owning position pos may write the
+ * cell when seq == pos and publishes it with seq = pos + 1; a consumer owning
+ * pos may read it when seq == pos + 1 and frees it with seq = pos + size.
+ * Positions are claimed with a CAS; a cell claimed but not yet published
+ * reads as "not ready", which keeps the order of claimed positions.
+ *
+ ******************************************************************************
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "S_TX_QUEUE.h"
+
+/* USER CODE BEGIN Includes */
+#include <string.h>
+/* USER CODE END Includes */
+
+/* Private define ------------------------------------------------------------*/
+/* USER CODE BEGIN PD */
+
+#define TXQ_MASK ((uint32_t)TVLCOM_TX_POOL_FRAMES - 1u)
+
+/* USER CODE END PD */
+
+/* Private user code ---------------------------------------------------------*/
+/* USER CODE BEGIN 0 */
+
+#if TVLCOM_TX_QUEUE_ATOMIC
+
+static void txq_ring_init(tvl_tx_ring_t *r)
+{
+    atomic_init(&r->enqueue_pos, 0u);
+    atomic_init(&r->dequeue_pos, 0u);
+    for (uint32_t i = 0; i < TVLCOM_TX_POOL_FRAMES; ++i) {
+        atomic_init(&r->cells[i].seq, i);
+        r->cells[i].buffer = 0;
+    }
+}
+
+static bool txq_ring_push(tvl_tx_ring_t *r, uint32_t buffer)
+{
+    uint32_t pos = atomic_load_explicit(&r->enqueue_pos, memory_order_relaxed);
+    tvl_tx_cell_t *cell;
+    for (;;) {
+        cell = &r->cells[pos & TXQ_MASK];
+        uint32_t seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+        int32_t dif = (int32_t)(seq - pos);
+        if (dif == 0) {
+            if (atomic_compare_exchange_weak_explicit(&r->enqueue_pos, &pos, pos + 1u,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        } else if (dif < 0) {
+            return false; /* full: cannot happen while every index is in one ring only */
+        } else {
+            pos = atomic_load_explicit(&r->enqueue_pos, memory_order_relaxed);
+        }
+    }
+    cell->buffer = buffer;
+    atomic_store_explicit(&cell->seq, pos + 1u, memory_order_release);
+    return true;
+}
+
+static bool txq_ring_pop(tvl_tx_ring_t *r, uint32_t *buffer)
+{
+    uint32_t pos = atomic_load_explicit(&r->dequeue_pos, memory_order_relaxed);
+    tvl_tx_cell_t *cell;
+    for (;;) {
+        cell = &r->cells[pos & TXQ_MASK];
+        uint32_t seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+        int32_t dif = (int32_t)(seq - (pos + 1u));
+        if (dif == 0) {
+            if (atomic_compare_exchange_weak_explicit(&r->dequeue_pos, &pos, pos + 1u,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        } else if (dif < 0) {
+            return false; /* empty (or the next position is not published yet) */
+        } else {
+            pos = atomic_load_explicit(&r->dequeue_pos, memory_order_relaxed);
+        }
+    }
+    *buffer = cell->buffer;
+    atomic_store_explicit(&cell->seq, pos + TXQ_MASK + 1u, memory_order_release);
+    return true;
+}
+
+/* Single consumer: look at the next cell without taking it */
+static bool txq_ring_peek(tvl_tx_ring_t *r, uint32_t *buffer)
+{
+    uint32_t pos = atomic_load_explicit(&r->dequeue_pos, memory_order_relaxed);
+    tvl_tx_cell_t *cell = &r->cells[pos & TXQ_MASK];
+    if (atomic_load_explicit(&cell->seq, memory_order_acquire) != pos + 1u) return false;
+    *buffer = cell->buffer;
+    return true;
+}
+
+static void txq_count(tvl_tx_counter_t *c)
+{
+    atomic_fetch_add_explicit(c, 1u, memory_order_relaxed);
+}
+
+static void txq_signal(tvl_tx_queue_t *q)
+{
+    const tvl_hal_vtable_t *hal = TVL_HAL_Get();
+    if (q->wake && hal && hal->event_signal) hal->event_signal(q->wake);
+}
+
+static uint32_t txq_index_of(const tvl_tx_queue_t *q, const tvl_tx_buffer_t *buf)
+{
+    return (uint32_t)(buf - q->buffers);
+}
+
+static void txq_put_back(tvl_tx_queue_t *q, uint32_t index)
+{
+    (void)txq_ring_push(&q->free_ring, index);
+    atomic_fetch_sub_explicit(&q->in_use, 1u, memory_order_relaxed);
+}
+
+#endif /* TVLCOM_TX_QUEUE_ATOMIC */
+
+/* USER CODE END 0 */
+
+/* Exported functions --------------------------------------------------------*/
+/* USER CODE BEGIN 1 */
+
+#if TVLCOM_TX_QUEUE_ATOMIC
+
+bool TVL_TxQueueInit(tvl_tx_queue_t *q)
+{
+    if (!q) return false;
+    memset(q, 0, sizeof(*q));
+    txq_ring_init(&q->free_ring);
+    txq_ring_init(&q->send_ring);
+    atomic_init(&q->queued, 0u);
+    atomic_init(&q->sent, 0u);
+    atomic_init(&q->errors, 0u);
+    atomic_init(&q->rejected, 0u);
+    atomic_init(&q->in_use, 0u);
+    atomic_init(&q->high_water, 0u);
+    for (uint32_t i = 0; i < TVLCOM_TX_POOL_FRAMES; ++i) (void)txq_ring_push(&q->free_ring, i);
+
+    const tvl_hal_vtable_t *hal = TVL_HAL_Get();
+    if (hal && hal->event_create) q->wake = hal->event_create();
+    return true;
+}
+
+void TVL_TxQueueDeinit(tvl_tx_queue_t *q)
+{
+    if (!q) return;
+    const tvl_hal_vtable_t *hal = TVL_HAL_Get();
+    if (q->wake && hal && hal->event_destroy) hal->event_destroy(q->wake);
+    memset(q, 0, sizeof(*q));
+}
+
+void TVL_TxQueueSetKick(tvl_tx_queue_t *q, tvl_tx_kick_t kick, void *user)
+{
+    if (!q) return;
+    q->kick_user = user;
+    q->kick = kick;
+}
+
+tvl_tx_buffer_t *TVL_TxQueueAcquire(tvl_tx_queue_t *q)
+{
+    if (!q) return NULL;
+    uint32_t index;
+    if (!txq_ring_pop(&q->free_ring, &index)) {
+        txq_count(&q->rejected);
+        return NULL;
+    }
+    uint32_t used = atomic_fetch_add_explicit(&q->in_use, 1u, memory_order_relaxed) + 1u;
+    uint32_t hw = atomic_load_explicit(&q->high_water, memory_order_relaxed);
+    while (used > hw && !atomic_compare_exchange_weak_explicit(&q->high_water, &hw, used,
+                                                               memory_order_relaxed, memory_order_relaxed)) {
+    }
+    q->buffers[index].len = 0;
+    return &q->buffers[index];
+}
+
+void TVL_TxQueueSubmit(tvl_tx_queue_t *q, tvl_tx_buffer_t *buf)
+{
+    if (!q || !buf) return;
+    (void)txq_ring_push(&q->send_ring, txq_index_of(q, buf));
+    txq_count(&q->queued);
+    txq_signal(q);
+    if (q->kick) q->kick(q, q->kick_user);
+}
+
+void TVL_TxQueueRelease(tvl_tx_queue_t *q, tvl_tx_buffer_t *buf)
+{
+    if (!q || !buf) return;
+    txq_put_back(q, txq_index_of(q, buf));
+}
+
+bool TVL_TxQueuePost(tvl_tx_queue_t *q, const uint8_t *data, uint16_t len)
+{
+    if (!q || !data || len > TVLCOM_TX_FRAME_SIZE) {
+        if (q) txq_count(&q->rejected);
+        return false;
+    }
+    tvl_tx_buffer_t *buf = TVL_TxQueueAcquire(q);
+    if (!buf) return false;
+    memcpy(buf->data, data, len);
+    buf->len = len;
+    TVL_TxQueueSubmit(q, buf);
+    return true;
+}
+
+const uint8_t *TVL_TxQueuePeek(tvl_tx_queue_t *q, uint16_t *len)
+{
+    uint32_t index;
+    if (!q || !txq_ring_peek(&q->send_ring, &index)) return NULL;
+    if (len) *len = q->buffers[index].len;
+    return q->buffers[index].data;
+}
+
+void TVL_TxQueueComplete(tvl_tx_queue_t *q)
+{
+    uint32_t index;
+    if (!q || !txq_ring_pop(&q->send_ring, &index)) return;
+    txq_count(&q->sent);
+    txq_put_back(q, index);
+}
+
+uint16_t TVL_TxQueueDrain(tvl_tx_queue_t *q, uint16_t max_frames)
+{
+    if (!q || !q->ctx) return 0;
+    uint16_t done = 0;
+    while (done < max_frames) {
+        uint16_t len = 0;
+        const uint8_t *frame = TVL_TxQueuePeek(q, &len);
+        if (!frame) break;
+        if (Transport_SendDirectCtx(q->ctx, q->interface, frame, len) < 0) txq_count(&q->errors);
+        TVL_TxQueueComplete(q);
+        done++;
+    }
+    return done;
+}
+
+uint16_t TVL_TxQueueRun(tvl_tx_queue_t *q, uint32_t timeout_ms)
+{
+    if (!q) return 0;
+    uint16_t done = TVL_TxQueueDrain(q, UINT16_MAX);
+    if (done) return done;
+
+    const tvl_hal_vtable_t *hal = TVL_HAL_Get();
+    if (q->wake && hal && hal->event_wait) {
+        (void)hal->event_wait(q->wake, timeout_ms);
+    } else if (hal && hal->sleep_ms && timeout_ms) {
+        hal->sleep_ms(1u); /* no event: poll */
+    }
+    return TVL_TxQueueDrain(q, UINT16_MAX);
+}
+
+void TVL_TxQueueWake(tvl_tx_queue_t *q)
+{
+    if (q) txq_signal(q);
+}
+
+void TVL_TxQueueGetStats(tvl_tx_queue_t *q, tvl_tx_queue_stats_t *stats)
+{
+    if (!stats) return;
+    memset(stats, 0, sizeof(*stats));
+    if (!q) return;
+    stats->queued = atomic_load_explicit(&q->queued, memory_order_relaxed);
+    stats->sent = atomic_load_explicit(&q->sent, memory_order_relaxed);
+    stats->errors = atomic_load_explicit(&q->errors, memory_order_relaxed);
+    stats->rejected = atomic_load_explicit(&q->rejected, memory_order_relaxed);
+    stats->in_use = (uint16_t)atomic_load_explicit(&q->in_use, memory_order_relaxed);
+    stats->high_water = (uint16_t)atomic_load_explicit(&q->high_water, memory_order_relaxed);
+}
+
+#else /* !TVLCOM_TX_QUEUE_ATOMIC: no async TX, the transport stays synchronous */
+
+bool TVL_TxQueueInit(tvl_tx_queue_t *q)
+{
+    if (q) memset(q, 0, sizeof(*q));
+    return false;
+}
+
+void TVL_TxQueueDeinit(tvl_tx_queue_t *q)
+{
+    (void)q;
+}
+
+void TVL_TxQueueSetKick(tvl_tx_queue_t *q, tvl_tx_kick_t kick, void *user)
+{
+    (void)q; (void)kick; (void)user;
+}
+
+tvl_tx_buffer_t *TVL_TxQueueAcquire(tvl_tx_queue_t *q)
+{
+    (void)q;
+    return NULL;
+}
+
+void TVL_TxQueueSubmit(tvl_tx_queue_t *q, tvl_tx_buffer_t *buf)
+{
+    (void)q; (void)buf;
+}
+
+void TVL_TxQueueRelease(tvl_tx_queue_t *q, tvl_tx_buffer_t *buf)
+{
+    (void)q; (void)buf;
+}
+
+bool TVL_TxQueuePost(tvl_tx_queue_t *q, const uint8_t *data, uint16_t len)
+{
+    (void)q; (void)data; (void)len;
+    return false;
+}
+
+const uint8_t *TVL_TxQueuePeek(tvl_tx_queue_t *q, uint16_t *len)
+{
+    (void)q; (void)len;
+    return NULL;
+}
+
+void TVL_TxQueueComplete(tvl_tx_queue_t *q)
+{
+    (void)q;
+}
+
+uint16_t TVL_TxQueueDrain(tvl_tx_queue_t *q, uint16_t max_frames)
+{
+    (void)q; (void)max_frames;
+    return 0;
+}
+
+uint16_t TVL_TxQueueRun(tvl_tx_queue_t *q, uint32_t timeout_ms)
+{
+    (void)q; (void)timeout_ms;
+    return 0;
+}
+
+void TVL_TxQueueWake(tvl_tx_queue_t *q)
+{
+    (void)q;
+}
+
+void TVL_TxQueueGetStats(tvl_tx_queue_t *q, tvl_tx_queue_stats_t *stats)
+{
+    (void)q;
+    if (stats) memset(stats, 0, sizeof(*stats));
+}
+
+#endif /* TVLCOM_TX_QUEUE_ATOMIC */
+
+/* USER CODE END 1 */
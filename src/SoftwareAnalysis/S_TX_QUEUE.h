@@ -0,0 +1,229 @@
+/* USER CODE BEGIN Header */
+/**
+ ******************************************************************************
+ * @file           : S_TX_QUEUE.h
+ * @brief          : Asynchronous TX queue with a fixed frame buffer pool.
+ * @author         : UF4OVER
+ * @date           : 2026-02-09
+ ******************************************************************************
+ * @attention
+ *
+ * Without a queue, every Transport_Send*() builds the frame on the caller's
+ * stack and runs the registered sender synchronously. Once a queue is
+ * attached (Transport_SetTxQueueCtx), the transport instead builds the frame
+ * in a buffer from the queue's pool, queues it and returns at once. A drain
+ * step sends the queued frames in order and returns the buffers:
+ * - TX thread: loop TVL_TxQueueRun(q, timeout); it sends through the
+ *   interface's registered sender and sleeps on the HAL event when idle.
+ * - DMA: set a kick callback (TVL_TxQueueSetKick) that starts a transfer of
+ *   TVL_TxQueuePeek() when the DMA is idle; the transfer-complete callback
+ *   calls TVL_TxQueueComplete() and starts the next one. The buffer stays
+ *   valid until then. Kick and completion race (thread vs ISR): guard the
+ *   "DMA busy" flag with a critical section.
+ *
+ * Backpressure:
+ * - The pool has TVLCOM_TX_POOL_FRAMES buffers of TVLCOM_TX_FRAME_SIZE bytes
+ *   (TLV_MAX_FRAME_SIZE by default: extended frames that don't fit are refused).
+ *   When all are queued or in flight, sends fail at once (Transport_Send*()
+ *   returns -3 / false) and the refusal is counted; nothing blocks.
+ *
+ * Concurrency:
+ * - Any number of threads may send (lock-free multi-producer queue: bounded
+ *   array with per-cell sequence numbers). Exactly one drainer.
+ * - Needs C11 atomics (TVLCOM_TX_QUEUE_ATOMIC); without them TVL_TxQueueInit()
+ *   fails and the transport stays synchronous.
+ *
+ * The queue is a plain struct (no heap) and can be allocated statically.
+ *
+ ******************************************************************************
+ */
+/* USER CODE END Header */
+/* Define to prevent recursive inclusion -------------------------------------*/
+
+#ifndef STM32F407_LM5175_S_TX_QUEUE_H
+#define STM32F407_LM5175_S_TX_QUEUE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdbool.h>
+#include "stdint.h"
+/* USER CODE BEGIN Includes */
+
+#include "GLOBAL_CONFIG.h"
+#include "S_TLV_PROTOCOL.h"
+#include "S_TRANSPORT_PROTOCOL.h"
+#include "HAL/hal.h"
+#if TVLCOM_TX_QUEUE_ATOMIC
+#include <stdatomic.h>
+#endif
+
+/* USER CODE END Includes */
+
+/* Exported constants --------------------------------------------------------*/
+/* USER CODE BEGIN EC */
+
+#if TVLCOM_TX_POOL_FRAMES < 2 || (TVLCOM_TX_POOL_FRAMES & (TVLCOM_TX_POOL_FRAMES - 1)) != 0
+#error "TVLCOM_TX_POOL_FRAMES must be a power of two, at least 2"
+#endif
+
+/* USER CODE END EC */
+
+/* Exported types ------------------------------------------------------------*/
+/* USER CODE BEGIN ET */
+
+#if TVLCOM_TX_QUEUE_ATOMIC
+typedef atomic_uint tvl_tx_counter_t;
+#else
+typedef uint32_t tvl_tx_counter_t;
+#endif
+
+/* Called after a frame was queued, on the sending thread (see TVL_TxQueueSetKick) */
+typedef void (*tvl_tx_kick_t)(tvl_tx_queue_t *q, void *user);
+
+/* Pool buffer size: TLV_MAX_FRAME_SIZE holds any classic frame; raise it to queue extended frames */
+#ifndef TVLCOM_TX_FRAME_SIZE
+#define TVLCOM_TX_FRAME_SIZE TLV_MAX_FRAME_SIZE
+#endif
+#if TVLCOM_TX_FRAME_SIZE < TLV_MAX_FRAME_SIZE || TVLCOM_TX_FRAME_SIZE > TLV_EXT_MAX_FRAME_SIZE
+#error "TVLCOM_TX_FRAME_SIZE must be between TLV_MAX_FRAME_SIZE and TLV_EXT_MAX_FRAME_SIZE"
+#endif
+
+/* One pooled frame buffer */
+typedef struct {
+    uint16_t len;
+    uint8_t data[TVLCOM_TX_FRAME_SIZE];
+} tvl_tx_buffer_t;
+
+/* Queue counters (see TVL_TxQueueGetStats) */
+typedef struct {
+    uint32_t queued;        /* frames accepted */
+    uint32_t sent;          /* frames completed (sent or failed) */
+    uint32_t errors;        /* sender returned an error (drain step) */
+    uint32_t rejected;      /* sends refused: pool exhausted or frame too large */
+    uint16_t in_use;        /* buffers taken from the pool right now */
+    uint16_t high_water;    /* most buffers ever taken at once */
+} tvl_tx_queue_stats_t;
+
+/* Bounded queue cell: seq tells producers/consumers whose turn the cell is */
+typedef struct {
+    tvl_tx_counter_t seq;
+    uint32_t buffer;        /* index into buffers[] */
+} tvl_tx_cell_t;
+
+/* Index ring: lock-free multi-producer/multi-consumer */
+typedef struct {
+    _Alignas(TVLCOM_CACHE_LINE) tvl_tx_counter_t enqueue_pos;
+    _Alignas(TVLCOM_CACHE_LINE) tvl_tx_counter_t dequeue_pos;
+    _Alignas(TVLCOM_CACHE_LINE) tvl_tx_cell_t cells[TVLCOM_TX_POOL_FRAMES];
+} tvl_tx_ring_t;
+
+struct tvl_tx_queue {
+    tvl_context_t *ctx;             /* set by Transport_SetTxQueueCtx() */
+    tlv_interface_t interface;
+    tvl_hal_event_t wake;
+    tvl_tx_kick_t kick;
+    void *kick_user;
+
+    tvl_tx_ring_t free_ring;        /* buffers available to senders */
+    tvl_tx_ring_t send_ring;        /* buffers waiting for the drain step, in order */
+
+    _Alignas(TVLCOM_CACHE_LINE) tvl_tx_counter_t queued;
+    tvl_tx_counter_t sent;
+    tvl_tx_counter_t errors;
+    tvl_tx_counter_t rejected;
+    tvl_tx_counter_t in_use;
+    tvl_tx_counter_t high_water;
+
+    tvl_tx_buffer_t buffers[TVLCOM_TX_POOL_FRAMES];
+};
+
+/* USER CODE END ET */
+
+/* Exported functions prototypes ---------------------------------------------*/
+/* USER CODE BEGIN EFP */
+
+/**
+ * @brief Initialise an empty queue with every buffer in the pool.
+ *
+ * Creates the HAL event used by TVL_TxQueueRun() when the HAL provides one.
+ * @return false without C11 atomics (TVLCOM_TX_QUEUE_ATOMIC=0).
+ */
+bool TVL_TxQueueInit(tvl_tx_queue_t *q);
+
+/**
+ * @brief Release the HAL event. Detach the queue from its context and stop the
+ *        drain step first; frames still queued are discarded.
+ */
+void TVL_TxQueueDeinit(tvl_tx_queue_t *q);
+
+/**
+ * @brief Call 'kick' after every queued frame (DMA start); NULL to clear.
+ */
+void TVL_TxQueueSetKick(tvl_tx_queue_t *q, tvl_tx_kick_t kick, void *user);
+
+/**
+ * @brief Producer: take a buffer from the pool to build a frame in place.
+ * @return NULL when the pool is exhausted (counted as rejected).
+ */
+tvl_tx_buffer_t *TVL_TxQueueAcquire(tvl_tx_queue_t *q);
+
+/**
+ * @brief Producer: queue a buffer from TVL_TxQueueAcquire() whose data/len are filled in.
+ */
+void TVL_TxQueueSubmit(tvl_tx_queue_t *q, tvl_tx_buffer_t *buf);
+
+/**
+ * @brief Producer: give back an acquired buffer without sending it.
+ */
+void TVL_TxQueueRelease(tvl_tx_queue_t *q, tvl_tx_buffer_t *buf);
+
+/**
+ * @brief Producer: copy a complete frame into a pool buffer and queue it.
+ * @return false if the pool is exhausted or len exceeds TLV_MAX_FRAME_SIZE.
+ */
+bool TVL_TxQueuePost(tvl_tx_queue_t *q, const uint8_t *data, uint16_t len);
+
+/**
+ * @brief Drainer: oldest queued frame, left in the queue.
+ * @return Frame bytes (valid until TVL_TxQueueComplete), or NULL if nothing is queued.
+ */
+const uint8_t *TVL_TxQueuePeek(tvl_tx_queue_t *q, uint16_t *len);
+
+/**
+ * @brief Drainer: the frame from TVL_TxQueuePeek() is done; its buffer returns to the pool.
+ */
+void TVL_TxQueueComplete(tvl_tx_queue_t *q);
+
+/**
+ * @brief Drainer: send up to max_frames queued frames through the interface's
+ *        registered sender, without waiting.
+ * @return Frames sent (including those the sender failed, counted as errors).
+ */
+uint16_t TVL_TxQueueDrain(tvl_tx_queue_t *q, uint16_t max_frames);
+
+/**
+ * @brief TX thread loop body: wait up to timeout_ms for frames, then send everything queued.
+ * @return Frames sent.
+ */
+uint16_t TVL_TxQueueRun(tvl_tx_queue_t *q, uint32_t timeout_ms);
+
+/**
+ * @brief Wake a thread blocked in TVL_TxQueueRun() (e.g. to let it exit).
+ */
+void TVL_TxQueueWake(tvl_tx_queue_t *q);
+
+/**
+ * @brief Snapshot of the counters; safe from any thread.
+ */
+void TVL_TxQueueGetStats(tvl_tx_queue_t *q, tvl_tx_queue_stats_t *stats);
+
+/* USER CODE END EFP */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //STM32F407_LM5175_S_TX_QUEUE_H
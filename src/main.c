@@ -9,6 +9,7 @@
  * - Opens a serial port (COMx) and registers a Transport sender.
  * - Initializes Receive module and registers TLV/CMD/ACK callbacks.
  * - Optionally runs a dedicated RX thread.
+ * - Optionally runs TLV handlers on a dispatch worker thread (S_DISPATCH.h).
  *
  * Notes:
  * - When TLV_DEBUG_ENABLE==0 logs are compiled out.
@@ -27,9 +28,11 @@
 #include <time.h>     /* time */
 
 #include "SERIAL.h"
+#include "SERIAL_READER.h"
 #include "S_TRANSPORT_PROTOCOL.h"
 #include "S_RECEIVE_PROTOCOL.h"
 #include "S_TLV_PROTOCOL.h"
+#include "S_DISPATCH.h"
 
 #include "GLOBAL_CONFIG.h"
 #include "HAL/hal.h"
@@ -75,8 +78,14 @@
 #  define TVLCOM_DEMO_IDLE_SLEEP_MS 1u
 #endif
 
+/* 1: low-latency port mode + serial_reader (no idle sleep, returns per frame); 0: classic read loop */
+#ifndef TVLCOM_DEMO_LOW_LATENCY
+#  define TVLCOM_DEMO_LOW_LATENCY 1
+#endif
+
 #define ENABLE_PERIODIC_SENDER 0
 #define ENABLE_RX_THREAD       1  /* 1: RX+parse in background thread */
+#define ENABLE_DISPATCH_WORKER 1  /* 1: handlers run on a worker thread, RX thread only parses */
 
 /* ------------------------------- globals ---------------------------------- */
 
@@ -88,6 +97,10 @@ static HANDLE g_sender_thread = NULL;
 #if ENABLE_RX_THREAD
 static HANDLE g_receiver_thread = NULL;
 #endif
+#if ENABLE_DISPATCH_WORKER
+static tvl_dispatch_t g_dispatch;
+static HANDLE g_dispatch_thread = NULL;
+#endif
 
 /* ------------------------------- helpers ---------------------------------- */
 
@@ -118,6 +131,21 @@ static int uart_send_impl(const uint8_t *data, uint16_t len)
     return (int)n;
 }
 
+/**
+ * @brief Scatter-gather sender for UART: TLV values go from caller memory to the driver.
+ */
+static int uart_sendv_impl(const transport_iovec_t *iov, uint8_t iovcnt)
+{
+    if (!g_serial || iovcnt > SERIAL_WRITEV_MAX_IOV) return -1;
+    serial_iovec_t vec[SERIAL_WRITEV_MAX_IOV];
+    for (uint8_t i = 0; i < iovcnt; ++i) {
+        vec[i].base = iov[i].base;
+        vec[i].len = iov[i].len;
+    }
+    ssize_t n = serial_writev(g_serial, vec, (int)iovcnt);
+    return (int)n;
+}
+
 /**
  * @brief Feed bytes from serial into the TLV parser.
  */
@@ -133,9 +161,7 @@ static void process_rx_bytes(tlv_parser_t *parser, const uint8_t *buf, ssize_t n
     TLV_LOG("\n");
 #endif
 
-    for (ssize_t i = 0; i < n; ++i) {
-        TLV_ProcessByte(parser, buf[i]);
-    }
+    (void)TLV_ProcessBuffer(parser, buf, (size_t)n);
 }
 
 /* ------------------------------- callbacks -------------------------------- */
@@ -191,10 +217,10 @@ static bool on_string_tlv(const tlv_entry_t *e, tlv_interface_t iface)
 #if TLV_DEBUG_ENABLE
     if (e->value) {
         /* Avoid huge/untrusted prints; keep it readable in console. */
-        const uint8_t max_print = 64;
-        uint8_t to_print = e->length;
+        const uint16_t max_print = 64;
+        uint16_t to_print = e->length;
         if (to_print > max_print) to_print = max_print;
-        for (uint8_t i = 0; i < to_print; i++) {
+        for (uint16_t i = 0; i < to_print; i++) {
             unsigned char c = (unsigned char)e->value[i];
             if (c >= 32 && c <= 126) {
                 putchar((int)c);
@@ -285,7 +311,8 @@ static void send_voltage_once(float v)
     tlv_entry_t e;
     TLV_CreateVoltageEntry(v, &e);
     uint8_t frame_id = Transport_NextFrameId();
-    (void)Transport_SendTLVs(TLV_INTERFACE_UART, frame_id, &e, 1);
+    /* Telemetry sample: a lost one is superseded by the next, don't ask for an ACK */
+    (void)Transport_SendTLVsEx(TLV_INTERFACE_UART, frame_id, &e, 1, TRANSPORT_DELIVERY_BEST_EFFORT);
 }
 
 /* ------------------------------- threads ---------------------------------- */
@@ -362,6 +389,17 @@ static void rx_loop(void)
             continue;
         }
 
+#if TVLCOM_DEMO_LOW_LATENCY && !TVLCOM_DEMO_DUMP_RX_HEX
+        serial_reader_t *reader = serial_reader_create(g_serial, parser, 0);
+        if (reader) {
+            (void)serial_set_low_latency(g_serial, true);
+            while (g_running && serial_reader_poll(reader, TVLCOM_DEMO_READ_TIMEOUT_MS, true) >= 0) {
+            }
+            serial_reader_destroy(reader);
+            continue;
+        }
+#endif
+
         ssize_t n = serial_read(g_serial, buf, sizeof(buf), TVLCOM_DEMO_READ_TIMEOUT_MS);
         if (n > 0) {
             process_rx_bytes(parser, buf, n);
@@ -378,6 +416,18 @@ static DWORD WINAPI ReceiverThread(LPVOID lp)
     return 0;
 }
 
+#if ENABLE_DISPATCH_WORKER
+/* Runs the TLV handlers and sends ACK/NACK, so a slow handler never stalls serial reads */
+static DWORD WINAPI DispatchThread(LPVOID lp)
+{
+    (void)lp;
+    while (g_running) {
+        (void)TVL_DispatchRun(&g_dispatch, 0, 100);
+    }
+    return 0;
+}
+#endif
+
 int main(void)
 {
     SetConsoleCtrlHandler(ConsoleCtrlHandler, TRUE);
@@ -395,7 +445,13 @@ int main(void)
     }
 
     Transport_RegisterSender(TLV_INTERFACE_UART, uart_send_impl);
+    Transport_RegisterSenderV(TLV_INTERFACE_UART, uart_sendv_impl);
     FloatReceive_Init(TLV_INTERFACE_UART);
+#if ENABLE_DISPATCH_WORKER
+    TVL_DispatchInit(&g_dispatch, 1);
+    FloatReceive_SetDispatch(&g_dispatch);
+    g_dispatch_thread = CreateThread(NULL, 0, DispatchThread, NULL, 0, NULL);
+#endif
 
     /* Register handlers */
     FloatReceive_RegisterTLVHandler(TLV_TYPE_INTEGER, on_integer_tlv);
@@ -425,6 +481,8 @@ int main(void)
 
     while (g_running) {
         Sleep(100);
+        Transport_Poll();   /* RTO for Transport_SendReliable() */
+        FloatReceive_Poll(); /* deadline for coalesced ACKs */
     }
 #else
     rx_loop();
@@ -446,6 +504,16 @@ int main(void)
         g_receiver_thread = NULL;
     }
 #endif
+#if ENABLE_DISPATCH_WORKER
+    if (g_dispatch_thread) {
+        TVL_DispatchWake(&g_dispatch, 0);
+        WaitForSingleObject(g_dispatch_thread, 2000);
+        CloseHandle(g_dispatch_thread);
+        g_dispatch_thread = NULL;
+    }
+    FloatReceive_SetDispatch(NULL);
+    TVL_DispatchDeinit(&g_dispatch);
+#endif
 
     if (g_serial) {
         serial_close(g_serial);
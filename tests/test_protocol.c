@@ -7,13 +7,31 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <string.h>
 #include <stdio.h>
 
 #include "HAL/hal.h"
+#include "S_CRC16.h"
+#include "S_SYNC_SCAN.h"
 #include "S_TLV_PROTOCOL.h"
 #include "S_TRANSPORT_PROTOCOL.h"
 #include "S_RECEIVE_PROTOCOL.h"
+#include "S_FRAGMENT.h"
+#include "S_CONTEXT.h"
+#include "S_DISPATCH.h"
+#include "S_RX_RING.h"
+#include "S_TX_QUEUE.h"
+
+/* Concurrency stress tests need pthreads (Linux) */
+#if defined(__linux__)
+#define TEST_HAVE_THREADS 1
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#else
+#define TEST_HAVE_THREADS 0
+#endif
 
 /* --------------------------- tiny test macros --------------------------- */
 
@@ -30,10 +48,19 @@
     fprintf(stdout, "[PASS] %s\n", #fn); \
 } while(0)
 
+/* Feed helper: block path by default, per-byte path with -DTEST_FEED_PER_BYTE */
+#ifdef TEST_FEED_PER_BYTE
+#define TEST_FEED(p, data, len) do { \
+    for (uint16_t i_ = 0; i_ < (len); ++i_) TLV_ProcessByte((p), (data)[i_]); \
+} while(0)
+#else
+#define TEST_FEED(p, data, len) ((void)TLV_ProcessBuffer((p), (data), (len)))
+#endif
+
 /* --------------------------- mock transport --------------------------- */
 
 typedef struct {
-    uint8_t buf[2048];
+    uint8_t buf[TLV_EXT_MAX_FRAME_SIZE];
     uint16_t len;
 } capture_t;
 
@@ -65,9 +92,7 @@ static bool capture_contains_tlv_type(uint8_t type)
 static void feed_bytes_to_uart_parser(const uint8_t *data, uint16_t len)
 {
     tlv_parser_t *p = FloatReceive_GetUARTParser();
-    for (uint16_t i = 0; i < len; ++i) {
-        TLV_ProcessByte(p, data[i]);
-    }
+    TEST_FEED(p, data, len);
 }
 
 /* --------------------------- handlers --------------------------- */
@@ -153,11 +178,2167 @@ static int test_no_ack_storm_on_received_ack(void)
     return 0;
 }
 
+static int test_crc16_engines_match_reference(void)
+{
+    /* CRC-16/CCITT-FALSE check value */
+    const uint8_t check[] = "123456789";
+    TEST_ASSERT(TLV_CalculateCRC16(check, 9) == 0x29B1);
+
+    uint8_t buf[600];
+    uint32_t seed = 0xC0FFEEu;
+    for (uint16_t i = 0; i < sizeof(buf); ++i) {
+        seed = seed * 1103515245u + 12345u;
+        buf[i] = (uint8_t)(seed >> 16);
+    }
+
+    for (int e = TLV_CRC16_ENGINE_BITWISE; e < TLV_CRC16_ENGINE_COUNT; ++e) {
+        tlv_crc16_engine_t engine = (tlv_crc16_engine_t)e;
+        if (!TLV_Crc16EngineAvailable(engine)) continue;
+        for (uint16_t off = 0; off < 4; ++off) {
+            for (uint16_t len = 0; len + off <= sizeof(buf); len = (uint16_t)(len + (len < 140 ? 1 : 37))) {
+                uint16_t ref = TLV_Crc16Compute(TLV_CRC16_ENGINE_BITWISE, TLV_CRC16_INIT, buf + off, len);
+                TEST_ASSERT(TLV_Crc16Compute(engine, TLV_CRC16_INIT, buf + off, len) == ref);
+                /* split computation must match (running CRC carried across calls) */
+                uint16_t half = (uint16_t)(len / 2);
+                uint16_t crc = TLV_Crc16Compute(engine, TLV_CRC16_INIT, buf + off, half);
+                crc = TLV_Crc16Compute(engine, crc, buf + off + half, (size_t)(len - half));
+                TEST_ASSERT(crc == ref);
+            }
+        }
+        TEST_ASSERT(TLV_Crc16SetEngine(engine));
+        TEST_ASSERT(TLV_CalculateCRC16(check, 9) == 0x29B1);
+    }
+    TEST_ASSERT(TLV_Crc16SetEngine(TLV_CRC16_ENGINE_AUTO));
+    TEST_ASSERT(TLV_Crc16GetEngine() != TLV_CRC16_ENGINE_AUTO);
+    return 0;
+}
+
+static uint8_t g_last_error_id;
+static tlv_error_t g_last_error;
+static int g_error_count;
+
+static void on_parser_error(uint8_t frame_id, tlv_interface_t iface, tlv_error_t err)
+{
+    (void)iface;
+    g_last_error_id = frame_id;
+    g_last_error = err;
+    g_error_count++;
+}
+
+static int test_streaming_crc_and_parser_crc_check(void)
+{
+    uint8_t data[200];
+    for (uint16_t i = 0; i < sizeof(data); ++i) data[i] = (uint8_t)(i * 7u + 3u);
+
+    uint16_t crc = TLV_Crc16Init();
+    crc = TLV_Crc16Update(crc, data, 10);
+    for (uint16_t i = 10; i < 50; ++i) crc = TLV_Crc16UpdateByte(crc, data[i]);
+    crc = TLV_Crc16Update(crc, data + 50, sizeof(data) - 50);
+    TEST_ASSERT(TLV_Crc16Final(crc) == TLV_CalculateCRC16(data, sizeof(data)));
+
+    /* Parser accumulates the CRC per byte: a good frame passes, a corrupted payload byte fails */
+    TVL_HAL_Set(NULL);
+    capture_reset();
+    Transport_RegisterSender(TLV_INTERFACE_UART, mock_send);
+    FloatReceive_Init(TLV_INTERFACE_UART);
+    FloatReceive_RegisterTLVHandler(0x55, on_custom_ok);
+    tlv_parser_t *p = FloatReceive_GetUARTParser();
+    TLV_SetErrorCallback(p, on_parser_error);
+    g_error_count = 0;
+
+    tlv_entry_t e;
+    uint8_t v = 0xAA;
+    TLV_CreateRawEntry(0x55, &v, 1, &e);
+    uint8_t frame[TLV_MAX_FRAME_SIZE];
+    uint16_t frame_len = 0;
+    TEST_ASSERT(TLV_BuildFrame(0x33, &e, 1, frame, &frame_len));
+
+    feed_bytes_to_uart_parser(frame, frame_len);
+    TEST_ASSERT(g_error_count == 0);
+    TEST_ASSERT(p->crc_calculated == p->crc_received);
+
+    frame[6] ^= 0x01; /* flip a value bit */
+    feed_bytes_to_uart_parser(frame, frame_len);
+    TEST_ASSERT(g_error_count == 1);
+    TEST_ASSERT(g_last_error == TLV_ERR_CRC);
+    TEST_ASSERT(g_last_error_id == 0x33);
+    return 0;
+}
+
+/* Records every frame/error callback so two parser runs can be compared. */
+typedef struct {
+    uint8_t log[8192];
+    uint16_t len;
+} event_log_t;
+
+static event_log_t g_events;
+
+static void log_event(uint8_t kind, uint8_t id, const uint8_t *data, uint16_t length)
+{
+    if ((uint32_t)g_events.len + 4u + length > sizeof(g_events.log)) return;
+    g_events.log[g_events.len++] = kind;
+    g_events.log[g_events.len++] = id;
+    g_events.log[g_events.len++] = (uint8_t)(length >> 8);
+    g_events.log[g_events.len++] = (uint8_t)(length & 0xFF);
+    if (length) memcpy(&g_events.log[g_events.len], data, length);
+    g_events.len = (uint16_t)(g_events.len + length);
+}
+
+static void on_logged_frame(uint8_t frame_id, const uint8_t *data, uint16_t length, tlv_interface_t iface)
+{
+    (void)iface;
+    log_event(0xFA, frame_id, data, length);
+}
+
+static void on_logged_error(uint8_t frame_id, tlv_interface_t iface, tlv_error_t err)
+{
+    (void)iface;
+    uint8_t code = (uint8_t)err;
+    log_event(0xEE, frame_id, &code, 1);
+}
+
+static int test_process_buffer_matches_per_byte(void)
+{
+    /* Stream: valid frames, noise, truncated/oversized frames, corrupted CRC */
+    uint8_t stream[4096];
+    uint16_t n = 0;
+    uint32_t seed = 0xBADC0DEu;
+    while ((size_t)n + TLV_MAX_FRAME_SIZE + 16u < sizeof(stream)) {
+        seed = seed * 1103515245u + 12345u;
+        uint8_t kind = (uint8_t)((seed >> 16) % 5);
+        if (kind <= 1) {
+            uint8_t payload[64];
+            uint8_t plen = (uint8_t)(1 + ((seed >> 8) % sizeof(payload)));
+            for (uint8_t k = 0; k < plen; ++k) payload[k] = (uint8_t)(seed >> (k % 24));
+            tlv_entry_t e;
+            TLV_CreateRawEntry(0x40, payload, plen, &e);
+            uint16_t flen = 0;
+            TEST_ASSERT(TLV_BuildFrame((uint8_t)n, &e, 1, &stream[n], &flen));
+            if (kind == 1) stream[n + 4 + (plen / 2)] ^= 0x5A; /* CRC mismatch */
+            n = (uint16_t)(n + flen);
+        } else if (kind == 2) {
+            stream[n++] = TLV_FRAME_HEADER_0;
+            stream[n++] = TLV_FRAME_HEADER_1;
+            stream[n++] = 0x77;
+            stream[n++] = 0xF5; /* DataLen > TLV_MAX_DATA_LENGTH */
+        } else {
+            for (uint8_t k = 0; k < 9; ++k) {
+                seed = seed * 1103515245u + 12345u;
+                stream[n++] = (k & 1) ? TLV_FRAME_HEADER_0 : (uint8_t)(seed >> 16);
+            }
+            if (seed & 0x100) {
+                stream[n++] = TLV_FRAME_HEADER_0; /* F0 F0 0F: header right after a repeated 0xF0 */
+                stream[n++] = TLV_FRAME_HEADER_0;
+                stream[n++] = TLV_FRAME_HEADER_1;
+            }
+        }
+    }
+
+    tlv_parser_t parser;
+    static event_log_t reference;
+
+    for (int backtrack = 0; backtrack < 2; ++backtrack) {
+        memset(&g_events, 0, sizeof(g_events));
+        TLV_InitParser(&parser, TLV_INTERFACE_UART, on_logged_frame);
+        TLV_SetErrorCallback(&parser, on_logged_error);
+        TLV_SetBacktracking(&parser, backtrack != 0);
+        for (uint16_t i = 0; i < n; ++i) TLV_ProcessByte(&parser, stream[i]);
+        reference = g_events;
+        TEST_ASSERT(reference.len > 0);
+
+        static const uint16_t chunks[] = { 1, 2, 3, 7, 64, 255, 4096 };
+        for (uint8_t c = 0; c < sizeof(chunks) / sizeof(chunks[0]); ++c) {
+            memset(&g_events, 0, sizeof(g_events));
+            TLV_InitParser(&parser, TLV_INTERFACE_UART, on_logged_frame);
+            TLV_SetErrorCallback(&parser, on_logged_error);
+            TLV_SetBacktracking(&parser, backtrack != 0);
+            for (uint16_t off = 0; off < n; off = (uint16_t)(off + chunks[c])) {
+                uint16_t len = (uint16_t)((n - off) < chunks[c] ? (n - off) : chunks[c]);
+                TEST_ASSERT(TLV_ProcessBuffer(&parser, &stream[off], len) == len);
+            }
+            TEST_ASSERT(g_events.len == reference.len);
+            TEST_ASSERT(memcmp(g_events.log, reference.log, reference.len) == 0);
+        }
+    }
+    return 0;
+}
+
+static size_t naive_sync_find(const uint8_t *d, size_t n)
+{
+    for (size_t i = 0; i < n; ++i) {
+        if (d[i] == TLV_FRAME_HEADER_0 && (i + 1 == n || d[i + 1] == TLV_FRAME_HEADER_1)) return i;
+    }
+    return n;
+}
+
+static int test_sync_scan_impls_agree(void)
+{
+    uint8_t buf[300];
+    uint32_t seed = 0x5EED5EEDu;
+
+    for (int impl = TLV_SYNC_IMPL_SCALAR; impl < TLV_SYNC_IMPL_COUNT; ++impl) {
+        if (!TLV_SyncImplAvailable((tlv_sync_impl_t)impl)) continue;
+        TEST_ASSERT(TLV_SyncSetImpl((tlv_sync_impl_t)impl));
+        for (int round = 0; round < 400; ++round) {
+            /* Dense 0xF0/0x0F noise so near-misses and block edges get exercised */
+            for (uint16_t i = 0; i < sizeof(buf); ++i) {
+                seed = seed * 1103515245u + 12345u;
+                uint8_t r = (uint8_t)(seed >> 16);
+                buf[i] = (r & 3) == 0 ? TLV_FRAME_HEADER_0 : ((r & 3) == 1 ? 0x00 : r);
+            }
+            size_t pos = (size_t)(seed >> 8) % sizeof(buf);
+            if (round & 1) {
+                buf[pos] = TLV_FRAME_HEADER_0;
+                if (pos + 1 < sizeof(buf)) buf[pos + 1] = TLV_FRAME_HEADER_1;
+            }
+            for (size_t off = 0; off < 40; off += 13) {
+                for (size_t len = 0; len + off <= sizeof(buf); len += (len < 70 ? 1 : 29)) {
+                    TEST_ASSERT(TLV_SyncFind(buf + off, len) == naive_sync_find(buf + off, len));
+                }
+            }
+        }
+    }
+    TEST_ASSERT(TLV_SyncSetImpl(TLV_SYNC_IMPL_AUTO));
+
+    /* A repeated 0xF0 before the real header must not hide the frame */
+    tlv_parser_t parser;
+    memset(&g_events, 0, sizeof(g_events));
+    TLV_InitParser(&parser, TLV_INTERFACE_UART, on_logged_frame);
+    tlv_entry_t e;
+    uint8_t v = 0x42;
+    TLV_CreateRawEntry(0x40, &v, 1, &e);
+    uint8_t stream[TLV_MAX_FRAME_SIZE + 1];
+    uint16_t flen = 0;
+    stream[0] = TLV_FRAME_HEADER_0;
+    TEST_ASSERT(TLV_BuildFrame(0x21, &e, 1, &stream[1], &flen));
+    for (uint16_t i = 0; i < flen + 1; ++i) TLV_ProcessByte(&parser, stream[i]);
+    TEST_ASSERT(g_events.len > 0 && g_events.log[0] == 0xFA && g_events.log[1] == 0x21);
+    return 0;
+}
+
+static int test_backtracking_recovers_frame_behind_false_header(void)
+{
+#if TVLCOM_PARSER_BACKTRACK
+    /* False header with DataLen=40 swallows a real 9-byte frame, then garbage */
+    uint8_t stream[128];
+    uint16_t n = 0;
+    stream[n++] = TLV_FRAME_HEADER_0;
+    stream[n++] = TLV_FRAME_HEADER_1;
+    stream[n++] = 0x99;
+    stream[n++] = 40;
+    stream[n++] = 0x12;
+    tlv_entry_t e;
+    uint8_t v = 0x5A;
+    TLV_CreateRawEntry(0x40, &v, 1, &e);
+    uint16_t flen = 0;
+    TEST_ASSERT(TLV_BuildFrame(0x44, &e, 1, &stream[n], &flen));
+    n = (uint16_t)(n + flen);
+    while (n < 4 + 40 + 4) stream[n++] = 0x00; /* rest of the bogus payload, CRC, bad tail */
+
+    tlv_parser_t parser;
+    for (int mode = 0; mode < 2; ++mode) {
+        memset(&g_events, 0, sizeof(g_events));
+        TLV_InitParser(&parser, TLV_INTERFACE_UART, on_logged_frame);
+        TEST_ASSERT(TLV_SetBacktracking(&parser, mode == 1));
+        if (mode == 0) {
+            for (uint16_t i = 0; i < n; ++i) TLV_ProcessByte(&parser, stream[i]);
+            TEST_ASSERT(g_events.len == 0); /* legacy behaviour: real frame lost */
+        } else {
+            TEST_ASSERT(TLV_ProcessBuffer(&parser, stream, n) == n);
+            TEST_ASSERT(g_events.len > 0 && g_events.log[0] == 0xFA && g_events.log[1] == 0x44);
+        }
+    }
+#endif
+    return 0;
+}
+
+static int test_frame_writer_matches_build_frame(void)
+{
+    /* CRC combine identity used by TLV_WriterFinish() */
+    static const uint8_t check[] = "123456789";
+    for (size_t split = 0; split <= 9; ++split) {
+        uint16_t a = TLV_Crc16Update(TLV_Crc16Init(), check, split);
+        uint16_t b = TLV_Crc16Update(0, &check[split], 9 - split);
+        TEST_ASSERT((TLV_Crc16Shift(a, 9 - split) ^ b) == 0x29B1);
+    }
+
+    /* Same entries through both paths -> identical bytes */
+    static const uint8_t raw[3] = { 0x01, 0xF0, 0x0F };
+    tlv_entry_t entries[3];
+    TLV_CreateRawEntry(RAW_ADC, raw, sizeof(raw), &entries[0]);
+    TLV_CreateControlCmdEntry(0x07, &entries[1]);
+    TLV_CreateStringEntry("HELLO", &entries[2]);
+    uint8_t ref[TLV_MAX_FRAME_SIZE];
+    uint16_t ref_len = 0;
+    TEST_ASSERT(TLV_BuildFrame(0x5C, entries, 3, ref, &ref_len));
+
+    tlv_frame_writer_t w;
+    uint8_t out[TLV_MAX_FRAME_SIZE];
+    uint16_t out_len = 0;
+    TEST_ASSERT(TLV_WriterBegin(&w, 0x5C, out, sizeof(out)));
+    TEST_ASSERT(TLV_WriterAppendBytes(&w, RAW_ADC, raw, sizeof(raw)));
+    TEST_ASSERT(TLV_WriterAppendU8(&w, TLV_TYPE_CONTROL_CMD, 0x07));
+    TEST_ASSERT(TLV_WriterAppendString(&w, TLV_TYPE_STRING, "HELLO"));
+    TEST_ASSERT(TLV_WriterFinish(&w, &out_len));
+    TEST_ASSERT(out_len == ref_len && memcmp(out, ref, ref_len) == 0);
+
+    /* Typed values round-trip through the parser and TLV_Extract*() */
+    TEST_ASSERT(TLV_WriterBegin(&w, 0x5D, out, sizeof(out)));
+    TEST_ASSERT(TLV_WriterAppendI32(&w, TLV_TYPE_INTEGER, -123456));
+    TEST_ASSERT(TLV_WriterAppendF32(&w, 0x41, 1.5f));
+    TEST_ASSERT(TLV_WriterAppendScaled(&w, INFO_VBUS, 12.5f));
+    TEST_ASSERT(TLV_WriterFinish(&w, &out_len));
+    tlv_parser_t parser;
+    memset(&g_events, 0, sizeof(g_events));
+    TLV_InitParser(&parser, TLV_INTERFACE_UART, on_logged_frame);
+    TEST_FEED(&parser, out, out_len);
+    TEST_ASSERT(g_events.len > 0 && g_events.log[0] == 0xFA && g_events.log[1] == 0x5D);
+    tlv_entry_t parsed[3];
+    TEST_ASSERT(TLV_ParseData(&out[4], out[3], parsed, 3) == 3);
+    TEST_ASSERT(TLV_ExtractInt32Value(&parsed[0]) == -123456);
+    union { int32_t i; float f; } conv = { .i = TLV_ExtractInt32Value(&parsed[1]) };
+    TEST_ASSERT(conv.f == 1.5f);
+    TEST_ASSERT(TLV_ExtractFloatValue(&parsed[2]) == 12.5f);
+
+    /* Overflow is detected before writing and poisons Finish */
+    uint8_t big[200];
+    memset(big, 0xAB, sizeof(big));
+    TEST_ASSERT(TLV_WriterBegin(&w, 0x5E, out, sizeof(out)));
+    TEST_ASSERT(TLV_WriterAppendBytes(&w, RAW_ADC, big, sizeof(big)));
+    uint16_t remaining = TLV_WriterRemaining(&w);
+    TEST_ASSERT(remaining == TLV_MAX_DATA_LENGTH - 202);
+    TEST_ASSERT(!TLV_WriterAppendBytes(&w, RAW_ADC, big, (uint8_t)(remaining - 1)));
+    TEST_ASSERT(TLV_WriterRemaining(&w) == 0);
+    TEST_ASSERT(!TLV_WriterFinish(&w, &out_len));
+
+    /* Strings over 255 bytes are rejected, not truncated, even with room in an extended frame */
+    static uint8_t ext_out[TLV_EXT_MAX_FRAME_SIZE];
+    char long_str[300];
+    memset(long_str, 'x', sizeof(long_str) - 1);
+    long_str[sizeof(long_str) - 1] = '\0';
+    TEST_ASSERT(TLV_WriterBeginExt(&w, 0x5E, ext_out, sizeof(ext_out)));
+    long_str[255] = '\0';
+    TEST_ASSERT(TLV_WriterAppendString(&w, TLV_TYPE_STRING, long_str));
+    long_str[255] = 'x';
+    TEST_ASSERT(!TLV_WriterAppendString(&w, TLV_TYPE_STRING, long_str));
+    TEST_ASSERT(!TLV_WriterFinish(&w, &out_len));
+
+    /* Small caller buffer limits appends too */
+    uint8_t small[TLV_OVERHEAD_SIZE + 4];
+    TEST_ASSERT(TLV_WriterBegin(&w, 0x5F, small, sizeof(small)));
+    TEST_ASSERT(TLV_WriterAppendU8(&w, 0x40, 1));
+    TEST_ASSERT(!TLV_WriterAppendU8(&w, 0x41, 2));
+    TEST_ASSERT(!TLV_WriterBegin(&w, 0x60, small, TLV_OVERHEAD_SIZE - 1));
+    return 0;
+}
+
+/* sendv mock: gathers slices into g_tx and remembers which buffers were referenced */
+static const uint8_t *g_sendv_bases[TRANSPORT_SENDV_MAX_IOV];
+static uint8_t g_sendv_count;
+
+static int mock_sendv(const transport_iovec_t *iov, uint8_t iovcnt)
+{
+    g_sendv_count = iovcnt;
+    int total = 0;
+    for (uint8_t i = 0; i < iovcnt; ++i) {
+        g_sendv_bases[i] = iov[i].base;
+        if (mock_send(iov[i].base, iov[i].len) < 0) return -1;
+        total += iov[i].len;
+    }
+    return total;
+}
+
+static bool sendv_referenced(const uint8_t *p)
+{
+    for (uint8_t i = 0; i < g_sendv_count; ++i) {
+        if (g_sendv_bases[i] == p) return true;
+    }
+    return false;
+}
+
+static int test_send_tlvs_scatter_gather(void)
+{
+    static uint8_t dump[120];
+    for (uint16_t i = 0; i < sizeof(dump); ++i) dump[i] = (uint8_t)(i * 7u);
+    tlv_entry_t entries[4];
+    TLV_CreateControlCmdEntry(0x02, &entries[0]);
+    TLV_CreateRawEntry(RAW_ADC, dump, 100, &entries[1]);
+    TLV_CreateStringEntry("CHUNK", &entries[2]);
+    TLV_CreateRawEntry(RAW_DAC1, &dump[100], 20, &entries[3]);
+
+    uint8_t ref[TLV_MAX_FRAME_SIZE];
+    uint16_t ref_len = 0;
+    TEST_ASSERT(TLV_BuildFrame(0x6A, entries, 4, ref, &ref_len));
+
+    capture_reset();
+    Transport_RegisterSender(TLV_INTERFACE_UART, mock_send);
+    Transport_RegisterSenderV(TLV_INTERFACE_UART, mock_sendv);
+    TEST_ASSERT(Transport_SendTLVs(TLV_INTERFACE_UART, 0x6A, entries, 4));
+    TEST_ASSERT(g_tx.len == ref_len && memcmp(g_tx.buf, ref, ref_len) == 0);
+    /* Large values are referenced in place, short ones are packed */
+    TEST_ASSERT(sendv_referenced(dump) && sendv_referenced(&dump[100]));
+    TEST_ASSERT(g_sendv_count == 5);
+
+    /* As many sliced values as fit in one frame: same bytes */
+    tlv_entry_t many[TRANSPORT_SENDV_MAX_IOV];
+    uint8_t n_many = 0;
+    while ((n_many + 1) * (2 + TRANSPORT_SENDV_COPY_BELOW) <= TLV_MAX_DATA_LENGTH && n_many < TRANSPORT_SENDV_MAX_IOV) {
+        TLV_CreateRawEntry(0x50, dump, TRANSPORT_SENDV_COPY_BELOW, &many[n_many++]);
+    }
+    TEST_ASSERT(TLV_BuildFrame(0x6B, many, n_many, ref, &ref_len));
+    capture_reset();
+    g_sendv_count = 0;
+    TEST_ASSERT(Transport_SendTLVs(TLV_INTERFACE_UART, 0x6B, many, n_many));
+    TEST_ASSERT(g_tx.len == ref_len && memcmp(g_tx.buf, ref, ref_len) == 0);
+
+    /* Without a sendv backend Transport_SendV gathers for the plain sender */
+    Transport_RegisterSenderV(TLV_INTERFACE_UART, NULL);
+    const transport_iovec_t iov[2] = { { ref, 10 }, { &ref[10], (uint16_t)(ref_len - 10) } };
+    capture_reset();
+    TEST_ASSERT(Transport_SendV(TLV_INTERFACE_UART, iov, 2) == (int)ref_len);
+    TEST_ASSERT(g_tx.len == ref_len && memcmp(g_tx.buf, ref, ref_len) == 0);
+    return 0;
+}
+
+static int test_extended_frames_share_parser_with_classic(void)
+{
+    static uint8_t big[1500];
+    for (uint16_t i = 0; i < sizeof(big); ++i) big[i] = (uint8_t)(i ^ (i >> 8));
+    tlv_entry_t entries[3];
+    TLV_CreateControlCmdEntry(0x01, &entries[0]);
+    TLV_CreateRawEntry(RAW_ADC, big, 1200, &entries[1]); /* needs the TLV_LEN_EXT escape */
+    TLV_CreateRawEntry(RAW_DAC1, &big[1200], 200, &entries[2]);
+
+    static uint8_t stream[2 * TLV_EXT_MAX_FRAME_SIZE];
+    uint16_t n = 0, flen = 0;
+    TEST_ASSERT(!TLV_BuildFrameExt(0x70, entries, 3, stream, 64, &flen)); /* buffer too small */
+    TEST_ASSERT(TLV_BuildFrameExt(0x70, entries, 3, stream, TLV_EXT_MAX_FRAME_SIZE, &flen));
+    TEST_ASSERT(stream[3] == TLV_DATA_LEN_EXT);
+    n = flen;
+    tlv_entry_t small;
+    uint8_t v = 0x33;
+    TLV_CreateRawEntry(0x40, &v, 1, &small);
+    TEST_ASSERT(TLV_BuildFrame(0x71, &small, 1, &stream[n], &flen));
+    n = (uint16_t)(n + flen);
+
+    /* Writer produces the same extended bytes */
+    static uint8_t out[TLV_EXT_MAX_FRAME_SIZE];
+    tlv_frame_writer_t w;
+    uint16_t out_len = 0;
+    TEST_ASSERT(TLV_WriterBeginExt(&w, 0x70, out, sizeof(out)));
+    TEST_ASSERT(TLV_WriterAppendU8(&w, TLV_TYPE_CONTROL_CMD, 0x01));
+    TEST_ASSERT(TLV_WriterAppendBytes(&w, RAW_ADC, big, 1200));
+    TEST_ASSERT(TLV_WriterAppendBytes(&w, RAW_DAC1, &big[1200], 200));
+    TEST_ASSERT(TLV_WriterFinish(&w, &out_len));
+    TEST_ASSERT(out_len == n - flen && memcmp(out, stream, out_len) == 0);
+
+    /* Default parser: extended frame rejected as too long, classic frame still decoded */
+    tlv_parser_t parser;
+    memset(&g_events, 0, sizeof(g_events));
+    TLV_InitParser(&parser, TLV_INTERFACE_UART, on_logged_frame);
+    TLV_SetErrorCallback(&parser, on_logged_error);
+    TEST_FEED(&parser, stream, n);
+    TEST_ASSERT(g_events.log[0] == 0xEE && g_events.log[1] == 0x70 && g_events.log[4] == TLV_ERR_LEN);
+    TEST_ASSERT(g_events.log[5] == 0xFA && g_events.log[6] == 0x71);
+
+    /* With a per-instance 2 KB buffer both frames are decoded */
+    static uint8_t rx_buf[2048];
+    memset(&g_events, 0, sizeof(g_events));
+    TLV_InitParser(&parser, TLV_INTERFACE_UART, on_logged_frame);
+    TEST_ASSERT(!TLV_SetDataBuffer(&parser, rx_buf, TLV_MAX_DATA_LENGTH - 1));
+    TEST_ASSERT(TLV_SetDataBuffer(&parser, rx_buf, sizeof(rx_buf)));
+    TEST_FEED(&parser, stream, n);
+    TEST_ASSERT(g_events.log[0] == 0xFA && g_events.log[1] == 0x70);
+    uint16_t data_len = (uint16_t)((g_events.log[2] << 8) | g_events.log[3]);
+    TEST_ASSERT(data_len == 3 + 1204 + 202);
+    tlv_entry_t parsed[4];
+    TEST_ASSERT(TLV_ParseData(&g_events.log[4], data_len, parsed, 4) == 3);
+    TEST_ASSERT(parsed[1].type == RAW_ADC && parsed[1].length == 1200 && memcmp(parsed[1].value, big, 1200) == 0);
+    TEST_ASSERT(parsed[2].length == 200 && memcmp(parsed[2].value, &big[1200], 200) == 0);
+    uint16_t next = (uint16_t)(4 + data_len);
+    TEST_ASSERT(g_events.log[next] == 0xFA && g_events.log[next + 1] == 0x71);
+
+    /* Transport picks the extended format by itself, on the sendv path... */
+    capture_reset();
+    Transport_RegisterSender(TLV_INTERFACE_UART, mock_send);
+    Transport_RegisterSenderV(TLV_INTERFACE_UART, mock_sendv);
+    TEST_ASSERT(Transport_SendTLVs(TLV_INTERFACE_UART, 0x70, entries, 3));
+    TEST_ASSERT(g_tx.len == out_len && memcmp(g_tx.buf, out, out_len) == 0);
+
+    /* ...the plain sender (one call per slice)... */
+    capture_reset();
+    Transport_RegisterSenderV(TLV_INTERFACE_UART, NULL);
+    TEST_ASSERT(Transport_SendTLVs(TLV_INTERFACE_UART, 0x70, entries, 3));
+    TEST_ASSERT(g_tx.len == out_len && memcmp(g_tx.buf, out, out_len) == 0);
+
+#if TVLCOM_TX_QUEUE_ATOMIC
+    /* ...and a TX queue, as far as the pool buffers are large enough */
+    static tvl_tx_queue_t q;
+    TEST_ASSERT(TVL_TxQueueInit(&q));
+    Transport_SetTxQueue(TLV_INTERFACE_UART, &q);
+    capture_reset();
+    bool queued = Transport_SendTLVs(TLV_INTERFACE_UART, 0x70, entries, 3);
+    TEST_ASSERT(queued == (out_len <= TVLCOM_TX_FRAME_SIZE));
+    TEST_ASSERT(Transport_SendTLVs(TLV_INTERFACE_UART, 0x70, entries, 1));
+    TEST_ASSERT(TVL_TxQueueDrain(&q, UINT16_MAX) == (queued ? 2 : 1));
+    if (queued) TEST_ASSERT(memcmp(g_tx.buf, out, out_len) == 0);
+    Transport_SetTxQueue(TLV_INTERFACE_UART, NULL);
+    TVL_TxQueueDeinit(&q);
+#endif
+
+    /* Too many large values for the slice array: refused, not sent as a broken classic frame */
+    tlv_entry_t many[TRANSPORT_SENDV_MAX_IOV / 2];
+    for (uint8_t i = 0; i < TRANSPORT_SENDV_MAX_IOV / 2; ++i) {
+        TLV_CreateRawEntry(RAW_ADC, &big[i * 64u], 64, &many[i]);
+    }
+    capture_reset();
+    TEST_ASSERT(!Transport_SendTLVs(TLV_INTERFACE_UART, 0x72, many, TRANSPORT_SENDV_MAX_IOV / 2));
+    TEST_ASSERT(g_tx.len == 0);
+
+    /* Classic-only builders refuse long entries; a 16-bit running sum used to wrap to 0 here */
+    tlv_entry_t huge[2];
+    memset(huge, 0, sizeof(huge));
+    huge[0].type = RAW_ADC;
+    huge[0].length = 65534;
+    huge[0].value = big;
+    uint8_t frame[TLV_MAX_FRAME_SIZE];
+    TEST_ASSERT(!TLV_BuildFrame(0x73, huge, 1, frame, &flen));
+    huge[0].length = TLV_LEN_EXT;
+    TEST_ASSERT(!TLV_BuildFrame(0x73, huge, 1, frame, &flen));
+    huge[0].length = 65000;
+    TLV_CreateRawEntry(RAW_DAC1, big, 200, &huge[1]);
+    TEST_ASSERT(!TLV_BuildFrame(0x73, huge, 2, frame, &flen));
+    capture_reset();
+    TEST_ASSERT(!Transport_SendReliable(TLV_INTERFACE_UART, huge, 1, NULL, NULL, NULL));
+    TEST_ASSERT(g_tx.len == 0 && Transport_InFlight(TLV_INTERFACE_UART) == 0);
+    return 0;
+}
+
+static uint32_t g_fake_tick;
+static uint32_t fake_tick_ms(void) { return g_fake_tick; }
+
+static const uint8_t *g_msg_expect;
+static uint32_t g_msg_len;
+static uint8_t g_msg_type;
+static int g_msg_count;
+
+static bool on_fragment_message(uint8_t msg_type, uint8_t msg_id, const uint8_t *data, uint32_t length,
+                                tlv_interface_t iface)
+{
+    (void)msg_id;
+    (void)iface;
+    g_msg_count++;
+    g_msg_type = msg_type;
+    g_msg_len = length;
+    return g_msg_expect && memcmp(data, g_msg_expect, length) == 0;
+}
+
+static int test_fragment_reassembly_pool(void)
+{
+    static const tvl_hal_vtable_t hal = { .tick_ms = fake_tick_ms };
+    TVL_HAL_Set(&hal);
+    g_fake_tick = 1000;
+
+    static uint8_t msg[1000];
+    for (uint16_t i = 0; i < sizeof(msg); ++i) msg[i] = (uint8_t)(i * 31u + 5u);
+
+    capture_reset();
+    Transport_RegisterSender(TLV_INTERFACE_UART, mock_send);
+    FloatReceive_Init(TLV_INTERFACE_UART);
+    Fragment_Init();
+    Fragment_RegisterHandler(on_fragment_message);
+    g_msg_expect = msg;
+    g_msg_count = 0;
+
+    /* 1000 bytes -> 5 fragments of 200 bytes, all frames the same size */
+    TEST_ASSERT(Fragment_Send(TLV_INTERFACE_UART, DEVICE_FLASH, msg, sizeof(msg)));
+    const uint16_t flen = TLV_OVERHEAD_SIZE + 2 + FRAGMENT_HEADER_SIZE + 200;
+    TEST_ASSERT(g_tx.len == 5 * flen);
+    static uint8_t stream[5 * (TLV_OVERHEAD_SIZE + 2 + FRAGMENT_HEADER_SIZE + 200)];
+    memcpy(stream, g_tx.buf, sizeof(stream));
+
+    /* Out of order, with a duplicate: delivered once, every frame ACKed */
+    capture_reset();
+    static const uint8_t order[] = { 3, 0, 4, 0, 2, 1 };
+    for (uint8_t i = 0; i < sizeof(order); ++i) {
+        if (i == 5) TEST_ASSERT(g_msg_count == 0 && Fragment_PendingCount() == 1);
+        feed_bytes_to_uart_parser(&stream[order[i] * flen], flen);
+    }
+    TEST_ASSERT(g_msg_count == 1 && g_msg_type == DEVICE_FLASH && g_msg_len == sizeof(msg));
+    TEST_ASSERT(!capture_contains_tlv_type(TLV_TYPE_NACK));
+    TEST_ASSERT(Fragment_PendingCount() == 0);
+
+    /* A rejected message stays pooled; resending the NACKed fragment delivers it again */
+    capture_reset();
+    TEST_ASSERT(Fragment_Send(TLV_INTERFACE_UART, DEVICE_FLASH, msg, sizeof(msg)));
+    memcpy(stream, g_tx.buf, sizeof(stream));
+    g_msg_count = 0;
+    g_msg_expect = NULL;
+    capture_reset();
+    feed_bytes_to_uart_parser(stream, sizeof(stream));
+    TEST_ASSERT(g_msg_count == 1 && capture_contains_tlv_type(TLV_TYPE_NACK));
+    TEST_ASSERT(Fragment_PendingCount() == 1);
+    g_msg_expect = msg;
+    capture_reset();
+    feed_bytes_to_uart_parser(&stream[4 * flen], flen);
+    TEST_ASSERT(g_msg_count == 2 && g_msg_len == sizeof(msg));
+    TEST_ASSERT(capture_contains_tlv_type(TLV_TYPE_ACK) && !capture_contains_tlv_type(TLV_TYPE_NACK));
+    TEST_ASSERT(Fragment_PendingCount() == 0);
+
+    /* Pool exhaustion NACKs new messages; idle partial messages time out */
+    for (uint8_t m = 0; m < TVLCOM_FRAG_POOL_SIZE; ++m) {
+        capture_reset();
+        TEST_ASSERT(Fragment_Send(TLV_INTERFACE_UART, DEVICE_FLASH, msg, sizeof(msg)));
+        memcpy(stream, g_tx.buf, flen);
+        capture_reset();
+        feed_bytes_to_uart_parser(stream, flen);
+        TEST_ASSERT(!capture_contains_tlv_type(TLV_TYPE_NACK));
+    }
+    capture_reset();
+    TEST_ASSERT(Fragment_Send(TLV_INTERFACE_UART, DEVICE_ESPFU, msg, sizeof(msg)));
+    memcpy(stream, g_tx.buf, flen);
+    capture_reset();
+    feed_bytes_to_uart_parser(stream, flen);
+    TEST_ASSERT(capture_contains_tlv_type(TLV_TYPE_NACK));
+    g_fake_tick += TVLCOM_FRAG_TIMEOUT_MS - 1;
+    Fragment_Poll();
+    TEST_ASSERT(Fragment_PendingCount() == TVLCOM_FRAG_POOL_SIZE);
+    g_fake_tick += 1;
+    Fragment_Poll();
+    TEST_ASSERT(Fragment_PendingCount() == 0);
+
+    /* A message that fits one fragment skips the pool */
+    g_msg_count = 0;
+    capture_reset();
+    TEST_ASSERT(Fragment_Send(TLV_INTERFACE_UART, DEVICE_NAME, msg, 12));
+    memcpy(stream, g_tx.buf, g_tx.len);
+    uint16_t n = g_tx.len;
+    capture_reset();
+    feed_bytes_to_uart_parser(stream, n);
+    TEST_ASSERT(g_msg_count == 1 && g_msg_type == DEVICE_NAME && g_msg_len == 12);
+    TEST_ASSERT(capture_contains_tlv_type(TLV_TYPE_ACK) && Fragment_PendingCount() == 0);
+
+    TVL_HAL_Set(NULL);
+    return 0;
+}
+
+typedef struct {
+    uint8_t id[8];
+    transport_tx_status_t status[8];
+    uint8_t n;
+} tx_done_log_t;
+
+static void on_tx_done(uint8_t frame_id, transport_tx_status_t status, void *user)
+{
+    tx_done_log_t *log = (tx_done_log_t *)user;
+    if (log->n < 8) {
+        log->id[log->n] = frame_id;
+        log->status[log->n] = status;
+        log->n++;
+    }
+}
+
+static void feed_reply(bool ack, uint8_t frame_id)
+{
+    uint8_t f[TLV_MAX_FRAME_SIZE];
+    uint16_t n = 0;
+    if (ack) TLV_BuildAckFrame(frame_id, f, &n);
+    else TLV_BuildNackFrame(frame_id, f, &n);
+    feed_bytes_to_uart_parser(f, n);
+}
+
+static int test_reliable_window_retransmit(void)
+{
+    static const tvl_hal_vtable_t hal = { .tick_ms = fake_tick_ms };
+    TVL_HAL_Set(&hal);
+    g_fake_tick = 50;
+    capture_reset();
+    Transport_RegisterSender(TLV_INTERFACE_UART, mock_send);
+    FloatReceive_Init(TLV_INTERFACE_UART);
+
+    /* Start just before the 8-bit id wraps */
+    while (Transport_NextFrameId() != 0xFD) {}
+
+    tx_done_log_t log;
+    memset(&log, 0, sizeof(log));
+    tlv_entry_t e;
+    TLV_CreateControlCmdEntry(0x05, &e);
+    uint8_t ids[TRANSPORT_TX_WINDOW];
+    for (uint8_t i = 0; i < TRANSPORT_TX_WINDOW; ++i) {
+        TEST_ASSERT(Transport_SendReliable(TLV_INTERFACE_UART, &e, 1, on_tx_done, &log, &ids[i]));
+    }
+    TEST_ASSERT(ids[0] == 0xFE && ids[1] == 0xFF && ids[2] == 0x00);
+    TEST_ASSERT(!Transport_SendReliable(TLV_INTERFACE_UART, &e, 1, on_tx_done, &log, NULL)); /* window full */
+    TEST_ASSERT(Transport_InFlight(TLV_INTERFACE_UART) == TRANSPORT_TX_WINDOW);
+    const uint16_t flen = (uint16_t)(g_tx.len / TRANSPORT_TX_WINDOW);
+
+    /* Out-of-order ACK across the wrap frees one slot; stale/unknown ACKs are ignored */
+    feed_reply(true, ids[2]);
+    feed_reply(true, ids[2]);
+    TEST_ASSERT(log.n == 1 && log.id[0] == ids[2] && log.status[0] == TRANSPORT_TX_ACKED);
+    TEST_ASSERT(Transport_InFlight(TLV_INTERFACE_UART) == TRANSPORT_TX_WINDOW - 1);
+
+    /* Wrap the counter again: in-flight ids are skipped, never reissued */
+    while (Transport_NextFrameId() != (uint8_t)(ids[0] - 1u)) {}
+    uint8_t id_new = 0;
+    TEST_ASSERT(Transport_SendReliable(TLV_INTERFACE_UART, &e, 1, on_tx_done, &log, &id_new));
+    TEST_ASSERT(id_new == ids[2]);
+
+    /* Plain frames share the counter but never take an in-flight id, so their ACK can't retire one */
+    while (Transport_NextFrameId() != (uint8_t)(ids[0] - 1u)) {}
+    uint8_t plain = Transport_NextFrameId();
+    TEST_ASSERT(plain == (uint8_t)(ids[TRANSPORT_TX_WINDOW - 1] + 1u));
+    feed_reply(true, plain);
+    TEST_ASSERT(log.n == 1 && Transport_InFlight(TLV_INTERFACE_UART) == TRANSPORT_TX_WINDOW);
+
+    /* NACK resends the identical frame immediately */
+    capture_reset();
+    feed_reply(false, ids[0]);
+    TEST_ASSERT(g_tx.len == flen && g_tx.buf[2] == ids[0]);
+
+    /* RTO: everything unanswered is resent, then reported after the last retry */
+    for (uint8_t r = 0; r < TRANSPORT_TX_MAX_RETRIES; ++r) {
+        g_fake_tick += TRANSPORT_TX_RTO_MS;
+        capture_reset();
+        Transport_Poll();
+        TEST_ASSERT(g_tx.len > 0);
+        feed_reply(true, ids[1]); /* only acts once */
+    }
+    TEST_ASSERT(log.n == 3 && log.id[1] == ids[1] && log.status[1] == TRANSPORT_TX_ACKED);
+    TEST_ASSERT(log.id[2] == ids[0] && log.status[2] == TRANSPORT_TX_TIMEOUT); /* the NACK used one retry */
+    g_fake_tick += TRANSPORT_TX_RTO_MS;
+    capture_reset();
+    Transport_Poll();
+    TEST_ASSERT(g_tx.len == 0);
+    TEST_ASSERT(log.n == TRANSPORT_TX_WINDOW + 1);
+    for (uint8_t i = 3; i < log.n; ++i) {
+        TEST_ASSERT(log.status[i] == TRANSPORT_TX_TIMEOUT);
+    }
+    TEST_ASSERT(Transport_InFlight(TLV_INTERFACE_UART) == 0);
+
+    TVL_HAL_Set(NULL);
+    return 0;
+}
+
+static uint8_t g_acked_ids[16];
+static uint8_t g_acked_count;
+
+static void on_ack_record(uint8_t original_id, tlv_interface_t iface)
+{
+    (void)iface;
+    if (g_acked_count < sizeof(g_acked_ids)) g_acked_ids[g_acked_count++] = original_id;
+}
+
+static int test_coalesced_ack_bitmap(void)
+{
+    static const tvl_hal_vtable_t hal = { .tick_ms = fake_tick_ms };
+    TVL_HAL_Set(&hal);
+    g_fake_tick = 500;
+    capture_reset();
+    Transport_RegisterSender(TLV_INTERFACE_UART, mock_send);
+    FloatReceive_Init(TLV_INTERFACE_UART);
+    FloatReceive_RegisterTLVHandler(0x55, on_custom_ok);
+    FloatReceive_SetAckCoalescing(4, 20);
+
+    tlv_entry_t e;
+    uint8_t v = 0xAA;
+    TLV_CreateRawEntry(0x55, &v, 1, &e);
+    uint8_t frame[TLV_MAX_FRAME_SIZE];
+    uint16_t n = 0;
+
+    /* Ids straddling the wrap; the 4th frame flushes one ACK frame for all of them */
+    static const uint8_t ids[] = { 0xFE, 0x01, 0xFF, 0xFE, 0x00 };
+    for (uint8_t i = 0; i < sizeof(ids); ++i) {
+        if (i == 4) TEST_ASSERT(g_tx.len == 0);
+        TEST_ASSERT(TLV_BuildFrame(ids[i], &e, 1, frame, &n));
+        feed_bytes_to_uart_parser(frame, n);
+    }
+    TEST_ASSERT(g_tx.len == TLV_OVERHEAD_SIZE + 2 + 2);
+    TEST_ASSERT(g_tx.buf[4] == TLV_TYPE_ACK_BITMAP && g_tx.buf[6] == 0xFE && g_tx.buf[7] == 0x0F);
+
+    /* The peer fans the bitmap out per id, and does not answer it */
+    uint8_t ack[TLV_MAX_FRAME_SIZE];
+    uint16_t ack_len = g_tx.len;
+    memcpy(ack, g_tx.buf, ack_len);
+    capture_reset();
+    g_acked_count = 0;
+    FloatReceive_RegisterAckHandler(on_ack_record);
+    feed_bytes_to_uart_parser(ack, ack_len);
+    TEST_ASSERT(g_tx.len == 0);
+    TEST_ASSERT(g_acked_count == 4 && g_acked_ids[0] == 0xFE && g_acked_ids[3] == 0x01);
+
+    /* A lone ACK goes out once the delay expires; NACKs are never held */
+    TEST_ASSERT(TLV_BuildFrame(0x30, &e, 1, frame, &n));
+    feed_bytes_to_uart_parser(frame, n);
+    FloatReceive_Poll();
+    TEST_ASSERT(g_tx.len == 0);
+    g_fake_tick += 20;
+    FloatReceive_Poll();
+    TEST_ASSERT(g_tx.len == TLV_OVERHEAD_SIZE + 3 && g_tx.buf[4] == TLV_TYPE_ACK && g_tx.buf[6] == 0x30);
+    capture_reset();
+    v = 0x00;
+    TEST_ASSERT(TLV_BuildFrame(0x31, &e, 1, frame, &n));
+    feed_bytes_to_uart_parser(frame, n);
+    TEST_ASSERT(capture_contains_tlv_type(TLV_TYPE_NACK));
+
+    /* Default mode: one plain ACK per frame */
+    FloatReceive_SetAckCoalescing(0, 0);
+    FloatReceive_RegisterAckHandler(NULL);
+    capture_reset();
+    v = 0xAA;
+    TEST_ASSERT(TLV_BuildFrame(0x32, &e, 1, frame, &n));
+    feed_bytes_to_uart_parser(frame, n);
+    TEST_ASSERT(g_tx.buf[4] == TLV_TYPE_ACK && g_tx.buf[6] == 0x32);
+
+    TVL_HAL_Set(NULL);
+    return 0;
+}
+
+static int test_piggybacked_ack_on_data_frames(void)
+{
+    static const tvl_hal_vtable_t hal = { .tick_ms = fake_tick_ms };
+    TVL_HAL_Set(&hal);
+    g_fake_tick = 900;
+    capture_reset();
+    Transport_RegisterSender(TLV_INTERFACE_UART, mock_send);
+    FloatReceive_Init(TLV_INTERFACE_UART);
+    FloatReceive_RegisterTLVHandler(0x55, on_custom_ok);
+    FloatReceive_SetAckPiggyback(true, 10);
+
+    tlv_entry_t e;
+    uint8_t v = 0xAA;
+    TLV_CreateRawEntry(0x55, &v, 1, &e);
+    uint8_t frame[TLV_MAX_FRAME_SIZE];
+    uint16_t n = 0;
+
+    /* ACK is held, then rides on our next data frame as a 3-byte TLV */
+    TEST_ASSERT(TLV_BuildFrame(0x40, &e, 1, frame, &n));
+    feed_bytes_to_uart_parser(frame, n);
+    TEST_ASSERT(g_tx.len == 0);
+    TEST_ASSERT(Transport_SendTLVs(TLV_INTERFACE_UART, 0x90, &e, 1));
+    tlv_entry_t parsed[4];
+    TEST_ASSERT(g_tx.len == TLV_OVERHEAD_SIZE + 3 + 3);
+    TEST_ASSERT(TLV_ParseData(&g_tx.buf[4], g_tx.buf[3], parsed, 4) == 2);
+    TEST_ASSERT(parsed[1].type == TLV_TYPE_ACK && parsed[1].value[0] == 0x40);
+
+    /* Nothing pending any more: the next frame is sent as built */
+    capture_reset();
+    TEST_ASSERT(Transport_SendTLVs(TLV_INTERFACE_UART, 0x91, &e, 1));
+    TEST_ASSERT(g_tx.len == TLV_OVERHEAD_SIZE + 3);
+
+    /* No data to ride on: standalone bitmap ACK after the deadline */
+    for (uint8_t id = 0x41; id <= 0x43; ++id) {
+        TEST_ASSERT(TLV_BuildFrame(id, &e, 1, frame, &n));
+        feed_bytes_to_uart_parser(frame, n);
+    }
+    capture_reset();
+    FloatReceive_Poll();
+    TEST_ASSERT(g_tx.len == 0);
+    g_fake_tick += 10;
+    FloatReceive_Poll();
+    TEST_ASSERT(g_tx.buf[4] == TLV_TYPE_ACK_BITMAP && g_tx.buf[6] == 0x41 && g_tx.buf[7] == 0x07);
+
+    /* Mixed frame from the peer: the ACK part is reported, the data part is ACKed (once) */
+    tlv_entry_t mixed[2];
+    uint8_t acked_id = 0x77;
+    mixed[0] = e;
+    TLV_CreateRawEntry(TLV_TYPE_ACK, &acked_id, 1, &mixed[1]);
+    TEST_ASSERT(TLV_BuildFrame(0x44, mixed, 2, frame, &n));
+    g_acked_count = 0;
+    g_seen_custom = false;
+    FloatReceive_RegisterAckHandler(on_ack_record);
+    capture_reset();
+    feed_bytes_to_uart_parser(frame, n);
+    TEST_ASSERT(g_seen_custom && g_acked_count == 1 && g_acked_ids[0] == 0x77);
+    FloatReceive_FlushAcks(TLV_INTERFACE_UART);
+    TEST_ASSERT(g_tx.len == TLV_OVERHEAD_SIZE + 3 && g_tx.buf[4] == TLV_TYPE_ACK && g_tx.buf[6] == 0x44);
+
+    /* ...and an ACK-only frame is still never answered */
+    memcpy(frame, g_tx.buf, g_tx.len);
+    n = g_tx.len;
+    capture_reset();
+    feed_bytes_to_uart_parser(frame, n);
+    g_fake_tick += 100;
+    FloatReceive_Poll();
+    TEST_ASSERT(g_tx.len == 0);
+
+    FloatReceive_SetAckPiggyback(false, 0);
+    FloatReceive_RegisterAckHandler(NULL);
+    TVL_HAL_Set(NULL);
+    return 0;
+}
+
+static int failing_send(const uint8_t *data, uint16_t len)
+{
+    (void)data;
+    (void)len;
+    return -1;
+}
+
+static int test_piggybacked_acks_survive_failed_send(void)
+{
+    static const tvl_hal_vtable_t hal = { .tick_ms = fake_tick_ms };
+    TVL_HAL_Set(&hal);
+    g_fake_tick = 1200;
+    capture_reset();
+    Transport_RegisterSender(TLV_INTERFACE_UART, mock_send);
+    FloatReceive_Init(TLV_INTERFACE_UART);
+    FloatReceive_RegisterTLVHandler(0x55, on_custom_ok);
+    FloatReceive_SetAckPiggyback(true, 10);
+
+    tlv_entry_t e;
+    uint8_t v = 0xAA;
+    TLV_CreateRawEntry(0x55, &v, 1, &e);
+    uint8_t frame[TLV_MAX_FRAME_SIZE];
+    uint16_t n = 0;
+    for (uint8_t id = 0x50; id <= 0x52; ++id) {
+        TEST_ASSERT(TLV_BuildFrame(id, &e, 1, frame, &n));
+        feed_bytes_to_uart_parser(frame, n);
+    }
+    TEST_ASSERT(g_tx.len == 0);
+
+    /* The data frame carrying the ACKs fails: they go back to the batch */
+    Transport_RegisterSender(TLV_INTERFACE_UART, failing_send);
+    TEST_ASSERT(!Transport_SendTLVs(TLV_INTERFACE_UART, 0x92, &e, 1));
+
+    /* One more id arrives meanwhile; the next frame acknowledges all four */
+    Transport_RegisterSender(TLV_INTERFACE_UART, mock_send);
+    TEST_ASSERT(TLV_BuildFrame(0x53, &e, 1, frame, &n));
+    feed_bytes_to_uart_parser(frame, n);
+    TEST_ASSERT(g_tx.len == 0);
+    TEST_ASSERT(Transport_SendTLVs(TLV_INTERFACE_UART, 0x93, &e, 1));
+    tlv_entry_t parsed[4];
+    TEST_ASSERT(TLV_ParseData(&g_tx.buf[4], g_tx.buf[3], parsed, 4) == 2);
+    TEST_ASSERT(parsed[1].type == TLV_TYPE_ACK_BITMAP && parsed[1].length == 2);
+    TEST_ASSERT(parsed[1].value[0] == 0x50 && parsed[1].value[1] == 0x0F);
+
+    /* A lone ACK taken by a failed frame still goes out by the deadline */
+    TEST_ASSERT(TLV_BuildFrame(0x54, &e, 1, frame, &n));
+    feed_bytes_to_uart_parser(frame, n);
+    Transport_RegisterSender(TLV_INTERFACE_UART, failing_send);
+    TEST_ASSERT(!Transport_SendTLVs(TLV_INTERFACE_UART, 0x94, &e, 1));
+    Transport_RegisterSender(TLV_INTERFACE_UART, mock_send);
+    capture_reset();
+    g_fake_tick += 10;
+    FloatReceive_Poll();
+    TEST_ASSERT(g_tx.len == TLV_OVERHEAD_SIZE + 3 && g_tx.buf[4] == TLV_TYPE_ACK && g_tx.buf[6] == 0x54);
+
+    FloatReceive_SetAckPiggyback(false, 0);
+    TVL_HAL_Set(NULL);
+    return 0;
+}
+
+static int test_best_effort_frames_are_not_answered(void)
+{
+    TVL_HAL_Set(NULL);
+    capture_reset();
+    Transport_RegisterSender(TLV_INTERFACE_UART, mock_send);
+    FloatReceive_Init(TLV_INTERFACE_UART);
+    FloatReceive_RegisterTLVHandler(0x55, on_custom_ok);
+
+    tlv_entry_t e;
+    uint8_t v = 0xAA;
+    TLV_CreateRawEntry(0x55, &v, 1, &e);
+
+    /* Sender side: one zero-length flag TLV up front, the rest unchanged */
+    TEST_ASSERT(Transport_SendTLVsEx(TLV_INTERFACE_UART, 0x60, &e, 1, TRANSPORT_DELIVERY_BEST_EFFORT));
+    TEST_ASSERT(g_tx.len == TLV_OVERHEAD_SIZE + 2 + 3);
+    TEST_ASSERT(g_tx.buf[4] == TLV_TYPE_NO_ACK && g_tx.buf[5] == 0 && g_tx.buf[6] == 0x55);
+
+    /* Receiver side: handler runs, nothing is sent back (even when it fails) */
+    uint8_t frame[TLV_MAX_FRAME_SIZE];
+    uint16_t n = g_tx.len;
+    memcpy(frame, g_tx.buf, n);
+    capture_reset();
+    g_seen_custom = false;
+    feed_bytes_to_uart_parser(frame, n);
+    TEST_ASSERT(g_seen_custom && g_tx.len == 0);
+    v = 0x00;
+    TEST_ASSERT(Transport_SendTLVsEx(TLV_INTERFACE_UART, 0x61, &e, 1, TRANSPORT_DELIVERY_BEST_EFFORT));
+    n = g_tx.len;
+    memcpy(frame, g_tx.buf, n);
+    capture_reset();
+    feed_bytes_to_uart_parser(frame, n);
+    TEST_ASSERT(g_tx.len == 0);
+
+    /* Acked class is byte-identical to Transport_SendTLVs() and still answered */
+    v = 0xAA;
+    TEST_ASSERT(Transport_SendTLVsEx(TLV_INTERFACE_UART, 0x62, &e, 1, TRANSPORT_DELIVERY_ACKED));
+    n = g_tx.len;
+    memcpy(frame, g_tx.buf, n);
+    capture_reset();
+    feed_bytes_to_uart_parser(frame, n);
+    TEST_ASSERT(capture_contains_tlv_type(TLV_TYPE_ACK));
+    return 0;
+}
+
+static tlv_nack_info_t g_nack_detail;
+
+static void on_nack_detail(const tlv_nack_info_t *nack, tlv_interface_t iface)
+{
+    (void)iface;
+    g_nack_detail = *nack;
+}
+
+static uint8_t on_custom_status(const tlv_entry_t *e, tlv_interface_t iface)
+{
+    (void)iface;
+    return (e->length == 1 && e->value[0] == 0xAA) ? TLV_STATUS_OK : TLV_STATUS_BAD_VALUE;
+}
+
+static int test_selective_nack_resends_only_rejected(void)
+{
+    static const tvl_hal_vtable_t hal = { .tick_ms = fake_tick_ms };
+    TVL_HAL_Set(&hal);
+    g_fake_tick = 1000;
+    capture_reset();
+    Transport_RegisterSender(TLV_INTERFACE_UART, mock_send);
+    FloatReceive_Init(TLV_INTERFACE_UART);
+    FloatReceive_RegisterTLVHandler(0x55, on_custom_ok);
+    FloatReceive_RegisterTLVStatusHandler(0x56, on_custom_status);
+    FloatReceive_RegisterNackDetailHandler(on_nack_detail);
+
+    /* [ok 0x55][unknown 0x77][bad value 0x56][ok 0x56] */
+    uint8_t good = 0xAA, bad = 0x01;
+    tlv_entry_t e[4];
+    TLV_CreateRawEntry(0x55, &good, 1, &e[0]);
+    TLV_CreateRawEntry(0x77, &good, 1, &e[1]);
+    TLV_CreateRawEntry(0x56, &bad, 1, &e[2]);
+    TLV_CreateRawEntry(0x56, &good, 1, &e[3]);
+    uint8_t frame[TLV_MAX_FRAME_SIZE];
+    uint16_t n = 0;
+    TEST_ASSERT(TLV_BuildFrame(0x70, e, 4, frame, &n));
+    feed_bytes_to_uart_parser(frame, n);
+
+    /* Receiver lists exactly the two rejected TLVs */
+    tlv_entry_t reply[2];
+    TEST_ASSERT(TLV_ParseData(&g_tx.buf[4], g_tx.buf[3], reply, 2) == 1);
+    tlv_nack_info_t info;
+    TEST_ASSERT(TLV_ParseNack(&reply[0], &info));
+    TEST_ASSERT(info.frame_id == 0x70 && info.count == 2);
+    TEST_ASSERT(info.items[0].index == 1 && info.items[0].type == 0x77 &&
+                info.items[0].status == TLV_STATUS_UNKNOWN_TYPE);
+    TEST_ASSERT(info.items[1].index == 2 && info.items[1].type == 0x56 &&
+                info.items[1].status == TLV_STATUS_BAD_VALUE);
+
+    /* Legacy 1-byte NACK still parses, with no items */
+    tlv_entry_t legacy;
+    uint8_t legacy_id = 0x70;
+    TLV_CreateRawEntry(TLV_TYPE_NACK, &legacy_id, 1, &legacy);
+    TEST_ASSERT(TLV_ParseNack(&legacy, &info) && info.frame_id == 0x70 && info.count == 0);
+
+    /* Sender resends only the rejected entries, as a new frame */
+    TEST_ASSERT(TLV_ParseNack(&reply[0], &info));
+    capture_reset();
+    uint8_t id = 0;
+    TEST_ASSERT(Transport_ResendRejected(TLV_INTERFACE_UART, e, 4, &info, &id));
+    tlv_entry_t resent[4];
+    TEST_ASSERT(g_tx.buf[2] == id && id != 0x70);
+    TEST_ASSERT(TLV_ParseData(&g_tx.buf[4], g_tx.buf[3], resent, 4) == 2);
+    TEST_ASSERT(resent[0].type == 0x77 && resent[1].type == 0x56 && resent[1].value[0] == bad);
+
+    /* Reliable window: a selective NACK trims the stored frame before the retry */
+    tx_done_log_t log;
+    memset(&log, 0, sizeof(log));
+    uint8_t rid = 0;
+    capture_reset();
+    TEST_ASSERT(Transport_SendReliable(TLV_INTERFACE_UART, e, 4, on_tx_done, &log, &rid));
+    const uint16_t full_len = g_tx.len;
+    info.frame_id = rid;
+    uint8_t f[TLV_MAX_FRAME_SIZE];
+    uint16_t fl = 0;
+    TEST_ASSERT(TLV_BuildNackFrameEx(&info, f, &fl));
+    g_nack_detail.count = 0;
+    capture_reset();
+    feed_bytes_to_uart_parser(f, fl);
+    TEST_ASSERT(g_nack_detail.frame_id == rid && g_nack_detail.count == 2);
+    TEST_ASSERT(g_tx.len > 0 && g_tx.len < full_len && g_tx.buf[2] == rid);
+    TEST_ASSERT(TLV_ParseData(&g_tx.buf[4], g_tx.buf[3], resent, 4) == 2);
+    TEST_ASSERT(resent[0].type == 0x77 && resent[1].type == 0x56);
+    feed_reply(true, rid);
+    TEST_ASSERT(log.n == 1 && log.id[0] == rid && log.status[0] == TRANSPORT_TX_ACKED);
+
+    FloatReceive_RegisterNackDetailHandler(NULL);
+    TVL_HAL_Set(NULL);
+    return 0;
+}
+
+static uint8_t g_cmd_runs;
+
+static bool on_cmd_count(uint8_t command, tlv_interface_t iface)
+{
+    (void)command;
+    (void)iface;
+    g_cmd_runs++;
+    return true;
+}
+
+static int test_duplicate_frames_replay_cached_reply(void)
+{
+#if !TVLCOM_DUP_CACHE_SIZE
+    return 0;
+#endif
+    static const tvl_hal_vtable_t hal = { .tick_ms = fake_tick_ms };
+    TVL_HAL_Set(&hal);
+    g_fake_tick = 100;
+    capture_reset();
+    Transport_RegisterSender(TLV_INTERFACE_UART, mock_send);
+    FloatReceive_Init(TLV_INTERFACE_UART);
+    FloatReceive_RegisterCmdHandler(0x07, on_cmd_count);
+    g_cmd_runs = 0;
+
+    /* Retransmitted command: handler runs once, the ACK is sent both times */
+    tlv_entry_t e[2];
+    TLV_CreateControlCmdEntry(0x07, &e[0]);
+    uint8_t frame[TLV_MAX_FRAME_SIZE];
+    uint16_t n = 0;
+    TEST_ASSERT(TLV_BuildFrame(0x21, e, 1, frame, &n));
+    feed_bytes_to_uart_parser(frame, n);
+    uint8_t first[TLV_MAX_FRAME_SIZE];
+    uint16_t first_len = g_tx.len;
+    memcpy(first, g_tx.buf, first_len);
+    capture_reset();
+    feed_bytes_to_uart_parser(frame, n);
+    TEST_ASSERT(g_cmd_runs == 1);
+    TEST_ASSERT(g_tx.len == first_len && memcmp(g_tx.buf, first, first_len) == 0);
+
+    /* Same id, different content: a new frame (sender wrapped), dispatched */
+    TLV_CreateControlCmdEntry(0x08, &e[1]);
+    TEST_ASSERT(TLV_BuildFrame(0x21, e, 2, frame, &n));
+    capture_reset();
+    feed_bytes_to_uart_parser(frame, n);
+    TEST_ASSERT(g_cmd_runs == 2);
+
+    /* NACKed frame: not cached, the retransmission is dispatched and NACKed again */
+    capture_reset();
+    feed_bytes_to_uart_parser(frame, n);
+    TEST_ASSERT(g_cmd_runs == 3);
+    tlv_entry_t reply;
+    tlv_nack_info_t info;
+    TEST_ASSERT(TLV_ParseData(&g_tx.buf[4], g_tx.buf[3], &reply, 1) == 1);
+    TEST_ASSERT(TLV_ParseNack(&reply, &info));
+    TEST_ASSERT(info.frame_id == 0x21 && info.count == 1 && info.items[0].index == 1 &&
+                info.items[0].status == TLV_STATUS_UNKNOWN_TYPE);
+
+    /* Entries age out */
+    TEST_ASSERT(TLV_BuildFrame(0x22, e, 1, frame, &n));
+    feed_bytes_to_uart_parser(frame, n);
+    TEST_ASSERT(g_cmd_runs == 4);
+    g_fake_tick += TVLCOM_DUP_CACHE_TIMEOUT_MS;
+    feed_bytes_to_uart_parser(frame, n);
+    TEST_ASSERT(g_cmd_runs == 5);
+
+    /* Direct callback (no parser CRC to reuse) is fingerprinted the same way */
+    FloatReceive_FrameCallback(0x22, &frame[4], frame[3], TLV_INTERFACE_UART);
+    TEST_ASSERT(g_cmd_runs == 5);
+
+    FloatReceive_RegisterCmdHandler(0x07, NULL);
+    TVL_HAL_Set(NULL);
+    return 0;
+}
+
+#if TVLCOM_DUP_CACHE_SIZE
+static uint8_t g_busy_runs;
+
+/* Busy the first time, fine afterwards */
+static uint8_t on_busy_once(const tlv_entry_t *e, tlv_interface_t iface)
+{
+    (void)e;
+    (void)iface;
+    return (g_busy_runs++ == 0) ? TLV_STATUS_BUSY : TLV_STATUS_OK;
+}
+#endif
+
+static int test_duplicate_cache_retries_nacked_frame(void)
+{
+#if TVLCOM_DUP_CACHE_SIZE
+    static const tvl_hal_vtable_t hal = { .tick_ms = fake_tick_ms };
+    TVL_HAL_Set(&hal);
+    g_fake_tick = 100;
+    capture_reset();
+    Transport_RegisterSender(TLV_INTERFACE_UART, mock_send);
+    FloatReceive_Init(TLV_INTERFACE_UART);
+    FloatReceive_RegisterTLVStatusHandler(0x58, on_busy_once);
+    g_busy_runs = 0;
+
+    tlv_entry_t e;
+    uint8_t v = 0x11;
+    TLV_CreateRawEntry(0x58, &v, 1, &e);
+    uint8_t frame[TLV_MAX_FRAME_SIZE];
+    uint16_t n = 0;
+    TEST_ASSERT(TLV_BuildFrame(0x31, &e, 1, frame, &n));
+
+    /* First delivery: BUSY -> selective NACK */
+    feed_bytes_to_uart_parser(frame, n);
+    tlv_entry_t reply;
+    tlv_nack_info_t info;
+    TEST_ASSERT(g_busy_runs == 1);
+    TEST_ASSERT(TLV_ParseData(&g_tx.buf[4], g_tx.buf[3], &reply, 1) == 1);
+    TEST_ASSERT(TLV_ParseNack(&reply, &info) && info.count == 1 && info.items[0].status == TLV_STATUS_BUSY);
+
+    /* Identical retransmission: the handler runs again and succeeds -> ACK */
+    capture_reset();
+    feed_bytes_to_uart_parser(frame, n);
+    TEST_ASSERT(g_busy_runs == 2);
+    TEST_ASSERT(TLV_ParseData(&g_tx.buf[4], g_tx.buf[3], &reply, 1) == 1 && reply.type == TLV_TYPE_ACK);
+
+    /* Now ACKed: a further copy is answered from the cache */
+    capture_reset();
+    feed_bytes_to_uart_parser(frame, n);
+    TEST_ASSERT(g_busy_runs == 2 && g_tx.len > 0);
+
+    FloatReceive_RegisterTLVStatusHandler(0x58, NULL);
+    TVL_HAL_Set(NULL);
+#endif
+    return 0;
+}
+
+static uint16_t g_typed_runs;
+
+static bool on_typed_count(const tlv_entry_t *e, tlv_interface_t iface)
+{
+    (void)e;
+    (void)iface;
+    g_typed_runs++;
+    return true;
+}
+
+static int test_dispatch_tables_lift_handler_cap(void)
+{
+    TVL_HAL_Set(NULL);
+    capture_reset();
+    Transport_RegisterSender(TLV_INTERFACE_UART, mock_send);
+    FloatReceive_Init(TLV_INTERFACE_UART);
+
+    /* More than the old 32-entry cap: INFO_* range plus the SENSOR_* page */
+    uint8_t types[40];
+    for (uint8_t i = 0; i < 32; ++i) types[i] = (uint8_t)(0xA0 + i);
+    for (uint8_t i = 0; i < 8; ++i) types[32 + i] = (uint8_t)(0x20 + i);
+    for (uint8_t i = 0; i < 40; ++i) FloatReceive_RegisterTLVHandler(types[i], on_typed_count);
+    for (uint8_t c = 0; c < 40; ++c) FloatReceive_RegisterCmdHandler(c, on_cmd_count);
+
+    /* Every registered id dispatches; the last registered ones included */
+    g_typed_runs = 0;
+    g_cmd_runs = 0;
+    uint8_t v = 0;
+    for (uint8_t i = 0; i < 40; ++i) {
+        tlv_entry_t e[2];
+        TLV_CreateRawEntry(types[i], &v, 1, &e[0]);
+        TLV_CreateControlCmdEntry(i, &e[1]);
+        uint8_t frame[TLV_MAX_FRAME_SIZE];
+        uint16_t n = 0;
+        TEST_ASSERT(TLV_BuildFrame((uint8_t)(0x80 + i), e, 2, frame, &n));
+        capture_reset();
+        feed_bytes_to_uart_parser(frame, n);
+        TEST_ASSERT(capture_contains_tlv_type(TLV_TYPE_ACK));
+    }
+    TEST_ASSERT(g_typed_runs == 40 && g_cmd_runs == 40);
+
+    /* Unregistered neighbours of registered ids are still unknown */
+    tlv_entry_t e;
+    TLV_CreateRawEntry(0x28, &v, 1, &e);
+    uint8_t frame[TLV_MAX_FRAME_SIZE];
+    uint16_t n = 0;
+    TEST_ASSERT(TLV_BuildFrame(0xC0, &e, 1, frame, &n));
+    capture_reset();
+    feed_bytes_to_uart_parser(frame, n);
+    TEST_ASSERT(capture_contains_tlv_type(TLV_TYPE_NACK) && g_typed_runs == 40);
+
+    /* Unregister: the id becomes unknown again */
+    FloatReceive_RegisterTLVHandler(types[39], NULL);
+    TLV_CreateRawEntry(types[39], &v, 1, &e);
+    TEST_ASSERT(TLV_BuildFrame(0xC1, &e, 1, frame, &n));
+    capture_reset();
+    feed_bytes_to_uart_parser(frame, n);
+    TEST_ASSERT(capture_contains_tlv_type(TLV_TYPE_NACK) && g_typed_runs == 40);
+
+    for (uint8_t i = 0; i < 40; ++i) FloatReceive_RegisterTLVHandler(types[i], NULL);
+    for (uint8_t c = 0; c < 40; ++c) FloatReceive_RegisterCmdHandler(c, NULL);
+    return 0;
+}
+
+static bool on_register_more(const tlv_entry_t *e, tlv_interface_t iface)
+{
+    (void)e;
+    (void)iface;
+    /* Registering from inside a handler must not block on the registry */
+    for (uint8_t i = 0; i < 4; ++i) FloatReceive_RegisterTLVHandler(0x66, on_typed_count);
+    FloatReceive_RegisterCmdHandler(0x09, on_cmd_count);
+    return true;
+}
+
+static int test_registry_snapshot_per_frame(void)
+{
+    TVL_HAL_Set(NULL);
+    capture_reset();
+    Transport_RegisterSender(TLV_INTERFACE_UART, mock_send);
+    FloatReceive_Init(TLV_INTERFACE_UART);
+    FloatReceive_RegisterTLVHandler(0x65, on_register_more);
+    FloatReceive_RegisterTLVHandler(0x66, NULL);
+    FloatReceive_RegisterCmdHandler(0x09, NULL);
+
+    /* Handlers are resolved once per frame: 0x66 registered mid-frame is still unknown here */
+    uint8_t v = 0;
+    tlv_entry_t e[3];
+    TLV_CreateRawEntry(0x65, &v, 1, &e[0]);
+    TLV_CreateRawEntry(0x66, &v, 1, &e[1]);
+    TLV_CreateControlCmdEntry(0x09, &e[2]);
+    uint8_t frame[TLV_MAX_FRAME_SIZE];
+    uint16_t n = 0;
+    TEST_ASSERT(TLV_BuildFrame(0x90, e, 3, frame, &n));
+    g_typed_runs = 0;
+    g_cmd_runs = 0;
+    feed_bytes_to_uart_parser(frame, n);
+    tlv_entry_t reply;
+    tlv_nack_info_t info;
+    TEST_ASSERT(TLV_ParseData(&g_tx.buf[4], g_tx.buf[3], &reply, 1) == 1);
+    TEST_ASSERT(TLV_ParseNack(&reply, &info) && info.count == 2);
+    TEST_ASSERT(g_typed_runs == 0 && g_cmd_runs == 0);
+
+    /* ... and in effect from the next frame on */
+    TEST_ASSERT(TLV_BuildFrame(0x91, &e[1], 2, frame, &n));
+    capture_reset();
+    feed_bytes_to_uart_parser(frame, n);
+    TEST_ASSERT(capture_contains_tlv_type(TLV_TYPE_ACK));
+    TEST_ASSERT(g_typed_runs == 1 && g_cmd_runs == 1);
+
+    FloatReceive_RegisterTLVHandler(0x65, NULL);
+    FloatReceive_RegisterTLVHandler(0x66, NULL);
+    FloatReceive_RegisterCmdHandler(0x09, NULL);
+    return 0;
+}
+
+/* Second link for the context tests */
+static capture_t g_tx_b;
+
+static int mock_send_b(const uint8_t *data, uint16_t len)
+{
+    if (!data || (uint32_t)g_tx_b.len + len > sizeof(g_tx_b.buf)) return -1;
+    memcpy(&g_tx_b.buf[g_tx_b.len], data, len);
+    g_tx_b.len = (uint16_t)(g_tx_b.len + len);
+    return (int)len;
+}
+
+static tvl_context_t *g_seen_ctx;
+
+static bool on_ctx_tlv(const tlv_entry_t *entry, tlv_interface_t interface)
+{
+    (void)entry;
+    (void)interface;
+    g_seen_ctx = TVL_ContextCurrent();
+    return true;
+}
+
+static int test_contexts_are_isolated(void)
+{
+    static tvl_context_t a, b;
+    TVL_HAL_Set(NULL);
+    TVL_ContextInit(&a);
+    TVL_ContextInit(&b);
+    TEST_ASSERT(((uintptr_t)&a % TVLCOM_CACHE_LINE) == 0);
+    TEST_ASSERT((offsetof(tvl_context_t, tx_senders) % TVLCOM_CACHE_LINE) == 0);
+
+    capture_reset();
+    memset(&g_tx_b, 0, sizeof(g_tx_b));
+    Transport_RegisterSender(TLV_INTERFACE_UART, mock_send);
+    FloatReceive_Init(TLV_INTERFACE_UART);
+    Transport_RegisterSenderCtx(&a, TLV_INTERFACE_UART, mock_send);
+    Transport_RegisterSenderCtx(&b, TLV_INTERFACE_UART, mock_send_b);
+    FloatReceive_InitCtx(&a, TLV_INTERFACE_UART);
+    FloatReceive_InitCtx(&b, TLV_INTERFACE_UART);
+    FloatReceive_RegisterTLVHandlerCtx(&a, 0x70, on_ctx_tlv);
+
+    uint8_t v = 1;
+    tlv_entry_t e;
+    TLV_CreateRawEntry(0x70, &v, 1, &e);
+    uint8_t frame[TLV_MAX_FRAME_SIZE];
+    uint16_t n = 0;
+    TEST_ASSERT(TLV_BuildFrame(0x40, &e, 1, frame, &n));
+
+    /* Handlers and replies stay on their own link; handlers see which context called them */
+    g_seen_ctx = NULL;
+    TEST_FEED(FloatReceive_GetParserCtx(&a, TLV_INTERFACE_UART), frame, n);
+    TEST_ASSERT(g_seen_ctx == &a);
+    TEST_ASSERT(TVL_ContextCurrent() == TVL_ContextDefault());
+    TEST_ASSERT(capture_contains_tlv_type(TLV_TYPE_ACK) && g_tx_b.len == 0);
+
+    capture_reset();
+    TEST_FEED(FloatReceive_GetParserCtx(&b, TLV_INTERFACE_UART), frame, n);
+    TEST_ASSERT(g_tx.len == 0 && g_tx_b.len > 0);
+    tlv_entry_t reply;
+    TEST_ASSERT(TLV_ParseData(&g_tx_b.buf[4], g_tx_b.buf[3], &reply, 1) == 1);
+    TEST_ASSERT(reply.type == TLV_TYPE_NACK);
+
+    feed_bytes_to_uart_parser(frame, n); /* default context: no 0x70 handler either */
+    TEST_ASSERT(capture_contains_tlv_type(TLV_TYPE_NACK));
+
+    /* Frame ids and reliable-send windows are per context */
+    TEST_ASSERT(Transport_NextFrameIdCtx(&a) == 1 && Transport_NextFrameIdCtx(&a) == 2);
+    TEST_ASSERT(Transport_NextFrameIdCtx(&b) == 1);
+    uint8_t id = 0;
+    TEST_ASSERT(Transport_SendReliableCtx(&b, TLV_INTERFACE_UART, &e, 1, NULL, NULL, &id));
+    TEST_ASSERT(Transport_InFlightCtx(&b, TLV_INTERFACE_UART) == 1);
+    TEST_ASSERT(Transport_InFlightCtx(&a, TLV_INTERFACE_UART) == 0);
+    TEST_ASSERT(Transport_InFlight(TLV_INTERFACE_UART) == 0);
+
+    uint8_t ack[20];
+    uint16_t ack_len = 0;
+    TLV_BuildAckFrame(id, ack, &ack_len);
+    TEST_FEED(FloatReceive_GetParserCtx(&a, TLV_INTERFACE_UART), ack, ack_len); /* wrong link: ignored */
+    TEST_ASSERT(Transport_InFlightCtx(&b, TLV_INTERFACE_UART) == 1);
+    TEST_FEED(FloatReceive_GetParserCtx(&b, TLV_INTERFACE_UART), ack, ack_len);
+    TEST_ASSERT(Transport_InFlightCtx(&b, TLV_INTERFACE_UART) == 0);
+
+    TVL_ContextDeinit(&a);
+    TVL_ContextDeinit(&b);
+    return 0;
+}
+
+static uint8_t g_order[TVLCOM_DISPATCH_QUEUE_DEPTH + 4];
+static uint8_t g_order_count;
+
+static bool on_order_tlv(const tlv_entry_t *entry, tlv_interface_t interface)
+{
+    (void)interface;
+    if (g_order_count < sizeof(g_order)) g_order[g_order_count++] = entry->value[0];
+    return true;
+}
+
+static uint16_t build_order_frame(uint8_t frame_id, uint8_t v, bool best_effort, uint8_t *frame)
+{
+    tlv_entry_t e[2];
+    uint8_t n = 0;
+    if (best_effort) TLV_CreateRawEntry(TLV_TYPE_NO_ACK, NULL, 0, &e[n++]);
+    TLV_CreateRawEntry(0x71, &v, 1, &e[n++]);
+    uint16_t len = 0;
+    TLV_BuildFrame(frame_id, e, n, frame, &len);
+    return len;
+}
+
+static int test_dispatch_pool_defers_and_orders(void)
+{
+    static tvl_dispatch_t pool;
+    TVL_HAL_Set(NULL);
+    capture_reset();
+    Transport_RegisterSender(TLV_INTERFACE_UART, mock_send);
+    FloatReceive_Init(TLV_INTERFACE_UART);
+    FloatReceive_RegisterTLVHandler(0x71, on_order_tlv);
+    TVL_DispatchInit(&pool, 2);
+    FloatReceive_SetDispatch(&pool);
+    uint8_t w = TVL_DispatchWorkerOf(&pool, TVL_ContextDefault(), TLV_INTERFACE_UART);
+    g_order_count = 0;
+
+    /* The parsing thread only queues: no handler, no reply yet */
+    uint8_t frame[TLV_MAX_FRAME_SIZE];
+    for (uint8_t i = 0; i < 3; ++i) {
+        uint16_t n = build_order_frame((uint8_t)(0x50 + i), (uint8_t)(i + 1), false, frame);
+        feed_bytes_to_uart_parser(frame, n);
+    }
+    tvl_dispatch_stats_t st;
+    TVL_DispatchGetStats(&pool, w, &st);
+    TEST_ASSERT(st.pending == 3 && g_order_count == 0 && g_tx.len == 0);
+    TEST_ASSERT(TVL_DispatchRunOnce(&pool, (uint8_t)(w ^ 1u), 8) == 0);
+
+    /* The worker runs them in arrival order and sends the ACKs */
+    TEST_ASSERT(TVL_DispatchRun(&pool, w, 0) == 3);
+    TEST_ASSERT(g_order_count == 3 && g_order[0] == 1 && g_order[1] == 2 && g_order[2] == 3);
+    TEST_ASSERT(capture_contains_tlv_type(TLV_TYPE_ACK));
+
+    /* Full queue: reliable frames are NACKed for retransmission, best-effort ones dropped */
+    for (uint8_t i = 0; i < TVLCOM_DISPATCH_QUEUE_DEPTH; ++i) {
+        uint16_t n = build_order_frame((uint8_t)(0x60 + i), i, false, frame);
+        feed_bytes_to_uart_parser(frame, n);
+    }
+    capture_reset();
+    uint16_t n = build_order_frame(0x7F, 0xEE, true, frame);
+    feed_bytes_to_uart_parser(frame, n);
+    TEST_ASSERT(g_tx.len == 0);
+    n = build_order_frame(0x7E, 0xEE, false, frame);
+    feed_bytes_to_uart_parser(frame, n);
+    TEST_ASSERT(capture_contains_tlv_type(TLV_TYPE_NACK));
+    TVL_DispatchGetStats(&pool, w, &st);
+    TEST_ASSERT(st.rejected == 2 && st.pending == TVLCOM_DISPATCH_QUEUE_DEPTH);
+
+    g_order_count = 0;
+    TEST_ASSERT(TVL_DispatchRunOnce(&pool, w, UINT16_MAX) == TVLCOM_DISPATCH_QUEUE_DEPTH);
+    TEST_ASSERT(g_order_count == TVLCOM_DISPATCH_QUEUE_DEPTH && g_order[TVLCOM_DISPATCH_QUEUE_DEPTH - 1] ==
+                TVLCOM_DISPATCH_QUEUE_DEPTH - 1);
+
+    /* Larger than a slot: never fits, so a final TOO_LARGE NACK instead of one asking for a retry */
+    static uint8_t big[4 + TVLCOM_DISPATCH_SLOT_DATA + 60];
+    const uint16_t vlen = (uint16_t)(sizeof(big) - 4u);
+    big[0] = 0x71;
+    big[1] = TLV_LEN_EXT;
+    big[2] = (uint8_t)(vlen >> 8);
+    big[3] = (uint8_t)(vlen & 0xFF);
+    capture_reset();
+    FloatReceive_FrameCallback(0x7D, big, (uint16_t)sizeof(big), TLV_INTERFACE_UART);
+    tlv_entry_t reply;
+    tlv_nack_info_t info;
+    TEST_ASSERT(TLV_ParseData(&g_tx.buf[4], g_tx.buf[3], &reply, 1) == 1 && TLV_ParseNack(&reply, &info));
+    TEST_ASSERT(info.frame_id == 0x7D && info.count == 1 && info.items[0].index == 0 &&
+                info.items[0].type == 0x71 && info.items[0].status == TLV_STATUS_TOO_LARGE);
+    TVL_DispatchGetStats(&pool, w, &st);
+    TEST_ASSERT(st.rejected == 3 && st.pending == 0 && g_order_count == TVLCOM_DISPATCH_QUEUE_DEPTH);
+
+    /* The sender's reliable window fails such a frame at once, without retransmitting */
+    tx_done_log_t log;
+    memset(&log, 0, sizeof(log));
+    tlv_entry_t e;
+    uint8_t v = 1;
+    uint8_t rid = 0;
+    TLV_CreateRawEntry(0x71, &v, 1, &e);
+    TEST_ASSERT(Transport_SendReliable(TLV_INTERFACE_UART, &e, 1, on_tx_done, &log, &rid));
+    info.frame_id = rid;
+    capture_reset();
+    Transport_HandleNackEx(&info, TLV_INTERFACE_UART);
+    TEST_ASSERT(g_tx.len == 0 && log.n == 1 && log.id[0] == rid && log.status[0] == TRANSPORT_TX_NACKED);
+    TEST_ASSERT(Transport_InFlight(TLV_INTERFACE_UART) == 0);
+    TEST_ASSERT(!Transport_ResendRejected(TLV_INTERFACE_UART, &e, 1, &info, NULL));
+
+    FloatReceive_SetDispatch(NULL);
+    TVL_DispatchDeinit(&pool);
+    FloatReceive_RegisterTLVHandler(0x71, NULL);
+    return 0;
+}
+
+static uint32_t g_ring_frames;
+static uint32_t g_ring_errors;
+static uint32_t g_ring_bad;
+
+/* Frame i carries seq i (4 bytes) followed by i % 40 filler bytes of (uint8_t)i */
+static uint16_t build_ring_frame(uint32_t seq, uint8_t *frame)
+{
+    uint8_t value[4 + 40];
+    uint16_t vlen = (uint16_t)(4u + seq % 40u);
+    memcpy(value, &seq, 4);
+    memset(value + 4, (int)(uint8_t)seq, vlen - 4u);
+    tlv_entry_t e;
+    TLV_CreateRawEntry(0x72, value, vlen, &e);
+    uint16_t n = 0;
+    TLV_BuildFrame((uint8_t)seq, &e, 1, frame, &n);
+    return n;
+}
+
+static void on_ring_frame(uint8_t frame_id, const uint8_t *data, uint16_t length, tlv_interface_t iface)
+{
+    (void)iface;
+    uint32_t seq = 0;
+    if (length >= 6) memcpy(&seq, data + 2, 4);
+    bool ok = length >= 6 && seq == g_ring_frames && frame_id == (uint8_t)seq &&
+              length == 6u + seq % 40u;
+    for (uint16_t i = 6; ok && i < length; ++i) ok = data[i] == (uint8_t)seq;
+    if (!ok) g_ring_bad++;
+    g_ring_frames++;
+}
+
+static void on_ring_error(uint8_t frame_id, tlv_interface_t iface, tlv_error_t error)
+{
+    (void)frame_id;
+    (void)iface;
+    (void)error;
+    g_ring_errors++;
+}
+
+static int test_rx_ring_wraps_and_counts(void)
+{
+    static uint8_t storage[64];
+    static tvl_rx_ring_t ring;
+    uint8_t bytes[64];
+    for (uint8_t i = 0; i < sizeof(bytes); ++i) bytes[i] = i;
+
+    TEST_ASSERT(!TVL_RxRingInit(&ring, storage, 48));
+    TEST_ASSERT(TVL_RxRingInit(&ring, storage, sizeof(storage)));
+
+    /* Move the indices near the end of storage, then wrap */
+    TEST_ASSERT(TVL_RxRingPush(&ring, bytes, 50) == 50);
+    const uint8_t *p = NULL;
+    TEST_ASSERT(TVL_RxRingPeek(&ring, &p) == 50 && p[49] == 49);
+    TVL_RxRingConsume(&ring, 50);
+    TEST_ASSERT(TVL_RxRingPush(&ring, bytes, 20) == 20);
+    TEST_ASSERT(TVL_RxRingPeek(&ring, &p) == 14 && p[0] == 0 && p[13] == 13);
+    TVL_RxRingConsume(&ring, 14);
+    TEST_ASSERT(TVL_RxRingPeek(&ring, &p) == 6 && p[0] == 14 && p == storage);
+    TVL_RxRingConsume(&ring, 6);
+
+    /* Full ring: what doesn't fit is dropped and counted */
+    TEST_ASSERT(TVL_RxRingPush(&ring, bytes, 60) == 60);
+    TEST_ASSERT(TVL_RxRingPush(&ring, bytes, 10) == 4);
+    TEST_ASSERT(!TVL_RxRingPushByte(&ring, 0xAA));
+    tvl_rx_ring_stats_t st;
+    TVL_RxRingGetStats(&ring, &st);
+    TEST_ASSERT(st.size == 64 && st.used == 64 && st.high_water == 64);
+    TEST_ASSERT(st.pushed == 134 && st.dropped == 7 && st.overflows == 2);
+    TVL_RxRingConsume(&ring, TVL_RxRingUsed(&ring));
+
+    /* Drain a frame that straddles the end of storage into a parser, in two pieces */
+    tlv_parser_t parser;
+    TLV_InitParser(&parser, TLV_INTERFACE_UART, on_ring_frame);
+    TLV_SetErrorCallback(&parser, on_ring_error);
+    g_ring_frames = g_ring_errors = g_ring_bad = 0;
+    uint8_t frame[TLV_MAX_FRAME_SIZE];
+    uint16_t n = build_ring_frame(0, frame);
+    TEST_ASSERT(TVL_RxRingPush(&ring, frame, 5) == 5);
+    TEST_ASSERT(TVL_RxRingDrain(&ring, &parser, 0) == 5 && g_ring_frames == 0);
+    TEST_ASSERT(TVL_RxRingPush(&ring, frame + 5, (uint32_t)(n - 5u)) == (uint32_t)(n - 5u));
+    TEST_ASSERT(TVL_RxRingDrain(&ring, &parser, 0) == (uint32_t)(n - 5u));
+    TEST_ASSERT(g_ring_frames == 1 && g_ring_errors == 0 && g_ring_bad == 0);
+    TEST_ASSERT(TVL_RxRingUsed(&ring) == 0);
+    return 0;
+}
+
+#if TEST_HAVE_THREADS && TVLCOM_RX_RING_ATOMIC
+#define RING_STRESS_FRAMES 20000u
+
+typedef struct {
+    tvl_rx_ring_t *ring;
+    uint32_t pushed;        /* bytes stored */
+    uint32_t refused;       /* bytes the ring refused (counted as dropped) */
+    uint32_t short_pushes;  /* pushes that stored less than asked */
+} ring_producer_t;
+
+/* Producer thread: every frame goes in eventually; refused remainders are pushed again */
+static void *ring_producer(void *arg)
+{
+    ring_producer_t *pr = (ring_producer_t *)arg;
+    uint8_t frame[TLV_MAX_FRAME_SIZE];
+    uint32_t rnd = 0x9E3779B9u;
+    for (uint32_t seq = 0; seq < RING_STRESS_FRAMES; ++seq) {
+        uint16_t n = build_ring_frame(seq, frame);
+        uint16_t off = 0;
+        while (off < n) {
+            rnd ^= rnd << 13; rnd ^= rnd >> 17; rnd ^= rnd << 5;
+            uint32_t want = 1u + rnd % 23u;
+            if (want > (uint32_t)(n - off)) want = (uint32_t)(n - off);
+            uint32_t got = (rnd & 0x100u) && want == 1u ? (uint32_t)TVL_RxRingPushByte(pr->ring, frame[off])
+                                                        : TVL_RxRingPush(pr->ring, frame + off, want);
+            if (got < want) {
+                pr->refused += want - got;
+                pr->short_pushes++;
+                if (!got) sched_yield(); /* ring full: let the consumer run (single-core hosts) */
+            }
+            pr->pushed += got;
+            off = (uint16_t)(off + got);
+        }
+    }
+    return NULL;
+}
+#endif
+
+static int test_rx_ring_concurrent_stress(void)
+{
+#if !(TEST_HAVE_THREADS && TVLCOM_RX_RING_ATOMIC)
+    return 0;
+#else
+    /* Small ring so the producer keeps running into a full ring and the indices wrap */
+    static uint8_t storage[256];
+    static tvl_rx_ring_t ring;
+    TEST_ASSERT(TVL_RxRingInit(&ring, storage, sizeof(storage)));
+    tlv_parser_t parser;
+    TLV_InitParser(&parser, TLV_INTERFACE_UART, on_ring_frame);
+    TLV_SetErrorCallback(&parser, on_ring_error);
+    g_ring_frames = g_ring_errors = g_ring_bad = 0;
+
+    ring_producer_t pr = { &ring, 0, 0, 0 };
+    pthread_t th;
+    TEST_ASSERT(pthread_create(&th, NULL, ring_producer, &pr) == 0);
+    uint32_t spins = 0;
+    while (g_ring_frames < RING_STRESS_FRAMES && spins < 10000000u) {
+        /* Alternate whole drains with small bounded ones to vary the consumer's steps */
+        uint32_t fed = TVL_RxRingDrain(&ring, &parser, (spins & 1u) ? 7u : 0u);
+        if (!fed) {
+            spins++;
+            sched_yield();
+        }
+    }
+    pthread_join(th, NULL);
+    (void)TVL_RxRingDrain(&ring, &parser, 0);
+
+    TEST_ASSERT(g_ring_frames == RING_STRESS_FRAMES);
+    TEST_ASSERT(g_ring_errors == 0 && g_ring_bad == 0);
+    tvl_rx_ring_stats_t st;
+    TVL_RxRingGetStats(&ring, &st);
+    TEST_ASSERT(st.used == 0 && st.pushed == pr.pushed);
+    TEST_ASSERT(st.dropped == pr.refused && st.overflows == pr.short_pushes);
+    TEST_ASSERT(st.high_water > 0 && st.high_water <= sizeof(storage));
+    return 0;
+#endif
+}
+
+#if TVLCOM_TX_QUEUE_ATOMIC
+static uint32_t g_kicks;
+
+static void on_tx_kick(tvl_tx_queue_t *q, void *user)
+{
+    (void)q;
+    (void)user;
+    g_kicks++;
+}
+#endif
+
+static int test_tx_queue_async_and_backpressure(void)
+{
+#if !TVLCOM_TX_QUEUE_ATOMIC
+    return 0;
+#else
+    static tvl_tx_queue_t q;
+    TVL_HAL_Set(NULL);
+    capture_reset();
+    Transport_RegisterSender(TLV_INTERFACE_UART, mock_send);
+    FloatReceive_Init(TLV_INTERFACE_UART);
+    TEST_ASSERT(TVL_TxQueueInit(&q));
+    Transport_SetTxQueue(TLV_INTERFACE_UART, &q);
+
+    /* Sends only queue; the pool bounds how many */
+    uint8_t expected[TLV_MAX_FRAME_SIZE * 2];
+    uint16_t expected_len = 0;
+    for (uint8_t i = 0; i < TVLCOM_TX_POOL_FRAMES; ++i) {
+        tlv_entry_t e;
+        TLV_CreateInt32Entry(0x73, i, &e);
+        TEST_ASSERT(Transport_SendTLVs(TLV_INTERFACE_UART, (uint8_t)(0x20 + i), &e, 1));
+        if (i < 2) {
+            uint16_t n = 0;
+            TEST_ASSERT(TLV_BuildFrame((uint8_t)(0x20 + i), &e, 1, &expected[expected_len], &n));
+            expected_len = (uint16_t)(expected_len + n);
+        }
+    }
+    TEST_ASSERT(g_tx.len == 0);
+    tlv_entry_t extra;
+    TLV_CreateInt32Entry(0x73, 99, &extra);
+    TEST_ASSERT(!Transport_SendTLVs(TLV_INTERFACE_UART, 0x30, &extra, 1));
+    TEST_ASSERT(Transport_Send(TLV_INTERFACE_UART, expected, 4) == -3);
+    tvl_tx_queue_stats_t st;
+    TVL_TxQueueGetStats(&q, &st);
+    TEST_ASSERT(st.queued == TVLCOM_TX_POOL_FRAMES && st.rejected == 2);
+    TEST_ASSERT(st.in_use == TVLCOM_TX_POOL_FRAMES && st.high_water == TVLCOM_TX_POOL_FRAMES);
+
+    /* The drain step sends in order and frees buffers */
+    TEST_ASSERT(TVL_TxQueueDrain(&q, 2) == 2);
+    TEST_ASSERT(g_tx.len == expected_len && memcmp(g_tx.buf, expected, expected_len) == 0);
+    TVL_TxQueueGetStats(&q, &st);
+    TEST_ASSERT(st.sent == 2 && st.in_use == TVLCOM_TX_POOL_FRAMES - 2);
+    TEST_ASSERT(TVL_TxQueueDrain(&q, UINT16_MAX) == TVLCOM_TX_POOL_FRAMES - 2);
+
+    /* DMA-style: kick on submit, buffer stays put until Complete */
+    capture_reset();
+    g_kicks = 0;
+    TVL_TxQueueSetKick(&q, on_tx_kick, NULL);
+    TEST_ASSERT(Transport_Send(TLV_INTERFACE_UART, expected, 4) == 4);
+    TEST_ASSERT(g_kicks == 1);
+    uint16_t len = 0;
+    const uint8_t *head = TVL_TxQueuePeek(&q, &len);
+    TEST_ASSERT(head && len == 4 && memcmp(head, expected, 4) == 0 && TVL_TxQueuePeek(&q, &len) == head);
+    TVL_TxQueueComplete(&q);
+    TEST_ASSERT(TVL_TxQueuePeek(&q, &len) == NULL && g_tx.len == 0);
+    TVL_TxQueueSetKick(&q, NULL, NULL);
+
+    /* Replies from the receive layer go through the queue too */
+    capture_reset();
+    uint8_t frame[TLV_MAX_FRAME_SIZE];
+    uint16_t n = 0;
+    TEST_ASSERT(TLV_BuildFrame(0x41, &extra, 1, frame, &n));
+    feed_bytes_to_uart_parser(frame, n);
+    TEST_ASSERT(g_tx.len == 0);
+    TEST_ASSERT(TVL_TxQueueRun(&q, 0) == 1 && capture_contains_tlv_type(TLV_TYPE_NACK));
+
+    TVL_TxQueueGetStats(&q, &st);
+    TEST_ASSERT(st.in_use == 0 && st.sent == st.queued && st.errors == 0);
+    Transport_SetTxQueue(TLV_INTERFACE_UART, NULL);
+    TVL_TxQueueDeinit(&q);
+    return 0;
+#endif
+}
+
+#if TEST_HAVE_THREADS && TVLCOM_TX_QUEUE_ATOMIC
+#define TXQ_STRESS_PRODUCERS 4u
+#define TXQ_STRESS_FRAMES 5000u
+
+static tlv_parser_t g_txq_far;              /* far side of the wire */
+static uint32_t g_txq_next[TXQ_STRESS_PRODUCERS];
+static uint32_t g_txq_frames;
+static uint32_t g_txq_bad;
+static atomic_bool g_txq_done;
+
+/* Runs on the drain thread only */
+static int txq_wire_send(const uint8_t *data, uint16_t len)
+{
+    (void)TLV_ProcessBuffer(&g_txq_far, data, len);
+    return (int)len;
+}
+
+/* Per producer, frames must arrive complete and in send order */
+static void on_txq_frame(uint8_t frame_id, const uint8_t *data, uint16_t length, tlv_interface_t iface)
+{
+    (void)frame_id;
+    (void)iface;
+    if (length != 7 || data[0] != 0x74 || data[2] >= TXQ_STRESS_PRODUCERS) {
+        g_txq_bad++;
+        return;
+    }
+    uint32_t seq;
+    memcpy(&seq, &data[3], 4);
+    if (seq != g_txq_next[data[2]]++) g_txq_bad++;
+    g_txq_frames++;
+}
+
+static void on_txq_error(uint8_t frame_id, tlv_interface_t iface, tlv_error_t error)
+{
+    (void)frame_id;
+    (void)iface;
+    (void)error;
+    g_txq_bad++;
+}
+
+static void *txq_producer(void *arg)
+{
+    uint8_t value[5];
+    value[0] = (uint8_t)(uintptr_t)arg;
+    for (uint32_t seq = 0; seq < TXQ_STRESS_FRAMES; ++seq) {
+        memcpy(&value[1], &seq, 4);
+        tlv_entry_t e;
+        TLV_CreateRawEntry(0x74, value, sizeof(value), &e);
+        while (!Transport_SendTLVs(TLV_INTERFACE_UART, (uint8_t)seq, &e, 1)) {
+            sched_yield(); /* pool exhausted: back off */
+        }
+    }
+    return NULL;
+}
+
+static void *txq_drainer(void *arg)
+{
+    tvl_tx_queue_t *q = (tvl_tx_queue_t *)arg;
+    while (!atomic_load(&g_txq_done)) {
+        if (!TVL_TxQueueDrain(q, UINT16_MAX)) sched_yield();
+    }
+    (void)TVL_TxQueueDrain(q, UINT16_MAX);
+    return NULL;
+}
+#endif
+
+static int test_tx_queue_concurrent_producers(void)
+{
+#if !(TEST_HAVE_THREADS && TVLCOM_TX_QUEUE_ATOMIC)
+    return 0;
+#else
+    static tvl_tx_queue_t q;
+    TVL_HAL_Set(NULL);
+    TLV_InitParser(&g_txq_far, TLV_INTERFACE_UART, on_txq_frame);
+    TLV_SetErrorCallback(&g_txq_far, on_txq_error);
+    memset(g_txq_next, 0, sizeof(g_txq_next));
+    g_txq_frames = g_txq_bad = 0;
+    atomic_store(&g_txq_done, false);
+    Transport_RegisterSender(TLV_INTERFACE_UART, txq_wire_send);
+    TEST_ASSERT(TVL_TxQueueInit(&q));
+    Transport_SetTxQueue(TLV_INTERFACE_UART, &q);
+
+    pthread_t prod[TXQ_STRESS_PRODUCERS], drain;
+    TEST_ASSERT(pthread_create(&drain, NULL, txq_drainer, &q) == 0);
+    for (uintptr_t i = 0; i < TXQ_STRESS_PRODUCERS; ++i) {
+        TEST_ASSERT(pthread_create(&prod[i], NULL, txq_producer, (void *)i) == 0);
+    }
+    for (unsigned i = 0; i < TXQ_STRESS_PRODUCERS; ++i) pthread_join(prod[i], NULL);
+    atomic_store(&g_txq_done, true);
+    pthread_join(drain, NULL);
+
+    TEST_ASSERT(g_txq_bad == 0 && g_txq_frames == TXQ_STRESS_PRODUCERS * TXQ_STRESS_FRAMES);
+    tvl_tx_queue_stats_t st;
+    TVL_TxQueueGetStats(&q, &st);
+    TEST_ASSERT(st.queued == g_txq_frames && st.sent == g_txq_frames && st.in_use == 0);
+    TEST_ASSERT(st.high_water <= TVLCOM_TX_POOL_FRAMES);
+
+    Transport_SetTxQueue(TLV_INTERFACE_UART, NULL);
+    TVL_TxQueueDeinit(&q);
+    Transport_RegisterSender(TLV_INTERFACE_UART, mock_send);
+    return 0;
+#endif
+}
+
+#if TEST_HAVE_THREADS
+#define CMB_PRODUCERS 4u
+#define CMB_FRAMES 2000u
+#define CMB_WIRE_CHUNK 5u
+
+/* pthread mutexes for the HAL: concurrent senders only serialise when the HAL has a mutex */
+static tvl_hal_mutex_t test_mutex_create(void)
+{
+    pthread_mutex_t *m = (pthread_mutex_t *)malloc(sizeof(*m));
+    if (m) pthread_mutex_init(m, NULL);
+    return m;
+}
+
+static void test_mutex_destroy(tvl_hal_mutex_t m)
+{
+    pthread_mutex_destroy((pthread_mutex_t *)m);
+    free(m);
+}
+
+static void test_mutex_lock(tvl_hal_mutex_t m)
+{
+    pthread_mutex_lock((pthread_mutex_t *)m);
+}
+
+static void test_mutex_unlock(tvl_hal_mutex_t m)
+{
+    pthread_mutex_unlock((pthread_mutex_t *)m);
+}
+
+static const tvl_hal_vtable_t g_pthread_hal = {
+    .mutex_create = test_mutex_create,
+    .mutex_destroy = test_mutex_destroy,
+    .mutex_lock = test_mutex_lock,
+    .mutex_unlock = test_mutex_unlock,
+};
+
+static tvl_context_t g_cmb_ctx;
+static tlv_parser_t g_cmb_far;              /* far side of the wire */
+static pthread_mutex_t g_cmb_wire = PTHREAD_MUTEX_INITIALIZER;
+static uint32_t g_cmb_next[CMB_PRODUCERS];
+static uint32_t g_cmb_frames;
+static uint32_t g_cmb_bad;
+
+/* A wire taking at most CMB_WIRE_CHUNK bytes per write and yielding in between (short writes) */
+static void cmb_wire_put(const uint8_t *data, uint16_t len)
+{
+    for (uint16_t off = 0; off < len;) {
+        uint16_t n = (uint16_t)(len - off);
+        if (n > CMB_WIRE_CHUNK) n = CMB_WIRE_CHUNK;
+        (void)TLV_ProcessBuffer(&g_cmb_far, data + off, n);
+        off = (uint16_t)(off + n);
+        sched_yield();
+    }
+}
+
+static int cmb_wire_send(const uint8_t *data, uint16_t len)
+{
+    if (pthread_mutex_trylock(&g_cmb_wire) != 0) {
+        g_cmb_bad++; /* two writers at once; the far side will see broken frames too */
+        return -1;
+    }
+    cmb_wire_put(data, len);
+    pthread_mutex_unlock(&g_cmb_wire);
+    return (int)len;
+}
+
+static int cmb_wire_sendv(const transport_iovec_t *iov, uint8_t iovcnt)
+{
+    if (pthread_mutex_trylock(&g_cmb_wire) != 0) {
+        g_cmb_bad++;
+        return -1;
+    }
+    int total = 0;
+    for (uint8_t i = 0; i < iovcnt; ++i) {
+        cmb_wire_put(iov[i].base, iov[i].len);
+        total += iov[i].len;
+    }
+    pthread_mutex_unlock(&g_cmb_wire);
+    return total;
+}
+
+/* Per producer, frames must arrive complete and in send order */
+static void on_cmb_frame(uint8_t frame_id, const uint8_t *data, uint16_t length, tlv_interface_t iface)
+{
+    (void)frame_id;
+    (void)iface;
+    if (length != 7 || data[0] != 0x75 || data[2] >= CMB_PRODUCERS) {
+        g_cmb_bad++;
+        return;
+    }
+    uint32_t seq;
+    memcpy(&seq, &data[3], 4);
+    if (seq != g_cmb_next[data[2]]++) g_cmb_bad++;
+    g_cmb_frames++;
+}
+
+static void on_cmb_error(uint8_t frame_id, tlv_interface_t iface, tlv_error_t error)
+{
+    (void)frame_id;
+    (void)iface;
+    (void)error;
+    g_cmb_bad++;
+}
+
+static void *cmb_producer(void *arg)
+{
+    uint8_t value[5];
+    value[0] = (uint8_t)(uintptr_t)arg;
+    for (uint32_t seq = 0; seq < CMB_FRAMES; ++seq) {
+        memcpy(&value[1], &seq, 4);
+        tlv_entry_t e;
+        TLV_CreateRawEntry(0x75, value, sizeof(value), &e);
+        if (!Transport_SendTLVsCtx(&g_cmb_ctx, TLV_INTERFACE_UART, (uint8_t)seq, &e, 1)) g_cmb_bad++;
+    }
+    return NULL;
+}
+
+/* One round: every producer's frames reach the far side whole and in order */
+static int cmb_run_producers(void)
+{
+    TLV_InitParser(&g_cmb_far, TLV_INTERFACE_UART, on_cmb_frame);
+    TLV_SetErrorCallback(&g_cmb_far, on_cmb_error);
+    memset(g_cmb_next, 0, sizeof(g_cmb_next));
+    g_cmb_frames = g_cmb_bad = 0;
+
+    pthread_t prod[CMB_PRODUCERS];
+    for (uintptr_t i = 0; i < CMB_PRODUCERS; ++i) {
+        TEST_ASSERT(pthread_create(&prod[i], NULL, cmb_producer, (void *)i) == 0);
+    }
+    for (unsigned i = 0; i < CMB_PRODUCERS; ++i) pthread_join(prod[i], NULL);
+    TEST_ASSERT(g_cmb_bad == 0 && g_cmb_frames == CMB_PRODUCERS * CMB_FRAMES);
+    return 0;
+}
+#endif
+
+#if TEST_HAVE_THREADS
+static uint8_t g_reentrant_in_flight;
+
+/* A sender that looks at the reliable window: deadlocks if the window lock is held across sends */
+static int reentrant_window_send(const uint8_t *data, uint16_t len)
+{
+    g_reentrant_in_flight = Transport_InFlightCtx(&g_cmb_ctx, TLV_INTERFACE_UART);
+    return mock_send(data, len);
+}
+#endif
+
+static int test_reliable_sends_outside_window_lock(void)
+{
+#if !TEST_HAVE_THREADS
+    return 0;
+#else
+    TVL_HAL_Set(&g_pthread_hal);
+    TVL_ContextInit(&g_cmb_ctx);
+    capture_reset();
+    Transport_RegisterSenderCtx(&g_cmb_ctx, TLV_INTERFACE_UART, reentrant_window_send);
+
+    tlv_entry_t e;
+    TLV_CreateControlCmdEntry(0x05, &e);
+    uint8_t id = 0;
+    TEST_ASSERT(Transport_SendReliableCtx(&g_cmb_ctx, TLV_INTERFACE_UART, &e, 1, NULL, NULL, &id));
+    TEST_ASSERT(g_reentrant_in_flight == 1 && g_tx.len > 0 && g_tx.buf[2] == id);
+
+    /* NACK retransmission runs the sender unlocked too */
+    capture_reset();
+    g_reentrant_in_flight = 0;
+    tlv_nack_info_t nack;
+    memset(&nack, 0, sizeof(nack));
+    nack.frame_id = id;
+    Transport_HandleNackExCtx(&g_cmb_ctx, &nack, TLV_INTERFACE_UART);
+    TEST_ASSERT(g_reentrant_in_flight == 1 && g_tx.len > 0 && g_tx.buf[2] == id);
+
+    TVL_ContextDeinit(&g_cmb_ctx);
+    TVL_HAL_Set(NULL);
+    Transport_RegisterSender(TLV_INTERFACE_UART, mock_send);
+    return 0;
+#endif
+}
+
+#if TEST_HAVE_THREADS && TVLCOM_HAVE_THREAD_LOCAL
+static int g_reentrant_send_rc;
+
+/* A sender that tries to send on its own interface while being called for it */
+static int reentrant_self_send(const uint8_t *data, uint16_t len)
+{
+    static const uint8_t nested[1] = { 0x00 };
+    g_reentrant_send_rc = Transport_SendCtx(&g_cmb_ctx, TLV_INTERFACE_UART, nested, sizeof(nested));
+    return mock_send(data, len);
+}
+#endif
+
+static int test_sender_reentry_fails_fast(void)
+{
+#if !(TEST_HAVE_THREADS && TVLCOM_HAVE_THREAD_LOCAL)
+    return 0;
+#else
+    TVL_HAL_Set(&g_pthread_hal);
+    TVL_ContextInit(&g_cmb_ctx);
+    capture_reset();
+    Transport_RegisterSenderCtx(&g_cmb_ctx, TLV_INTERFACE_UART, reentrant_self_send);
+
+    /* The nested send fails instead of blocking on the write lock; the outer one goes out */
+    static const uint8_t frame[4] = { 1, 2, 3, 4 };
+    g_reentrant_send_rc = 0;
+    TEST_ASSERT(Transport_SendCtx(&g_cmb_ctx, TLV_INTERFACE_UART, frame, sizeof(frame)) == (int)sizeof(frame));
+    TEST_ASSERT(g_reentrant_send_rc == -4 && g_tx.len == sizeof(frame));
+
+    /* Later calls from this thread are unaffected */
+    Transport_RegisterSenderCtx(&g_cmb_ctx, TLV_INTERFACE_UART, mock_send);
+    capture_reset();
+    TEST_ASSERT(Transport_SendCtx(&g_cmb_ctx, TLV_INTERFACE_UART, frame, sizeof(frame)) == (int)sizeof(frame));
+
+    TVL_ContextDeinit(&g_cmb_ctx);
+    TVL_HAL_Set(NULL);
+    Transport_RegisterSender(TLV_INTERFACE_UART, mock_send);
+    return 0;
+#endif
+}
+
+static int test_concurrent_senders_never_interleave(void)
+{
+#if !TEST_HAVE_THREADS
+    return 0;
+#else
+    TVL_HAL_Set(&g_pthread_hal);
+    TVL_ContextInit(&g_cmb_ctx);
+    transport_write_stats_t st;
+
+    /* Plain sender: queued frames are copied into the batch buffer */
+    Transport_RegisterSenderCtx(&g_cmb_ctx, TLV_INTERFACE_UART, cmb_wire_send);
+    TEST_ASSERT(cmb_run_producers() == 0);
+    Transport_GetWriteStatsCtx(&g_cmb_ctx, TLV_INTERFACE_UART, &st);
+    TEST_ASSERT(st.frames == CMB_PRODUCERS * CMB_FRAMES);
+#if TRANSPORT_COMBINE_BYTES
+    TEST_ASSERT(st.writes < st.frames && st.max_batch >= 2 && st.combined <= st.frames);
+    TEST_ASSERT(st.max_batch <= TRANSPORT_COMBINE_BYTES / (TLV_OVERHEAD_SIZE + 7u));
+#else
+    TEST_ASSERT(st.writes == st.frames && st.combined == 0); /* serialised, one write per frame */
+#endif
+
+    /* sendv backend: queued frames go out as one slice list */
+    Transport_RegisterSenderVCtx(&g_cmb_ctx, TLV_INTERFACE_UART, cmb_wire_sendv);
+    TEST_ASSERT(cmb_run_producers() == 0);
+    transport_write_stats_t st2;
+    Transport_GetWriteStatsCtx(&g_cmb_ctx, TLV_INTERFACE_UART, &st2);
+    TEST_ASSERT(st2.frames - st.frames == CMB_PRODUCERS * CMB_FRAMES);
+    TEST_ASSERT(st2.writes - st.writes < st2.frames - st.frames);
+
+    TVL_ContextDeinit(&g_cmb_ctx);
+    TVL_HAL_Set(NULL);
+    return 0;
+#endif
+}
+
 int main(void)
 {
     TEST_RUN(test_auto_ack_when_all_handlers_ok);
     TEST_RUN(test_auto_nack_when_unknown_type);
     TEST_RUN(test_no_ack_storm_on_received_ack);
+    TEST_RUN(test_crc16_engines_match_reference);
+    TEST_RUN(test_streaming_crc_and_parser_crc_check);
+    TEST_RUN(test_process_buffer_matches_per_byte);
+    TEST_RUN(test_sync_scan_impls_agree);
+    TEST_RUN(test_backtracking_recovers_frame_behind_false_header);
+    TEST_RUN(test_frame_writer_matches_build_frame);
+    TEST_RUN(test_send_tlvs_scatter_gather);
+    TEST_RUN(test_extended_frames_share_parser_with_classic);
+    TEST_RUN(test_fragment_reassembly_pool);
+    TEST_RUN(test_reliable_window_retransmit);
+    TEST_RUN(test_coalesced_ack_bitmap);
+    TEST_RUN(test_piggybacked_ack_on_data_frames);
+    TEST_RUN(test_piggybacked_acks_survive_failed_send);
+    TEST_RUN(test_best_effort_frames_are_not_answered);
+    TEST_RUN(test_selective_nack_resends_only_rejected);
+    TEST_RUN(test_duplicate_frames_replay_cached_reply);
+    TEST_RUN(test_duplicate_cache_retries_nacked_frame);
+    TEST_RUN(test_dispatch_tables_lift_handler_cap);
+    TEST_RUN(test_registry_snapshot_per_frame);
+    TEST_RUN(test_contexts_are_isolated);
+    TEST_RUN(test_dispatch_pool_defers_and_orders);
+    TEST_RUN(test_rx_ring_wraps_and_counts);
+    TEST_RUN(test_rx_ring_concurrent_stress);
+    TEST_RUN(test_tx_queue_async_and_backpressure);
+    TEST_RUN(test_tx_queue_concurrent_producers);
+    TEST_RUN(test_reliable_sends_outside_window_lock);
+    TEST_RUN(test_sender_reentry_fails_fast);
+    TEST_RUN(test_concurrent_senders_never_interleave);
 
     fprintf(stdout, "All tests passed.\n");
     return 0;